@@ -16,6 +16,7 @@
 #include "json_helpers.h"
 #include "json_common.h"
 #include "json_protocol_names.h"
+#include "cloud_codec_stream.h"
 
 #include <logging/log.h>
 LOG_MODULE_REGISTER(cloud_codec, CONFIG_CLOUD_CODEC_LOG_LEVEL);
@@ -391,6 +392,18 @@ int cloud_codec_encode_batch_data(
 	char *buffer;
 	bool object_added = false;
 
+#if defined(CONFIG_CLOUD_CODEC_BATCH_STREAM)
+	return cloud_codec_stream_encode_batch_data(output, gps_buf, sensor_buf,
+						    modem_dyn_buf, ui_buf,
+						    accel_buf, bat_buf,
+						    gps_buf_count,
+						    sensor_buf_count,
+						    modem_dyn_buf_count,
+						    ui_buf_count,
+						    accel_buf_count,
+						    bat_buf_count);
+#endif
+
 	cJSON *root_obj = cJSON_CreateObject();
 
 	if (root_obj == NULL) {
@@ -0,0 +1,861 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <sys/byteorder.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <date_time.h>
+
+#include "cloud_codec.h"
+#include "cloud_codec_stream.h"
+#include "json_protocol_names.h"
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(cloud_codec_stream, CONFIG_CLOUD_CODEC_LOG_LEVEL);
+
+/* Size of the stack buffer used when determining the length of a message. */
+#define COUNT_CHUNK_SIZE 32
+
+/* Number of times a batch message is encoded when the date and time are
+ * updated between determining its length and encoding it.
+ */
+#define ENCODE_ATTEMPTS 3
+
+/* Deepest nesting of maps and arrays that can be encoded. */
+#define DEPTH_MAX 31
+
+#define CBOR_MAJOR_UINT 0
+#define CBOR_MAJOR_NINT 1
+#define CBOR_MAJOR_TEXT 3
+
+#define CBOR_ARRAY_INDEF 0x9f
+#define CBOR_MAP_INDEF 0xbf
+#define CBOR_FLOAT32 0xfa
+#define CBOR_FLOAT64 0xfb
+#define CBOR_BREAK 0xff
+
+static void stream_write(struct cloud_codec_stream *stream, const void *data, size_t len)
+{
+	const char *src = data;
+
+	while (len > 0 && !stream->err) {
+		size_t n;
+
+		if (stream->len == stream->size) {
+			if (stream->flush == NULL) {
+				stream->err = -ENOMEM;
+				return;
+			}
+
+			stream->err = stream->flush(stream->buf, stream->len,
+						    stream->user_data);
+			stream->len = 0;
+			continue;
+		}
+
+		n = MIN(len, stream->size - stream->len);
+		memcpy(&stream->buf[stream->len], src, n);
+		stream->len += n;
+		stream->total += n;
+		src += n;
+		len -= n;
+	}
+}
+
+static void stream_write_byte(struct cloud_codec_stream *stream, uint8_t byte)
+{
+	stream_write(stream, &byte, 1);
+}
+
+/* JSON output, formatted the same way as cJSON_PrintUnformatted(). */
+
+static void json_string(struct cloud_codec_stream *stream, const char *str)
+{
+	const char *start = str;
+
+	stream_write_byte(stream, '"');
+
+	for (; *str != '\0'; str++) {
+		char esc[7];
+		uint8_t c = *str;
+
+		if (c >= 32 && c != '"' && c != '\\') {
+			continue;
+		}
+
+		stream_write(stream, start, str - start);
+		start = str + 1;
+
+		switch (c) {
+		case '"':
+		case '\\':
+			esc[0] = '\\';
+			esc[1] = c;
+			stream_write(stream, esc, 2);
+			break;
+		case '\b':
+			stream_write(stream, "\\b", 2);
+			break;
+		case '\f':
+			stream_write(stream, "\\f", 2);
+			break;
+		case '\n':
+			stream_write(stream, "\\n", 2);
+			break;
+		case '\r':
+			stream_write(stream, "\\r", 2);
+			break;
+		case '\t':
+			stream_write(stream, "\\t", 2);
+			break;
+		default:
+			snprintf(esc, sizeof(esc), "\\u%04x", c);
+			stream_write(stream, esc, 6);
+			break;
+		}
+	}
+
+	stream_write(stream, start, str - start);
+	stream_write_byte(stream, '"');
+}
+
+static void json_number(struct cloud_codec_stream *stream, double value)
+{
+	char num[26];
+	int len;
+	int valueint;
+
+	/* cJSON stores numbers as a double and a saturated integer, and
+	 * prints the integer if the two are equal.
+	 */
+	if (value >= INT_MAX) {
+		valueint = INT_MAX;
+	} else if (value <= (double)INT_MIN) {
+		valueint = INT_MIN;
+	} else {
+		valueint = (int)value;
+	}
+
+	if (isnan(value) || isinf(value)) {
+		len = snprintf(num, sizeof(num), "null");
+	} else if (value == (double)valueint) {
+		len = snprintf(num, sizeof(num), "%d", valueint);
+	} else {
+		double test;
+
+		/* Shortest representation that reads back as the same
+		 * value.
+		 */
+		len = snprintf(num, sizeof(num), "%1.15g", value);
+		test = strtod(num, NULL);
+		if (fabs(test - value) >
+		    MAX(fabs(test), fabs(value)) * DBL_EPSILON) {
+			len = snprintf(num, sizeof(num), "%1.17g", value);
+		}
+	}
+
+	stream_write(stream, num, len);
+}
+
+/* CBOR output. */
+
+static void cbor_head(struct cloud_codec_stream *stream, uint8_t major,
+		      uint64_t value)
+{
+	uint8_t head[9];
+	size_t len;
+
+	head[0] = major << 5;
+
+	if (value < 24) {
+		head[0] |= value;
+		len = 1;
+	} else if (value <= UINT8_MAX) {
+		head[0] |= 24;
+		head[1] = value;
+		len = 2;
+	} else if (value <= UINT16_MAX) {
+		head[0] |= 25;
+		sys_put_be16(value, &head[1]);
+		len = 3;
+	} else if (value <= UINT32_MAX) {
+		head[0] |= 26;
+		sys_put_be32(value, &head[1]);
+		len = 5;
+	} else {
+		head[0] |= 27;
+		sys_put_be64(value, &head[1]);
+		len = 9;
+	}
+
+	stream_write(stream, head, len);
+}
+
+static void cbor_string(struct cloud_codec_stream *stream, const char *str)
+{
+	size_t len = strlen(str);
+
+	cbor_head(stream, CBOR_MAJOR_TEXT, len);
+	stream_write(stream, str, len);
+}
+
+static void cbor_int(struct cloud_codec_stream *stream, int64_t value)
+{
+	if (value >= 0) {
+		cbor_head(stream, CBOR_MAJOR_UINT, value);
+	} else {
+		cbor_head(stream, CBOR_MAJOR_NINT, -(value + 1));
+	}
+}
+
+static void cbor_number(struct cloud_codec_stream *stream, double value)
+{
+	float value32 = value;
+	uint8_t buf[9];
+	union {
+		double f64;
+		uint64_t u64;
+	} d = { .f64 = value };
+	union {
+		float f32;
+		uint32_t u32;
+	} f = { .f32 = value32 };
+
+	if (value >= INT64_MIN && value < (double)INT64_MAX &&
+	    value == (double)(int64_t)value) {
+		cbor_int(stream, (int64_t)value);
+		return;
+	}
+
+	if ((double)value32 == value || isnan(value)) {
+		buf[0] = CBOR_FLOAT32;
+		sys_put_be32(f.u32, &buf[1]);
+		stream_write(stream, buf, 5);
+		return;
+	}
+
+	buf[0] = CBOR_FLOAT64;
+	sys_put_be64(d.u64, &buf[1]);
+	stream_write(stream, buf, 9);
+}
+
+/* Format independent encoding of maps, arrays and their members. */
+
+static void member_begin(struct cloud_codec_stream *stream, const char *key)
+{
+	if (stream->format == CLOUD_CODEC_STREAM_JSON) {
+		if (stream->members & BIT(stream->depth)) {
+			stream_write_byte(stream, ',');
+		}
+
+		stream->members |= BIT(stream->depth);
+
+		if (key != NULL) {
+			json_string(stream, key);
+			stream_write_byte(stream, ':');
+		}
+	} else if (key != NULL) {
+		cbor_string(stream, key);
+	}
+}
+
+static void container_begin(struct cloud_codec_stream *stream, const char *key,
+			    bool map)
+{
+	if (stream->depth == DEPTH_MAX) {
+		stream->err = -EINVAL;
+		return;
+	}
+
+	member_begin(stream, key);
+
+	if (stream->format == CLOUD_CODEC_STREAM_JSON) {
+		stream_write_byte(stream, map ? '{' : '[');
+	} else {
+		stream_write_byte(stream, map ? CBOR_MAP_INDEF : CBOR_ARRAY_INDEF);
+	}
+
+	stream->depth++;
+	stream->members &= ~BIT(stream->depth);
+}
+
+static void container_end(struct cloud_codec_stream *stream, bool map)
+{
+	if (stream->format == CLOUD_CODEC_STREAM_JSON) {
+		stream_write_byte(stream, map ? '}' : ']');
+	} else {
+		stream_write_byte(stream, CBOR_BREAK);
+	}
+
+	stream->depth--;
+}
+
+static void map_begin(struct cloud_codec_stream *stream, const char *key)
+{
+	container_begin(stream, key, true);
+}
+
+static void map_end(struct cloud_codec_stream *stream)
+{
+	container_end(stream, true);
+}
+
+static void array_begin(struct cloud_codec_stream *stream, const char *key)
+{
+	container_begin(stream, key, false);
+}
+
+static void array_end(struct cloud_codec_stream *stream)
+{
+	container_end(stream, false);
+}
+
+static void int_add(struct cloud_codec_stream *stream, const char *key,
+		    int64_t value)
+{
+	member_begin(stream, key);
+
+	if (stream->format == CLOUD_CODEC_STREAM_JSON) {
+		json_number(stream, value);
+	} else {
+		cbor_int(stream, value);
+	}
+}
+
+static void number_add(struct cloud_codec_stream *stream, const char *key,
+		       double value)
+{
+	member_begin(stream, key);
+
+	if (stream->format == CLOUD_CODEC_STREAM_JSON) {
+		json_number(stream, value);
+	} else {
+		cbor_number(stream, value);
+	}
+}
+
+static void str_add(struct cloud_codec_stream *stream, const char *key,
+		    const char *value)
+{
+	member_begin(stream, key);
+
+	if (stream->format == CLOUD_CODEC_STREAM_JSON) {
+		json_string(stream, value);
+	} else {
+		cbor_string(stream, value);
+	}
+}
+
+/* Batch data entries, encoded with the same structure as in json_common. */
+
+static int ts_get(int64_t ts, int64_t *unix_ts)
+{
+	int err;
+
+	*unix_ts = ts;
+
+	err = date_time_uptime_to_unix_time_ms(unix_ts);
+	if (err) {
+		LOG_ERR("date_time_uptime_to_unix_time_ms, error: %d", err);
+	}
+
+	return err;
+}
+
+static bool modem_dynamic_valid(const void *entry)
+{
+	const struct cloud_data_modem_dynamic *data = entry;
+
+	return data->queued &&
+	       (data->rsrp_fresh || data->area_code_fresh || data->mccmnc_fresh ||
+		data->cell_id_fresh || data->ip_address_fresh);
+}
+
+static int modem_dynamic_encode(struct cloud_codec_stream *stream,
+				const void *entry)
+{
+	const struct cloud_data_modem_dynamic *data = entry;
+	uint32_t mccmnc = 0;
+	char *end_ptr;
+	int64_t ts;
+	int err;
+
+	err = ts_get(data->ts, &ts);
+	if (err) {
+		return err;
+	}
+
+	if (data->mccmnc_fresh) {
+		/* Convert mccmnc to unsigned long integer. */
+		errno = 0;
+		mccmnc = strtoul(data->mccmnc, &end_ptr, 10);
+
+		if ((errno == ERANGE) || (*end_ptr != '\0')) {
+			LOG_ERR("MCCMNC string could not be converted.");
+			return -ENOTEMPTY;
+		}
+	}
+
+	map_begin(stream, NULL);
+	map_begin(stream, DATA_VALUE);
+
+	if (data->rsrp_fresh) {
+		int_add(stream, MODEM_RSRP, data->rsrp);
+	}
+
+	if (data->area_code_fresh) {
+		int_add(stream, MODEM_AREA_CODE, data->area);
+	}
+
+	if (data->mccmnc_fresh) {
+		int_add(stream, MODEM_MCCMNC, mccmnc);
+	}
+
+	if (data->cell_id_fresh) {
+		int_add(stream, MODEM_CELL_ID, data->cell);
+	}
+
+	if (data->ip_address_fresh) {
+		str_add(stream, MODEM_IP_ADDRESS, data->ip);
+	}
+
+	map_end(stream);
+	int_add(stream, DATA_TIMESTAMP, ts);
+	map_end(stream);
+
+	return stream->err;
+}
+
+static bool gps_valid(const void *entry)
+{
+	return ((const struct cloud_data_gps *)entry)->queued;
+}
+
+static int gps_encode(struct cloud_codec_stream *stream, const void *entry)
+{
+	const struct cloud_data_gps *data = entry;
+	int64_t ts;
+	int err;
+
+	err = ts_get(data->gps_ts, &ts);
+	if (err) {
+		return err;
+	}
+
+	switch (data->format) {
+	case CLOUD_CODEC_GPS_FORMAT_PVT:
+		map_begin(stream, NULL);
+		map_begin(stream, DATA_VALUE);
+		number_add(stream, DATA_GPS_LONGITUDE, data->pvt.longi);
+		number_add(stream, DATA_GPS_LATITUDE, data->pvt.lat);
+		number_add(stream, DATA_MOVEMENT, data->pvt.acc);
+		number_add(stream, DATA_GPS_ALTITUDE, data->pvt.alt);
+		number_add(stream, DATA_GPS_SPEED, data->pvt.spd);
+		number_add(stream, DATA_GPS_HEADING, data->pvt.hdg);
+		map_end(stream);
+		break;
+	case CLOUD_CODEC_GPS_FORMAT_NMEA:
+		map_begin(stream, NULL);
+		str_add(stream, DATA_VALUE, data->nmea);
+		break;
+	case CLOUD_CODEC_GPS_FORMAT_INVALID:
+		/* Fall through */
+	default:
+		LOG_WRN("GPS data format not set");
+		return -EINVAL;
+	}
+
+	int_add(stream, DATA_TIMESTAMP, ts);
+	map_end(stream);
+
+	return stream->err;
+}
+
+static bool sensor_valid(const void *entry)
+{
+	return ((const struct cloud_data_sensors *)entry)->queued;
+}
+
+static int sensor_encode(struct cloud_codec_stream *stream, const void *entry)
+{
+	const struct cloud_data_sensors *data = entry;
+	int64_t ts;
+	int err;
+
+	err = ts_get(data->env_ts, &ts);
+	if (err) {
+		return err;
+	}
+
+	map_begin(stream, NULL);
+	map_begin(stream, DATA_VALUE);
+	number_add(stream, DATA_TEMPERATURE, data->temp);
+	number_add(stream, DATA_HUMID, data->hum);
+	map_end(stream);
+	int_add(stream, DATA_TIMESTAMP, ts);
+	map_end(stream);
+
+	return stream->err;
+}
+
+static bool ui_valid(const void *entry)
+{
+	return ((const struct cloud_data_ui *)entry)->queued;
+}
+
+static int ui_encode(struct cloud_codec_stream *stream, const void *entry)
+{
+	const struct cloud_data_ui *data = entry;
+	int64_t ts;
+	int err;
+
+	err = ts_get(data->btn_ts, &ts);
+	if (err) {
+		return err;
+	}
+
+	map_begin(stream, NULL);
+	int_add(stream, DATA_VALUE, data->btn);
+	int_add(stream, DATA_TIMESTAMP, ts);
+	map_end(stream);
+
+	return stream->err;
+}
+
+static bool battery_valid(const void *entry)
+{
+	return ((const struct cloud_data_battery *)entry)->queued;
+}
+
+static int battery_encode(struct cloud_codec_stream *stream, const void *entry)
+{
+	const struct cloud_data_battery *data = entry;
+	int64_t ts;
+	int err;
+
+	err = ts_get(data->bat_ts, &ts);
+	if (err) {
+		return err;
+	}
+
+	map_begin(stream, NULL);
+	int_add(stream, DATA_VALUE, data->bat);
+	int_add(stream, DATA_TIMESTAMP, ts);
+	map_end(stream);
+
+	return stream->err;
+}
+
+static bool accel_valid(const void *entry)
+{
+	return ((const struct cloud_data_accelerometer *)entry)->queued;
+}
+
+static int accel_encode(struct cloud_codec_stream *stream, const void *entry)
+{
+	const struct cloud_data_accelerometer *data = entry;
+	int64_t ts;
+	int err;
+
+	err = ts_get(data->ts, &ts);
+	if (err) {
+		return err;
+	}
+
+	map_begin(stream, NULL);
+	map_begin(stream, DATA_VALUE);
+	number_add(stream, DATA_MOVEMENT_X, data->values[0]);
+	number_add(stream, DATA_MOVEMENT_Y, data->values[1]);
+	number_add(stream, DATA_MOVEMENT_Z, data->values[2]);
+	map_end(stream);
+	int_add(stream, DATA_TIMESTAMP, ts);
+	map_end(stream);
+
+	return stream->err;
+}
+
+/* Batch data buffer, encoded as an array of its valid entries. */
+struct batch_array {
+	const char *label;
+	const void *buf;
+	size_t count;
+	size_t entry_size;
+	bool (*valid)(const void *entry);
+	int (*encode)(struct cloud_codec_stream *stream, const void *entry);
+};
+
+#define BATCH_ARRAY(_label, _buf, _count, _type)                               \
+	{                                                                      \
+		.label = _label,                                               \
+		.buf = _buf,                                                   \
+		.count = _count,                                               \
+		.entry_size = sizeof(*(_buf)),                                 \
+		.valid = _type##_valid,                                        \
+		.encode = _type##_encode,                                      \
+	}
+
+static bool batch_array_empty(const struct batch_array *array)
+{
+	for (size_t i = 0; i < array->count; i++) {
+		if (array->valid((const uint8_t *)array->buf +
+				 i * array->entry_size)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static int batch_array_encode(struct cloud_codec_stream *stream,
+			      const struct batch_array *array)
+{
+	int err;
+
+	array_begin(stream, array->label);
+
+	for (size_t i = 0; i < array->count; i++) {
+		const void *entry = (const uint8_t *)array->buf +
+				    i * array->entry_size;
+
+		if (!array->valid(entry)) {
+			continue;
+		}
+
+		err = array->encode(stream, entry);
+		if (err) {
+			LOG_ERR("Encoding error: %d returned at %s:%d", err,
+				__FILE__, __LINE__);
+			return err;
+		}
+	}
+
+	array_end(stream);
+
+	return stream->err;
+}
+
+void cloud_codec_stream_init(struct cloud_codec_stream *stream,
+			     enum cloud_codec_stream_format format,
+			     char *buf, size_t size,
+			     cloud_codec_stream_flush_t flush, void *user_data)
+{
+	*stream = (struct cloud_codec_stream){
+		.format = format,
+		.buf = buf,
+		.size = size,
+		.flush = flush,
+		.user_data = user_data,
+	};
+}
+
+int cloud_codec_stream_batch_encode(struct cloud_codec_stream *stream,
+				    const struct cloud_codec_batch *batch)
+{
+	/* Same order as the cJSON based batch encoding. */
+	const struct batch_array arrays[] = {
+		BATCH_ARRAY(DATA_MODEM_DYNAMIC, batch->modem_dyn_buf,
+			    batch->modem_dyn_buf_count, modem_dynamic),
+		BATCH_ARRAY(DATA_GPS, batch->gps_buf, batch->gps_buf_count, gps),
+		BATCH_ARRAY(DATA_ENVIRONMENTALS, batch->sensor_buf,
+			    batch->sensor_buf_count, sensor),
+		BATCH_ARRAY(DATA_BUTTON, batch->ui_buf, batch->ui_buf_count, ui),
+		BATCH_ARRAY(DATA_BATTERY, batch->bat_buf, batch->bat_buf_count,
+			    battery),
+		BATCH_ARRAY(DATA_MOVEMENT, batch->accel_buf,
+			    batch->accel_buf_count, accel),
+	};
+	bool object_added = false;
+	int err;
+
+	for (size_t i = 0; i < ARRAY_SIZE(arrays); i++) {
+		if (batch_array_empty(&arrays[i])) {
+			continue;
+		}
+
+		if (!object_added) {
+			map_begin(stream, NULL);
+			object_added = true;
+		}
+
+		err = batch_array_encode(stream, &arrays[i]);
+		if (err) {
+			return err;
+		}
+	}
+
+	if (!object_added) {
+		LOG_DBG("No data to encode, batch message empty...");
+		return -ENODATA;
+	}
+
+	map_end(stream);
+
+	return stream->err;
+}
+
+int cloud_codec_stream_finish(struct cloud_codec_stream *stream)
+{
+	if (!stream->err && stream->len > 0 && stream->flush != NULL) {
+		stream->err = stream->flush(stream->buf, stream->len,
+					    stream->user_data);
+		stream->len = 0;
+	}
+
+	return stream->err;
+}
+
+void cloud_codec_stream_batch_dequeue(const struct cloud_codec_batch *batch)
+{
+	for (size_t i = 0; i < batch->modem_dyn_buf_count; i++) {
+		batch->modem_dyn_buf[i].queued = false;
+	}
+
+	for (size_t i = 0; i < batch->gps_buf_count; i++) {
+		batch->gps_buf[i].queued = false;
+	}
+
+	for (size_t i = 0; i < batch->sensor_buf_count; i++) {
+		batch->sensor_buf[i].queued = false;
+	}
+
+	for (size_t i = 0; i < batch->ui_buf_count; i++) {
+		batch->ui_buf[i].queued = false;
+	}
+
+	for (size_t i = 0; i < batch->bat_buf_count; i++) {
+		batch->bat_buf[i].queued = false;
+	}
+
+	for (size_t i = 0; i < batch->accel_buf_count; i++) {
+		batch->accel_buf[i].queued = false;
+	}
+}
+
+static int count_flush(const char *buf, size_t len, void *user_data)
+{
+	return 0;
+}
+
+static int batch_data_encode(struct cloud_codec_data *output,
+			     enum cloud_codec_stream_format format,
+			     const struct cloud_codec_batch *batch)
+{
+	struct cloud_codec_stream stream;
+	char chunk[COUNT_CHUNK_SIZE];
+	size_t len;
+	char *buffer;
+	int err;
+
+	/* Encode the message once without output to get its length. */
+	cloud_codec_stream_init(&stream, format, chunk, sizeof(chunk),
+				count_flush, NULL);
+
+	err = cloud_codec_stream_batch_encode(&stream, batch);
+	if (err) {
+		return err;
+	}
+
+	len = stream.total;
+
+	buffer = k_malloc(len + 1);
+	if (buffer == NULL) {
+		LOG_ERR("Failed to allocate memory for batch message");
+		return -ENOMEM;
+	}
+
+	cloud_codec_stream_init(&stream, format, buffer, len, NULL, NULL);
+
+	err = cloud_codec_stream_batch_encode(&stream, batch);
+	if (err == -ENOMEM || (err == 0 && stream.total != len)) {
+		/* Date and time were updated between the two passes, which
+		 * changed the timestamps.
+		 */
+		err = -EAGAIN;
+	}
+
+	if (err) {
+		k_free(buffer);
+		return err;
+	}
+
+	buffer[len] = '\0';
+
+	output->buf = buffer;
+	output->len = len;
+
+	return 0;
+}
+
+int cloud_codec_stream_batch_data_encode(struct cloud_codec_data *output,
+					 enum cloud_codec_stream_format format,
+					 const struct cloud_codec_batch *batch)
+{
+	int err = -EAGAIN;
+
+	for (int i = 0; (i < ENCODE_ATTEMPTS) && (err == -EAGAIN); i++) {
+		err = batch_data_encode(output, format, batch);
+	}
+
+	if (err == -ENODATA) {
+		/* Drop dynamic modem data entries without fresh values. */
+		cloud_codec_stream_batch_dequeue(batch);
+		return err;
+	} else if (err) {
+		LOG_ERR("Failed to encode batch message, error: %d", err);
+		return err;
+	}
+
+	if (format == CLOUD_CODEC_STREAM_JSON) {
+		LOG_DBG("Encoded batch message: %s", log_strdup(output->buf));
+	} else {
+		LOG_HEXDUMP_DBG(output->buf, output->len, "Encoded batch message:");
+	}
+
+	cloud_codec_stream_batch_dequeue(batch);
+
+	return 0;
+}
+
+int cloud_codec_stream_encode_batch_data(struct cloud_codec_data *output,
+					 struct cloud_data_gps *gps_buf,
+					 struct cloud_data_sensors *sensor_buf,
+					 struct cloud_data_modem_dynamic *modem_dyn_buf,
+					 struct cloud_data_ui *ui_buf,
+					 struct cloud_data_accelerometer *accel_buf,
+					 struct cloud_data_battery *bat_buf,
+					 size_t gps_buf_count,
+					 size_t sensor_buf_count,
+					 size_t modem_dyn_buf_count,
+					 size_t ui_buf_count,
+					 size_t accel_buf_count,
+					 size_t bat_buf_count)
+{
+	const struct cloud_codec_batch batch = {
+		.gps_buf = gps_buf,
+		.sensor_buf = sensor_buf,
+		.modem_dyn_buf = modem_dyn_buf,
+		.ui_buf = ui_buf,
+		.accel_buf = accel_buf,
+		.bat_buf = bat_buf,
+		.gps_buf_count = gps_buf_count,
+		.sensor_buf_count = sensor_buf_count,
+		.modem_dyn_buf_count = modem_dyn_buf_count,
+		.ui_buf_count = ui_buf_count,
+		.accel_buf_count = accel_buf_count,
+		.bat_buf_count = bat_buf_count,
+	};
+	enum cloud_codec_stream_format format =
+		IS_ENABLED(CONFIG_CLOUD_CODEC_BATCH_STREAM_CBOR) ?
+		CLOUD_CODEC_STREAM_CBOR : CLOUD_CODEC_STREAM_JSON;
+
+	return cloud_codec_stream_batch_data_encode(output, format, &batch);
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**@file
+ *
+ * @brief   Streaming encoder for batch data
+ *
+ * Encodes the batch data buffers directly into an output buffer, without
+ * building an intermediate cJSON object tree. The output is written in chunks
+ * to a caller-provided buffer, which is passed to a flush callback whenever
+ * it is full, so that messages can be encoded into a buffer smaller than the
+ * message.
+ *
+ * The JSON output is identical to the output of the cJSON based batch
+ * encoding in json_common. The CBOR output (RFC 8949) has the same structure
+ * and labels, with indefinite-length maps and arrays, integers in their
+ * shortest form and floating point values as single precision where this is
+ * lossless.
+ */
+
+#ifndef CLOUD_CODEC_STREAM_H__
+#define CLOUD_CODEC_STREAM_H__
+
+#include <zephyr.h>
+#include "cloud_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Output formats of the stream encoder. */
+enum cloud_codec_stream_format {
+	CLOUD_CODEC_STREAM_JSON,
+	CLOUD_CODEC_STREAM_CBOR
+};
+
+/** @brief Callback for a full chunk of encoded output.
+ *
+ *  @param buf Encoded output.
+ *  @param len Length of the encoded output.
+ *  @param user_data User data passed to @ref cloud_codec_stream_init.
+ *
+ *  @return 0 on success, or a negative error code that aborts the encoding.
+ */
+typedef int (*cloud_codec_stream_flush_t)(const char *buf, size_t len,
+					  void *user_data);
+
+/** Stream encoder state. Members are internal. */
+struct cloud_codec_stream {
+	enum cloud_codec_stream_format format;
+	char *buf;
+	size_t size;
+	size_t len;
+	/** Total number of bytes encoded. */
+	size_t total;
+	cloud_codec_stream_flush_t flush;
+	void *user_data;
+	/* Nesting depth, and a bit for every level that has members. */
+	uint8_t depth;
+	uint32_t members;
+	int err;
+};
+
+/** Batch data buffers to encode. */
+struct cloud_codec_batch {
+	struct cloud_data_gps *gps_buf;
+	struct cloud_data_sensors *sensor_buf;
+	struct cloud_data_modem_dynamic *modem_dyn_buf;
+	struct cloud_data_ui *ui_buf;
+	struct cloud_data_accelerometer *accel_buf;
+	struct cloud_data_battery *bat_buf;
+	size_t gps_buf_count;
+	size_t sensor_buf_count;
+	size_t modem_dyn_buf_count;
+	size_t ui_buf_count;
+	size_t accel_buf_count;
+	size_t bat_buf_count;
+};
+
+/** @brief Initialize a stream encoder.
+ *
+ *  @param stream Stream encoder.
+ *  @param format Output format.
+ *  @param buf Output buffer.
+ *  @param size Size of the output buffer.
+ *  @param flush Callback for the output buffer when it is full, or NULL if
+ *               the output must fit the buffer.
+ *  @param user_data User data passed to the callback.
+ */
+void cloud_codec_stream_init(struct cloud_codec_stream *stream,
+			     enum cloud_codec_stream_format format,
+			     char *buf, size_t size,
+			     cloud_codec_stream_flush_t flush, void *user_data);
+
+/** @brief Encode the queued entries of the batch data buffers.
+ *
+ *  The buffers are not modified, see @ref cloud_codec_stream_batch_dequeue.
+ *
+ *  @param stream Stream encoder.
+ *  @param batch Batch data buffers.
+ *
+ *  @retval 0 The batch data was encoded.
+ *  @retval -ENODATA No entries are queued.
+ *  @retval -ENOMEM The output does not fit the output buffer.
+ *  @return Other negative error codes on invalid data, or as returned by the
+ *          flush callback.
+ */
+int cloud_codec_stream_batch_encode(struct cloud_codec_stream *stream,
+				    const struct cloud_codec_batch *batch);
+
+/** @brief Pass the remaining output to the flush callback.
+ *
+ *  @param stream Stream encoder.
+ *
+ *  @return 0 on success, or the first error that occurred while encoding.
+ */
+int cloud_codec_stream_finish(struct cloud_codec_stream *stream);
+
+/** @brief Unqueue all entries of the batch data buffers.
+ *
+ *  @param batch Batch data buffers.
+ */
+void cloud_codec_stream_batch_dequeue(const struct cloud_codec_batch *batch);
+
+/** @brief Encode the batch data buffers into an allocated buffer.
+ *
+ *  The size of the message is determined before it is encoded into a buffer
+ *  allocated with the exact size of the message, which is the only heap
+ *  allocation made. If the date and time are updated in between, which
+ *  changes the size of the timestamps, the message is encoded again. The
+ *  encoded entries are unqueued. The output buffer is
+ *  released with @ref cloud_codec_release_data, and JSON output is null
+ *  terminated.
+ *
+ *  @param output Encoded output.
+ *  @param format Output format.
+ *  @param batch Batch data buffers.
+ *
+ *  @return 0 on success, or a negative error code on failure.
+ */
+int cloud_codec_stream_batch_data_encode(struct cloud_codec_data *output,
+					 enum cloud_codec_stream_format format,
+					 const struct cloud_codec_batch *batch);
+
+/** @brief Encode batch data in the format selected in Kconfig.
+ *
+ *  Implementation of @ref cloud_codec_encode_batch_data for the cloud codecs,
+ *  see @ref cloud_codec_stream_batch_data_encode.
+ *
+ *  @return 0 on success, or a negative error code on failure.
+ */
+int cloud_codec_stream_encode_batch_data(struct cloud_codec_data *output,
+					 struct cloud_data_gps *gps_buf,
+					 struct cloud_data_sensors *sensor_buf,
+					 struct cloud_data_modem_dynamic *modem_dyn_buf,
+					 struct cloud_data_ui *ui_buf,
+					 struct cloud_data_accelerometer *accel_buf,
+					 struct cloud_data_battery *bat_buf,
+					 size_t gps_buf_count,
+					 size_t sensor_buf_count,
+					 size_t modem_dyn_buf_count,
+					 size_t ui_buf_count,
+					 size_t accel_buf_count,
+					 size_t bat_buf_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLOUD_CODEC_STREAM_H__ */
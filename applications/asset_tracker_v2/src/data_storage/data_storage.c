@@ -0,0 +1,840 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <pm_config.h>
+#include <string.h>
+#include <storage/flash_map.h>
+#include <sys/byteorder.h>
+#include <sys/crc.h>
+#include <date_time.h>
+
+#include "cloud/cloud_codec/cloud_codec.h"
+#include "data_storage.h"
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(data_storage, CONFIG_DATA_MODULE_LOG_LEVEL);
+
+#define SECTOR_SIZE CONFIG_DATA_FLASH_STORAGE_SECTOR_SIZE
+#define SECTOR_COUNT (PM_DATA_STORAGE_SIZE / SECTOR_SIZE)
+
+BUILD_ASSERT((PM_DATA_STORAGE_SIZE % SECTOR_SIZE) == 0,
+	     "The data storage partition size must be a multiple of the sector size");
+BUILD_ASSERT(SECTOR_COUNT >= 2,
+	     "The data storage partition must hold at least two sectors");
+
+/* Sector header: magic number followed by the sector sequence number. */
+#define SECTOR_MAGIC 0x41545632
+#define SECTOR_HEADER_SIZE 8
+
+/* Record header: type, payload length and CRC-16 over the type, the length
+ * and the payload. The record is padded to the flash write block size.
+ */
+#define RECORD_HEADER_SIZE 4
+#define RECORD_PAYLOAD_MAX 96
+
+/* Type of a record header that has not been written. */
+#define RECORD_ERASED 0xff
+
+/* Largest supported flash write block size. */
+#define WRITE_BLOCK_MAX 16
+
+#define RECORD_SIZE_MAX ROUND_UP(RECORD_HEADER_SIZE + RECORD_PAYLOAD_MAX, WRITE_BLOCK_MAX)
+
+/* Size of the fields common to all data records. */
+#define TS_SIZE sizeof(uint64_t)
+
+/* Variable length strings are stored with a single byte length prefix. */
+BUILD_ASSERT(TS_SIZE + sizeof(((struct cloud_data_gps *)0)->nmea) <= RECORD_PAYLOAD_MAX,
+	     "NMEA string does not fit a record");
+BUILD_ASSERT(TS_SIZE + 9 + sizeof(((struct cloud_data_modem_dynamic *)0)->ip) +
+	     sizeof(((struct cloud_data_modem_dynamic *)0)->mccmnc) <= RECORD_PAYLOAD_MAX,
+	     "Dynamic modem data does not fit a record");
+
+/* Record types. The values are stored in flash and must not change. */
+enum record_type {
+	RECORD_CHECKPOINT = 0x01,
+	RECORD_GPS_PVT = 0x10,
+	RECORD_GPS_NMEA = 0x11,
+	RECORD_SENSORS = 0x20,
+	RECORD_MODEM_DYNAMIC = 0x30,
+	RECORD_UI = 0x40,
+	RECORD_ACCELEROMETER = 0x50,
+	RECORD_BATTERY = 0x60,
+};
+
+/* Flags of the dynamic modem data record. */
+#define MODEM_AREA_CODE_FRESH	BIT(0)
+#define MODEM_CELL_ID_FRESH	BIT(1)
+#define MODEM_RSRP_FRESH	BIT(2)
+#define MODEM_IP_ADDRESS_FRESH	BIT(3)
+#define MODEM_MCCMNC_FRESH	BIT(4)
+
+struct record {
+	uint8_t type;
+	uint8_t len;
+	uint8_t payload[RECORD_PAYLOAD_MAX];
+};
+
+union entry {
+	struct cloud_data_gps gps;
+	struct cloud_data_sensors sensors;
+	struct cloud_data_modem_dynamic modem_dyn;
+	struct cloud_data_ui ui;
+	struct cloud_data_accelerometer accel;
+	struct cloud_data_battery bat;
+};
+
+static const struct flash_area *fa;
+static uint8_t write_align;
+
+/* Offset of the first record in every sector. */
+static uint32_t data_start;
+
+/* Sequence numbers of the oldest and the newest sector in use. The sector
+ * with sequence number seq is stored at index seq % SECTOR_COUNT.
+ */
+static uint32_t first_seq;
+static uint32_t head_seq;
+
+/* Offset of the next record in the newest sector. */
+static uint32_t write_offset;
+
+/* Position of the oldest record that has not been consumed. */
+static struct data_storage_pos tail;
+
+static off_t sector_offset(uint32_t seq)
+{
+	return (seq % SECTOR_COUNT) * SECTOR_SIZE;
+}
+
+static bool pos_before(const struct data_storage_pos *a,
+		       const struct data_storage_pos *b)
+{
+	return (a->seq < b->seq) ||
+	       ((a->seq == b->seq) && (a->offset < b->offset));
+}
+
+static bool sector_valid(uint32_t index, uint32_t *seq)
+{
+	uint8_t buf[SECTOR_HEADER_SIZE];
+	int err;
+
+	err = flash_area_read(fa, index * SECTOR_SIZE, buf, sizeof(buf));
+	if (err) {
+		LOG_ERR("flash_area_read, error: %d", err);
+		return false;
+	}
+
+	if (sys_get_le32(buf) != SECTOR_MAGIC) {
+		return false;
+	}
+
+	*seq = sys_get_le32(&buf[4]);
+
+	return (*seq % SECTOR_COUNT) == index;
+}
+
+/* Erase the sector for the given sequence number and make it the newest. */
+static int sector_start(uint32_t seq)
+{
+	uint8_t buf[ROUND_UP(SECTOR_HEADER_SIZE, WRITE_BLOCK_MAX)];
+	int err;
+
+	err = flash_area_erase(fa, sector_offset(seq), SECTOR_SIZE);
+	if (err) {
+		LOG_ERR("flash_area_erase, error: %d", err);
+		return err;
+	}
+
+	memset(buf, 0xff, sizeof(buf));
+	sys_put_le32(SECTOR_MAGIC, buf);
+	sys_put_le32(seq, &buf[4]);
+
+	err = flash_area_write(fa, sector_offset(seq), buf, data_start);
+	if (err) {
+		LOG_ERR("flash_area_write, error: %d", err);
+		return err;
+	}
+
+	head_seq = seq;
+	write_offset = data_start;
+
+	return 0;
+}
+
+static int sector_advance(void)
+{
+	uint32_t next = head_seq + 1;
+
+	if ((next - first_seq) >= SECTOR_COUNT) {
+		/* The next sector holds the oldest data. */
+		if (tail.seq == first_seq) {
+			LOG_WRN("Data storage full, dropping oldest data");
+			tail.seq = first_seq + 1;
+			tail.offset = data_start;
+		}
+
+		first_seq++;
+	}
+
+	return sector_start(next);
+}
+
+/* Returns the size of the record in flash, 0 at the end of the data in the
+ * sector, or -EBADMSG if the record is corrupted.
+ */
+static int record_read(const struct data_storage_pos *pos, struct record *rec)
+{
+	off_t offset = sector_offset(pos->seq) + pos->offset;
+	uint8_t hdr[RECORD_HEADER_SIZE];
+	uint16_t crc;
+	size_t size;
+	int err;
+
+	if ((pos->offset + RECORD_HEADER_SIZE) > SECTOR_SIZE) {
+		return 0;
+	}
+
+	err = flash_area_read(fa, offset, hdr, sizeof(hdr));
+	if (err) {
+		LOG_ERR("flash_area_read, error: %d", err);
+		return err;
+	}
+
+	if (hdr[0] == RECORD_ERASED) {
+		return 0;
+	}
+
+	rec->type = hdr[0];
+	rec->len = hdr[1];
+	size = ROUND_UP(RECORD_HEADER_SIZE + rec->len, write_align);
+
+	if ((rec->len > RECORD_PAYLOAD_MAX) ||
+	    ((pos->offset + size) > SECTOR_SIZE)) {
+		return -EBADMSG;
+	}
+
+	if (rec->len) {
+		err = flash_area_read(fa, offset + RECORD_HEADER_SIZE,
+				      rec->payload, rec->len);
+		if (err) {
+			LOG_ERR("flash_area_read, error: %d", err);
+			return err;
+		}
+	}
+
+	crc = crc16_ccitt(0xffff, hdr, 2);
+	crc = crc16_ccitt(crc, rec->payload, rec->len);
+	if (crc != sys_get_le16(&hdr[2])) {
+		return -EBADMSG;
+	}
+
+	return size;
+}
+
+static int record_write(uint8_t type, const uint8_t *payload, uint8_t len)
+{
+	uint8_t buf[RECORD_SIZE_MAX];
+	size_t size = ROUND_UP(RECORD_HEADER_SIZE + len, write_align);
+	uint16_t crc;
+	int err;
+
+	if ((write_offset + size) > SECTOR_SIZE) {
+		err = sector_advance();
+		if (err) {
+			return err;
+		}
+	}
+
+	memset(buf, 0xff, size);
+	buf[0] = type;
+	buf[1] = len;
+	memcpy(&buf[RECORD_HEADER_SIZE], payload, len);
+
+	crc = crc16_ccitt(0xffff, buf, 2);
+	crc = crc16_ccitt(crc, &buf[RECORD_HEADER_SIZE], len);
+	sys_put_le16(crc, &buf[2]);
+
+	err = flash_area_write(fa, sector_offset(head_seq) + write_offset, buf,
+			       size);
+
+	/* Skip the record also on failure, as it may have been partially
+	 * written.
+	 */
+	write_offset += size;
+
+	if (err) {
+		LOG_ERR("flash_area_write, error: %d", err);
+	}
+
+	return err;
+}
+
+static uint8_t *put_float(uint8_t *p, float val)
+{
+	uint32_t raw;
+
+	memcpy(&raw, &val, sizeof(raw));
+	sys_put_le32(raw, p);
+
+	return p + sizeof(raw);
+}
+
+static uint8_t *put_double(uint8_t *p, double val)
+{
+	uint64_t raw;
+
+	memcpy(&raw, &val, sizeof(raw));
+	sys_put_le64(raw, p);
+
+	return p + sizeof(raw);
+}
+
+static uint8_t *put_str(uint8_t *p, const char *str, size_t size)
+{
+	uint8_t len = strnlen(str, size - 1);
+
+	*p++ = len;
+	memcpy(p, str, len);
+
+	return p + len;
+}
+
+static float get_float(const uint8_t *p)
+{
+	uint32_t raw = sys_get_le32(p);
+	float val;
+
+	memcpy(&val, &raw, sizeof(val));
+
+	return val;
+}
+
+static double get_double(const uint8_t *p)
+{
+	uint64_t raw = sys_get_le64(p);
+	double val;
+
+	memcpy(&val, &raw, sizeof(val));
+
+	return val;
+}
+
+static const uint8_t *get_str(const uint8_t *p, const uint8_t *end, char *str,
+			      size_t size)
+{
+	uint8_t len;
+
+	if (p >= end) {
+		return NULL;
+	}
+
+	len = *p++;
+	if ((len >= size) || ((end - p) < len)) {
+		return NULL;
+	}
+
+	memcpy(str, p, len);
+	str[len] = '\0';
+
+	return p + len;
+}
+
+/* Entries are timestamped with uptime, which is not valid after a reset.
+ * Timestamps are therefore stored as UNIX time, and converted back to uptime,
+ * possibly negative, when loaded.
+ */
+static int time_offset_get(int64_t *offset)
+{
+	int64_t uptime = k_uptime_get();
+	int64_t unix_time = uptime;
+	int err;
+
+	err = date_time_uptime_to_unix_time_ms(&unix_time);
+	if (err) {
+		return -ENODATA;
+	}
+
+	*offset = unix_time - uptime;
+
+	return 0;
+}
+
+static int record_pack(enum data_storage_type type, const void *data,
+		       int64_t time_offset, struct record *rec)
+{
+	uint8_t *p = rec->payload;
+
+	switch (type) {
+	case DATA_STORAGE_GPS: {
+		const struct cloud_data_gps *gps = data;
+
+		sys_put_le64(gps->gps_ts + time_offset, p);
+		p += TS_SIZE;
+
+		if (gps->format == CLOUD_CODEC_GPS_FORMAT_PVT) {
+			rec->type = RECORD_GPS_PVT;
+			p = put_double(p, gps->pvt.longi);
+			p = put_double(p, gps->pvt.lat);
+			p = put_float(p, gps->pvt.alt);
+			p = put_float(p, gps->pvt.acc);
+			p = put_float(p, gps->pvt.spd);
+			p = put_float(p, gps->pvt.hdg);
+		} else if (gps->format == CLOUD_CODEC_GPS_FORMAT_NMEA) {
+			rec->type = RECORD_GPS_NMEA;
+			p = put_str(p, gps->nmea, sizeof(gps->nmea));
+		} else {
+			return -EINVAL;
+		}
+		break;
+	}
+	case DATA_STORAGE_SENSORS: {
+		const struct cloud_data_sensors *sensors = data;
+
+		rec->type = RECORD_SENSORS;
+		sys_put_le64(sensors->env_ts + time_offset, p);
+		p += TS_SIZE;
+		p = put_float(p, sensors->temp);
+		p = put_float(p, sensors->hum);
+		break;
+	}
+	case DATA_STORAGE_MODEM_DYNAMIC: {
+		const struct cloud_data_modem_dynamic *modem = data;
+		uint8_t flags = 0;
+
+		flags |= modem->area_code_fresh ? MODEM_AREA_CODE_FRESH : 0;
+		flags |= modem->cell_id_fresh ? MODEM_CELL_ID_FRESH : 0;
+		flags |= modem->rsrp_fresh ? MODEM_RSRP_FRESH : 0;
+		flags |= modem->ip_address_fresh ? MODEM_IP_ADDRESS_FRESH : 0;
+		flags |= modem->mccmnc_fresh ? MODEM_MCCMNC_FRESH : 0;
+
+		rec->type = RECORD_MODEM_DYNAMIC;
+		sys_put_le64(modem->ts + time_offset, p);
+		p += TS_SIZE;
+		sys_put_le16(modem->area, p);
+		p += 2;
+		sys_put_le32(modem->cell, p);
+		p += 4;
+		sys_put_le16(modem->rsrp, p);
+		p += 2;
+		*p++ = flags;
+		p = put_str(p, modem->ip, sizeof(modem->ip));
+		p = put_str(p, modem->mccmnc, sizeof(modem->mccmnc));
+		break;
+	}
+	case DATA_STORAGE_UI: {
+		const struct cloud_data_ui *ui = data;
+
+		rec->type = RECORD_UI;
+		sys_put_le64(ui->btn_ts + time_offset, p);
+		p += TS_SIZE;
+		sys_put_le32(ui->btn, p);
+		p += 4;
+		break;
+	}
+	case DATA_STORAGE_ACCELEROMETER: {
+		const struct cloud_data_accelerometer *accel = data;
+
+		rec->type = RECORD_ACCELEROMETER;
+		sys_put_le64(accel->ts + time_offset, p);
+		p += TS_SIZE;
+
+		for (size_t i = 0; i < ARRAY_SIZE(accel->values); i++) {
+			p = put_float(p, accel->values[i]);
+		}
+		break;
+	}
+	case DATA_STORAGE_BATTERY: {
+		const struct cloud_data_battery *bat = data;
+
+		rec->type = RECORD_BATTERY;
+		sys_put_le64(bat->bat_ts + time_offset, p);
+		p += TS_SIZE;
+		sys_put_le16(bat->bat, p);
+		p += 2;
+		break;
+	}
+	default:
+		return -EINVAL;
+	}
+
+	rec->len = p - rec->payload;
+
+	return 0;
+}
+
+static int record_unpack(const struct record *rec, int64_t time_offset,
+			 enum data_storage_type *type, union entry *entry)
+{
+	const uint8_t *p = &rec->payload[TS_SIZE];
+	const uint8_t *end = &rec->payload[rec->len];
+	int64_t ts;
+
+	if (rec->len < TS_SIZE) {
+		return -EBADMSG;
+	}
+
+	memset(entry, 0, sizeof(*entry));
+	ts = sys_get_le64(rec->payload) - time_offset;
+
+	switch (rec->type) {
+	case RECORD_GPS_PVT:
+		if (rec->len != (TS_SIZE + 32)) {
+			return -EBADMSG;
+		}
+
+		*type = DATA_STORAGE_GPS;
+		entry->gps.gps_ts = ts;
+		entry->gps.format = CLOUD_CODEC_GPS_FORMAT_PVT;
+		entry->gps.pvt.longi = get_double(&p[0]);
+		entry->gps.pvt.lat = get_double(&p[8]);
+		entry->gps.pvt.alt = get_float(&p[16]);
+		entry->gps.pvt.acc = get_float(&p[20]);
+		entry->gps.pvt.spd = get_float(&p[24]);
+		entry->gps.pvt.hdg = get_float(&p[28]);
+		entry->gps.queued = true;
+		break;
+	case RECORD_GPS_NMEA:
+		*type = DATA_STORAGE_GPS;
+		entry->gps.gps_ts = ts;
+		entry->gps.format = CLOUD_CODEC_GPS_FORMAT_NMEA;
+		if (!get_str(p, end, entry->gps.nmea, sizeof(entry->gps.nmea))) {
+			return -EBADMSG;
+		}
+
+		entry->gps.queued = true;
+		break;
+	case RECORD_SENSORS:
+		if (rec->len != (TS_SIZE + 8)) {
+			return -EBADMSG;
+		}
+
+		*type = DATA_STORAGE_SENSORS;
+		entry->sensors.env_ts = ts;
+		entry->sensors.temp = get_float(&p[0]);
+		entry->sensors.hum = get_float(&p[4]);
+		entry->sensors.queued = true;
+		break;
+	case RECORD_MODEM_DYNAMIC: {
+		struct cloud_data_modem_dynamic *modem = &entry->modem_dyn;
+		uint8_t flags;
+
+		if (rec->len < (TS_SIZE + 9)) {
+			return -EBADMSG;
+		}
+
+		*type = DATA_STORAGE_MODEM_DYNAMIC;
+		modem->ts = ts;
+		modem->area = sys_get_le16(&p[0]);
+		modem->cell = sys_get_le32(&p[2]);
+		modem->rsrp = sys_get_le16(&p[6]);
+		flags = p[8];
+		p += 9;
+
+		p = get_str(p, end, modem->ip, sizeof(modem->ip));
+		if (p) {
+			p = get_str(p, end, modem->mccmnc, sizeof(modem->mccmnc));
+		}
+
+		if (!p) {
+			return -EBADMSG;
+		}
+
+		modem->area_code_fresh = flags & MODEM_AREA_CODE_FRESH;
+		modem->cell_id_fresh = flags & MODEM_CELL_ID_FRESH;
+		modem->rsrp_fresh = flags & MODEM_RSRP_FRESH;
+		modem->ip_address_fresh = flags & MODEM_IP_ADDRESS_FRESH;
+		modem->mccmnc_fresh = flags & MODEM_MCCMNC_FRESH;
+		modem->queued = true;
+		break;
+	}
+	case RECORD_UI:
+		if (rec->len != (TS_SIZE + 4)) {
+			return -EBADMSG;
+		}
+
+		*type = DATA_STORAGE_UI;
+		entry->ui.btn_ts = ts;
+		entry->ui.btn = (int32_t)sys_get_le32(p);
+		entry->ui.queued = true;
+		break;
+	case RECORD_ACCELEROMETER:
+		if (rec->len != (TS_SIZE + 12)) {
+			return -EBADMSG;
+		}
+
+		*type = DATA_STORAGE_ACCELEROMETER;
+		entry->accel.ts = ts;
+
+		for (size_t i = 0; i < ARRAY_SIZE(entry->accel.values); i++) {
+			entry->accel.values[i] = get_float(&p[i * 4]);
+		}
+
+		entry->accel.queued = true;
+		break;
+	case RECORD_BATTERY:
+		if (rec->len != (TS_SIZE + 2)) {
+			return -EBADMSG;
+		}
+
+		*type = DATA_STORAGE_BATTERY;
+		entry->bat.bat_ts = ts;
+		entry->bat.bat = sys_get_le16(p);
+		entry->bat.queued = true;
+		break;
+	default:
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
+static bool type_enabled(enum data_storage_type type)
+{
+	switch (type) {
+	case DATA_STORAGE_GPS:
+		return IS_ENABLED(CONFIG_DATA_GPS_BUFFER_STORE);
+	case DATA_STORAGE_SENSORS:
+		return IS_ENABLED(CONFIG_DATA_SENSOR_BUFFER_STORE);
+	case DATA_STORAGE_MODEM_DYNAMIC:
+		return IS_ENABLED(CONFIG_DATA_DYNAMIC_MODEM_BUFFER_STORE);
+	case DATA_STORAGE_UI:
+		return IS_ENABLED(CONFIG_DATA_UI_BUFFER_STORE);
+	case DATA_STORAGE_ACCELEROMETER:
+		return IS_ENABLED(CONFIG_DATA_ACCELEROMETER_BUFFER_STORE);
+	case DATA_STORAGE_BATTERY:
+		return IS_ENABLED(CONFIG_DATA_BATTERY_BUFFER_STORE);
+	default:
+		return false;
+	}
+}
+
+/* Scan the records of a sector for checkpoints. Returns the offset after the
+ * last valid record, or the sector size if the sector holds a corrupted
+ * record, so that no more records are written to it.
+ */
+static int sector_scan(uint32_t seq, uint32_t *end)
+{
+	struct data_storage_pos pos = {
+		.seq = seq,
+		.offset = data_start
+	};
+	struct record rec;
+	int size;
+
+	while ((size = record_read(&pos, &rec)) > 0) {
+		if ((rec.type == RECORD_CHECKPOINT) && (rec.len == 8)) {
+			tail.seq = sys_get_le32(&rec.payload[0]);
+			tail.offset = sys_get_le32(&rec.payload[4]);
+		}
+
+		pos.offset += size;
+	}
+
+	if (size == -EBADMSG) {
+		LOG_WRN("Corrupted record in sector %u at offset %u",
+			seq, pos.offset);
+		*end = SECTOR_SIZE;
+		return 0;
+	}
+
+	*end = pos.offset;
+
+	return size;
+}
+
+int data_storage_init(void)
+{
+	struct data_storage_pos write_pos;
+	bool found = false;
+	uint32_t end;
+	uint32_t seq;
+	int err;
+
+	err = flash_area_open(PM_DATA_STORAGE_ID, &fa);
+	if (err) {
+		LOG_ERR("flash_area_open, error: %d", err);
+		return err;
+	}
+
+	write_align = flash_area_align(fa);
+	if (write_align > WRITE_BLOCK_MAX) {
+		LOG_ERR("Unsupported flash write block size: %d", write_align);
+		fa = NULL;
+		return -ENOTSUP;
+	}
+
+	data_start = ROUND_UP(SECTOR_HEADER_SIZE, write_align);
+
+	/* The newest sector has the highest sequence number. */
+	for (uint32_t i = 0; i < SECTOR_COUNT; i++) {
+		if (sector_valid(i, &seq) && (!found || (seq > head_seq))) {
+			head_seq = seq;
+			found = true;
+		}
+	}
+
+	if (!found) {
+		LOG_INF("No stored data found, starting from scratch");
+
+		err = sector_start(0);
+		if (err) {
+			fa = NULL;
+			return err;
+		}
+
+		first_seq = 0;
+		tail.seq = 0;
+		tail.offset = data_start;
+
+		return 0;
+	}
+
+	/* Sectors are taken into use in sequence, so the sectors in use are the
+	 * ones before the newest with consecutive sequence numbers.
+	 */
+	first_seq = head_seq;
+	while ((first_seq > 0) && ((head_seq - first_seq) < (SECTOR_COUNT - 1)) &&
+	       sector_valid((first_seq - 1) % SECTOR_COUNT, &seq) &&
+	       (seq == (first_seq - 1))) {
+		first_seq--;
+	}
+
+	tail.seq = first_seq;
+	tail.offset = data_start;
+
+	for (seq = first_seq; seq <= head_seq; seq++) {
+		err = sector_scan(seq, &end);
+		if (err) {
+			fa = NULL;
+			return err;
+		}
+	}
+
+	write_offset = end;
+
+	/* The checkpoint may point to data that has since been dropped. */
+	write_pos.seq = head_seq;
+	write_pos.offset = write_offset;
+
+	if (tail.seq < first_seq) {
+		tail.seq = first_seq;
+		tail.offset = data_start;
+	} else if (pos_before(&write_pos, &tail)) {
+		tail = write_pos;
+	}
+
+	LOG_INF("Data storage initialized, %d sectors in use",
+		head_seq - first_seq + 1);
+
+	return 0;
+}
+
+int data_storage_add(enum data_storage_type type, const void *data)
+{
+	int64_t time_offset;
+	struct record rec;
+	int err;
+
+	if (fa == NULL) {
+		return -ENODEV;
+	}
+
+	if (!type_enabled(type)) {
+		return -ENOTSUP;
+	}
+
+	err = time_offset_get(&time_offset);
+	if (err) {
+		return err;
+	}
+
+	err = record_pack(type, data, time_offset, &rec);
+	if (err) {
+		return err;
+	}
+
+	return record_write(rec.type, rec.payload, rec.len);
+}
+
+int data_storage_load(data_storage_load_cb cb, void *user_data,
+		      struct data_storage_pos *end)
+{
+	struct data_storage_pos pos = tail;
+	struct data_storage_pos write_pos = {
+		.seq = head_seq,
+		.offset = write_offset
+	};
+	enum data_storage_type type;
+	int64_t time_offset;
+	union entry entry;
+	struct record rec;
+	int count = 0;
+	int size;
+	int err;
+
+	if (fa == NULL) {
+		return -ENODEV;
+	}
+
+	err = time_offset_get(&time_offset);
+	if (err) {
+		return err;
+	}
+
+	while (pos_before(&pos, &write_pos)) {
+		size = record_read(&pos, &rec);
+		if ((size < 0) && (size != -EBADMSG)) {
+			return size;
+		}
+
+		if (size <= 0) {
+			/* No more valid records in this sector. */
+			pos.seq++;
+			pos.offset = data_start;
+			continue;
+		}
+
+		if (rec.type != RECORD_CHECKPOINT) {
+			err = record_unpack(&rec, time_offset, &type, &entry);
+			if (err) {
+				LOG_WRN("Skipping invalid record of type 0x%02x",
+					rec.type);
+			} else if (!cb(type, &entry, user_data)) {
+				break;
+			} else {
+				count++;
+			}
+		}
+
+		pos.offset += size;
+	}
+
+	*end = pos;
+
+	return count;
+}
+
+int data_storage_consume(const struct data_storage_pos *end)
+{
+	uint8_t payload[8];
+
+	if (fa == NULL) {
+		return -ENODEV;
+	}
+
+	if (!pos_before(&tail, end)) {
+		return 0;
+	}
+
+	tail = *end;
+
+	sys_put_le32(tail.seq, &payload[0]);
+	sys_put_le32(tail.offset, &payload[4]);
+
+	return record_write(RECORD_CHECKPOINT, payload, sizeof(payload));
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**@file
+ *
+ * @brief   Flash-backed data storage for asset tracker
+ *
+ * Log-structured ring of sampled data in the data_storage flash partition.
+ * Entries are appended as compact binary records to the partition, which is
+ * split into sectors of the flash erase block size. When the partition is
+ * full, the sector holding the oldest data is erased and reused.
+ *
+ * Every sector starts with a header holding a sequence number, and every
+ * record is protected by a CRC, so that the contents of the storage can be
+ * recovered after a reset, including one in the middle of a write. Records
+ * that have been delivered are marked as such by appending a checkpoint
+ * record, which makes the storage deliver its contents at least once across
+ * resets.
+ *
+ * Timestamps are stored as UNIX time, so entries can only be stored and
+ * loaded while the date and time are known.
+ */
+
+#ifndef DATA_STORAGE_H__
+#define DATA_STORAGE_H__
+
+#include <zephyr.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Types of data that can be stored. */
+enum data_storage_type {
+	/** @c struct cloud_data_gps */
+	DATA_STORAGE_GPS,
+	/** @c struct cloud_data_sensors */
+	DATA_STORAGE_SENSORS,
+	/** @c struct cloud_data_modem_dynamic */
+	DATA_STORAGE_MODEM_DYNAMIC,
+	/** @c struct cloud_data_ui */
+	DATA_STORAGE_UI,
+	/** @c struct cloud_data_accelerometer */
+	DATA_STORAGE_ACCELEROMETER,
+	/** @c struct cloud_data_battery */
+	DATA_STORAGE_BATTERY,
+
+	DATA_STORAGE_TYPE_COUNT
+};
+
+/** Position of a record in the storage. */
+struct data_storage_pos {
+	/** Sequence number of the sector. */
+	uint32_t seq;
+	/** Offset within the sector. */
+	uint32_t offset;
+};
+
+/** @brief Callback for the entries loaded from the storage.
+ *
+ *  @param type Type of the entry.
+ *  @param data Entry, as the cloud codec structure of the given type, with
+ *              the queued flag set. The timestamp is converted to the
+ *              uptime of the current boot, which is negative for entries
+ *              stored before the last reset.
+ *  @param user_data User data passed to @ref data_storage_load.
+ *
+ *  @retval true The entry was taken, continue loading.
+ *  @retval false The entry could not be taken, stop loading before it.
+ */
+typedef bool (*data_storage_load_cb)(enum data_storage_type type, void *data,
+				     void *user_data);
+
+/** @brief Initialize the storage.
+ *
+ *  Scans the storage partition for the sector written last, the end of the
+ *  written data and the last checkpoint.
+ *
+ *  @return 0 on success, or a negative error code on failure.
+ */
+int data_storage_init(void);
+
+/** @brief Append an entry to the storage.
+ *
+ *  If the storage is full, the oldest sector is erased to make room for the
+ *  entry, and the entries in it that have not been consumed are lost.
+ *
+ *  @param type Type of the entry.
+ *  @param data Entry, as the cloud codec structure of the given type.
+ *
+ *  @retval 0 The entry was stored.
+ *  @retval -ENOTSUP Storing entries of this type is disabled.
+ *  @retval -ENODATA The date and time are not known.
+ *  @retval -ENODEV The storage has not been initialized.
+ *  @return Other negative error codes on flash access failure.
+ */
+int data_storage_add(enum data_storage_type type, const void *data);
+
+/** @brief Load entries that have not been consumed, oldest first.
+ *
+ *  Entries are passed to the callback one by one, until the callback
+ *  returns false or there are no more entries. Loading does not consume
+ *  the entries, see @ref data_storage_consume.
+ *
+ *  @param cb Callback called for every entry.
+ *  @param user_data User data passed to the callback.
+ *  @param[out] end Position after the last entry taken by the callback.
+ *
+ *  @retval -ENODATA The date and time are not known.
+ *  @return Number of entries taken by the callback, or another negative
+ *          error code on failure.
+ */
+int data_storage_load(data_storage_load_cb cb, void *user_data,
+		      struct data_storage_pos *end);
+
+/** @brief Consume the entries before the given position.
+ *
+ *  Consumed entries are not loaded again, also after a reset.
+ *
+ *  @param end Position returned by @ref data_storage_load.
+ *
+ *  @return 0 on success, or a negative error code on failure.
+ */
+int data_storage_consume(const struct data_storage_pos *end);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DATA_STORAGE_H__ */
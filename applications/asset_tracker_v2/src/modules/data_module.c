@@ -10,6 +10,7 @@
 #include <date_time.h>
 
 #include "cloud/cloud_codec/cloud_codec.h"
+#include "data_storage/data_storage.h"
 
 #define MODULE data_module
 
@@ -116,6 +117,7 @@ enum data_type {
 	UNUSED,
 	GENERIC,
 	BATCH,
+	STORED_BATCH,
 	UI,
 	NEIGHBOR_CELLS,
 	CONFIG
@@ -133,6 +135,11 @@ static struct ack_data failed_data[CONFIG_FAILED_DATA_COUNT];
 /* Data that has been encoded and shipped on, but has not yet been ACKed. */
 static struct ack_data pending_data[CONFIG_PENDING_DATA_COUNT];
 
+/* Batch of data loaded from flash storage that has not yet been ACKed. Only one such batch is
+ * sent at a time.
+ */
+static void *stored_batch_ptr;
+
 /* Data module message queue. */
 #define DATA_QUEUE_ENTRY_COUNT		10
 #define DATA_QUEUE_BYTE_ALIGNMENT	4
@@ -148,6 +155,7 @@ static struct module_data self = {
 
 /* Forward declarations */
 static void data_send_work_fn(struct k_work *work);
+static void stored_data_sent(void);
 static int config_settings_handler(const char *key, size_t len,
 				   settings_read_cb read_cb, void *cb_arg);
 
@@ -312,6 +320,11 @@ static void data_list_clear_and_free(struct ack_data *list, size_t list_count)
 {
 	for (size_t i = 0; i < list_count; i++) {
 		if (list[i].ptr != NULL) {
+			if (list[i].ptr == stored_batch_ptr) {
+				/* The data is loaded from flash storage again later. */
+				stored_batch_ptr = NULL;
+			}
+
 			k_free(list[i].ptr);
 			data_list_clear_entry(&list[i]);
 		}
@@ -373,6 +386,8 @@ static void data_resend(void)
 				evt->type = DATA_EVT_DATA_SEND;
 				break;
 			case BATCH:
+				/* Fall through */
+			case STORED_BATCH:
 				evt->type = DATA_EVT_DATA_SEND_BATCH;
 				break;
 			case CONFIG:
@@ -412,6 +427,8 @@ static void data_resend(void)
 
 static void data_ack(void *ptr, bool sent)
 {
+	bool stored = false;
+
 	/* Move data from pending to failed data list if incoming data is
 	 * flagged as not sent. If data is flagged as sent, free entry in
 	 * pending data list.
@@ -420,6 +437,7 @@ static void data_ack(void *ptr, bool sent)
 	for (size_t i = 0; i < ARRAY_SIZE(pending_data); i++) {
 		if (pending_data[i].ptr == ptr) {
 			if (sent) {
+				stored = (ptr == stored_batch_ptr);
 				k_free(ptr);
 				LOG_DBG("Pending data ACKed: %p",
 					pending_data[i].ptr);
@@ -433,6 +451,10 @@ static void data_ack(void *ptr, bool sent)
 						     pending_data[i].type);
 			}
 			data_list_clear_entry(&pending_data[i]);
+
+			if (stored) {
+				stored_data_sent();
+			}
 			return;
 		}
 	}
@@ -476,6 +498,14 @@ static int setup(void)
 		return err;
 	}
 
+#if defined(CONFIG_DATA_FLASH_STORAGE)
+	err = data_storage_init();
+	if (err) {
+		/* Data is buffered in RAM only. */
+		LOG_ERR("data_storage_init, error: %d", err);
+	}
+#endif
+
 	return 0;
 }
 
@@ -518,6 +548,209 @@ static void data_send(enum data_module_event_type event,
 	data->len = 0;
 }
 
+#if defined(CONFIG_DATA_FLASH_STORAGE)
+/* Position in flash storage after the last entry in the batch that is being sent. */
+static struct data_storage_pos stored_batch_end;
+
+/* Store data in flash while disconnected from cloud, where it is not overwritten during longer
+ * outages and survives reboots. Returns true if the data was stored.
+ */
+static bool stored_data_add(enum data_storage_type type, const void *data)
+{
+	int err;
+
+	if (state == STATE_CLOUD_CONNECTED) {
+		return false;
+	}
+
+	err = data_storage_add(type, data);
+	switch (err) {
+	case 0:
+		return true;
+	case -ENOTSUP:
+		/* Storing of this data type is disabled. */
+		break;
+	case -ENODATA:
+		/* Date time library does not have valid time yet, keep the data in RAM. */
+		break;
+	case -ENODEV:
+		/* Flash storage is not available. */
+		break;
+	default:
+		LOG_WRN("data_storage_add, error: %d", err);
+		break;
+	}
+
+	return false;
+}
+
+/* Get the number of entries that can be loaded into each ringbuffer without overwriting
+ * entries that are yet to be encoded.
+ */
+static void stored_data_capacity_get(size_t *capacity)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(gps_buf); i++) {
+		capacity[DATA_STORAGE_GPS] += !gps_buf[i].queued;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(sensors_buf); i++) {
+		capacity[DATA_STORAGE_SENSORS] += !sensors_buf[i].queued;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(modem_dyn_buf); i++) {
+		capacity[DATA_STORAGE_MODEM_DYNAMIC] += !modem_dyn_buf[i].queued;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(ui_buf); i++) {
+		capacity[DATA_STORAGE_UI] += !ui_buf[i].queued;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(accel_buf); i++) {
+		capacity[DATA_STORAGE_ACCELEROMETER] += !accel_buf[i].queued;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(bat_buf); i++) {
+		capacity[DATA_STORAGE_BATTERY] += !bat_buf[i].queued;
+	}
+}
+
+static bool stored_data_load_cb(enum data_storage_type type, void *data,
+				void *user_data)
+{
+	size_t *capacity = user_data;
+
+	if (capacity[type] == 0) {
+		return false;
+	}
+
+	capacity[type]--;
+
+	switch (type) {
+	case DATA_STORAGE_GPS:
+		cloud_codec_populate_gps_buffer(gps_buf, data, &head_gps_buf,
+						ARRAY_SIZE(gps_buf));
+		break;
+	case DATA_STORAGE_SENSORS:
+		cloud_codec_populate_sensor_buffer(sensors_buf, data,
+						   &head_sensor_buf,
+						   ARRAY_SIZE(sensors_buf));
+		break;
+	case DATA_STORAGE_MODEM_DYNAMIC:
+		cloud_codec_populate_modem_dynamic_buffer(modem_dyn_buf, data,
+							  &head_modem_dyn_buf,
+							  ARRAY_SIZE(modem_dyn_buf));
+		break;
+	case DATA_STORAGE_UI:
+		cloud_codec_populate_ui_buffer(ui_buf, data, &head_ui_buf,
+					       ARRAY_SIZE(ui_buf));
+		break;
+	case DATA_STORAGE_ACCELEROMETER:
+		cloud_codec_populate_accel_buffer(accel_buf, data,
+						  &head_accel_buf,
+						  ARRAY_SIZE(accel_buf));
+		break;
+	case DATA_STORAGE_BATTERY:
+		cloud_codec_populate_bat_buffer(bat_buf, data, &head_bat_buf,
+						ARRAY_SIZE(bat_buf));
+		break;
+	default:
+		break;
+	}
+
+	return true;
+}
+
+/* Load the next batch of data from flash storage into the ringbuffers, and encode and send it.
+ * The batch size is limited by the ringbuffers, so that no additional memory is needed to
+ * hold the stored data. This function allocates buffer on the heap, which needs to be freed
+ * after use.
+ */
+static void stored_data_send(void)
+{
+	int err;
+	size_t capacity[DATA_STORAGE_TYPE_COUNT] = {0};
+	struct cloud_codec_data codec = {0};
+	struct data_storage_pos end;
+
+	if (stored_batch_ptr != NULL) {
+		/* The next batch is sent when the previous one has been ACKed. */
+		return;
+	}
+
+	stored_data_capacity_get(capacity);
+
+	err = data_storage_load(stored_data_load_cb, capacity, &end);
+	if (err <= 0) {
+		if ((err < 0) && (err != -ENODEV)) {
+			LOG_ERR("data_storage_load, error: %d", err);
+		}
+		return;
+	}
+
+	LOG_DBG("%d entries loaded from flash storage", err);
+
+	err = cloud_codec_encode_batch_data(&codec,
+					gps_buf,
+					sensors_buf,
+					modem_dyn_buf,
+					ui_buf,
+					accel_buf,
+					bat_buf,
+					ARRAY_SIZE(gps_buf),
+					ARRAY_SIZE(sensors_buf),
+					ARRAY_SIZE(modem_dyn_buf),
+					ARRAY_SIZE(ui_buf),
+					ARRAY_SIZE(accel_buf),
+					ARRAY_SIZE(bat_buf));
+	switch (err) {
+	case 0:
+		LOG_DBG("Stored data encoded successfully");
+		stored_batch_ptr = codec.buf;
+		stored_batch_end = end;
+		data_send(DATA_EVT_DATA_SEND_BATCH, STORED_BATCH, &codec);
+		break;
+	case -ENODATA:
+		LOG_DBG("No valid data in the entries loaded from flash storage");
+		data_storage_consume(&end);
+		break;
+	default:
+		LOG_ERR("Error batch-enconding stored data: %d", err);
+		SEND_ERROR(data, DATA_EVT_ERROR, err);
+		return;
+	}
+}
+
+static void stored_data_sent(void)
+{
+	int err;
+
+	err = data_storage_consume(&stored_batch_end);
+	if (err) {
+		LOG_WRN("data_storage_consume, error: %d", err);
+	}
+
+	stored_batch_ptr = NULL;
+
+	/* Keep on sending until all stored data has been sent. */
+	if (state == STATE_CLOUD_CONNECTED) {
+		stored_data_send();
+	}
+}
+#else
+static bool stored_data_add(enum data_storage_type type, const void *data)
+{
+	return false;
+}
+
+static void stored_data_send(void)
+{
+}
+
+static void stored_data_sent(void)
+{
+}
+#endif /* CONFIG_DATA_FLASH_STORAGE */
+
 /* This function allocates buffer on the heap, which needs to be freed after use. */
 static void data_encode(void)
 {
@@ -602,6 +835,8 @@ static void data_encode(void)
 		SEND_ERROR(data, DATA_EVT_ERROR, err);
 		return;
 	}
+
+	stored_data_send();
 }
 
 static void config_get(void)
@@ -953,9 +1188,11 @@ static void on_all_states(struct data_msg_data *msg)
 			.queued = true
 		};
 
-		cloud_codec_populate_ui_buffer(ui_buf, &new_ui_data,
-					       &head_ui_buf,
-					       ARRAY_SIZE(ui_buf));
+		if (!stored_data_add(DATA_STORAGE_UI, &new_ui_data)) {
+			cloud_codec_populate_ui_buffer(ui_buf, &new_ui_data,
+						       &head_ui_buf,
+						       ARRAY_SIZE(ui_buf));
+		}
 
 		SEND_EVENT(data, DATA_EVT_UI_DATA_READY);
 		return;
@@ -1021,11 +1258,13 @@ static void on_all_states(struct data_msg_data *msg)
 		strcpy(new_modem_data.ip, msg->module.modem.data.modem_dynamic.ip_address);
 		strcpy(new_modem_data.mccmnc, msg->module.modem.data.modem_dynamic.mccmnc);
 
-		cloud_codec_populate_modem_dynamic_buffer(
-						modem_dyn_buf,
-						&new_modem_data,
-						&head_modem_dyn_buf,
-						ARRAY_SIZE(modem_dyn_buf));
+		if (!stored_data_add(DATA_STORAGE_MODEM_DYNAMIC, &new_modem_data)) {
+			cloud_codec_populate_modem_dynamic_buffer(
+							modem_dyn_buf,
+							&new_modem_data,
+							&head_modem_dyn_buf,
+							ARRAY_SIZE(modem_dyn_buf));
+		}
 
 		requested_data_status_set(APP_DATA_MODEM_DYNAMIC);
 	}
@@ -1041,9 +1280,11 @@ static void on_all_states(struct data_msg_data *msg)
 			.queued = true
 		};
 
-		cloud_codec_populate_bat_buffer(bat_buf, &new_battery_data,
-						&head_bat_buf,
-						ARRAY_SIZE(bat_buf));
+		if (!stored_data_add(DATA_STORAGE_BATTERY, &new_battery_data)) {
+			cloud_codec_populate_bat_buffer(bat_buf, &new_battery_data,
+							&head_bat_buf,
+							ARRAY_SIZE(bat_buf));
+		}
 
 		requested_data_status_set(APP_DATA_BATTERY);
 	}
@@ -1056,10 +1297,12 @@ static void on_all_states(struct data_msg_data *msg)
 			.queued = true
 		};
 
-		cloud_codec_populate_sensor_buffer(sensors_buf,
-						   &new_sensor_data,
-						   &head_sensor_buf,
-						   ARRAY_SIZE(sensors_buf));
+		if (!stored_data_add(DATA_STORAGE_SENSORS, &new_sensor_data)) {
+			cloud_codec_populate_sensor_buffer(sensors_buf,
+							   &new_sensor_data,
+							   &head_sensor_buf,
+							   ARRAY_SIZE(sensors_buf));
+		}
 
 		requested_data_status_set(APP_DATA_ENVIRONMENTAL);
 	}
@@ -1077,9 +1320,11 @@ static void on_all_states(struct data_msg_data *msg)
 			.queued = true
 		};
 
-		cloud_codec_populate_accel_buffer(accel_buf, &new_movement_data,
-						  &head_accel_buf,
-						  ARRAY_SIZE(accel_buf));
+		if (!stored_data_add(DATA_STORAGE_ACCELEROMETER, &new_movement_data)) {
+			cloud_codec_populate_accel_buffer(accel_buf, &new_movement_data,
+							  &head_accel_buf,
+							  ARRAY_SIZE(accel_buf));
+		}
 	}
 
 	if (IS_EVENT(msg, gps, GPS_EVT_DATA_READY)) {
@@ -1117,9 +1362,11 @@ static void on_all_states(struct data_msg_data *msg)
 			return;
 		}
 
-		cloud_codec_populate_gps_buffer(gps_buf, &new_gps_data,
-						&head_gps_buf,
-						ARRAY_SIZE(gps_buf));
+		if (!stored_data_add(DATA_STORAGE_GPS, &new_gps_data)) {
+			cloud_codec_populate_gps_buffer(gps_buf, &new_gps_data,
+							&head_gps_buf,
+							ARRAY_SIZE(gps_buf));
+		}
 
 		requested_data_status_set(APP_DATA_GNSS);
 	}
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+
+#include "date_time.h"
+
+/* Set by the test to emulate that the date and time are not known. */
+bool date_time_mock_unknown;
+
+/* Mocking function that converts the input uptime with a constant offset. */
+int date_time_uptime_to_unix_time_ms(int64_t *uptime)
+{
+	if (date_time_mock_unknown) {
+		return -ENODATA;
+	}
+
+	*uptime += 1563968747123;
+
+	return 0;
+}
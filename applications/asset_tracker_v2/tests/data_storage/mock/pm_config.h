@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef PM_CONFIG_H__
+#define PM_CONFIG_H__
+
+/* Data storage partition of four sectors, emulated in RAM by the test. */
+#define PM_DATA_STORAGE_ID 0
+#define PM_DATA_STORAGE_SIZE 0x4000
+
+#endif /* PM_CONFIG_H__ */
@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <ztest.h>
+#include <pm_config.h>
+#include <storage/flash_map.h>
+
+#include "cloud/cloud_codec/cloud_codec.h"
+#include "data_storage.h"
+
+#define SECTOR_SIZE CONFIG_DATA_FLASH_STORAGE_SECTOR_SIZE
+#define SECTOR_COUNT (PM_DATA_STORAGE_SIZE / SECTOR_SIZE)
+#define WRITE_ALIGN 4
+
+/* Sector header and UI records, as laid out in flash. */
+#define SECTOR_HEADER_SIZE 8
+#define UI_RECORD_SIZE 16
+#define UI_RECORDS_PER_SECTOR ((SECTOR_SIZE - SECTOR_HEADER_SIZE) / UI_RECORD_SIZE)
+
+#define LOADED_MAX (UI_RECORDS_PER_SECTOR * SECTOR_COUNT)
+
+extern bool date_time_mock_unknown;
+
+/* Flash partition emulated in RAM. */
+static uint8_t flash[PM_DATA_STORAGE_SIZE];
+static const struct flash_area test_fa = {
+	.fa_id = PM_DATA_STORAGE_ID,
+	.fa_off = 0,
+	.fa_size = PM_DATA_STORAGE_SIZE,
+};
+
+/* Number of bytes written by the next write before it fails, to emulate a
+ * reset in the middle of a write. Negative when disabled.
+ */
+static int torn_write_len = -1;
+
+static int loaded_btn[LOADED_MAX];
+static int64_t loaded_ts[LOADED_MAX];
+static int loaded_limit;
+
+int flash_area_open(uint8_t id, const struct flash_area **fa)
+{
+	zassert_equal(id, PM_DATA_STORAGE_ID, "Invalid flash area");
+
+	*fa = &test_fa;
+
+	return 0;
+}
+
+uint8_t flash_area_align(const struct flash_area *fa)
+{
+	return WRITE_ALIGN;
+}
+
+int flash_area_read(const struct flash_area *fa, off_t off, void *dst,
+		    size_t len)
+{
+	zassert_true((off >= 0) && ((off + len) <= sizeof(flash)),
+		     "Read out of bounds");
+
+	memcpy(dst, &flash[off], len);
+
+	return 0;
+}
+
+int flash_area_write(const struct flash_area *fa, off_t off, const void *src,
+		     size_t len)
+{
+	const uint8_t *data = src;
+
+	zassert_true((off >= 0) && ((off + len) <= sizeof(flash)),
+		     "Write out of bounds");
+	zassert_equal(off % WRITE_ALIGN, 0, "Unaligned write");
+	zassert_equal(len % WRITE_ALIGN, 0, "Unaligned write length");
+
+	if (torn_write_len >= 0) {
+		len = torn_write_len;
+		torn_write_len = -1;
+
+		for (size_t i = 0; i < len; i++) {
+			flash[off + i] &= data[i];
+		}
+
+		return -EIO;
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		zassert_equal(flash[off + i], 0xff, "Write to non-erased flash");
+		flash[off + i] = data[i];
+	}
+
+	return 0;
+}
+
+int flash_area_erase(const struct flash_area *fa, off_t off, size_t len)
+{
+	zassert_equal(off % SECTOR_SIZE, 0, "Unaligned erase");
+	zassert_equal(len % SECTOR_SIZE, 0, "Unaligned erase length");
+	zassert_true((off + len) <= sizeof(flash), "Erase out of bounds");
+
+	memset(&flash[off], 0xff, len);
+
+	return 0;
+}
+
+static bool load_cb(enum data_storage_type type, void *data, void *user_data)
+{
+	struct cloud_data_ui *ui = data;
+	int *count = user_data;
+
+	if (*count >= loaded_limit) {
+		return false;
+	}
+
+	zassert_equal(type, DATA_STORAGE_UI, "Invalid entry type");
+	zassert_true(ui->queued, "Loaded entry not queued");
+
+	loaded_btn[*count] = ui->btn;
+	loaded_ts[*count] = ui->btn_ts;
+	(*count)++;
+
+	return true;
+}
+
+/* Load at most limit entries, and check that they are consecutive buttons
+ * starting from first.
+ */
+static int load(int limit, int first, struct data_storage_pos *end)
+{
+	int count = 0;
+	int ret;
+
+	loaded_limit = limit;
+
+	ret = data_storage_load(load_cb, &count, end);
+	zassert_equal(ret, count, "Invalid number of loaded entries");
+
+	for (int i = 0; i < count; i++) {
+		zassert_equal(loaded_btn[i], first + i,
+			      "Unexpected entry %d: %d", i, loaded_btn[i]);
+	}
+
+	return count;
+}
+
+static void add_ui(int btn)
+{
+	struct cloud_data_ui ui = {
+		.btn = btn,
+		.btn_ts = k_uptime_get() - btn,
+		.queued = true
+	};
+
+	zassert_equal(data_storage_add(DATA_STORAGE_UI, &ui), 0,
+		      "Adding entry failed");
+}
+
+static void reboot(void)
+{
+	zassert_equal(data_storage_init(), 0, "Initialization failed");
+}
+
+static void setup(void)
+{
+	memset(flash, 0xff, sizeof(flash));
+	torn_write_len = -1;
+	date_time_mock_unknown = false;
+
+	reboot();
+}
+
+static void test_store_and_load(void)
+{
+	struct data_storage_pos end;
+	struct cloud_data_battery bat = {
+		.bat = 3600,
+		.bat_ts = k_uptime_get(),
+		.queued = true
+	};
+	int64_t ts[3];
+
+	for (int i = 0; i < ARRAY_SIZE(ts); i++) {
+		add_ui(i);
+		ts[i] = k_uptime_get() - i;
+	}
+
+	zassert_equal(load(LOADED_MAX, 0, &end), ARRAY_SIZE(ts),
+		      "Invalid number of entries");
+
+	for (int i = 0; i < ARRAY_SIZE(ts); i++) {
+		/* Timestamps survive the conversion to UNIX time and back. */
+		zassert_true((loaded_ts[i] <= ts[i]) &&
+			     (loaded_ts[i] >= ts[i] - 10),
+			     "Invalid timestamp");
+	}
+
+	/* Entries of disabled types are not stored. */
+	zassert_equal(data_storage_add(DATA_STORAGE_SENSORS, &bat), -ENOTSUP,
+		      "Disabled type stored");
+
+	date_time_mock_unknown = true;
+	zassert_equal(data_storage_add(DATA_STORAGE_BATTERY, &bat), -ENODATA,
+		      "Stored without known time");
+}
+
+static void test_consume(void)
+{
+	struct data_storage_pos end;
+	struct data_storage_pos end2;
+
+	for (int i = 0; i < 5; i++) {
+		add_ui(i);
+	}
+
+	/* Loading does not consume the entries. */
+	zassert_equal(load(2, 0, &end), 2, "Invalid number of entries");
+	zassert_equal(load(2, 0, &end), 2, "Entries consumed by loading");
+
+	zassert_equal(data_storage_consume(&end), 0, "Consume failed");
+	zassert_equal(load(LOADED_MAX, 2, &end2), 3,
+		      "Invalid number of entries after consume");
+
+	/* Consuming the same entries again has no effect. */
+	zassert_equal(data_storage_consume(&end), 0, "Consume failed");
+	zassert_equal(load(LOADED_MAX, 2, &end2), 3,
+		      "Entries consumed twice");
+
+	zassert_equal(data_storage_consume(&end2), 0, "Consume failed");
+	zassert_equal(load(LOADED_MAX, 0, &end), 0, "Entries not consumed");
+}
+
+static void test_recovery_after_reboot(void)
+{
+	struct data_storage_pos end;
+
+	for (int i = 0; i < 5; i++) {
+		add_ui(i);
+	}
+
+	zassert_equal(load(2, 0, &end), 2, "Invalid number of entries");
+	zassert_equal(data_storage_consume(&end), 0, "Consume failed");
+
+	/* Entries that were not consumed are loaded again after a reset. */
+	reboot();
+	zassert_equal(load(LOADED_MAX, 2, &end), 3,
+		      "Invalid number of entries after reboot");
+
+	/* New entries are appended after the recovered ones. */
+	add_ui(5);
+	zassert_equal(load(LOADED_MAX, 2, &end), 4,
+		      "Invalid number of entries after adding");
+
+	zassert_equal(data_storage_consume(&end), 0, "Consume failed");
+	reboot();
+	zassert_equal(load(LOADED_MAX, 0, &end), 0,
+		      "Consumed entries loaded after reboot");
+}
+
+static void test_torn_write(void)
+{
+	/* Reset after writing part of the record header, the whole header, and
+	 * part of the payload.
+	 */
+	const int torn_lens[] = { 2, 4, 8 };
+	struct data_storage_pos end;
+
+	for (int i = 0; i < ARRAY_SIZE(torn_lens); i++) {
+		struct cloud_data_ui ui = {
+			.btn = 100,
+			.btn_ts = k_uptime_get()
+		};
+
+		setup();
+
+		for (int j = 0; j < 3; j++) {
+			add_ui(j);
+		}
+
+		torn_write_len = torn_lens[i];
+		zassert_equal(data_storage_add(DATA_STORAGE_UI, &ui), -EIO,
+			      "Torn write did not fail");
+
+		reboot();
+		zassert_equal(load(LOADED_MAX, 0, &end), 3,
+			      "Invalid number of entries before torn record");
+
+		/* The sector with the torn record is not written to again. */
+		add_ui(3);
+		zassert_equal(load(LOADED_MAX, 0, &end), 4,
+			      "Entry after torn record not loaded");
+
+		reboot();
+		zassert_equal(load(LOADED_MAX, 0, &end), 4,
+			      "Invalid number of entries after second reboot");
+	}
+}
+
+static void test_wrap_around(void)
+{
+	/* Fill the storage more than once. The oldest sectors are erased, so
+	 * the entries in the last SECTOR_COUNT sectors are kept.
+	 */
+	const int total = UI_RECORDS_PER_SECTOR * (SECTOR_COUNT + 2);
+	const int kept = UI_RECORDS_PER_SECTOR * SECTOR_COUNT;
+	struct data_storage_pos end;
+
+	for (int i = 0; i < total; i++) {
+		add_ui(i);
+	}
+
+	zassert_equal(load(LOADED_MAX, total - kept, &end), kept,
+		      "Invalid number of entries after wrap-around");
+
+	reboot();
+	zassert_equal(load(LOADED_MAX, total - kept, &end), kept,
+		      "Invalid number of entries after reboot");
+
+	/* Consume part of the entries, and wrap around again. The checkpoint
+	 * starts a new sector, so the oldest sector holding the consumed
+	 * position is dropped, and another one when the sector after the
+	 * checkpoint is full.
+	 */
+	zassert_equal(load(10, total - kept, &end), 10,
+		      "Invalid number of entries");
+	zassert_equal(data_storage_consume(&end), 0, "Consume failed");
+
+	for (int i = total; i < total + UI_RECORDS_PER_SECTOR; i++) {
+		add_ui(i);
+	}
+
+	reboot();
+	zassert_equal(load(LOADED_MAX, total - 2 * UI_RECORDS_PER_SECTOR, &end),
+		      3 * UI_RECORDS_PER_SECTOR,
+		      "Invalid number of entries after second wrap-around");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(data_storage,
+		ztest_unit_test_setup_teardown(test_store_and_load, setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_consume, setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_recovery_after_reboot,
+					       setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_torn_write, setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_wrap_around, setup,
+					       unit_test_noop)
+	);
+
+	ztest_run_test_suite(data_storage);
+}
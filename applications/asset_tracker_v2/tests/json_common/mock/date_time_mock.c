@@ -8,9 +8,23 @@
 
 #include "date_time.h"
 
+/* Number of conversions after which the date and time are updated, or a
+ * negative value to keep them constant.
+ */
+int date_time_mock_update_after = -1;
+
 /* Mocking function that always converts the input uptime to a known timestamp. */
 int date_time_uptime_to_unix_time_ms(int64_t *uptime)
 {
+	if (date_time_mock_update_after == 0) {
+		*uptime = 15639687471230;
+		return 0;
+	}
+
+	if (date_time_mock_update_after > 0) {
+		date_time_mock_update_after--;
+	}
+
 	*uptime = 1563968747123;
 
 	return 0;
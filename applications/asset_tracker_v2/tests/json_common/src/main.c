@@ -16,6 +16,13 @@
 #include "cloud_codec.h"
 #include "json_protocol_names.h"
 #include "json_validate.h"
+#include "cloud_codec_stream.h"
+
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+#include "native_rtc.h"
+#endif
+
+extern int date_time_mock_update_after;
 
 /* Structure used to generate cJSON objects and encoded output string buffers. */
 static struct test_dummy {
@@ -891,6 +898,491 @@ static void test_encode_batch_data_object(void)
 	zassert_equal(-EINVAL, ret, "Return value %d is wrong.", ret);
 }
 
+/* Streamed batch encoding */
+
+/* Number of entries of every type in the streamed batch tests. */
+#define STREAM_BATCH_COUNT 4
+
+/* Number of times the batch data is encoded in the benchmark. */
+#define BENCH_ROUNDS 100
+
+struct stream_batch_data {
+	struct cloud_data_gps gps[STREAM_BATCH_COUNT];
+	struct cloud_data_sensors sensor[STREAM_BATCH_COUNT];
+	struct cloud_data_modem_dynamic modem_dynamic[STREAM_BATCH_COUNT];
+	struct cloud_data_ui ui[STREAM_BATCH_COUNT];
+	struct cloud_data_accelerometer accel[STREAM_BATCH_COUNT];
+	struct cloud_data_battery bat[STREAM_BATCH_COUNT];
+};
+
+static struct stream_batch_data stream_data;
+static struct stream_batch_data ref_data;
+static char stream_out[4096];
+static size_t stream_out_len;
+
+static void stream_batch_fill(struct stream_batch_data *data)
+{
+	memset(data, 0, sizeof(*data));
+
+	for (int i = 0; i < STREAM_BATCH_COUNT; i++) {
+		data->gps[i].gps_ts = 1000 + i;
+		data->gps[i].queued = true;
+
+		if (i % 2) {
+			data->gps[i].format = CLOUD_CODEC_GPS_FORMAT_NMEA;
+			strcpy(data->gps[i].nmea,
+			       "$GPGLL,4916.45,N,12311.12,W,225444,A,*1D\r\n");
+		} else {
+			data->gps[i].format = CLOUD_CODEC_GPS_FORMAT_PVT;
+			data->gps[i].pvt.longi = 10.4345 + i;
+			data->gps[i].pvt.lat = 63.4218 - i;
+			data->gps[i].pvt.acc = 24.1 * i;
+			data->gps[i].pvt.alt = 170;
+			data->gps[i].pvt.spd = 0.35 * i;
+			data->gps[i].pvt.hdg = 176.12;
+		}
+
+		data->sensor[i].env_ts = 1000 + i;
+		data->sensor[i].temp = 23.1 - 30 * i;
+		data->sensor[i].hum = 50 + i / 3.0;
+		data->sensor[i].queued = true;
+
+		data->modem_dynamic[i].ts = 1000 + i;
+		data->modem_dynamic[i].rsrp = -8 - i;
+		data->modem_dynamic[i].area = 12;
+		data->modem_dynamic[i].cell = 33703719;
+		strcpy(data->modem_dynamic[i].mccmnc, "24202");
+		strcpy(data->modem_dynamic[i].ip, "10.81.183.99");
+		data->modem_dynamic[i].queued = true;
+		data->modem_dynamic[i].rsrp_fresh = true;
+		data->modem_dynamic[i].area_code_fresh = (i == 0);
+		data->modem_dynamic[i].mccmnc_fresh = (i == 0);
+		data->modem_dynamic[i].cell_id_fresh = (i == 0);
+		data->modem_dynamic[i].ip_address_fresh = (i == 0);
+
+		data->ui[i].btn = i + 1;
+		data->ui[i].btn_ts = 1000 + i;
+		data->ui[i].queued = true;
+
+		data->accel[i].values[0] = 1.5 * i;
+		data->accel[i].values[1] = -9.81;
+		data->accel[i].values[2] = 0.1 + i;
+		data->accel[i].ts = 1000 + i;
+		data->accel[i].queued = true;
+
+		data->bat[i].bat = 3600 + i;
+		data->bat[i].bat_ts = 1000 + i;
+		data->bat[i].queued = true;
+	}
+
+	/* Entries that are not encoded. */
+	data->bat[1].queued = false;
+	data->modem_dynamic[3].rsrp_fresh = false;
+}
+
+static struct cloud_codec_batch stream_batch_get(struct stream_batch_data *data)
+{
+	return (struct cloud_codec_batch){
+		.gps_buf = data->gps,
+		.sensor_buf = data->sensor,
+		.modem_dyn_buf = data->modem_dynamic,
+		.ui_buf = data->ui,
+		.accel_buf = data->accel,
+		.bat_buf = data->bat,
+		.gps_buf_count = ARRAY_SIZE(data->gps),
+		.sensor_buf_count = ARRAY_SIZE(data->sensor),
+		.modem_dyn_buf_count = ARRAY_SIZE(data->modem_dynamic),
+		.ui_buf_count = ARRAY_SIZE(data->ui),
+		.accel_buf_count = ARRAY_SIZE(data->accel),
+		.bat_buf_count = ARRAY_SIZE(data->bat),
+	};
+}
+
+/* Batch data encoded with cJSON, in the same order as the cloud codec backends. */
+static char *stream_batch_cjson_encode(struct stream_batch_data *data)
+{
+	int ret;
+	char *buffer;
+	cJSON *root_obj = cJSON_CreateObject();
+	const struct {
+		enum json_common_buffer_type type;
+		void *buf;
+		size_t count;
+		const char *label;
+	} arrays[] = {
+		{ JSON_COMMON_MODEM_DYNAMIC, data->modem_dynamic,
+		  ARRAY_SIZE(data->modem_dynamic), DATA_MODEM_DYNAMIC },
+		{ JSON_COMMON_GPS, data->gps, ARRAY_SIZE(data->gps), DATA_GPS },
+		{ JSON_COMMON_SENSOR, data->sensor, ARRAY_SIZE(data->sensor),
+		  DATA_ENVIRONMENTALS },
+		{ JSON_COMMON_UI, data->ui, ARRAY_SIZE(data->ui), DATA_BUTTON },
+		{ JSON_COMMON_BATTERY, data->bat, ARRAY_SIZE(data->bat), DATA_BATTERY },
+		{ JSON_COMMON_ACCELEROMETER, data->accel, ARRAY_SIZE(data->accel),
+		  DATA_MOVEMENT },
+	};
+
+	if (root_obj == NULL) {
+		return NULL;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(arrays); i++) {
+		ret = json_common_batch_data_add(root_obj, arrays[i].type,
+						 arrays[i].buf, arrays[i].count,
+						 arrays[i].label);
+		if (ret && ret != -ENODATA) {
+			cJSON_Delete(root_obj);
+			return NULL;
+		}
+	}
+
+	buffer = cJSON_PrintUnformatted(root_obj);
+	cJSON_Delete(root_obj);
+
+	return buffer;
+}
+
+static int stream_out_flush(const char *buf, size_t len, void *user_data)
+{
+	if (stream_out_len + len > sizeof(stream_out)) {
+		return -ENOMEM;
+	}
+
+	memcpy(&stream_out[stream_out_len], buf, len);
+	stream_out_len += len;
+
+	return 0;
+}
+
+static int stream_encode(struct stream_batch_data *data,
+			 enum cloud_codec_stream_format format, size_t chunk_size)
+{
+	int ret;
+	char chunk[64];
+	struct cloud_codec_stream stream;
+	struct cloud_codec_batch batch = stream_batch_get(data);
+
+	stream_out_len = 0;
+	cloud_codec_stream_init(&stream, format, chunk, MIN(chunk_size, sizeof(chunk)),
+				stream_out_flush, NULL);
+
+	ret = cloud_codec_stream_batch_encode(&stream, &batch);
+	if (ret) {
+		return ret;
+	}
+
+	ret = cloud_codec_stream_finish(&stream);
+	if (ret) {
+		return ret;
+	}
+
+	if (stream.total != stream_out_len) {
+		return -EMSGSIZE;
+	}
+
+	return 0;
+}
+
+static void test_stream_batch_json(void)
+{
+	int ret;
+	char *reference;
+	struct cloud_codec_data output;
+	struct cloud_codec_batch batch = stream_batch_get(&stream_data);
+	const size_t chunk_sizes[] = { 1, 7, 64 };
+
+	stream_batch_fill(&stream_data);
+	stream_batch_fill(&ref_data);
+
+	reference = stream_batch_cjson_encode(&ref_data);
+	zassert_not_null(reference, "Reference encoding failed");
+
+	/* Streamed output is identical to the cJSON output, regardless of the
+	 * chunk size.
+	 */
+	for (int i = 0; i < ARRAY_SIZE(chunk_sizes); i++) {
+		ret = stream_encode(&stream_data, CLOUD_CODEC_STREAM_JSON,
+				    chunk_sizes[i]);
+		zassert_equal(0, ret, "Return value %d is wrong", ret);
+		zassert_equal(strlen(reference), stream_out_len,
+			      "Wrong length with chunk size %d", chunk_sizes[i]);
+		zassert_mem_equal(reference, stream_out, stream_out_len,
+				  "Wrong output with chunk size %d", chunk_sizes[i]);
+	}
+
+	/* Encoding into a stream doesn't modify the data. */
+	zassert_true(stream_data.gps[0].queued, "Entry unqueued");
+	zassert_equal(1000, stream_data.gps[0].gps_ts, "Timestamp modified");
+	zassert_true(stream_data.modem_dynamic[3].queued, "Entry unqueued");
+
+	ret = cloud_codec_stream_batch_data_encode(&output,
+						   CLOUD_CODEC_STREAM_JSON,
+						   &batch);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(strlen(reference), output.len, "Wrong length");
+	zassert_equal(0, strcmp(reference, output.buf), "Wrong output");
+
+	for (int i = 0; i < STREAM_BATCH_COUNT; i++) {
+		zassert_false(stream_data.gps[i].queued, "Entry still queued");
+		zassert_false(stream_data.modem_dynamic[i].queued,
+			      "Entry still queued");
+		zassert_false(stream_data.bat[i].queued, "Entry still queued");
+	}
+
+	cloud_codec_release_data(&output);
+	cJSON_FreeString(reference);
+
+	ret = cloud_codec_stream_batch_data_encode(&output,
+						   CLOUD_CODEC_STREAM_JSON,
+						   &batch);
+	zassert_equal(-ENODATA, ret, "Return value %d is wrong", ret);
+}
+
+static void test_stream_batch_cbor(void)
+{
+	int ret;
+	size_t json_len;
+	struct stream_batch_data data = {
+		.bat[0].bat = 3600,
+		.bat[0].bat_ts = 1000,
+		.bat[0].queued = true,
+		.accel[0].values = { 1.5, -2, 0.1 },
+		.accel[0].ts = 1000,
+		.accel[0].queued = true,
+	};
+	/* {"bat":[{"v":3600,"ts":1563968747123}],
+	 *  "acc":[{"v":{"x":1.5,"y":-2,"z":0.1},"ts":1563968747123}]}
+	 */
+	const uint8_t expected[] = {
+		0xbf,
+		0x63, 'b', 'a', 't', 0x9f,
+		0xbf,
+		0x61, 'v', 0x19, 0x0e, 0x10,
+		0x62, 't', 's', 0x1b, 0x00, 0x00, 0x01, 0x6c, 0x23, 0xcd, 0x36, 0x73,
+		0xff,
+		0xff,
+		0x63, 'a', 'c', 'c', 0x9f,
+		0xbf,
+		0x61, 'v', 0xbf,
+		0x61, 'x', 0xfa, 0x3f, 0xc0, 0x00, 0x00,
+		0x61, 'y', 0x21,
+		0x61, 'z', 0xfb, 0x3f, 0xb9, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a,
+		0xff,
+		0x62, 't', 's', 0x1b, 0x00, 0x00, 0x01, 0x6c, 0x23, 0xcd, 0x36, 0x73,
+		0xff,
+		0xff,
+		0xff,
+	};
+
+	ret = stream_encode(&data, CLOUD_CODEC_STREAM_CBOR, 5);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(sizeof(expected), stream_out_len, "Wrong length");
+	zassert_mem_equal(expected, stream_out, sizeof(expected), "Wrong output");
+
+	/* CBOR output is smaller than the JSON output of the same data. */
+	stream_batch_fill(&stream_data);
+
+	ret = stream_encode(&stream_data, CLOUD_CODEC_STREAM_JSON, 64);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	json_len = stream_out_len;
+
+	ret = stream_encode(&stream_data, CLOUD_CODEC_STREAM_CBOR, 64);
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_true(stream_out_len < json_len, "CBOR output %d larger than JSON %d",
+		     stream_out_len, json_len);
+}
+
+static int stream_fail_flush(const char *buf, size_t len, void *user_data)
+{
+	return -EIO;
+}
+
+static void test_stream_batch_errors(void)
+{
+	int ret;
+	char buf[16];
+	struct cloud_codec_stream stream;
+	struct cloud_codec_batch batch = stream_batch_get(&stream_data);
+
+	/* Nothing queued. */
+	memset(&stream_data, 0, sizeof(stream_data));
+	ret = stream_encode(&stream_data, CLOUD_CODEC_STREAM_JSON, 64);
+	zassert_equal(-ENODATA, ret, "Return value %d is wrong", ret);
+
+	/* Dynamic modem data without fresh values is not encoded. */
+	stream_data.modem_dynamic[0].queued = true;
+	ret = stream_encode(&stream_data, CLOUD_CODEC_STREAM_JSON, 64);
+	zassert_equal(-ENODATA, ret, "Return value %d is wrong", ret);
+
+	/* Invalid data. */
+	stream_batch_fill(&stream_data);
+	stream_data.gps[2].format = CLOUD_CODEC_GPS_FORMAT_INVALID;
+	ret = stream_encode(&stream_data, CLOUD_CODEC_STREAM_JSON, 64);
+	zassert_equal(-EINVAL, ret, "Return value %d is wrong", ret);
+
+	stream_batch_fill(&stream_data);
+	strcpy(stream_data.modem_dynamic[0].mccmnc, "242O2");
+	ret = stream_encode(&stream_data, CLOUD_CODEC_STREAM_CBOR, 64);
+	zassert_equal(-ENOTEMPTY, ret, "Return value %d is wrong", ret);
+
+	/* Output errors. */
+	stream_batch_fill(&stream_data);
+	cloud_codec_stream_init(&stream, CLOUD_CODEC_STREAM_JSON, buf,
+				sizeof(buf), NULL, NULL);
+	ret = cloud_codec_stream_batch_encode(&stream, &batch);
+	zassert_equal(-ENOMEM, ret, "Return value %d is wrong", ret);
+
+	cloud_codec_stream_init(&stream, CLOUD_CODEC_STREAM_JSON, buf,
+				sizeof(buf), stream_fail_flush, NULL);
+	ret = cloud_codec_stream_batch_encode(&stream, &batch);
+	zassert_equal(-EIO, ret, "Return value %d is wrong", ret);
+	ret = cloud_codec_stream_finish(&stream);
+	zassert_equal(-EIO, ret, "Return value %d is wrong", ret);
+}
+
+static void test_stream_batch_time_update(void)
+{
+	int ret;
+	struct cloud_codec_data output;
+	struct cloud_codec_batch batch = stream_batch_get(&stream_data);
+
+	stream_batch_fill(&stream_data);
+
+	/* Date and time are updated after the first timestamp is converted,
+	 * so the size of the message changes between the two passes.
+	 */
+	date_time_mock_update_after = 1;
+
+	ret = cloud_codec_stream_batch_data_encode(&output,
+						   CLOUD_CODEC_STREAM_JSON,
+						   &batch);
+	date_time_mock_update_after = -1;
+
+	zassert_equal(0, ret, "Return value %d is wrong", ret);
+	zassert_equal(strlen(output.buf), output.len, "Wrong length");
+	zassert_not_null(strstr(output.buf, "15639687471230"),
+			 "Updated timestamp not encoded");
+
+	/* All timestamps are encoded with the updated date and time. */
+	for (char *ts = strstr(output.buf, "1563968747123"); ts != NULL;
+	     ts = strstr(ts + 1, "1563968747123")) {
+		zassert_equal('0', ts[13], "Timestamp from before the update");
+	}
+
+	cloud_codec_release_data(&output);
+}
+
+/* Heap usage of cJSON, tracked by cJSON hooks that store the size of every
+ * allocation in front of it.
+ */
+static size_t bench_heap_used;
+static size_t bench_heap_peak;
+
+static void *bench_malloc(size_t size)
+{
+	uint64_t *block = k_malloc(sizeof(*block) + size);
+
+	if (block == NULL) {
+		return NULL;
+	}
+
+	*block = size;
+	bench_heap_used += size;
+	bench_heap_peak = MAX(bench_heap_peak, bench_heap_used);
+
+	return block + 1;
+}
+
+static void bench_free(void *ptr)
+{
+	uint64_t *block = ptr;
+
+	if (block == NULL) {
+		return;
+	}
+
+	bench_heap_used -= block[-1];
+	k_free(&block[-1]);
+}
+
+static uint64_t bench_time_us(void)
+{
+#if defined(CONFIG_BOARD_NATIVE_POSIX)
+	return native_rtc_gettime_us(RTC_CLOCK_REAL);
+#else
+	return k_ticks_to_us_floor64(k_uptime_ticks());
+#endif
+}
+
+static void test_stream_batch_benchmark(void)
+{
+	int ret;
+	uint64_t start;
+	uint64_t cjson_us, json_us, cbor_us;
+	size_t cjson_peak, json_peak = 0, cbor_peak = 0;
+	size_t len = 0;
+	char *buffer;
+	struct cloud_codec_data output;
+	struct cloud_codec_batch batch = stream_batch_get(&stream_data);
+	cJSON_Hooks hooks = {
+		.malloc_fn = bench_malloc,
+		.free_fn = bench_free,
+	};
+
+	cJSON_InitHooks(&hooks);
+	bench_heap_used = 0;
+	bench_heap_peak = 0;
+
+	start = bench_time_us();
+	for (int i = 0; i < BENCH_ROUNDS; i++) {
+		stream_batch_fill(&stream_data);
+		buffer = stream_batch_cjson_encode(&stream_data);
+		zassert_not_null(buffer, "Encoding failed");
+		len = strlen(buffer);
+		bench_free(buffer);
+	}
+	cjson_us = bench_time_us() - start;
+	cjson_peak = bench_heap_peak;
+
+	cJSON_Init();
+
+	/* The output buffer is the only allocation of the stream encoder. */
+	start = bench_time_us();
+	for (int i = 0; i < BENCH_ROUNDS; i++) {
+		stream_batch_fill(&stream_data);
+		ret = cloud_codec_stream_batch_data_encode(&output,
+							   CLOUD_CODEC_STREAM_JSON,
+							   &batch);
+		zassert_equal(0, ret, "Return value %d is wrong", ret);
+		zassert_equal(len, output.len, "Wrong length");
+		json_peak = output.len + 1;
+		cloud_codec_release_data(&output);
+	}
+	json_us = bench_time_us() - start;
+
+	start = bench_time_us();
+	for (int i = 0; i < BENCH_ROUNDS; i++) {
+		stream_batch_fill(&stream_data);
+		ret = cloud_codec_stream_batch_data_encode(&output,
+							   CLOUD_CODEC_STREAM_CBOR,
+							   &batch);
+		zassert_equal(0, ret, "Return value %d is wrong", ret);
+		cbor_peak = output.len + 1;
+		cloud_codec_release_data(&output);
+	}
+	cbor_us = bench_time_us() - start;
+
+	TC_PRINT("Batch of %d entries, %d bytes of JSON:\n",
+		 6 * STREAM_BATCH_COUNT, len);
+	TC_PRINT("  cJSON:       peak heap %6d bytes, %6d us per message\n",
+		 cjson_peak, (uint32_t)(cjson_us / BENCH_ROUNDS));
+	TC_PRINT("  Stream JSON: peak heap %6d bytes, %6d us per message\n",
+		 json_peak, (uint32_t)(json_us / BENCH_ROUNDS));
+	TC_PRINT("  Stream CBOR: peak heap %6d bytes, %6d us per message\n",
+		 cbor_peak, (uint32_t)(cbor_us / BENCH_ROUNDS));
+
+	zassert_true(json_peak < cjson_peak, "Stream encoder uses more heap");
+}
+
 /* Test used to verify encoding and decoding of data structures that contain floating point
  * values. Floating point values cannot be exactly represented in binary so they cannot be compared
  * with a predefined JSON string schema.
@@ -1221,6 +1713,13 @@ void test_main(void)
 					       test_setup_object,
 					       test_teardown_object),
 
+		/* Streamed batch */
+		ztest_unit_test(test_stream_batch_json),
+		ztest_unit_test(test_stream_batch_cbor),
+		ztest_unit_test(test_stream_batch_errors),
+		ztest_unit_test(test_stream_batch_time_update),
+		ztest_unit_test(test_stream_batch_benchmark),
+
 		/* GPS floating point values comparison */
 		ztest_unit_test_setup_teardown(test_floating_point_encoding_gps,
 					       test_setup_object,
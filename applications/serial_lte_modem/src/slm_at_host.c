@@ -20,6 +20,7 @@ LOG_MODULE_REGISTER(at_host, CONFIG_SLM_LOG_LEVEL);
 #include "slm_util.h"
 #include "slm_at_host.h"
 #include "slm_at_fota.h"
+#include "slm_uart_tx.h"
 
 #define OK_STR		"\r\nOK\r\n"
 #define ERROR_STR	"\r\nERROR\r\n"
@@ -31,8 +32,6 @@ LOG_MODULE_REGISTER(at_host, CONFIG_SLM_LOG_LEVEL);
  *  Modem library's NRF_MODEM_AT_MAX_CMD_SIZE */
 #define AT_MAX_CMD_LEN          4096
 
-#define UART_RX_BUF_NUM         2
-#define UART_RX_LEN             256
 #define UART_RX_TIMEOUT_MS      1
 #define UART_ERROR_DELAY_MS     500
 #define UART_RX_MARGIN_MS       10
@@ -53,14 +52,11 @@ static slm_datamode_handler_t datamode_handler;
 static struct k_work raw_send_work;
 static struct k_work cmd_send_work;
 
-static uint8_t uart_rx_buf[UART_RX_BUF_NUM][UART_RX_LEN];
-static uint8_t *next_buf = uart_rx_buf[1];
-static uint8_t *uart_tx_buf;
+static uint8_t uart_rx_buf[CONFIG_SLM_UART_RX_BUF_NUM][CONFIG_SLM_UART_RX_BUF_SIZE];
+static uint8_t next_buf;
 static bool uart_recovery_pending;
 static struct k_work_delayable uart_recovery_work;
 
-static K_SEM_DEFINE(tx_done, 0, 1);
-
 /* global functions defined in different files */
 int slm_at_parse(const char *at_cmd);
 int slm_at_init(void);
@@ -77,30 +73,6 @@ uint16_t datamode_time_limit;               /* Send trigger by time in data mode
 extern bool uart_configured;
 extern struct uart_config slm_uart;
 
-static int uart_send(const uint8_t *str, size_t len)
-{
-	int ret;
-
-	k_sem_take(&tx_done, K_FOREVER);
-
-	uart_tx_buf = k_malloc(len);
-	if (uart_tx_buf == NULL) {
-		LOG_WRN("No ram buffer");
-		k_sem_give(&tx_done);
-		return -ENOMEM;
-	}
-
-	memcpy(uart_tx_buf, str, len);
-	ret = uart_tx(uart_dev, uart_tx_buf, len, SYS_FOREVER_MS);
-	if (ret) {
-		LOG_WRN("uart_tx failed: %d", ret);
-		k_free(uart_tx_buf);
-		k_sem_give(&tx_done);
-	}
-
-	return ret;
-}
-
 void rsp_send(const uint8_t *str, size_t len)
 {
 	if (len == 0) {
@@ -108,13 +80,14 @@ void rsp_send(const uint8_t *str, size_t len)
 	}
 
 	LOG_HEXDUMP_DBG(str, len, "TX");
-	(void)uart_send(str, len);
+	(void)slm_uart_tx_send(str, len);
 }
 
 static int uart_receive(void)
 {
 	int ret;
 
+	next_buf = 1;
 	ret = uart_rx_enable(uart_dev, uart_rx_buf[0], sizeof(uart_rx_buf[0]), UART_RX_TIMEOUT_MS);
 	if (ret) {
 		LOG_ERR("UART RX failed: %d", ret);
@@ -198,7 +171,8 @@ int poweron_uart(void)
 		k_sleep(K_MSEC(100));
 		err = uart_receive();
 		if (err == 0) {
-			k_sem_give(&tx_done);
+			/* Resume sending the data queued while UART was powered off */
+			slm_uart_tx_start();
 			rsp_send(SLM_SYNC_STR, sizeof(SLM_SYNC_STR)-1);
 		}
 	}
@@ -230,7 +204,7 @@ bool verify_datamode_control(uint16_t time_limit, uint16_t *min_time_limit)
 		return false;
 	}
 
-	min_time = UART_RX_LEN * (8 + 1 + 1) * 1000 / slm_uart.baudrate;
+	min_time = CONFIG_SLM_UART_RX_BUF_SIZE * (8 + 1 + 1) * 1000 / slm_uart.baudrate;
 	min_time += UART_RX_MARGIN_MS;
 
 	if (time_limit > 0 && min_time > time_limit) {
@@ -263,17 +237,33 @@ static void raw_send(struct k_work *work)
 	ARG_UNUSED(work);
 
 	const uint32_t tx_buf_size = sizeof(at_buf) / 2;
-	uint32_t size = ring_buf_get(&data_rb, &at_buf[tx_buf_size], tx_buf_size);
+	uint32_t avail = ring_buf_size_get(&data_rb);
+	uint8_t *data = NULL;
+	uint32_t size;
+
+	/* Pass the data to the handler directly from the ring buffer. Data that wraps around
+	 * the end of the ring buffer is copied to the other half of at_buf, so that it is still
+	 * sent in one go.
+	 */
+	size = ring_buf_get_claim(&data_rb, &data, avail);
+	if (size < avail) {
+		(void)ring_buf_get_finish(&data_rb, 0);
+		data = &at_buf[tx_buf_size];
+		size = ring_buf_get(&data_rb, data, tx_buf_size);
+	}
 
 	if (size > 0) {
 		LOG_INF("Raw send %d", size);
-		LOG_HEXDUMP_DBG(&at_buf[tx_buf_size], size, "RX");
+		LOG_HEXDUMP_DBG(data, size, "RX");
 		if (datamode_handler) {
-			(void)datamode_handler(DATAMODE_SEND, &at_buf[tx_buf_size], size);
+			(void)datamode_handler(DATAMODE_SEND, data, size);
 		} else {
 			LOG_WRN("no handler, data dropped");
 		}
 	}
+	if (data != &at_buf[tx_buf_size]) {
+		(void)ring_buf_get_finish(&data_rb, size);
+	}
 	/* resume UART RX in case of stopped by buffer full */
 	if (datamode_rx_disabled) {
 		uart_receive();
@@ -360,7 +350,7 @@ static int raw_rx_handler(const uint8_t *data, int datalen)
 		return -1;
 	}
 	ret = ring_buf_space_get(&data_rb);
-	if (ret < UART_RX_LEN) {
+	if (ret < CONFIG_SLM_UART_RX_BUF_SIZE) {
 		LOG_WRN("data buffer full (%d)", ret);
 		uart_rx_disable(uart_dev);
 		return -1;
@@ -617,12 +607,11 @@ static void uart_callback(const struct device *dev, struct uart_event *evt, void
 
 	switch (evt->type) {
 	case UART_TX_DONE:
-		k_free(uart_tx_buf);
-		k_sem_give(&tx_done);
+		slm_uart_tx_done(evt->data.tx.len, true);
 		break;
 	case UART_TX_ABORTED:
-		k_free(uart_tx_buf);
-		k_sem_give(&tx_done);
+		/* The data that was not sent is sent when TX is resumed */
+		slm_uart_tx_done(evt->data.tx.len, false);
 		LOG_INF("TX_ABORTED");
 		break;
 	case UART_RX_RDY:
@@ -645,13 +634,13 @@ static void uart_callback(const struct device *dev, struct uart_event *evt, void
 		break;
 	case UART_RX_BUF_REQUEST:
 		pos = 0;
-		err = uart_rx_buf_rsp(uart_dev, next_buf, sizeof(uart_rx_buf[0]));
+		err = uart_rx_buf_rsp(uart_dev, uart_rx_buf[next_buf], sizeof(uart_rx_buf[0]));
 		if (err) {
 			LOG_WRN("UART RX buf rsp: %d", err);
 		}
+		next_buf = (next_buf + 1) % ARRAY_SIZE(uart_rx_buf);
 		break;
 	case UART_RX_BUF_RELEASED:
-		next_buf = evt->data.rx_buf.buf;
 		break;
 	case UART_RX_STOPPED:
 		LOG_WRN("RX_STOPPED (%d)", evt->data.rx_stop.reason);
@@ -724,6 +713,7 @@ int slm_at_host_init(void)
 			k_sleep(K_MSEC(10));
 		}
 	} while (err);
+	slm_uart_tx_init(uart_dev);
 	/* Register async handling callback */
 	err = uart_callback_set(uart_dev, uart_callback, NULL);
 	if (err) {
@@ -761,7 +751,6 @@ int slm_at_host_init(void)
 	k_work_init(&raw_send_work, raw_send);
 	k_work_init(&cmd_send_work, cmd_send);
 	k_work_init_delayable(&uart_recovery_work, uart_recovery);
-	k_sem_give(&tx_done);
 	rsp_send(SLM_SYNC_STR, sizeof(SLM_SYNC_STR)-1);
 	slm_fota_post_process();
 
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <logging/log.h>
+#include <drivers/uart.h>
+#include <sys/ring_buffer.h>
+#include "slm_uart_tx.h"
+
+LOG_MODULE_REGISTER(slm_uart_tx, CONFIG_SLM_LOG_LEVEL);
+
+/* Maximum length of a single UARTE transfer, the TXD.MAXCNT register
+ * of nRF9160 is 13 bits wide.
+ */
+#define UART_TX_MAX_LEN 8191
+
+static const struct device *uart_dev;
+static uint8_t uart_tx_buf[CONFIG_SLM_UART_TX_BUF_SIZE];
+static struct ring_buf tx_rb;
+static bool tx_busy;
+static struct k_spinlock tx_lock;
+
+static K_MUTEX_DEFINE(tx_mutex);
+static K_SEM_DEFINE(tx_done, 0, 1);
+
+void slm_uart_tx_init(const struct device *dev)
+{
+	k_spinlock_key_t key = k_spin_lock(&tx_lock);
+
+	uart_dev = dev;
+	ring_buf_init(&tx_rb, sizeof(uart_tx_buf), uart_tx_buf);
+	tx_busy = false;
+	k_spin_unlock(&tx_lock, key);
+}
+
+void slm_uart_tx_start(void)
+{
+	uint8_t *data;
+	uint32_t len;
+	int ret;
+	k_spinlock_key_t key = k_spin_lock(&tx_lock);
+
+	if (tx_busy) {
+		k_spin_unlock(&tx_lock, key);
+		return;
+	}
+
+	/* Send the contiguous part of the queued data directly from the ring buffer.
+	 * The data stays claimed until the transfer completes.
+	 */
+	len = ring_buf_get_claim(&tx_rb, &data, UART_TX_MAX_LEN);
+	if (len == 0) {
+		k_spin_unlock(&tx_lock, key);
+		return;
+	}
+	tx_busy = true;
+	k_spin_unlock(&tx_lock, key);
+
+	ret = uart_tx(uart_dev, data, len, SYS_FOREVER_MS);
+	if (ret) {
+		LOG_WRN("uart_tx failed: %d", ret);
+		/* Keep the data, it is sent with the next transfer */
+		key = k_spin_lock(&tx_lock);
+		(void)ring_buf_get_finish(&tx_rb, 0);
+		tx_busy = false;
+		k_spin_unlock(&tx_lock, key);
+	}
+}
+
+void slm_uart_tx_done(size_t sent, bool chain)
+{
+	k_spinlock_key_t key = k_spin_lock(&tx_lock);
+
+	if (tx_busy) {
+		/* Only the sent data is removed from the ring buffer */
+		(void)ring_buf_get_finish(&tx_rb, sent);
+		tx_busy = false;
+	}
+	k_spin_unlock(&tx_lock, key);
+
+	if (chain) {
+		slm_uart_tx_start();
+	}
+
+	/* Wake up the sender waiting for space */
+	k_sem_give(&tx_done);
+}
+
+int slm_uart_tx_send(const uint8_t *data, size_t len)
+{
+	k_spinlock_key_t key;
+	uint32_t queued;
+	bool in_isr = k_is_in_isr();
+
+	/* Keep the data of one response contiguous in the ring buffer */
+	if (!in_isr) {
+		k_mutex_lock(&tx_mutex, K_FOREVER);
+	}
+
+	while (len > 0) {
+		key = k_spin_lock(&tx_lock);
+		queued = ring_buf_put(&tx_rb, data, len);
+		k_spin_unlock(&tx_lock, key);
+
+		slm_uart_tx_start();
+
+		data += queued;
+		len -= queued;
+		if (len > 0) {
+			if (in_isr) {
+				LOG_WRN("TX buffer full, %d bytes dropped", len);
+				return -ENOBUFS;
+			}
+			/* Wait for the ongoing transfer to free space */
+			k_sem_take(&tx_done, K_FOREVER);
+		}
+	}
+
+	if (!in_isr) {
+		k_mutex_unlock(&tx_mutex);
+	}
+
+	return 0;
+}
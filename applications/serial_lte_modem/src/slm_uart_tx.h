@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef SLM_UART_TX_
+#define SLM_UART_TX_
+
+#include <zephyr/types.h>
+#include <device.h>
+
+/**@file slm_uart_tx.h
+ *
+ * @brief UART transmission from the TX ring buffer.
+ * @{
+ */
+/**
+ * @brief Initialize the TX ring buffer, dropping any queued data.
+ *
+ * @param dev UART device used for the transmission.
+ */
+void slm_uart_tx_init(const struct device *dev);
+
+/**
+ * @brief Queue data for the transmission and start sending it.
+ *
+ * In thread context, the function waits for space in the TX ring buffer.
+ * In interrupt context, data that does not fit in the buffer is dropped.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int slm_uart_tx_send(const uint8_t *data, size_t len);
+
+/**
+ * @brief Start sending the queued data, if no transfer is ongoing.
+ */
+void slm_uart_tx_start(void);
+
+/**
+ * @brief Complete the ongoing transfer.
+ *
+ * Must be called on the UART_TX_DONE and UART_TX_ABORTED events. The data
+ * that was not sent is kept in the TX ring buffer and sent again with
+ * the next transfer.
+ *
+ * @param sent  Number of bytes sent, as reported in the event.
+ * @param chain Start the next transfer if more data is queued.
+ */
+void slm_uart_tx_done(size_t sent, bool chain);
+/** @} */
+
+#endif /* SLM_UART_TX_ */
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <device.h>
+#include <drivers/uart.h>
+#include <ztest.h>
+
+#include "slm_uart_tx.h"
+
+#define UART_TX_MAX_LEN		8191
+#define TEST_DATA_SIZE		(CONFIG_SLM_UART_TX_BUF_SIZE + 4000)
+#define WRITER_STACK_SIZE	1024
+#define WRITER_PRIORITY		K_PRIO_PREEMPT(1)
+
+/* Fake UART driver. The test completes the transfers. */
+static const uint8_t *pending_data;
+static size_t pending_len;
+static size_t tx_cnt;
+static int tx_err;
+static bool tx_irq_locked;
+
+static uint8_t test_data[TEST_DATA_SIZE];
+static uint8_t output[TEST_DATA_SIZE];
+static size_t output_len;
+
+static int fake_tx(const struct device *dev, const uint8_t *buf, size_t len,
+		   int32_t timeout)
+{
+	unsigned int key = irq_lock();
+
+	/* The driver must not be called with the TX lock held. */
+	if (!arch_irq_unlocked(key)) {
+		tx_irq_locked = true;
+	}
+	irq_unlock(key);
+
+	tx_cnt++;
+
+	if (tx_err) {
+		int err = tx_err;
+
+		tx_err = 0;
+		return err;
+	}
+
+	zassert_equal(pending_len, 0, "Transfer started while busy");
+	zassert_true(len <= UART_TX_MAX_LEN, "Transfer too long: %u", len);
+
+	pending_data = buf;
+	pending_len = len;
+
+	return 0;
+}
+
+static const struct uart_driver_api fake_uart_api = {
+	.tx = fake_tx,
+};
+
+static int fake_uart_init(const struct device *dev)
+{
+	return 0;
+}
+
+DEVICE_DEFINE(fake_uart, "FAKE_UART", fake_uart_init, NULL, NULL, NULL,
+	      POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE, &fake_uart_api);
+
+/* Complete the pending transfer, as on the UART_TX_DONE or UART_TX_ABORTED
+ * event, after the given number of bytes is sent.
+ */
+static void tx_complete(size_t sent, bool done)
+{
+	zassert_true(sent <= pending_len, "Invalid length");
+	zassert_true(output_len + sent <= sizeof(output), "Output overflow");
+
+	memcpy(&output[output_len], pending_data, sent);
+	output_len += sent;
+	pending_len = 0;
+
+	slm_uart_tx_done(sent, done);
+}
+
+static void setup(void)
+{
+	slm_uart_tx_init(device_get_binding("FAKE_UART"));
+
+	pending_data = NULL;
+	pending_len = 0;
+	tx_cnt = 0;
+	tx_err = 0;
+	tx_irq_locked = false;
+	output_len = 0;
+
+	for (size_t i = 0; i < sizeof(test_data); i++) {
+		test_data[i] = (uint8_t)(i % 251);
+	}
+}
+
+static void teardown(void)
+{
+	zassert_false(tx_irq_locked, "uart_tx called with the TX lock held");
+}
+
+static void test_send_chunks(void)
+{
+	const size_t len = UART_TX_MAX_LEN + 1000;
+
+	zassert_equal(slm_uart_tx_send(test_data, len), 0, "Send failed");
+
+	/* The transfer is capped at the UARTE maximum. */
+	zassert_equal(pending_len, UART_TX_MAX_LEN, "Invalid transfer length");
+	tx_complete(pending_len, true);
+
+	zassert_equal(pending_len, 1000, "Next transfer not chained");
+	tx_complete(pending_len, true);
+
+	zassert_equal(pending_len, 0, "Unexpected transfer");
+	zassert_equal(tx_cnt, 2, "Invalid number of transfers");
+	zassert_equal(output_len, len, "Invalid amount of data sent");
+	zassert_mem_equal(output, test_data, len, "Invalid data sent");
+}
+
+static void test_abort_keeps_data(void)
+{
+	zassert_equal(slm_uart_tx_send(test_data, 100), 0, "Send failed");
+	zassert_equal(pending_len, 100, "Invalid transfer length");
+
+	/* Only the sent part of the aborted transfer is removed. */
+	tx_complete(40, false);
+	zassert_equal(pending_len, 0, "Transfer started after abort");
+
+	slm_uart_tx_start();
+	zassert_equal(pending_len, 60, "Unsent data not kept");
+	tx_complete(pending_len, true);
+
+	zassert_equal(output_len, 100, "Invalid amount of data sent");
+	zassert_mem_equal(output, test_data, 100, "Invalid data sent");
+}
+
+static void test_tx_error_keeps_data(void)
+{
+	tx_err = -EBUSY;
+
+	zassert_equal(slm_uart_tx_send(test_data, 50), 0, "Send failed");
+	zassert_equal(tx_cnt, 1, "Transfer not started");
+	zassert_equal(pending_len, 0, "Failed transfer pending");
+
+	slm_uart_tx_start();
+	zassert_equal(pending_len, 50, "Data of failed transfer not kept");
+	tx_complete(pending_len, true);
+
+	zassert_equal(output_len, 50, "Invalid amount of data sent");
+	zassert_mem_equal(output, test_data, 50, "Invalid data sent");
+}
+
+static K_THREAD_STACK_DEFINE(writer_stack, WRITER_STACK_SIZE);
+static struct k_thread writer_thread;
+static volatile bool writer_done;
+
+static void writer_fn(void *p1, void *p2, void *p3)
+{
+	zassert_equal(slm_uart_tx_send(test_data, sizeof(test_data)), 0,
+		      "Send failed");
+	writer_done = true;
+}
+
+static void test_send_waits_for_space(void)
+{
+	writer_done = false;
+
+	k_thread_create(&writer_thread, writer_stack,
+			K_THREAD_STACK_SIZEOF(writer_stack), writer_fn,
+			NULL, NULL, NULL, WRITER_PRIORITY, 0, K_NO_WAIT);
+
+	/* The data does not fit in the ring buffer. */
+	k_sleep(K_MSEC(50));
+	zassert_false(writer_done, "Writer not blocked on full buffer");
+
+	while (!writer_done || pending_len > 0) {
+		if (pending_len > 0) {
+			tx_complete(pending_len, true);
+		}
+		k_sleep(K_MSEC(1));
+	}
+
+	zassert_equal(k_thread_join(&writer_thread, K_SECONDS(1)), 0,
+		      "Writer did not finish");
+	zassert_equal(output_len, sizeof(test_data),
+		      "Invalid amount of data sent");
+	zassert_mem_equal(output, test_data, sizeof(test_data),
+			  "Invalid data sent");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(slm_uart_tx,
+		ztest_unit_test_setup_teardown(test_send_chunks, setup,
+					       teardown),
+		ztest_unit_test_setup_teardown(test_abort_keeps_data, setup,
+					       teardown),
+		ztest_unit_test_setup_teardown(test_tx_error_keeps_data, setup,
+					       teardown),
+		ztest_unit_test_setup_teardown(test_send_waits_for_space,
+					       setup, teardown)
+	);
+
+	ztest_run_test_suite(slm_uart_tx);
+}
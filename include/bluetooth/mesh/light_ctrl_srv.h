@@ -116,8 +116,21 @@ struct bt_mesh_light_ctrl_srv_reg_cfg {
 struct bt_mesh_light_ctrl_srv_reg {
 	/** Regulator step timer */
 	struct k_work_delayable timer;
+#if CONFIG_BT_MESH_LIGHT_CTRL_SRV_REG_FIXED_POINT
+	/** Internal integral sum, in fixed-point. */
+	int64_t i;
+	/** Fixed-point upwards integral coefficient */
+	int32_t kiu;
+	/** Fixed-point downwards integral coefficient */
+	int32_t kid;
+	/** Fixed-point upwards proportional coefficient */
+	int32_t kpu;
+	/** Fixed-point downwards proportional coefficient */
+	int32_t kpd;
+#else
 	/** Internal integral sum. */
 	float i;
+#endif
 	/** Previous output */
 	uint16_t prev;
 	/** Regulator configuration */
@@ -145,6 +145,20 @@ struct bt_scan_adv_info {
 	int8_t rssi;
 };
 
+/**@brief Statistics of the cache of the advertising reports.
+ */
+struct bt_scan_dedup_stats {
+	/** Number of repeated reports, which were not passed to
+	 *  the callbacks.
+	 */
+	uint32_t hits;
+
+	/** Number of new or changed reports, which were passed to
+	 *  the callbacks.
+	 */
+	uint32_t misses;
+};
+
 /**@brief A helper structure to set filters for the name.
  */
 struct bt_scan_short_name {
@@ -543,6 +557,25 @@ int bt_scan_blocklist_device_add(const bt_addr_le_t *addr);
  */
 void bt_scan_blocklist_clear(void);
 
+#if CONFIG_BT_SCAN_DEDUP
+/**@brief Clear the cache of the advertising reports.
+ *
+ * @details Use this function to pass the next report of every device
+ *          to the callbacks, even if it repeats the last report.
+ *          The cache is also cleared when the scanning is started.
+ */
+void bt_scan_dedup_clear(void);
+
+/**@brief Get the statistics of the cache of the advertising reports.
+ *
+ * @details The statistics are counted from the module initialization.
+ *
+ * @param[out] stats Cache statistics.
+ */
+void bt_scan_dedup_stats_get(struct bt_scan_dedup_stats *stats);
+
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
 #ifdef __cplusplus
 }
 #endif
@@ -65,6 +65,11 @@ struct event_header {
 
 	/** Pointer to the event type object. */
 	const struct event_type *type_id;
+
+#ifdef CONFIG_EVENT_MANAGER_DISPATCH_STATS
+	/** Cycle counter value captured when the event was submitted. */
+	uint32_t submit_cycles;
+#endif
 };
 
 
@@ -122,6 +127,26 @@ struct event_info {
 };
 
 
+/** @brief Event memory pool.
+ *
+ * Pool is used to allocate events of the given type if
+ * CONFIG_EVENT_MANAGER_EVENT_POOL is enabled.
+ */
+struct event_pool {
+	/** Memory slab serving the event allocations. */
+	struct k_mem_slab *slab;
+
+	/** Maximum number of events allocated from the slab at once. */
+	uint32_t max_used;
+
+	/** Number of allocations that were served by the shared pools. */
+	uint32_t shared_cnt;
+
+	/** Number of allocations that were served by the system heap. */
+	uint32_t heap_fallback_cnt;
+};
+
+
 /** @brief Event type.
  */
 struct event_type {
@@ -138,12 +163,50 @@ struct event_type {
 	/** Bool indicating if the event is logged by default. */
 	bool init_log_enable;
 
+	/** Dispatch class used to process events of this type. */
+	uint8_t dispatch_class;
+
 	/** Function to log data from this event. */
 	int (*log_event)(const struct event_header *eh, char *buf,
 			      size_t buf_len);
 
 	/** Logging and formatting information. */
 	const struct event_info *ev_info;
+
+	/** Function used to coalesce a submitted event into a pending event
+	 *  of the same type. */
+	bool (*coalesce)(struct event_header *pending,
+			 const struct event_header *eh);
+
+#ifdef CONFIG_EVENT_MANAGER_EVENT_POOL
+	/** Memory pool used to allocate events of this type. */
+	struct event_pool *pool;
+#endif
+};
+
+
+/** @brief Event dispatch statistics.
+ *
+ * Statistics are collected for every dispatch class if
+ * CONFIG_EVENT_MANAGER_DISPATCH_STATS is enabled.
+ */
+struct event_dispatch_stats {
+	/** Number of events submitted to the dispatch class. */
+	uint32_t submitted_cnt;
+
+	/** Number of events waiting to be processed. */
+	uint32_t queue_depth;
+
+	/** Maximum number of events waiting to be processed. */
+	uint32_t max_queue_depth;
+
+	/** Maximum time between event submission and processing
+	 *  (in microseconds). */
+	uint32_t max_latency_us;
+
+	/** Sum of times between event submission and processing
+	 *  (in microseconds). */
+	uint64_t total_latency_us;
 };
 
 
@@ -237,6 +300,38 @@ extern const struct event_type __stop_event_types[];
 #define EVENT_TYPE_DYNDATA_DECLARE(ename) _EVENT_TYPE_DYNDATA_DECLARE(ename)
 
 
+/** Assign an event type to a dispatch class.
+ *
+ * The macro can be passed as an optional argument of @ref EVENT_TYPE_DEFINE.
+ * Events of a given type are processed in the context of the work queue
+ * assigned to the dispatch class. Event types that do not specify the
+ * dispatch class are assigned to class 0.
+ *
+ * @param dclass  Dispatch class index, lower than
+ *                CONFIG_EVENT_MANAGER_DISPATCH_CLASS_CNT.
+ */
+#define EVENT_DISPATCH_CLASS(dclass) .dispatch_class = (dclass)
+
+
+/** Enable coalescing of events of a given type.
+ *
+ * The macro can be passed as an optional argument of @ref EVENT_TYPE_DEFINE.
+ * If CONFIG_EVENT_MANAGER_EVENT_COALESCING is enabled and an event of the
+ * same type is already waiting to be processed, the submitted event is
+ * passed to the coalescing function together with the pending event.
+ * If the function returns true, the function has merged the submitted
+ * event into the pending event (for example, by replacing or accumulating
+ * its data) and the submitted event is freed without being processed.
+ * If the function returns false, the submitted event is queued.
+ *
+ * The coalescing function is called with the Event Manager lock held and
+ * must not modify the event header.
+ *
+ * @param coalesce_fn  Function used to coalesce events.
+ */
+#define EVENT_COALESCE(coalesce_fn) .coalesce = (coalesce_fn)
+
+
 /** Define an event type.
  *
  * This macro defines an event type. In addition, it defines functions
@@ -255,10 +350,37 @@ extern const struct event_type __stop_event_types[];
  * @param init_log_en	   Bool indicating if the event is logged
  *                         by default.
  * @param log_fn  	   Function to stringify an event of this type.
- * @param ev_info_struct   Data structure describing the event type.
+ * @param ...              Data structure describing the event type
+ *                         (ev_info_struct), optionally followed by event
+ *                         type properties, for example
+ *                         @ref EVENT_DISPATCH_CLASS or @ref EVENT_COALESCE.
+ */
+#define EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ...) \
+	_EVENT_TYPE_DEFINE(ename, CONFIG_EVENT_MANAGER_EVENT_POOL_BLOCK_CNT, \
+			   init_log_en, log_fn, __VA_ARGS__)
+
+
+/** Define an event type with a memory pool of a given size.
+ *
+ * This macro works like @ref EVENT_TYPE_DEFINE, but if
+ * CONFIG_EVENT_MANAGER_EVENT_POOL is enabled, the memory pool of the event
+ * type holds @p pool_size events instead of
+ * CONFIG_EVENT_MANAGER_EVENT_POOL_BLOCK_CNT. Use it for event types that are
+ * submitted in bursts, or set @p pool_size to 0 for event types that are
+ * rare or that do not fit in the pool because of their dynamic data, so
+ * that they are allocated only from the shared pools.
+ *
+ * @param ename     	   Name of the event.
+ * @param pool_size	   Number of events in the memory pool of the type.
+ * @param init_log_en	   Bool indicating if the event is logged
+ *                         by default.
+ * @param log_fn  	   Function to stringify an event of this type.
+ * @param ...              Data structure describing the event type
+ *                         (ev_info_struct), optionally followed by event
+ *                         type properties, as for @ref EVENT_TYPE_DEFINE.
  */
-#define EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct) \
-	_EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct)
+#define EVENT_TYPE_POOL_DEFINE(ename, pool_size, init_log_en, log_fn, ...) \
+	_EVENT_TYPE_DEFINE(ename, pool_size, init_log_en, log_fn, __VA_ARGS__)
 
 
 /** Verify if an event ID is valid.
@@ -289,6 +411,15 @@ void _event_submit(struct event_header *eh);
 #define EVENT_SUBMIT(event) _event_submit(&event->header)
 
 
+/** Free an event that was allocated, but not submitted.
+ *
+ * Submitted events are freed by the Event Manager after they are processed.
+ *
+ * @param eh  Pointer to the event header element in the event object.
+ */
+void event_manager_free(struct event_header *eh);
+
+
 /** Initialize the Event Manager.
  *
  * @retval 0 If the operation was successful.
@@ -296,6 +427,36 @@ void _event_submit(struct event_header *eh);
 int event_manager_init(void);
 
 
+/** Set the work queue used to process events of a dispatch class.
+ *
+ * By default, events of every dispatch class are processed by the system
+ * work queue. The function should be called before events of the given
+ * dispatch class are submitted.
+ *
+ * @param dispatch_class  Dispatch class index.
+ * @param work_q          Work queue or NULL to use the system work queue.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL If the dispatch class is invalid.
+ */
+int event_manager_dispatch_class_queue_set(uint8_t dispatch_class,
+					   struct k_work_q *work_q);
+
+
+#ifdef CONFIG_EVENT_MANAGER_DISPATCH_STATS
+/** Get dispatch statistics of a dispatch class.
+ *
+ * @param dispatch_class  Dispatch class index.
+ * @param stats           Pointer to the structure filled with statistics.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL If the dispatch class is invalid.
+ */
+int event_manager_dispatch_stats_get(uint8_t dispatch_class,
+				     struct event_dispatch_stats *stats);
+#endif /* CONFIG_EVENT_MANAGER_DISPATCH_STATS */
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,6 +23,7 @@ extern "C" {
 
 #include <zephyr/types.h>
 #include <stddef.h>
+#include <stdbool.h>
 
 /**
  * @brief AT command return codes
@@ -132,6 +133,65 @@ int at_cmd_write(const char *const cmd,
 		 size_t buf_len,
 		 enum at_cmd_state *state);
 
+/**
+ * @brief AT command in a batch.
+ */
+struct at_cmd_batch_cmd {
+	/** Null terminated AT command. */
+	const char *cmd;
+	/** Handler that processes the response, or NULL. */
+	at_cmd_handler_t callback;
+	/** State of the command, set by @ref at_cmd_batch_write. */
+	enum at_cmd_state state;
+	/** Return code of the command, as returned by @ref at_cmd_write.
+	 *  -ECANCELED if the command was not executed.
+	 */
+	int code;
+	/** Time from writing the command to receiving the response, in
+	 *  microseconds.
+	 */
+	uint32_t time_us;
+};
+
+/**
+ * @brief Batch of AT commands.
+ */
+struct at_cmd_batch {
+	/** Commands of the batch. */
+	struct at_cmd_batch_cmd *cmds;
+	/** Number of commands. */
+	size_t count;
+	/** Do not execute the rest of the batch if a command fails. */
+	bool stop_on_error;
+	/** Number of commands executed, set by @ref at_cmd_batch_write. */
+	size_t executed;
+	/** Time to execute the batch, in microseconds. */
+	uint32_t time_us;
+};
+
+/**
+ * @brief Function to send a batch of AT commands to the modem
+ *
+ * The commands are queued at once and written to the modem back to back from
+ * the AT command thread, each as soon as the response to the previous command
+ * is received. Commands of other users are not executed in between. The
+ * response to each command is passed to the callback of the command.
+ *
+ * This function blocks until the batch has been executed. The state, return
+ * code and execution time of each command are then stored in the batch.
+ *
+ * @note The callbacks run from at_cmd's thread. They must not call
+ *       at_cmd_write, as that would lead to a deadlock.
+ *
+ * @param batch Batch of commands. Must stay valid until the function returns.
+ *
+ * @retval 0 If all the executed commands were successful.
+ * @retval -EINVAL If the batch or one of its commands is invalid.
+ * @retval -EHOSTDOWN is returned if the Modem library is shutdown.
+ * @return Otherwise, the return code of the first command that failed.
+ */
+int at_cmd_batch_write(struct at_cmd_batch *batch);
+
 /**
  * @brief Function to set AT command global notification handler
  *
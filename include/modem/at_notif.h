@@ -63,9 +63,42 @@ int at_notif_init(void);
  */
 int at_notif_register_handler(void *context, at_notif_handler_t handler);
 
+/**
+ * @brief Function to register AT command notification handler for a set of
+ *        notification prefixes
+ *
+ * The handler is called only for the notifications that start with one of
+ * the given prefixes, followed by a colon or the end of the notification.
+ * For example, a handler registered for "+CEREG" receives "+CEREG: 1", but
+ * not "+CEREGX: 1".
+ *
+ * @note  If the same combination of context and handler exists in the memory,
+ *        then the request will be ignored and command execution will be
+ *        regarded as finished successfully.
+ *
+ * @param context      Pointer to context provided by the module which has
+ *                     registered the handler.
+ * @param handler      Pointer to a received notification handler function of
+ *                     type @ref at_notif_handler_t.
+ * @param prefixes     Notification prefixes, for example "+CEREG". The array
+ *                     and the strings must stay valid until the handler is
+ *                     de-registered.
+ * @param prefix_count Number of prefixes.
+ *
+ * @retval 0            If command execution was successful.
+ * @retval -ENOBUFS     If memory cannot be allocated.
+ * @retval -EINVAL      If handler is a NULL pointer, or a prefix is invalid.
+ */
+int at_notif_register_prefix_handler(void *context, at_notif_handler_t handler,
+				     const char *const *prefixes,
+				     size_t prefix_count);
+
 /**
  * @brief Function to de-register AT command notification handler
  *
+ * The handler is not called anymore when this function returns. It can be
+ * called from the handler itself.
+ *
  * @param context Pointer to context provided by the module which has
  *                registered the handler.
  * @param handler Pointer to a received notification handler function of type
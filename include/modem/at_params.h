@@ -22,10 +22,16 @@
  * All parameters values are copied in the list. Parameters should be
  * cleared to free that memory. Getter and setter methods are available
  * to read and write parameter values.
+ *
+ * Alternatively, a list can store the parameters as views into the parsed
+ * string, in parameter storage provided by the caller. Such a list does not
+ * use the heap, and numeric values are decoded only when they are read.
+ * See @ref at_params_list_init_views.
  */
 #ifndef AT_PARAMS_H__
 #define AT_PARAMS_H__
 
+#include <stdbool.h>
 #include <zephyr/types.h>
 
 #ifdef __cplusplus
@@ -54,6 +60,8 @@ union at_param_value {
 	char *str_val;
 	/** Array of uint32_t */
 	uint32_t *array_val;
+	/** Start of the parameter in the parsed string. */
+	const char *view;
 };
 
 /** @brief A parameter is defined with a type, length and value. */
@@ -72,6 +80,8 @@ struct at_param {
 struct at_param_list {
 	size_t param_count;
 	struct at_param *params;
+	/** Parameters are stored as views into the parsed string. */
+	bool views;
 };
 
 /**
@@ -90,6 +100,27 @@ struct at_param_list {
  */
 int at_params_list_init(struct at_param_list *list, size_t max_params_count);
 
+/**
+ * @brief Create a list of parameters stored as views into the parsed string.
+ *
+ * The list uses the array of @p max_params_count parameters provided by the
+ * caller, and no memory is allocated. Strings are not copied, but refer to
+ * the parsed string, which must not be modified or freed while the
+ * parameters are read. Numbers and arrays are decoded when they are read.
+ *
+ * @ref at_params_list_free does not need to be called for such a list.
+ *
+ * @param[in] list Parameter list to initialize.
+ * @param[in] params Storage for the parameters.
+ * @param[in] max_params_count Number of parameters in @p params.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_params_list_init_views(struct at_param_list *list,
+			      struct at_param *params,
+			      size_t max_params_count);
+
 /**
  * @brief Clear/reset all parameter types and values.
  *
@@ -129,6 +160,8 @@ int at_params_int_put(const struct at_param_list *list, size_t index, int64_t va
  *
  * The parameter string value is copied and added to the list as a
  * null-terminated string. If a parameter exists at this index, it is replaced.
+ * If the list stores views, the string is not copied and must remain valid
+ * while the list is used.
  *
  * @param[in] list    Parameter list.
  * @param[in] index   Index in the list where to put the parameter.
@@ -159,10 +192,32 @@ int at_params_string_put(const struct at_param_list *list, size_t index,
  *
  * @retval 0 If the operation was successful.
  *           Otherwise, a (negative) error code is returned.
+ * @retval -ENOTSUP If the list stores views.
  */
 int at_params_array_put(const struct at_param_list *list, size_t index,
 			const uint32_t *array, size_t array_len);
 
+/**
+ * @brief Add a parameter in the list at the specified index as a view into
+ * the parsed string.
+ *
+ * The value is not decoded nor copied. Numbers are decoded when they are
+ * read. Arrays are given without the enclosing brackets, for example
+ * "1,2,3". Only lists that store views support this function.
+ *
+ * @param[in] list    Parameter list.
+ * @param[in] index   Index in the list where to put the parameter.
+ * @param[in] type    Parameter type.
+ * @param[in] str     Start of the parameter in the parsed string.
+ * @param[in] str_len Number of characters of the parameter.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_params_view_put(const struct at_param_list *list, size_t index,
+		       enum at_param_type type, const char *str,
+		       size_t str_len);
+
 /**
  * @brief Add a parameter in the list at the specified index and assign it a
  * empty status.
@@ -276,6 +331,24 @@ int at_params_int64_get(const struct at_param_list *list, size_t index, int64_t
 int at_params_string_get(const struct at_param_list *list, size_t index,
 			 char *value, size_t *len);
 
+/**
+ * @brief Get a pointer to a string parameter value, without copying it.
+ *
+ * The parameter type must be a string, or an error is returned.
+ * The string is not null-terminated. It is valid until the parameter is
+ * cleared or, if the list stores views, while the parsed string is valid.
+ *
+ * @param[in]  list    Parameter list.
+ * @param[in]  index   Parameter index in the list.
+ * @param[out] value   Pointer to the string value.
+ * @param[out] len     Length of the string value in bytes.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_params_string_ptr_get(const struct at_param_list *list, size_t index,
+			     const char **value, size_t *len);
+
 /**
  * @brief Get a parameter value as a array.
  *
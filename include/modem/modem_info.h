@@ -120,6 +120,17 @@ struct modem_param_info {
 	struct device_param  device;/**< Device parameters. */
 };
 
+/**@brief Modem information statistics. */
+struct modem_info_stats {
+	uint32_t values; /**< Number of values requested. */
+	uint32_t cache_hits; /**< Number of responses taken from the cache. */
+	uint32_t at_cmds; /**< Number of AT commands sent to the modem. */
+	/** Total time waiting for responses from the modem, in microseconds. */
+	uint64_t latency_total_us;
+	/** Longest time waiting for a response from the modem, in microseconds. */
+	uint32_t latency_max_us;
+};
+
 /** @brief Initialize the modem information module.
  *
  * @retval 0 If the operation was successful.
@@ -175,6 +186,42 @@ int modem_info_string_get(enum modem_info info, char *buf,
  */
 int modem_info_short_get(enum modem_info info, uint16_t *buf);
 
+/** @brief Request the current modem status of several information values.
+ *
+ * Each AT command is sent once, also when several of the requested values
+ * are read from its response. Values of the string type are stored in
+ * the value_string member of the parameter, and other values in the value
+ * member.
+ *
+ * All values are requested, also when some of them cannot be obtained.
+ *
+ * @param params Parameters to obtain, with the information type set.
+ * @param count  Number of parameters.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, the (negative) error code of the first value that
+ *           could not be obtained is returned.
+ */
+int modem_info_batch_get(struct lte_param *const params[], size_t count);
+
+/** @brief Clear the cached modem responses.
+ *
+ * Values that do not change while the modem is running, such as the modem
+ * firmware version, are cached until this function is called. Call it when
+ * such values may have changed, for example after a modem firmware update
+ * or a SIM card change.
+ */
+void modem_info_cache_clear(void);
+
+/** @brief Get the modem information statistics.
+ *
+ * @param stats Where to store the statistics.
+ */
+void modem_info_stats_get(struct modem_info_stats *stats);
+
+/** @brief Reset the modem information statistics. */
+void modem_info_stats_reset(void);
+
 /** @brief Request the name of a modem information data type.
  *
  * @param info The requested information type.
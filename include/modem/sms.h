@@ -40,6 +40,18 @@ enum sms_type {
  */
 #define SMS_MAX_PAYLOAD_LEN_CHARS 160
 
+/**
+ * @brief Length of the payload buffer of received SMS messages in number of characters.
+ *
+ * @details When reassembly of concatenated messages is enabled, the buffer holds
+ * a complete message consisting of up to CONFIG_SMS_CONCAT_MAX_PARTS parts.
+ */
+#if defined(CONFIG_SMS_CONCAT_REASSEMBLY)
+#define SMS_PAYLOAD_BUF_LEN_CHARS (CONFIG_SMS_CONCAT_MAX_PARTS * SMS_MAX_PAYLOAD_LEN_CHARS)
+#else
+#define SMS_PAYLOAD_BUF_LEN_CHARS SMS_MAX_PAYLOAD_LEN_CHARS
+#endif
+
 /**
  * @brief Maximum length of SMS address, i.e., phone number, in characters
  * as specified in 3GPP TS 23.040 Section 9.1.2.3.
@@ -86,7 +98,11 @@ struct sms_udh_concat {
 	uint16_t ref_number;
 	/** @brief Maximum number of short messages in the concatenated short message. */
 	uint8_t total_msgs;
-	/** @brief Sequence number of the current short message. */
+	/**
+	 * @brief Sequence number of the current short message.
+	 *
+	 * @details Zero for a message reassembled from all of its parts.
+	 */
 	uint8_t seq_number;
 };
 
@@ -149,8 +165,11 @@ struct sms_data {
 	 * However, header may contain information that determines it for specific purpose,
 	 * e.g., via application port information, in which case it should be treated as
 	 * specified for that purpose.
+	 *
+	 * When reassembly of concatenated messages is enabled, a concatenated message is
+	 * delivered once with the payload of all parts.
 	 */
-	uint8_t payload[SMS_MAX_PAYLOAD_LEN_CHARS + 1];
+	uint8_t payload[SMS_PAYLOAD_BUF_LEN_CHARS + 1];
 };
 
 /** @brief SMS listener callback function. */
@@ -66,6 +66,8 @@ enum download_client_evt_id {
 struct download_fragment {
 	const void *buf;
 	size_t len;
+	/** Offset of the fragment in the file. */
+	size_t offset;
 };
 
 /**
@@ -119,6 +121,12 @@ struct download_client_cfg {
  * If the callback returns a non-zero value, the download stops.
  * To resume the download, use @ref download_client_start().
  *
+ * If @option{CONFIG_DOWNLOAD_CLIENT_FRAGMENT_BUF_CNT} is greater than one,
+ * @ref DOWNLOAD_CLIENT_EVT_FRAGMENT events are sent from a separate thread,
+ * while the next fragments are received. The buffer of the fragment is valid
+ * until the callback returns. Other events are sent after all the preceding
+ * fragments were handled. The callback is never called concurrently.
+ *
  * @param[in] event	The event.
  *
  * @return Zero to continue the download, non-zero otherwise.
@@ -132,8 +140,11 @@ typedef int (*download_client_callback_t)(
 struct download_client {
 	/** Socket descriptor. */
 	int fd;
-	/** Response buffer. */
-	char buf[CONFIG_DOWNLOAD_CLIENT_BUF_SIZE];
+	/** Fragment buffers. */
+	char fragment_buf[CONFIG_DOWNLOAD_CLIENT_FRAGMENT_BUF_CNT]
+			 [CONFIG_DOWNLOAD_CLIENT_BUF_SIZE];
+	/** Response buffer, one of the fragment buffers. */
+	char *buf;
 	/** Buffer offset. */
 	size_t offset;
 
@@ -141,6 +152,10 @@ struct download_client {
 	size_t file_size;
 	/** Download progress, number of bytes downloaded. */
 	size_t progress;
+	/** End of the range being downloaded, zero when downloading
+	 *  up to the end of the file.
+	 */
+	size_t range_end;
 
 	/** Server hosting the file, null-terminated. */
 	const char *host;
@@ -159,6 +174,18 @@ struct download_client {
 		bool has_header;
 		/** The server has closed the connection. */
 		bool connection_close;
+		/** Payload length of the current response,
+		 *  when using range requests.
+		 */
+		size_t body_len;
+		/** Number of bytes of the next response, which were
+		 *  received together with the current fragment.
+		 */
+		size_t carry_len;
+		/** Offset of the next range to request. */
+		size_t range_offset;
+		/** Number of range requests waiting for a response. */
+		uint8_t requests_pending;
 	} http;
 
 	struct {
@@ -166,6 +193,10 @@ struct download_client {
 		struct coap_block_context block_ctx;
 	} coap;
 
+	/** Given by the download thread when it has stopped. */
+	struct k_sem idle;
+	/** Given to let the download thread start a download. */
+	struct k_sem start;
 	/** Internal thread ID. */
 	k_tid_t tid;
 	/** Internal download thread. */
@@ -174,6 +205,25 @@ struct download_client {
 	K_THREAD_STACK_MEMBER(thread_stack,
 			      CONFIG_DOWNLOAD_CLIENT_STACK_SIZE);
 
+#if CONFIG_DOWNLOAD_CLIENT_FRAGMENT_BUF_CNT > 1
+	/** Fragments waiting to be handed to the application. */
+	struct k_msgq fragment_q;
+	/** Fragment queue storage. */
+	struct download_fragment
+		fragment_q_buf[CONFIG_DOWNLOAD_CLIENT_FRAGMENT_BUF_CNT];
+	/** Number of fragment buffers that can be used for reception. */
+	struct k_sem fragment_free;
+	/** Index of the fragment buffer used for reception. */
+	uint8_t fragment_idx;
+	/** The application has refused a fragment. */
+	bool fragment_refused;
+	/** Internal thread handing fragments to the application. */
+	struct k_thread fragment_thread;
+	/* Internal fragment thread stack. */
+	K_THREAD_STACK_MEMBER(fragment_thread_stack,
+			      CONFIG_DOWNLOAD_CLIENT_STACK_SIZE);
+#endif
+
 	/** Event handler. */
 	download_client_callback_t callback;
 };
@@ -222,6 +272,25 @@ int download_client_connect(struct download_client *client, const char *host,
 int download_client_start(struct download_client *client, const char *file,
 			  size_t from);
 
+/**
+ * @brief Download a range of a file.
+ *
+ * Works like @ref download_client_start, but downloads only the bytes from
+ * @p from up to, but not including, @p to. HTTP range requests are used
+ * regardless of @option{CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS}.
+ * The download completes when the whole range is downloaded.
+ * Only HTTP and HTTPS are supported.
+ *
+ * @param[in] client	Client instance.
+ * @param[in] file	File to download, null-terminated.
+ * @param[in] from	Offset of the first byte to download.
+ * @param[in] to	Offset of the end of the range.
+ *
+ * @retval int Zero on success, a negative error code otherwise.
+ */
+int download_client_range_start(struct download_client *client,
+				const char *file, size_t from, size_t to);
+
 /**
  * @brief Pause the download.
  *
@@ -257,6 +326,98 @@ int download_client_file_size_get(struct download_client *client, size_t *size);
  */
 int download_client_disconnect(struct download_client *client);
 
+#if defined(CONFIG_DOWNLOAD_CLIENT_MULTI_RANGE)
+/**
+ * @brief Multi-range download instance.
+ */
+struct download_client_multi {
+	/** Download clients, one for every range. */
+	struct download_client client[CONFIG_DOWNLOAD_CLIENT_MULTI_RANGE_CNT];
+	/** Offset up to which the data of every range has been delivered
+	 *  to the application. The download is resumed from these offsets.
+	 */
+	size_t delivered[CONFIG_DOWNLOAD_CLIENT_MULTI_RANGE_CNT];
+	/** Server hosting the file, null-terminated. */
+	const char *host;
+	/** File name, null-terminated. */
+	const char *file;
+	/** Configuration options. */
+	struct download_client_cfg config;
+	/** Number of ranges which are not downloaded yet. */
+	uint8_t ranges_left;
+	/** The application has stopped the download. */
+	bool stopped;
+	/** Serializes calls to the event handler. */
+	struct k_mutex lock;
+	/** Event handler. */
+	download_client_callback_t callback;
+};
+
+/**
+ * @brief Initialize the multi-range download.
+ *
+ * @param[in] dlm	Multi-range download instance.
+ * @param[in] callback	Callback function.
+ *
+ * @retval int Zero on success, otherwise a negative error code.
+ */
+int download_client_multi_init(struct download_client_multi *dlm,
+			       download_client_callback_t callback);
+
+/**
+ * @brief Download a file as several ranges in parallel.
+ *
+ * The file is split into @option{CONFIG_DOWNLOAD_CLIENT_MULTI_RANGE_CNT}
+ * ranges, which are downloaded over separate connections to the server.
+ * The fragments of all ranges are delivered to the application as they are
+ * received, so the application must use the offset of every fragment.
+ * The @ref DOWNLOAD_CLIENT_EVT_DONE event is sent when all ranges are
+ * downloaded. Errors are reported for every range separately. Returning
+ * zero lets the download client reconnect and resume the range.
+ *
+ * The callback is never called concurrently. Only one multi-range download
+ * can be in progress at a time.
+ *
+ * @param[in] dlm	Multi-range download instance.
+ * @param[in] host	Name of the host to connect to, null-terminated.
+ * @param[in] config	Configuration options.
+ * @param[in] file	File to download, null-terminated.
+ * @param[in] file_size	Size of the file, in bytes.
+ *
+ * @retval int Zero on success, a negative error code otherwise.
+ */
+int download_client_multi_start(struct download_client_multi *dlm,
+				const char *host,
+				const struct download_client_cfg *config,
+				const char *file, size_t file_size);
+
+/**
+ * @brief Resume a stopped multi-range download.
+ *
+ * Reconnects to the server and downloads the remaining part of every range
+ * which is not complete. Every range is resumed from the end of the last
+ * fragment that the application has accepted, so fragments that were
+ * received, but not delivered, are downloaded again.
+ *
+ * Ranges which are still being downloaded are stopped first, and the function
+ * blocks until the download threads of all ranges have stopped, so that no
+ * event of the previous download is delivered after the download is resumed.
+ * Therefore, it must not be called from the event callback.
+ *
+ * @param[in] dlm	Multi-range download instance.
+ *
+ * @retval int Zero on success, a negative error code otherwise.
+ */
+int download_client_multi_resume(struct download_client_multi *dlm);
+
+/**
+ * @brief Disconnect all connections of the multi-range download.
+ *
+ * @param[in] dlm	Multi-range download instance.
+ */
+void download_client_multi_disconnect(struct download_client_multi *dlm);
+#endif /* CONFIG_DOWNLOAD_CLIENT_MULTI_RANGE */
+
 #ifdef __cplusplus
 }
 #endif
@@ -41,6 +41,12 @@ struct cmd_item  {
 	at_cmd_handler_t callback;	/* Callback to execute on result */
 	size_t resp_size;		/* Size of response buffer */
 	enum at_cmd_flags flags;	/* Flags describing the request */
+	struct at_cmd_batch *batch;	/* Batch of the command, or NULL */
+	size_t index;			/* Index of the command in the batch */
+	bool written;			/* Command is written to the socket */
+	uint32_t start;			/* Cycle count when the command was
+					 * written
+					 */
 };
 
 /* Metadata for an AT response */
@@ -183,9 +189,46 @@ static void complete_cmd(void)
 {
 	k_mutex_lock(&current_cmd_mutex, K_FOREVER);
 	current_cmd.cmd = NULL;
+	current_cmd.batch = NULL;
 	k_mutex_unlock(&current_cmd_mutex);
 }
 
+static uint32_t cmd_time_us(void)
+{
+	return k_cyc_to_us_floor32(k_cycle_get_32() - current_cmd.start);
+}
+
+/*
+ * Store the result of the current command of a batch, and load the next
+ * command of the batch, if any. The loaded command is written by
+ * load_cmd_and_write(). Must be called with current_cmd_mutex locked.
+ *
+ * Returns true if a command was loaded, false if the batch is complete.
+ */
+static bool batch_cmd_complete(const struct resp_item *resp)
+{
+	struct at_cmd_batch *batch = current_cmd.batch;
+	struct at_cmd_batch_cmd *item = &batch->cmds[current_cmd.index];
+
+	item->state = resp->state;
+	item->code = resp->code;
+	item->time_us = cmd_time_us();
+	batch->executed++;
+
+	if (((resp->state != AT_CMD_OK) && batch->stop_on_error) ||
+	    (current_cmd.index + 1 == batch->count)) {
+		return false;
+	}
+
+	current_cmd.index++;
+	/* This cast is safe; we do not free cmd without AT_CMD_BUF_CMD */
+	current_cmd.cmd = (char *)batch->cmds[current_cmd.index].cmd;
+	current_cmd.callback = batch->cmds[current_cmd.index].callback;
+	current_cmd.written = false;
+
+	return true;
+}
+
 /*
  * Atomically load a new command if appropriate, then write it to the socket.
  * The operations are repeated until the queue is empty or a command is pending
@@ -201,12 +244,22 @@ static void load_cmd_and_write(void)
 	do {
 		ret = 0;
 
-		/* Do not load a new command if already loaded or none queued */
-		if (current_cmd.cmd != NULL ||
+		/* Do not write a command if one is pending a response */
+		if (current_cmd.cmd != NULL && current_cmd.written) {
+			break;
+		}
+
+		/* Load a new command unless the next command of a batch is
+		 * already loaded.
+		 */
+		if (current_cmd.cmd == NULL &&
 		    k_msgq_get(&commands, &current_cmd, K_NO_WAIT) != 0) {
 			break;
 		}
 
+		current_cmd.written = true;
+		current_cmd.start = k_cycle_get_32();
+
 		ret = at_write(current_cmd.cmd);
 
 		if (current_cmd.flags & AT_CMD_BUF_CMD) {
@@ -217,6 +270,10 @@ static void load_cmd_and_write(void)
 		if (ret != 0) {
 			resp.state = AT_CMD_ERROR_WRITE;
 			resp.code = ret;
+			if (current_cmd.batch != NULL &&
+			    batch_cmd_complete(&resp)) {
+				continue;
+			}
 			if (current_cmd.flags & AT_CMD_SYNC) {
 				k_msgq_put(&response_sync, &resp, K_FOREVER);
 			}
@@ -324,6 +381,24 @@ static void socket_thread_fn(void *arg1, void *arg2, void *arg3)
 		}
 
 next:
+		if (current_cmd.cmd != NULL && ret.state != AT_CMD_NOTIFICATION) {
+			LOG_DBG("Response received in %u us", cmd_time_us());
+		}
+
+		/* Continue with the next command of a batch, if any */
+		if (current_cmd.cmd != NULL && current_cmd.batch != NULL &&
+		    ret.state != AT_CMD_NOTIFICATION) {
+			bool loaded;
+
+			k_mutex_lock(&current_cmd_mutex, K_FOREVER);
+			loaded = batch_cmd_complete(&ret);
+			k_mutex_unlock(&current_cmd_mutex);
+
+			if (loaded) {
+				continue;
+			}
+		}
+
 		/* Dispatch response for sync call */
 		if (current_cmd.cmd != NULL &&
 		    current_cmd.flags & AT_CMD_SYNC &&
@@ -368,6 +443,8 @@ int at_cmd_write_with_callback(const char *const cmd,
 	command.resp = NULL;
 	command.callback = handler;
 	command.flags = AT_CMD_BUF_CMD;
+	command.batch = NULL;
+	command.written = false;
 
 	ret = k_msgq_put(&commands, &command, K_FOREVER);
 	if (ret) {
@@ -415,6 +492,8 @@ int at_cmd_write(const char *const cmd,
 	command.resp_size = buf_len;
 	command.callback = NULL;
 	command.flags = AT_CMD_SYNC;
+	command.batch = NULL;
+	command.written = false;
 
 	/* Ensure we get our own AT response, not an old one */
 	k_mutex_lock(&response_sync_get, K_FOREVER);
@@ -442,6 +521,82 @@ int at_cmd_write(const char *const cmd,
 	return ret.code;
 }
 
+int at_cmd_batch_write(struct at_cmd_batch *batch)
+{
+	struct cmd_item command;
+	struct resp_item ret;
+	uint32_t start;
+
+	if (atomic_get(&shutdown_mode) == 1) {
+		return -EHOSTDOWN;
+	}
+
+	__ASSERT(k_current_get() != socket_tid,
+		 "at_cmd deadlock: socket thread blocking self\n");
+
+	if (batch == NULL || batch->cmds == NULL || batch->count == 0) {
+		LOG_ERR("Invalid batch");
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < batch->count; i++) {
+		if (check_cmd(batch->cmds[i].cmd)) {
+			LOG_ERR("Invalid command at index %d", (int)i);
+			return -EINVAL;
+		}
+
+		/* Commands skipped because of an error keep this state. */
+		batch->cmds[i].state = AT_CMD_ERROR_QUEUE;
+		batch->cmds[i].code = -ECANCELED;
+		batch->cmds[i].time_us = 0;
+	}
+
+	batch->executed = 0;
+
+	/* This cast is safe; we do not free cmd without AT_CMD_BUF_CMD */
+	command.cmd = (char *)batch->cmds[0].cmd;
+	command.resp = NULL;
+	command.resp_size = 0;
+	command.callback = batch->cmds[0].callback;
+	command.flags = AT_CMD_SYNC;
+	command.batch = batch;
+	command.index = 0;
+	command.written = false;
+
+	/* Ensure we get our own AT response, not an old one */
+	k_mutex_lock(&response_sync_get, K_FOREVER);
+
+	start = k_cycle_get_32();
+
+	ret.code = k_msgq_put(&commands, &command, K_FOREVER);
+	if (ret.code) {
+		LOG_ERR("Could not enqueue batch, error %d", ret.code);
+		k_mutex_unlock(&response_sync_get);
+		return ret.code;
+	}
+
+	load_cmd_and_write();
+
+	/* The socket thread writes the commands of the batch back to back,
+	 * and responds when all of them have been executed.
+	 */
+	k_msgq_get(&response_sync, &ret, K_FOREVER);
+	k_mutex_unlock(&response_sync_get);
+
+	batch->time_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	LOG_DBG("Executed %d of %d commands in %u us", (int)batch->executed,
+		(int)batch->count, batch->time_us);
+
+	for (size_t i = 0; i < batch->executed; i++) {
+		if (batch->cmds[i].state != AT_CMD_OK) {
+			return batch->cmds[i].code;
+		}
+	}
+
+	return 0;
+}
+
 void at_cmd_set_notification_handler(at_cmd_handler_t handler)
 {
 	LOG_DBG("Setting notification handler to %p", handler);
@@ -17,13 +17,6 @@
 
 #define AT_CMD_MAX_ARRAY_SIZE 32
 
-#define AT_CMD_CGEV_LEN         5
-#define AT_CMD_CPIN_LEN         5
-#define AT_CMD_SHORTSWVER_LEN   11
-#define AT_CMD_HWVERSION_LEN    10
-#define AT_CMD_XMODEMUUID_LEN   11
-#define AT_CMD_XICCID_LEN       7
-
 enum at_parser_state {
 	IDLE,
 	ARRAY,
@@ -37,20 +30,49 @@ enum at_parser_state {
 	CLAC,
 };
 
-static enum at_parser_state state;
+/* Parser context. Kept on the stack of the caller, so that several threads
+ * can parse at the same time.
+ */
+struct at_parser {
+	enum at_parser_state state;
+	bool set_type_string;
+};
+
+/* The parameters of the response are all parsed as strings. */
+#define AT_PREFIX_FORCED_STRING BIT(0)
 
-static bool set_type_string;
+struct at_prefix {
+	const char *str;
+	uint8_t len;
+	uint8_t flags;
+};
+
+#define AT_PREFIX(_str, _flags) \
+	{ .str = _str, .len = sizeof(_str) - 1, .flags = _flags }
 
-static inline void set_new_state(enum at_parser_state new_state)
+/* Known notification and response prefixes. The table must be sorted in
+ * strcmp() order, and no prefix can be a prefix of another entry.
+ */
+static const struct at_prefix prefixes[] = {
+	AT_PREFIX("%HWVERSION", AT_PREFIX_FORCED_STRING),
+	AT_PREFIX("%SHORTSWVER", AT_PREFIX_FORCED_STRING),
+	AT_PREFIX("%XICCID", AT_PREFIX_FORCED_STRING),
+	AT_PREFIX("%XMODEMUUID", AT_PREFIX_FORCED_STRING),
+	AT_PREFIX("+CGEV", AT_PREFIX_FORCED_STRING),
+	AT_PREFIX("+CPIN", AT_PREFIX_FORCED_STRING),
+};
+
+static inline void set_new_state(struct at_parser *parser,
+				 enum at_parser_state new_state)
 {
-	state = new_state;
+	parser->state = new_state;
 }
 
-static inline void reset_state(void)
+static inline void reset_state(struct at_parser *parser)
 {
-	state = IDLE;
+	parser->state = IDLE;
 
-	set_type_string = false;
+	parser->set_type_string = false;
 }
 
 static inline void skip_command_prefix(const char **cmd)
@@ -64,23 +86,37 @@ static inline void skip_command_prefix(const char **cmd)
 	(*cmd)++;
 }
 
-static inline bool check_response_for_forced_string(const char *tmpstr)
+/* Binary search for the table entry that is a prefix of the string. */
+static const struct at_prefix *prefix_find(const char *str)
 {
-	bool retval = false;
-
-	if (!strncmp(tmpstr, "+CGEV", AT_CMD_CGEV_LEN) ||
-	    !strncmp(tmpstr, "+CPIN", AT_CMD_CPIN_LEN) ||
-	    !strncmp(tmpstr, "%SHORTSWVER", AT_CMD_SHORTSWVER_LEN) ||
-	    !strncmp(tmpstr, "%HWVERSION", AT_CMD_HWVERSION_LEN) ||
-	    !strncmp(tmpstr, "%XMODEMUUID", AT_CMD_XMODEMUUID_LEN) ||
-	    !strncmp(tmpstr, "%XICCID", AT_CMD_XICCID_LEN)) {
-			retval = true;
+	size_t lo = 0;
+	size_t hi = ARRAY_SIZE(prefixes);
+
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		int cmp = strncmp(str, prefixes[mid].str, prefixes[mid].len);
+
+		if (cmp == 0) {
+			return &prefixes[mid];
+		} else if (cmp < 0) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
+		}
 	}
 
-	return retval;
+	return NULL;
 }
 
-static int at_parse_detect_type(const char **str, int index)
+static inline bool check_response_for_forced_string(const char *tmpstr)
+{
+	const struct at_prefix *prefix = prefix_find(tmpstr);
+
+	return prefix && (prefix->flags & AT_PREFIX_FORCED_STRING);
+}
+
+static int at_parse_detect_type(struct at_parser *parser, const char **str,
+				int index)
 {
 	const char *tmpstr = *str;
 
@@ -88,29 +124,30 @@ static int at_parse_detect_type(const char **str, int index)
 		/* Only first parameter in the string can be
 		 * notification ID, (eg +CEREG:)
 		 */
-		set_new_state(NOTIFICATION);
+		set_new_state(parser, NOTIFICATION);
 
 		/* Check for responses we know need to be strings */
-		set_type_string = check_response_for_forced_string(tmpstr);
+		parser->set_type_string =
+			check_response_for_forced_string(tmpstr);
 
-	} else if (set_type_string) {
-		set_new_state(STRING);
+	} else if (parser->set_type_string) {
+		set_new_state(parser, STRING);
 	} else if ((index > 0) && is_clac(tmpstr)) {
 		/* Next, check if we deal with CLAC response (eg AT+, AT%)
 		 * NOTE - need to go back to index 0 and parse as CLAC state
 		 * NOTE - AT+CLAC always returns more than one line
 		 */
-		set_new_state(CLAC);
+		set_new_state(parser, CLAC);
 		return -2;
 	} else if ((index == 0) && is_command(tmpstr)) {
 		/* Next, check if we deal with command (eg AT+CCLK) */
-		set_new_state(COMMAND);
+		set_new_state(parser, COMMAND);
 	} else if (index == 0) {
 		/* If the string start without an notification
 		 * ID, we treat the whole string as one string
 		 * parameter
 		 */
-		set_new_state(STRING);
+		set_new_state(parser, STRING);
 	} else if ((index > 0) && is_notification(*tmpstr)) {
 		/* If notifications is detected later in the
 		 * string we should stop parsing and return
@@ -119,15 +156,15 @@ static int at_parse_detect_type(const char **str, int index)
 		*str = tmpstr;
 		return -1;
 	} else if (is_number(*tmpstr)) {
-		set_new_state(NUMBER);
+		set_new_state(parser, NUMBER);
 
 	} else if (is_dblquote(*tmpstr)) {
-		set_new_state(QUOTED_STRING);
+		set_new_state(parser, QUOTED_STRING);
 		tmpstr++;
 	} else if (is_array_start(*tmpstr)) {
-		set_new_state(ARRAY);
+		set_new_state(parser, ARRAY);
 		tmpstr++;
-	} else if (is_lfcr(*tmpstr) && (state == NUMBER)) {
+	} else if (is_lfcr(*tmpstr) && (parser->state == NUMBER)) {
 		/* If \n or \r is detected in the string and the
 		 * previous param was a number we assume the
 		 * next parameter is PDU data
@@ -137,14 +174,14 @@ static int at_parse_detect_type(const char **str, int index)
 			tmpstr++;
 		}
 
-		set_new_state(SMS_PDU);
-	} else if (is_lfcr(*tmpstr) && (state == OPTIONAL)) {
-		set_new_state(OPTIONAL);
+		set_new_state(parser, SMS_PDU);
+	} else if (is_lfcr(*tmpstr) && (parser->state == OPTIONAL)) {
+		set_new_state(parser, OPTIONAL);
 	} else if (is_separator(*tmpstr)) {
 		/* If a separator is detected we have detected
 		 * and empty optional parameter
 		 */
-		set_new_state(OPTIONAL);
+		set_new_state(parser, OPTIONAL);
 	} else {
 		/* The rule set is exhausted, and cannot
 		 * continue. Break the loop and return an error
@@ -157,7 +194,8 @@ static int at_parse_detect_type(const char **str, int index)
 	return 0;
 }
 
-static int at_parse_process_element(const char **str, int index,
+static int at_parse_process_element(struct at_parser *parser,
+				    const char **str, int index,
 				    struct at_param_list *const list)
 {
 	const char *tmpstr = *str;
@@ -166,7 +204,7 @@ static int at_parse_process_element(const char **str, int index,
 		return -1;
 	}
 
-	if (state == NOTIFICATION) {
+	if (parser->state == NOTIFICATION) {
 		const char *start_ptr = tmpstr++;
 
 		while (is_valid_notification_char(*tmpstr)) {
@@ -175,7 +213,7 @@ static int at_parse_process_element(const char **str, int index,
 
 		at_params_string_put(list, index, start_ptr,
 				     tmpstr - start_ptr);
-	} else if (state == COMMAND) {
+	} else if (parser->state == COMMAND) {
 		const char *start_ptr = tmpstr;
 
 		skip_command_prefix(&tmpstr);
@@ -195,10 +233,10 @@ static int at_parse_process_element(const char **str, int index,
 			tmpstr++;
 		}
 
-	} else if (state == OPTIONAL) {
+	} else if (parser->state == OPTIONAL) {
 		at_params_empty_put(list, index);
 
-	} else if (state == STRING) {
+	} else if (parser->state == STRING) {
 		const char *start_ptr = tmpstr;
 
 		while (!is_lfcr(*tmpstr) && !is_terminated(*tmpstr)) {
@@ -209,7 +247,7 @@ static int at_parse_process_element(const char **str, int index,
 				     tmpstr - start_ptr);
 
 		tmpstr++;
-	} else if (state == QUOTED_STRING) {
+	} else if (parser->state == QUOTED_STRING) {
 		const char *start_ptr = tmpstr;
 
 		while (!is_dblquote(*tmpstr) && !is_terminated(*tmpstr)) {
@@ -220,7 +258,19 @@ static int at_parse_process_element(const char **str, int index,
 				     tmpstr - start_ptr);
 
 		tmpstr++;
-	} else if (state == ARRAY) {
+	} else if ((parser->state == ARRAY) && list->views) {
+		const char *start_ptr = tmpstr;
+
+		/* The array is decoded when it is read. */
+		while (!is_array_stop(*tmpstr) && !is_terminated(*tmpstr)) {
+			tmpstr++;
+		}
+
+		at_params_view_put(list, index, AT_PARAM_TYPE_ARRAY, start_ptr,
+				   tmpstr - start_ptr);
+
+		tmpstr++;
+	} else if (parser->state == ARRAY) {
 		char *next;
 		size_t i = 0;
 		uint32_t tmparray[AT_CMD_MAX_ARRAY_SIZE];
@@ -251,14 +301,24 @@ static int at_parse_process_element(const char **str, int index,
 		at_params_array_put(list, index, tmparray, i * sizeof(uint32_t));
 
 		tmpstr++;
-	} else if (state == NUMBER) {
+	} else if ((parser->state == NUMBER) && list->views) {
+		const char *start_ptr = tmpstr++;
+
+		/* The number is decoded when it is read. */
+		while (isdigit((int)*tmpstr)) {
+			tmpstr++;
+		}
+
+		at_params_view_put(list, index, AT_PARAM_TYPE_NUM_INT, start_ptr,
+				   tmpstr - start_ptr);
+	} else if (parser->state == NUMBER) {
 		char *next;
 		int64_t value = (int64_t)strtoll(tmpstr, &next, 10);
 
 		tmpstr = next;
 
 		at_params_int_put(list, index, value);
-	} else if (state == SMS_PDU) {
+	} else if (parser->state == SMS_PDU) {
 		const char *start_ptr = tmpstr;
 
 		while (isxdigit((int)*tmpstr)) {
@@ -267,7 +327,7 @@ static int at_parse_process_element(const char **str, int index,
 
 		at_params_string_put(list, index, start_ptr,
 				     tmpstr - start_ptr);
-	} else if (state == CLAC) {
+	} else if (parser->state == CLAC) {
 		const char *start_ptr = tmpstr;
 
 		while (!is_terminated(*tmpstr)) {
@@ -290,19 +350,20 @@ static int at_parse_param(const char **at_params_str,
 			  struct at_param_list *const list,
 			  const size_t max_params)
 {
+	struct at_parser parser;
 	int index = 0;
 	const char *str = *at_params_str;
 	bool oversized = false;
 	int ret;
 
-	reset_state();
+	reset_state(&parser);
 
 	while ((!is_terminated(*str)) && (index < max_params)) {
 		if (isspace((int)*str)) {
 			str++;
 		}
 
-		ret = at_parse_detect_type(&str, index);
+		ret = at_parse_detect_type(&parser, &str, index);
 		if (ret == -1) {
 			break;
 		}
@@ -312,7 +373,8 @@ static int at_parse_param(const char **at_params_str,
 			index = 0;
 		}
 
-		if (at_parse_process_element(&str, index, list) == -1) {
+		if (at_parse_process_element(&parser, &str, index,
+					     list) == -1) {
 			break;
 		}
 
@@ -327,12 +389,14 @@ static int at_parse_param(const char **at_params_str,
 					break;
 				}
 
-				if (at_parse_detect_type(&str, index) == -1) {
+				if (at_parse_detect_type(&parser, &str,
+							 index) == -1) {
 					break;
 				}
 
-				if (at_parse_process_element(&str, index,
-							     list) == -1) {
+				ret = at_parse_process_element(&parser, &str,
+							       index, list);
+				if (ret == -1) {
 					break;
 				}
 			}
@@ -7,6 +7,7 @@
 #include <limits.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <zephyr.h>
 #include <zephyr/types.h>
@@ -14,6 +15,12 @@
 
 #include <modem/at_params.h>
 
+/* Maximum number of array elements, as in the parser. */
+#define AT_PARAMS_MAX_ARRAY_SIZE 32
+
+/* Maximum length of a 64-bit number with sign. */
+#define AT_PARAMS_MAX_NUM_LEN 20
+
 /* Internal function. Parameter cannot be null. */
 static void at_param_init(struct at_param *param)
 {
@@ -23,13 +30,16 @@ static void at_param_init(struct at_param *param)
 	memset(param, 0, sizeof(struct at_param));
 }
 
-/* Internal function. Parameter cannot be null. */
-static void at_param_clear(struct at_param *param)
+/* Internal function. Parameters cannot be null. */
+static void at_param_clear(const struct at_param_list *list,
+			   struct at_param *param)
 {
 	__ASSERT(param != NULL, "Parameter cannot be NULL.");
 
-	if ((param->type == AT_PARAM_TYPE_STRING) ||
-	    (param->type == AT_PARAM_TYPE_ARRAY)) {
+	/* Views refer to the parsed string, nothing to free. */
+	if (!list->views &&
+	    ((param->type == AT_PARAM_TYPE_STRING) ||
+	     (param->type == AT_PARAM_TYPE_ARRAY))) {
 		k_free(param->value.str_val);
 	}
 
@@ -51,13 +61,46 @@ static struct at_param *at_params_get(const struct at_param_list *list,
 	return &param[index];
 }
 
-/* Internal function. Parameter cannot be null. */
-static size_t at_param_size(const struct at_param *param)
+/* Internal function. Parameter cannot be null.
+ * Decodes an array stored as a view, for example "1,2,3", and returns
+ * the number of elements. If array is NULL, the elements are only counted.
+ */
+static size_t at_param_array_view_decode(const struct at_param *param,
+					 uint32_t *array)
+{
+	const char *str = param->value.view;
+	const char *end = str + param->size;
+	size_t cnt = 0;
+
+	do {
+		if (array != NULL) {
+			array[cnt] = (uint32_t)strtoul(str, NULL, 10);
+		}
+
+		cnt++;
+
+		/* Move to the next element. */
+		while ((str < end) && (*str != ',')) {
+			str++;
+		}
+
+		str++;
+	} while ((str < end) && (cnt < AT_PARAMS_MAX_ARRAY_SIZE));
+
+	return cnt;
+}
+
+/* Internal function. Parameters cannot be null. */
+static size_t at_param_size(const struct at_param_list *list,
+			    const struct at_param *param)
 {
 	__ASSERT(param != NULL, "Parameter cannot be NULL.");
 
 	if (param->type == AT_PARAM_TYPE_NUM_INT) {
 		return sizeof(uint64_t);
+	} else if (list->views && (param->type == AT_PARAM_TYPE_ARRAY)) {
+		return at_param_array_view_decode(param, NULL) *
+		       sizeof(uint32_t);
 	} else if ((param->type == AT_PARAM_TYPE_STRING) ||
 		   (param->type == AT_PARAM_TYPE_ARRAY)) {
 		return param->size;
@@ -66,6 +109,44 @@ static size_t at_param_size(const struct at_param *param)
 	return 0;
 }
 
+/* Internal function. Gets the value of an integer parameter,
+ * decoding it if it is stored as a view.
+ */
+static int at_param_int_val_get(const struct at_param_list *list,
+				size_t index, int64_t *value)
+{
+	if (list == NULL || list->params == NULL || value == NULL) {
+		return -EINVAL;
+	}
+
+	struct at_param *param = at_params_get(list, index);
+
+	if (param == NULL) {
+		return -EINVAL;
+	}
+
+	if (param->type != AT_PARAM_TYPE_NUM_INT) {
+		return -EINVAL;
+	}
+
+	if (list->views && (param->size > 0)) {
+		char num[AT_PARAMS_MAX_NUM_LEN + 1];
+
+		if (param->size > AT_PARAMS_MAX_NUM_LEN) {
+			return -EINVAL;
+		}
+
+		memcpy(num, param->value.view, param->size);
+		num[param->size] = '\0';
+
+		*value = (int64_t)strtoll(num, NULL, 10);
+		return 0;
+	}
+
+	*value = param->value.int_val;
+	return 0;
+}
+
 int at_params_list_init(struct at_param_list *list, size_t max_params_count)
 {
 	if (list == NULL) {
@@ -79,6 +160,23 @@ int at_params_list_init(struct at_param_list *list, size_t max_params_count)
 	}
 
 	list->param_count = max_params_count;
+	list->views = false;
+	return 0;
+}
+
+int at_params_list_init_views(struct at_param_list *list,
+			      struct at_param *params,
+			      size_t max_params_count)
+{
+	if (list == NULL || params == NULL) {
+		return -EINVAL;
+	}
+
+	memset(params, 0, max_params_count * sizeof(struct at_param));
+
+	list->params = params;
+	list->param_count = max_params_count;
+	list->views = true;
 	return 0;
 }
 
@@ -91,7 +189,7 @@ void at_params_list_clear(struct at_param_list *list)
 	for (size_t i = 0; i < list->param_count; ++i) {
 		struct at_param *params = list->params;
 
-		at_param_clear(&params[i]);
+		at_param_clear(list, &params[i]);
 		at_param_init(&params[i]);
 	}
 }
@@ -105,7 +203,9 @@ void at_params_list_free(struct at_param_list *list)
 	at_params_list_clear(list);
 
 	list->param_count = 0;
-	k_free(list->params);
+	if (!list->views) {
+		k_free(list->params);
+	}
 	list->params = NULL;
 }
 
@@ -121,7 +221,7 @@ int at_params_empty_put(const struct at_param_list *list, size_t index)
 		return -EINVAL;
 	}
 
-	at_param_clear(param);
+	at_param_clear(list, param);
 
 	param->type = AT_PARAM_TYPE_EMPTY;
 	param->value.int_val = 0;
@@ -141,9 +241,10 @@ int at_params_int_put(const struct at_param_list *list, size_t index, int64_t va
 		return -EINVAL;
 	}
 
-	at_param_clear(param);
+	at_param_clear(list, param);
 
 	param->type = AT_PARAM_TYPE_NUM_INT;
+	param->size = 0;
 	param->value.int_val = value;
 	return 0;
 }
@@ -161,6 +262,14 @@ int at_params_string_put(const struct at_param_list *list, size_t index,
 		return -EINVAL;
 	}
 
+	if (list->views) {
+		param->size = str_len;
+		param->type = AT_PARAM_TYPE_STRING;
+		param->value.view = str;
+
+		return 0;
+	}
+
 	char *param_value = (char *)k_malloc(str_len + 1);
 
 	if (param_value == NULL) {
@@ -169,7 +278,7 @@ int at_params_string_put(const struct at_param_list *list, size_t index,
 
 	memcpy(param_value, str, str_len);
 
-	at_param_clear(param);
+	at_param_clear(list, param);
 	param->size = str_len;
 	param->type = AT_PARAM_TYPE_STRING;
 	param->value.str_val = param_value;
@@ -184,6 +293,10 @@ int at_params_array_put(const struct at_param_list *list, size_t index,
 		return -EINVAL;
 	}
 
+	if (list->views) {
+		return -ENOTSUP;
+	}
+
 	struct at_param *param = at_params_get(list, index);
 
 	if (param == NULL) {
@@ -198,7 +311,7 @@ int at_params_array_put(const struct at_param_list *list, size_t index,
 
 	memcpy(param_value, array, array_len);
 
-	at_param_clear(param);
+	at_param_clear(list, param);
 	param->size = array_len;
 	param->type = AT_PARAM_TYPE_ARRAY;
 	param->value.array_val = param_value;
@@ -206,27 +319,46 @@ int at_params_array_put(const struct at_param_list *list, size_t index,
 	return 0;
 }
 
-int at_params_size_get(const struct at_param_list *list, size_t index,
-		       size_t *len)
+int at_params_view_put(const struct at_param_list *list, size_t index,
+		       enum at_param_type type, const char *str,
+		       size_t str_len)
 {
-	if (list == NULL || list->params == NULL || len == NULL) {
+	if (list == NULL || list->params == NULL || str == NULL) {
 		return -EINVAL;
 	}
 
+	if (!list->views) {
+		return -ENOTSUP;
+	}
+
 	struct at_param *param = at_params_get(list, index);
 
 	if (param == NULL) {
 		return -EINVAL;
 	}
 
-	*len = at_param_size(param);
+	if ((type != AT_PARAM_TYPE_NUM_INT) &&
+	    (type != AT_PARAM_TYPE_STRING) &&
+	    (type != AT_PARAM_TYPE_ARRAY)) {
+		return -EINVAL;
+	}
+
+	/* An empty view of a number would be taken as a decoded value. */
+	if ((type == AT_PARAM_TYPE_NUM_INT) && (str_len == 0)) {
+		return -EINVAL;
+	}
+
+	param->size = str_len;
+	param->type = type;
+	param->value.view = str;
+
 	return 0;
 }
 
-int at_params_short_get(const struct at_param_list *list, size_t index,
-			int16_t *value)
+int at_params_size_get(const struct at_param_list *list, size_t index,
+		       size_t *len)
 {
-	if (list == NULL || list->params == NULL || value == NULL) {
+	if (list == NULL || list->params == NULL || len == NULL) {
 		return -EINVAL;
 	}
 
@@ -236,95 +368,111 @@ int at_params_short_get(const struct at_param_list *list, size_t index,
 		return -EINVAL;
 	}
 
-	if (param->type != AT_PARAM_TYPE_NUM_INT) {
+	*len = at_param_size(list, param);
+	return 0;
+}
+
+int at_params_short_get(const struct at_param_list *list, size_t index,
+			int16_t *value)
+{
+	int64_t int_val;
+	int err;
+
+	if (value == NULL) {
 		return -EINVAL;
 	}
 
-	if ((param->value.int_val > INT16_MAX) || (param->value.int_val < INT16_MIN)) {
+	err = at_param_int_val_get(list, index, &int_val);
+	if (err) {
+		return err;
+	}
+
+	if ((int_val > INT16_MAX) || (int_val < INT16_MIN)) {
 		return -EINVAL;
 	}
 
-	*value = (int16_t)param->value.int_val;
+	*value = (int16_t)int_val;
 	return 0;
 }
 
 int at_params_unsigned_short_get(const struct at_param_list *list, size_t index,
 			uint16_t *value)
 {
-	if (list == NULL || list->params == NULL || value == NULL) {
-		return -EINVAL;
-	}
+	int64_t int_val;
+	int err;
 
-	struct at_param *param = at_params_get(list, index);
-
-	if (param == NULL) {
+	if (value == NULL) {
 		return -EINVAL;
 	}
 
-	if (param->type != AT_PARAM_TYPE_NUM_INT) {
-		return -EINVAL;
+	err = at_param_int_val_get(list, index, &int_val);
+	if (err) {
+		return err;
 	}
 
-	if ((param->value.int_val > UINT16_MAX) || (param->value.int_val < 0)) {
+	if ((int_val > UINT16_MAX) || (int_val < 0)) {
 		return -EINVAL;
 	}
 
-	*value = (uint16_t)param->value.int_val;
+	*value = (uint16_t)int_val;
 	return 0;
 }
 
 int at_params_int_get(const struct at_param_list *list, size_t index,
 		      int32_t *value)
 {
-	if (list == NULL || list->params == NULL || value == NULL) {
-		return -EINVAL;
-	}
-
-	struct at_param *param = at_params_get(list, index);
+	int64_t int_val;
+	int err;
 
-	if (param == NULL) {
+	if (value == NULL) {
 		return -EINVAL;
 	}
 
-	if (param->type != AT_PARAM_TYPE_NUM_INT) {
-		return -EINVAL;
+	err = at_param_int_val_get(list, index, &int_val);
+	if (err) {
+		return err;
 	}
 
-	if ((param->value.int_val > INT32_MAX) || (param->value.int_val < INT32_MIN)) {
+	if ((int_val > INT32_MAX) || (int_val < INT32_MIN)) {
 		return -EINVAL;
 	}
 
-	*value = (int32_t)param->value.int_val;
+	*value = (int32_t)int_val;
 	return 0;
 }
 
 int at_params_unsigned_int_get(const struct at_param_list *list, size_t index, uint32_t *value)
 {
-	if (list == NULL || list->params == NULL || value == NULL) {
-		return -EINVAL;
-	}
-
-	struct at_param *param = at_params_get(list, index);
+	int64_t int_val;
+	int err;
 
-	if (param == NULL) {
+	if (value == NULL) {
 		return -EINVAL;
 	}
 
-	if (param->type != AT_PARAM_TYPE_NUM_INT) {
-		return -EINVAL;
+	err = at_param_int_val_get(list, index, &int_val);
+	if (err) {
+		return err;
 	}
 
-	if ((param->value.int_val > UINT32_MAX) || (param->value.int_val < 0)) {
+	if ((int_val > UINT32_MAX) || (int_val < 0)) {
 		return -EINVAL;
 	}
 
-	*value = (uint32_t)param->value.int_val;
+	*value = (uint32_t)int_val;
 	return 0;
 }
 
 int at_params_int64_get(const struct at_param_list *list, size_t index, int64_t *value)
 {
-	if (list == NULL || list->params == NULL || value == NULL) {
+	return at_param_int_val_get(list, index, value);
+}
+
+int at_params_string_get(const struct at_param_list *list, size_t index,
+			 char *value, size_t *len)
+{
+	if (list == NULL || list->params == NULL || value == NULL ||
+	    value == NULL || len == NULL) {
 		return -EINVAL;
 	}
 
@@ -334,23 +482,27 @@ int at_params_int64_get(const struct at_param_list *list, size_t index, int64_t
 		return -EINVAL;
 	}
 
-	if (param->type != AT_PARAM_TYPE_NUM_INT) {
+	if (param->type != AT_PARAM_TYPE_STRING) {
 		return -EINVAL;
 	}
 
-	if ((param->value.int_val > INT64_MAX) || (param->value.int_val < INT64_MIN)) {
-		return -EINVAL;
+	size_t param_len = at_param_size(list, param);
+
+	if (*len < param_len) {
+		return -ENOMEM;
 	}
 
-	*value = param->value.int_val;
+	memcpy(value, param->value.str_val, param_len);
+	*len = param_len;
+
 	return 0;
 }
 
-int at_params_string_get(const struct at_param_list *list, size_t index,
-			 char *value, size_t *len)
+int at_params_string_ptr_get(const struct at_param_list *list, size_t index,
+			     const char **value, size_t *len)
 {
 	if (list == NULL || list->params == NULL || value == NULL ||
-	    value == NULL || len == NULL) {
+	    len == NULL) {
 		return -EINVAL;
 	}
 
@@ -364,14 +516,8 @@ int at_params_string_get(const struct at_param_list *list, size_t index,
 		return -EINVAL;
 	}
 
-	size_t param_len = at_param_size(param);
-
-	if (*len < param_len) {
-		return -ENOMEM;
-	}
-
-	memcpy(value, param->value.str_val, param_len);
-	*len = param_len;
+	*value = param->value.view;
+	*len = param->size;
 
 	return 0;
 }
@@ -394,13 +540,18 @@ int at_params_array_get(const struct at_param_list *list, size_t index,
 		return -EINVAL;
 	}
 
-	size_t param_len = at_param_size(param);
+	size_t param_len = at_param_size(list, param);
 
 	if (*len < param_len) {
 		return -ENOMEM;
 	}
 
-	memcpy(array, param->value.array_val, param_len);
+	if (list->views) {
+		at_param_array_view_decode(param, array);
+	} else {
+		memcpy(array, param->value.array_val, param_len);
+	}
+
 	*len = param_len;
 
 	return 0;
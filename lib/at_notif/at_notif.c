@@ -14,64 +14,152 @@
 
 LOG_MODULE_REGISTER(at_notif, CONFIG_AT_NOTIF_LOG_LEVEL);
 
+/* Protects the handler lists. It is not held while handlers are called. */
 static K_MUTEX_DEFINE(list_mtx);
 
+/* Held while handlers are called, so that a handler is not called anymore
+ * once it has been deregistered.
+ */
+static K_MUTEX_DEFINE(dispatch_mtx);
+
+/* Maximum length of a notification prefix, for example "%NCELLMEAS". */
+#define NOTIF_PREFIX_MAX_LEN 32
+
+struct notif_handler;
+
+/**@brief Link list element for a notification prefix of a handler. */
+struct notif_prefix {
+	sys_snode_t          node;
+	struct notif_handler *owner;
+	const char           *str;
+	uint8_t              len;
+	uint8_t              bucket;
+};
+
 /**@brief Link list element for notification handler. */
 struct notif_handler {
 	sys_snode_t        node;
 	void               *ctx;
 	at_notif_handler_t handler;
+	size_t             prefix_count;
+	struct notif_prefix prefixes[];
+};
+
+/**@brief Handler to be called for a notification. */
+struct notif_call {
+	void               *ctx;
+	at_notif_handler_t handler;
 };
 
+/* Handlers registered for all notifications. */
 static sys_slist_t handler_list;
 
+/* Handlers registered for a set of prefixes. */
+static sys_slist_t prefix_handler_list;
+
+/* Prefixes of the handlers in prefix_handler_list, hashed by prefix. */
+static sys_slist_t prefix_table[CONFIG_AT_NOTIF_PREFIX_TABLE_SIZE];
+
+/**@brief FNV-1a hash of a notification prefix. */
+static uint8_t prefix_bucket(const char *str, size_t len)
+{
+	uint32_t hash = 2166136261u;
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= (uint8_t)str[i];
+		hash *= 16777619u;
+	}
+
+	return hash % CONFIG_AT_NOTIF_PREFIX_TABLE_SIZE;
+}
+
+/**@brief Get the length of the prefix of a notification, for example
+ *        "+CEREG" in "+CEREG: 1".
+ */
+static size_t notif_prefix_len(const char *notif)
+{
+	size_t len = 0;
+
+	while ((notif[len] != '\0') && (notif[len] != ':') &&
+	       (notif[len] != ' ') && (notif[len] != '\r') &&
+	       (notif[len] != '\n')) {
+		len++;
+	}
+
+	return len;
+}
 
 /**
- * @brief Find the handler from the notification list.
+ * @brief Find the handler from the notification lists.
  *
- * @return The node or NULL if not found and its previous node in @p prev_out.
+ * @return The node or NULL if not found and the list it is in in @p list_out.
  */
-static struct notif_handler *find_node(struct notif_handler **prev_out,
+static struct notif_handler *find_node(sys_slist_t **list_out,
 	void *ctx, at_notif_handler_t handler)
 {
-	struct notif_handler *prev = NULL, *curr, *tmp;
+	sys_slist_t *lists[] = { &handler_list, &prefix_handler_list };
+	struct notif_handler *curr;
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&handler_list, curr, tmp, node) {
-		if (curr->ctx == ctx && curr->handler == handler) {
-			*prev_out = prev;
-			return curr;
+	for (size_t i = 0; i < ARRAY_SIZE(lists); i++) {
+		SYS_SLIST_FOR_EACH_CONTAINER(lists[i], curr, node) {
+			if (curr->ctx == ctx && curr->handler == handler) {
+				*list_out = lists[i];
+				return curr;
+			}
 		}
-		prev = curr;
 	}
 	return NULL;
 }
 
 /**@brief Add the handler in the notification list if not already present. */
-static int append_notif_handler(void *ctx, at_notif_handler_t handler)
+static int append_notif_handler(void *ctx, at_notif_handler_t handler,
+				const char *const *prefixes,
+				size_t prefix_count)
 {
 	struct notif_handler *to_ins;
+	sys_slist_t *list;
 
 	k_mutex_lock(&list_mtx, K_FOREVER);
 
 	/* Check if handler is already registered. */
-	if (find_node(&to_ins, ctx, handler) != NULL) {
+	if (find_node(&list, ctx, handler) != NULL) {
 		LOG_DBG("Handler already registered. Nothing to do");
 		k_mutex_unlock(&list_mtx);
 		return 0;
 	}
 
 	/* Allocate memory and fill. */
-	to_ins = (struct notif_handler *)k_malloc(sizeof(struct notif_handler));
+	to_ins = (struct notif_handler *)k_malloc(sizeof(struct notif_handler) +
+		prefix_count * sizeof(struct notif_prefix));
 	if (to_ins == NULL) {
 		k_mutex_unlock(&list_mtx);
 		return -ENOBUFS;
 	}
 	memset(to_ins, 0, sizeof(struct notif_handler));
-	to_ins->ctx     = ctx;
-	to_ins->handler = handler;
+	to_ins->ctx          = ctx;
+	to_ins->handler      = handler;
+	to_ins->prefix_count = prefix_count;
+
+	if (prefix_count == 0) {
+		/* Insert handler in the list. */
+		sys_slist_append(&handler_list, &to_ins->node);
+		k_mutex_unlock(&list_mtx);
+		return 0;
+	}
+
+	/* Insert handler in the prefix table. */
+	for (size_t i = 0; i < prefix_count; i++) {
+		struct notif_prefix *prefix = &to_ins->prefixes[i];
+
+		prefix->owner  = to_ins;
+		prefix->str    = prefixes[i];
+		prefix->len    = strlen(prefixes[i]);
+		prefix->bucket = prefix_bucket(prefix->str, prefix->len);
+
+		sys_slist_append(&prefix_table[prefix->bucket], &prefix->node);
+	}
+	sys_slist_append(&prefix_handler_list, &to_ins->node);
 
-	/* Insert handler in the list. */
-	sys_slist_append(&handler_list, &to_ins->node);
 	k_mutex_unlock(&list_mtx);
 	return 0;
 }
@@ -79,43 +167,95 @@ static int append_notif_handler(void *ctx, at_notif_handler_t handler)
 /**@brief Remove the handler from the notification list if registered. */
 static int remove_notif_handler(void *ctx, at_notif_handler_t handler)
 {
-	struct notif_handler *curr, *prev = NULL;
+	struct notif_handler *curr;
+	sys_slist_t *list;
 
+	/* Wait for the ongoing dispatch to complete. The mutex is recursive,
+	 * so handlers can deregister themselves.
+	 */
+	k_mutex_lock(&dispatch_mtx, K_FOREVER);
 	k_mutex_lock(&list_mtx, K_FOREVER);
 
 	/* Check if the handler is registered before removing it. */
-	curr = find_node(&prev, ctx, handler);
+	curr = find_node(&list, ctx, handler);
 	if (curr == NULL) {
 		LOG_WRN("Handler not registered. Nothing to do");
 		k_mutex_unlock(&list_mtx);
+		k_mutex_unlock(&dispatch_mtx);
 		return 0;
 	}
 
-	/* Remove the handler from the list. */
-	sys_slist_remove(&handler_list, &prev->node, &curr->node);
+	/* Remove the handler from the lists. */
+	for (size_t i = 0; i < curr->prefix_count; i++) {
+		struct notif_prefix *prefix = &curr->prefixes[i];
+
+		sys_slist_find_and_remove(&prefix_table[prefix->bucket],
+					  &prefix->node);
+	}
+	sys_slist_find_and_remove(list, &curr->node);
 	k_free(curr);
 
 	k_mutex_unlock(&list_mtx);
+	k_mutex_unlock(&dispatch_mtx);
 	return 0;
 }
 
+/**@brief Add a handler to the calls of a notification. */
+static size_t call_add(struct notif_call *calls, size_t count,
+		       const struct notif_handler *curr)
+{
+	if (count == CONFIG_AT_NOTIF_DISPATCH_MAX) {
+		LOG_ERR("Too many handlers for a notification, "
+			"increase CONFIG_AT_NOTIF_DISPATCH_MAX");
+		return count;
+	}
+
+	calls[count].ctx     = curr->ctx;
+	calls[count].handler = curr->handler;
+
+	return count + 1;
+}
+
 /**@brief AT command notifications handler. */
 static void notif_dispatch(const char *response)
 {
-	struct notif_handler *curr, *tmp;
+	struct notif_call calls[CONFIG_AT_NOTIF_DISPATCH_MAX];
+	struct notif_handler *curr;
+	struct notif_prefix *prefix;
+	size_t len = notif_prefix_len(response);
+	size_t count = 0;
 
+	k_mutex_lock(&dispatch_mtx, K_FOREVER);
 	k_mutex_lock(&list_mtx, K_FOREVER);
 
-	/* Dispatch notifications to all registered handlers */
+	SYS_SLIST_FOR_EACH_CONTAINER(&handler_list, curr, node) {
+		count = call_add(calls, count, curr);
+	}
+
+	if ((len > 0) && (len <= NOTIF_PREFIX_MAX_LEN)) {
+		uint8_t bucket = prefix_bucket(response, len);
+
+		SYS_SLIST_FOR_EACH_CONTAINER(&prefix_table[bucket], prefix,
+					     node) {
+			if ((prefix->len == len) &&
+			    (memcmp(prefix->str, response, len) == 0)) {
+				count = call_add(calls, count, prefix->owner);
+			}
+		}
+	}
+
+	k_mutex_unlock(&list_mtx);
+
+	/* Dispatch notifications to the matching handlers */
 	LOG_DBG("Dispatching events:");
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&handler_list, curr, tmp, node) {
-		LOG_DBG(" - ctx=0x%08X, handler=0x%08X", (uint32_t)curr->ctx,
-			(uint32_t)curr->handler);
-		curr->handler(curr->ctx, response);
+	for (size_t i = 0; i < count; i++) {
+		LOG_DBG(" - ctx=0x%08X, handler=0x%08X",
+			(uint32_t)calls[i].ctx, (uint32_t)calls[i].handler);
+		calls[i].handler(calls[i].ctx, response);
 	}
 	LOG_DBG("Done");
 
-	k_mutex_unlock(&list_mtx);
+	k_mutex_unlock(&dispatch_mtx);
 }
 
 static int module_init(const struct device *dev)
@@ -133,6 +273,10 @@ static int module_init(const struct device *dev)
 
 	LOG_DBG("Initialization");
 	sys_slist_init(&handler_list);
+	sys_slist_init(&prefix_handler_list);
+	for (size_t i = 0; i < ARRAY_SIZE(prefix_table); i++) {
+		sys_slist_init(&prefix_table[i]);
+	}
 	at_cmd_set_notification_handler(notif_dispatch);
 	return 0;
 }
@@ -149,7 +293,30 @@ int at_notif_register_handler(void *context, at_notif_handler_t handler)
 			(uint32_t)context, (uint32_t)handler);
 		return -EINVAL;
 	}
-	return append_notif_handler(context, handler);
+	return append_notif_handler(context, handler, NULL, 0);
+}
+
+int at_notif_register_prefix_handler(void *context, at_notif_handler_t handler,
+				     const char *const *prefixes,
+				     size_t prefix_count)
+{
+	if (handler == NULL || prefixes == NULL || prefix_count == 0) {
+		LOG_ERR("Invalid handler (context=0x%08X, handler=0x%08X)",
+			(uint32_t)context, (uint32_t)handler);
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < prefix_count; i++) {
+		if (prefixes[i] == NULL ||
+		    notif_prefix_len(prefixes[i]) != strlen(prefixes[i]) ||
+		    strlen(prefixes[i]) == 0 ||
+		    strlen(prefixes[i]) > NOTIF_PREFIX_MAX_LEN) {
+			LOG_ERR("Invalid notification prefix");
+			return -EINVAL;
+		}
+	}
+
+	return append_notif_handler(context, handler, prefixes, prefix_count);
 }
 
 int at_notif_deregister_handler(void *context, at_notif_handler_t handler)
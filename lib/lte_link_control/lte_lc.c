@@ -531,6 +531,11 @@ static int enable_notifications(void)
 static int init_and_config(void)
 {
 	int err;
+	struct at_cmd_batch_cmd batch_cmds[4] = { 0 };
+	struct at_cmd_batch batch = {
+		.cmds = batch_cmds,
+		.stop_on_error = true,
+	};
 
 	if (is_initialized) {
 		return -EALREADY;
@@ -550,7 +555,8 @@ static int init_and_config(void)
 		LOG_DBG("Default system mode is used: %d", sys_mode_current);
 	}
 
-	err = at_notif_register_handler(NULL, at_handler);
+	err = at_notif_register_prefix_handler(NULL, at_handler, at_notifs,
+					       ARRAY_SIZE(at_notifs));
 	if (err) {
 		LOG_ERR("Can't register AT handler, error: %d", err);
 		return err;
@@ -571,49 +577,44 @@ static int init_and_config(void)
 			sys_mode_current, mode_pref_current);
 	}
 
-#if !defined(CONFIG_NRF_MODEM_LIB_SYS_INIT) && \
-	defined(CONFIG_BOARD_THINGY91_NRF9160NS)
-	/* Configuring MAGPIO, so that the correct antenna
-	 * matching network is used for each LTE band and GPS.
-	 */
-	if (at_cmd_write(thingy91_magpio, NULL, 0, NULL) != 0) {
-		return -EIO;
-	}
-#endif
-
 #if defined(CONFIG_LTE_EDRX_REQ)
 	/* Request configured eDRX settings to save power */
 	if (lte_lc_edrx_req(true) != 0) {
 		return -EIO;
 	}
 #endif
+
+#if !defined(CONFIG_NRF_MODEM_LIB_SYS_INIT) && \
+	defined(CONFIG_BOARD_THINGY91_NRF9160NS)
+	/* Configuring MAGPIO, so that the correct antenna
+	 * matching network is used for each LTE band and GPS.
+	 */
+	batch_cmds[batch.count++].cmd = thingy91_magpio;
+#endif
 #if defined(CONFIG_NRF_MODEM_LIB_TRACE_ENABLED)
-	if (at_cmd_write(mdm_trace, NULL, 0, NULL) != 0) {
-		return -EIO;
-	}
+	batch_cmds[batch.count++].cmd = mdm_trace;
 #endif
 #if defined(CONFIG_LTE_LOCK_BANDS)
 	/* Set LTE band lock (volatile setting).
 	 * Has to be done every time before activating the modem.
 	 */
-	if (at_cmd_write(lock_bands, NULL, 0, NULL) != 0) {
-		return -EIO;
-	}
+	batch_cmds[batch.count++].cmd = lock_bands;
 #endif
 #if defined(CONFIG_LTE_LOCK_PLMN)
 	/* Manually select Operator (volatile setting).
 	 * Has to be done every time before activating the modem.
 	 */
-	if (at_cmd_write(lock_plmn, NULL, 0, NULL) != 0) {
-		return -EIO;
-	}
+	batch_cmds[batch.count++].cmd = lock_plmn;
 #elif defined(CONFIG_LTE_UNLOCK_PLMN)
 	/* Automatically select Operator (volatile setting).
 	 */
-	if (at_cmd_write(unlock_plmn, NULL, 0, NULL) != 0) {
+	batch_cmds[batch.count++].cmd = unlock_plmn;
+#endif
+
+	/* Send the configuration commands back to back. */
+	if ((batch.count > 0) && (at_cmd_batch_write(&batch) != 0)) {
 		return -EIO;
 	}
-#endif
 
 	/* Listen for RRC connection mode notifications */
 	err = enable_notifications();
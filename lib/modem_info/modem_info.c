@@ -131,12 +131,25 @@ LOG_MODULE_REGISTER(modem_info);
 #define APN_PARAM_INDEX		3
 #define APN_PARAM_COUNT		7
 
+/* Time that a cached response can be used for a value read from it, in
+ * milliseconds. Values that do not change are used until the cache is cleared,
+ * and values that change all the time are always read from the modem.
+ */
+#define TTL_STATIC		SYS_FOREVER_MS
+#define TTL_NONE		0
+#if defined(CONFIG_MODEM_INFO_CACHE)
+#define TTL_NETWORK		CONFIG_MODEM_INFO_CACHE_NETWORK_TTL
+#else
+#define TTL_NETWORK		0
+#endif
+
 struct modem_info_data {
 	const char *cmd;
 	const char *data_name;
 	uint8_t param_index;
 	uint8_t param_count;
 	enum at_param_type data_type;
+	int32_t ttl;
 };
 
 static const struct modem_info_data rsrp_data = {
@@ -145,6 +158,7 @@ static const struct modem_info_data rsrp_data = {
 	.param_index	= RSRP_PARAM_INDEX,
 	.param_count	= RSRP_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
+	.ttl		= TTL_NONE,
 };
 
 static const struct modem_info_data band_data = {
@@ -153,6 +167,7 @@ static const struct modem_info_data band_data = {
 	.param_index	= BAND_PARAM_INDEX,
 	.param_count	= BAND_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
+	.ttl		= TTL_NETWORK,
 };
 
 static const struct modem_info_data band_sup_data = {
@@ -161,6 +176,7 @@ static const struct modem_info_data band_sup_data = {
 	.param_index	= BAND_PARAM_INDEX,
 	.param_count	= BAND_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
+	.ttl		= TTL_STATIC,
 };
 
 static const struct modem_info_data mode_data = {
@@ -169,6 +185,7 @@ static const struct modem_info_data mode_data = {
 	.param_index	= MODE_PARAM_INDEX,
 	.param_count	= MODE_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
+	.ttl		= TTL_NETWORK,
 };
 
 static const struct modem_info_data operator_data = {
@@ -177,6 +194,7 @@ static const struct modem_info_data operator_data = {
 	.param_index	= OPERATOR_PARAM_INDEX,
 	.param_count	= OPERATOR_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
+	.ttl		= TTL_NETWORK,
 };
 
 static const struct modem_info_data mcc_data = {
@@ -185,6 +203,7 @@ static const struct modem_info_data mcc_data = {
 	.param_index	= OPERATOR_PARAM_INDEX,
 	.param_count	= OPERATOR_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
+	.ttl		= TTL_NETWORK,
 };
 
 static const struct modem_info_data mnc_data = {
@@ -193,6 +212,7 @@ static const struct modem_info_data mnc_data = {
 	.param_index	= OPERATOR_PARAM_INDEX,
 	.param_count	= OPERATOR_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
+	.ttl		= TTL_NETWORK,
 };
 
 static const struct modem_info_data cellid_data = {
@@ -201,6 +221,7 @@ static const struct modem_info_data cellid_data = {
 	.param_index	= CELLID_PARAM_INDEX,
 	.param_count	= CELLID_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
+	.ttl		= TTL_NETWORK,
 };
 
 static const struct modem_info_data area_data = {
@@ -209,6 +230,7 @@ static const struct modem_info_data area_data = {
 	.param_index	= AREA_CODE_PARAM_INDEX,
 	.param_count	= AREA_CODE_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
+	.ttl		= TTL_NETWORK,
 };
 
 static const struct modem_info_data ip_data = {
@@ -217,6 +239,7 @@ static const struct modem_info_data ip_data = {
 	.param_index	= IP_ADDRESS_PARAM_INDEX,
 	.param_count	= IP_ADDRESS_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
+	.ttl		= TTL_NETWORK,
 };
 
 static const struct modem_info_data uicc_data = {
@@ -225,6 +248,7 @@ static const struct modem_info_data uicc_data = {
 	.param_index	= UICC_PARAM_INDEX,
 	.param_count	= UICC_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
+	.ttl		= TTL_NETWORK,
 };
 
 static const struct modem_info_data battery_data = {
@@ -233,6 +257,7 @@ static const struct modem_info_data battery_data = {
 	.param_index	= VBAT_PARAM_INDEX,
 	.param_count	= VBAT_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
+	.ttl		= TTL_NONE,
 };
 
 static const struct modem_info_data temp_data = {
@@ -241,6 +266,7 @@ static const struct modem_info_data temp_data = {
 	.param_index	= TEMP_PARAM_INDEX,
 	.param_count	= TEMP_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
+	.ttl		= TTL_NONE,
 };
 
 static const struct modem_info_data fw_data = {
@@ -249,6 +275,7 @@ static const struct modem_info_data fw_data = {
 	.param_index	= MODEM_FW_PARAM_INDEX,
 	.param_count	= MODEM_FW_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
+	.ttl		= TTL_STATIC,
 };
 
 static const struct modem_info_data iccid_data = {
@@ -257,6 +284,7 @@ static const struct modem_info_data iccid_data = {
 	.param_index	= ICCID_PARAM_INDEX,
 	.param_count	= ICCID_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
+	.ttl		= TTL_STATIC,
 };
 
 static const struct modem_info_data lte_mode_data = {
@@ -265,6 +293,7 @@ static const struct modem_info_data lte_mode_data = {
 	.param_index	= LTE_MODE_PARAM_INDEX,
 	.param_count	= SYSTEMMODE_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
+	.ttl		= TTL_NETWORK,
 };
 
 static const struct modem_info_data nbiot_mode_data = {
@@ -273,6 +302,7 @@ static const struct modem_info_data nbiot_mode_data = {
 	.param_index	= NBIOT_MODE_PARAM_INDEX,
 	.param_count	= SYSTEMMODE_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
+	.ttl		= TTL_NETWORK,
 };
 
 static const struct modem_info_data gps_mode_data = {
@@ -281,6 +311,7 @@ static const struct modem_info_data gps_mode_data = {
 	.param_index	= GPS_MODE_PARAM_INDEX,
 	.param_count	= SYSTEMMODE_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
+	.ttl		= TTL_NETWORK,
 };
 
 static const struct modem_info_data imsi_data = {
@@ -289,6 +320,7 @@ static const struct modem_info_data imsi_data = {
 	.param_index	= IMSI_PARAM_INDEX,
 	.param_count	= IMSI_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
+	.ttl		= TTL_NETWORK,
 };
 
 static const struct modem_info_data imei_data = {
@@ -297,6 +329,7 @@ static const struct modem_info_data imei_data = {
 	.param_index	= MODEM_IMEI_PARAM_INDEX,
 	.param_count	= MODEM_IMEI_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
+	.ttl		= TTL_STATIC,
 };
 
 static const struct modem_info_data date_time_data = {
@@ -305,6 +338,7 @@ static const struct modem_info_data date_time_data = {
 	.param_index	= DATE_TIME_PARAM_INDEX,
 	.param_count	= DATE_TIME_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
+	.ttl		= TTL_NONE,
 };
 
 static const struct modem_info_data apn_data = {
@@ -313,6 +347,7 @@ static const struct modem_info_data apn_data = {
 	.param_index	= APN_PARAM_INDEX,
 	.param_count	= APN_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
+	.ttl		= TTL_NETWORK,
 };
 
 static const struct modem_info_data *const modem_data[] = {
@@ -340,9 +375,150 @@ static const struct modem_info_data *const modem_data[] = {
 	[MODEM_INFO_APN]	= &apn_data,
 };
 
+#if defined(CONFIG_MODEM_INFO_CACHE)
+struct cache_entry {
+	/* AT command of the response, NULL if the entry is free */
+	const char *cmd;
+	/* Uptime when the response was received */
+	int64_t time;
+	/* Lifetime of the response */
+	int32_t ttl;
+	char rsp[CONFIG_MODEM_INFO_BUFFER_SIZE];
+};
+
+static struct cache_entry cache[CONFIG_MODEM_INFO_CACHE_ENTRIES];
+#endif /* CONFIG_MODEM_INFO_CACHE */
+
+/* Protects the cache and the statistics */
+static K_MUTEX_DEFINE(cache_mutex);
+static struct modem_info_stats stats;
+
 static rsrp_cb_t modem_info_rsrp_cb;
 static struct at_param_list m_param_list;
 
+/* Shortest of two lifetimes, where 0 is the shortest. */
+static int32_t ttl_min(int32_t a, int32_t b)
+{
+	if (a == SYS_FOREVER_MS) {
+		return b;
+	} else if (b == SYS_FOREVER_MS) {
+		return a;
+	}
+
+	return MIN(a, b);
+}
+
+#if defined(CONFIG_MODEM_INFO_CACHE)
+static bool ttl_valid(int32_t ttl, int64_t time, int64_t now)
+{
+	return (ttl == SYS_FOREVER_MS) || (now - time < ttl);
+}
+
+/* Uptime when the entry expires. Free entries have expired first. */
+static int64_t cache_expiry(const struct cache_entry *entry)
+{
+	if (entry->cmd == NULL) {
+		return INT64_MIN;
+	} else if (entry->ttl == SYS_FOREVER_MS) {
+		return INT64_MAX;
+	}
+
+	return entry->time + entry->ttl;
+}
+
+static bool cache_get(const char *cmd, int32_t ttl, char *buf)
+{
+	int64_t now = k_uptime_get();
+
+	for (size_t i = 0; i < ARRAY_SIZE(cache); i++) {
+		if ((cache[i].cmd != NULL) && (strcmp(cache[i].cmd, cmd) == 0)) {
+			if (!ttl_valid(ttl, cache[i].time, now)) {
+				return false;
+			}
+
+			strcpy(buf, cache[i].rsp);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void cache_put(const char *cmd, int32_t ttl, const char *rsp)
+{
+	struct cache_entry *entry = &cache[0];
+
+	if (ttl == 0) {
+		return;
+	}
+
+	/* Replace the response to the same command, or else the entry that
+	 * expires first.
+	 */
+	for (size_t i = 0; i < ARRAY_SIZE(cache); i++) {
+		if ((cache[i].cmd != NULL) && (strcmp(cache[i].cmd, cmd) == 0)) {
+			entry = &cache[i];
+			break;
+		}
+
+		if (cache_expiry(&cache[i]) < cache_expiry(entry)) {
+			entry = &cache[i];
+		}
+	}
+
+	entry->cmd = cmd;
+	entry->time = k_uptime_get();
+	entry->ttl = ttl;
+	strcpy(entry->rsp, rsp);
+}
+#endif /* CONFIG_MODEM_INFO_CACHE */
+
+/* Get the response to an AT command, from the cache if it has been received
+ * within the given lifetime, or else from the modem.
+ */
+static int response_get(const char *cmd, int32_t ttl, size_t values, char *buf)
+{
+	int err;
+	uint32_t start;
+	uint32_t time_us;
+
+	k_mutex_lock(&cache_mutex, K_FOREVER);
+
+	stats.values += values;
+
+#if defined(CONFIG_MODEM_INFO_CACHE)
+	if (cache_get(cmd, ttl, buf)) {
+		stats.cache_hits++;
+		k_mutex_unlock(&cache_mutex);
+		return 0;
+	}
+#endif
+
+	k_mutex_unlock(&cache_mutex);
+
+	start = k_cycle_get_32();
+
+	err = at_cmd_write(cmd, buf, CONFIG_MODEM_INFO_BUFFER_SIZE, NULL);
+
+	time_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	k_mutex_lock(&cache_mutex, K_FOREVER);
+
+	stats.at_cmds++;
+	stats.latency_total_us += time_us;
+	stats.latency_max_us = MAX(stats.latency_max_us, time_us);
+
+#if defined(CONFIG_MODEM_INFO_CACHE)
+	if (err == 0) {
+		cache_put(cmd, ttl, buf);
+	}
+#endif
+
+	k_mutex_unlock(&cache_mutex);
+
+	return err ? -EIO : 0;
+}
+
 static bool is_cesq_notification(const char *buf, size_t len)
 {
 	return strstr(buf, AT_CMD_CESQ_RESP) ? true : false;
@@ -417,11 +593,32 @@ int modem_info_name_get(enum modem_info info, char *name)
 	return len;
 }
 
+static int short_parse(const struct modem_info_data *data, const char *recv_buf,
+		       uint16_t *buf)
+{
+	int err;
+
+	err = modem_info_parse(data, recv_buf);
+
+	if (err) {
+		return err;
+	}
+
+	err = at_params_unsigned_short_get(&m_param_list,
+					   data->param_index,
+					   buf);
+
+	if (err) {
+		return err;
+	}
+
+	return sizeof(uint16_t);
+}
+
 int modem_info_short_get(enum modem_info info, uint16_t *buf)
 {
 	int err;
 	char recv_buf[CONFIG_MODEM_INFO_BUFFER_SIZE] = {0};
-	int cmd_length = 0;
 
 	if (buf == NULL) {
 		return -EINVAL;
@@ -431,37 +628,20 @@ int modem_info_short_get(enum modem_info info, uint16_t *buf)
 		return -EINVAL;
 	}
 
-	err = at_cmd_write(modem_data[info]->cmd,
-			   recv_buf,
-			   CONFIG_MODEM_INFO_BUFFER_SIZE,
-			   NULL);
+	err = response_get(modem_data[info]->cmd, modem_data[info]->ttl, 1,
+			   recv_buf);
 
 	if (err != 0) {
-		return -EIO;
-	}
-
-	err = modem_info_parse(modem_data[info], &recv_buf[cmd_length]);
-
-	if (err) {
 		return err;
 	}
 
-	err = at_params_unsigned_short_get(&m_param_list,
-					   modem_data[info]->param_index,
-					   buf);
-
-	if (err) {
-		return err;
-	}
-
-	return sizeof(uint16_t);
+	return short_parse(modem_data[info], recv_buf, buf);
 }
 
-int modem_info_string_get(enum modem_info info, char *buf,
-				  const size_t buf_size)
+static int string_parse(enum modem_info info, char *recv_buf, char *buf,
+			const size_t buf_size)
 {
 	int err;
-	char recv_buf[CONFIG_MODEM_INFO_BUFFER_SIZE] = {0};
 	uint16_t param_value;
 	int ip_cnt = 0;
 	char *ip_str_end = recv_buf;
@@ -474,15 +654,6 @@ int modem_info_string_get(enum modem_info info, char *buf,
 	/* return value indicating length of the string written to buf */
 	size_t len = 0;
 
-	if ((buf == NULL) || (buf_size == 0)) {
-		return -EINVAL;
-	}
-
-	err = at_cmd_write(modem_data[info]->cmd,
-			  recv_buf,
-			  CONFIG_MODEM_INFO_BUFFER_SIZE,
-			  NULL);
-
 	/* modem_info does not yet support array objects, so here we handle
 	 * the supported bands independently as a string
 	 */
@@ -500,10 +671,6 @@ int modem_info_string_get(enum modem_info info, char *buf,
 		LOG_DBG("Device contains %d IP addresses", ip_cnt);
 	}
 
-	if (err != 0) {
-		return -EIO;
-	}
-
 parse:
 	if (info == MODEM_INFO_IP_ADDRESS) {
 		/* parse each IP address line separately */
@@ -595,6 +762,139 @@ parse:
 	return len <= 0 ? -ENOTSUP : len;
 }
 
+int modem_info_string_get(enum modem_info info, char *buf,
+				  const size_t buf_size)
+{
+	int err;
+	char recv_buf[CONFIG_MODEM_INFO_BUFFER_SIZE] = {0};
+
+	if ((buf == NULL) || (buf_size == 0)) {
+		return -EINVAL;
+	}
+
+	err = response_get(modem_data[info]->cmd, modem_data[info]->ttl, 1,
+			   recv_buf);
+
+	if (err != 0) {
+		return err;
+	}
+
+	return string_parse(info, recv_buf, buf, buf_size);
+}
+
+static int param_parse(struct lte_param *param, const char *rsp)
+{
+	char recv_buf[CONFIG_MODEM_INFO_BUFFER_SIZE];
+	const struct modem_info_data *data = modem_data[param->type];
+
+	/* Parsing modifies the response, which may be used for other values */
+	strcpy(recv_buf, rsp);
+
+	if (data->data_type == AT_PARAM_TYPE_STRING) {
+		return string_parse(param->type, recv_buf, param->value_string,
+				    sizeof(param->value_string));
+	}
+
+	return short_parse(data, recv_buf, &param->value);
+}
+
+static bool same_cmd(const struct lte_param *param, const char *cmd)
+{
+	return strcmp(modem_data[param->type]->cmd, cmd) == 0;
+}
+
+int modem_info_batch_get(struct lte_param *const params[], size_t count)
+{
+	int ret = 0;
+	char recv_buf[CONFIG_MODEM_INFO_BUFFER_SIZE];
+
+	if (params == NULL) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		if ((params[i] == NULL) || (params[i]->type >= MODEM_INFO_COUNT)) {
+			return -EINVAL;
+		}
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		const char *cmd = modem_data[params[i]->type]->cmd;
+		int32_t ttl = SYS_FOREVER_MS;
+		size_t values = 0;
+		bool read = false;
+		int err;
+
+		/* Skip the values read from an earlier response */
+		for (size_t j = 0; j < i; j++) {
+			if (same_cmd(params[j], cmd)) {
+				read = true;
+				break;
+			}
+		}
+
+		if (read) {
+			continue;
+		}
+
+		/* The response must be recent enough for all the values read
+		 * from it.
+		 */
+		for (size_t j = i; j < count; j++) {
+			if (same_cmd(params[j], cmd)) {
+				ttl = ttl_min(ttl, modem_data[params[j]->type]->ttl);
+				values++;
+			}
+		}
+
+		memset(recv_buf, 0, sizeof(recv_buf));
+
+		err = response_get(cmd, ttl, values, recv_buf);
+
+		for (size_t j = i; j < count; j++) {
+			if (!same_cmd(params[j], cmd)) {
+				continue;
+			}
+
+			if (err == 0) {
+				err = param_parse(params[j], recv_buf);
+				err = MIN(err, 0);
+			}
+
+			if (err) {
+				LOG_ERR("Link data not obtained: %d %d",
+					params[j]->type, err);
+				ret = ret ? ret : err;
+			}
+		}
+	}
+
+	return ret;
+}
+
+void modem_info_cache_clear(void)
+{
+#if defined(CONFIG_MODEM_INFO_CACHE)
+	k_mutex_lock(&cache_mutex, K_FOREVER);
+	memset(cache, 0, sizeof(cache));
+	k_mutex_unlock(&cache_mutex);
+#endif
+}
+
+void modem_info_stats_get(struct modem_info_stats *info_stats)
+{
+	k_mutex_lock(&cache_mutex, K_FOREVER);
+	*info_stats = stats;
+	k_mutex_unlock(&cache_mutex);
+}
+
+void modem_info_stats_reset(void)
+{
+	k_mutex_lock(&cache_mutex, K_FOREVER);
+	memset(&stats, 0, sizeof(stats));
+	k_mutex_unlock(&cache_mutex);
+}
+
 static void modem_info_rsrp_subscribe_handler(void *context, const char *response)
 {
 	ARG_UNUSED(context);
@@ -636,8 +936,11 @@ int modem_info_rsrp_register(rsrp_cb_t cb)
 {
 	modem_info_rsrp_cb = cb;
 
-	int rc = at_notif_register_handler(NULL,
-		modem_info_rsrp_subscribe_handler);
+	static const char *const rsrp_notifs[] = { AT_CMD_CESQ_RESP };
+
+	int rc = at_notif_register_prefix_handler(NULL,
+		modem_info_rsrp_subscribe_handler, rsrp_notifs,
+		ARRAY_SIZE(rsrp_notifs));
 	if (rc != 0) {
 		LOG_ERR("Can't register handler rc=%d", rc);
 		return rc;
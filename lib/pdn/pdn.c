@@ -35,6 +35,9 @@ struct pdn {
 	int8_t context_id;
 };
 
+/* Notifications handled by this module. */
+static const char *const pdn_notifs[] = { "+CGEV", "+CNEC_ESM" };
+
 static int esm_from_notif;
 static struct k_sem notif_sem;
 static struct pdn pdn_contexts[CONFIG_PDN_CONTEXTS_MAX];
@@ -161,7 +164,9 @@ int pdn_init(void)
 		pdn_contexts[i].context_id = CID_UNASSIGNED;
 	}
 
-	err = at_notif_register_handler(NULL, at_notif_handler);
+	err = at_notif_register_prefix_handler(NULL, at_notif_handler,
+					       pdn_notifs,
+					       ARRAY_SIZE(pdn_notifs));
 	if (err) {
 		return err;
 	}
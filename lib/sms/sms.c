@@ -17,6 +17,7 @@
 #include "sms_submit.h"
 #include "sms_deliver.h"
 #include "sms_at.h"
+#include "sms_concat.h"
 #include "sms_internal.h"
 
 LOG_MODULE_REGISTER(sms, CONFIG_SMS_LOG_LEVEL);
@@ -36,6 +37,9 @@ LOG_MODULE_REGISTER(sms, CONFIG_SMS_LOG_LEVEL);
 /** @brief AT command to an ACK in PDU mode. */
 #define AT_SMS_PDU_ACK "AT+CNMA=1"
 
+/** @brief Prefixes of the AT notifications handled by this module. */
+static const char *const sms_notifs[] = { "+CMT", "+CDS" };
+
 /** @brief SMS structure where received SMS is parsed. */
 static struct sms_data sms_data_info;
 
@@ -109,6 +113,16 @@ void sms_at_handler(void *context, const char *at_notif)
 		return;
 	}
 
+	if (IS_ENABLED(CONFIG_SMS_CONCAT_REASSEMBLY)) {
+		/* Parts of concatenated messages are acknowledged as they are received,
+		 * but the message is delivered only once all parts have been received.
+		 */
+		err = sms_concat_process(&sms_data_info);
+		if (err) {
+			goto sms_ack;
+		}
+	}
+
 	/* Notify all subscribers. */
 	LOG_DBG("Valid SMS notification decoded");
 	for (size_t i = 0; i < ARRAY_SIZE(subscribers); i++) {
@@ -177,7 +191,8 @@ static int sms_init(void)
 	}
 
 	/* Register for AT commands notifications before creating the client. */
-	ret = at_notif_register_handler(NULL, sms_at_handler);
+	ret = at_notif_register_prefix_handler(NULL, sms_at_handler, sms_notifs,
+					       ARRAY_SIZE(sms_notifs));
 	if (ret) {
 		LOG_ERR("Cannot register AT notification handler, err: %d",
 			ret);
@@ -285,6 +300,10 @@ static void sms_uninit(void)
 	/* Cleanup resources. */
 	at_params_list_free(&resp_list);
 
+	if (IS_ENABLED(CONFIG_SMS_CONCAT_REASSEMBLY)) {
+		sms_concat_reset();
+	}
+
 	sms_client_registered = false;
 }
 
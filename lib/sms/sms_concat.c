@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <logging/log.h>
+#include <modem/sms.h>
+
+#include "sms_concat.h"
+
+LOG_MODULE_DECLARE(sms, CONFIG_SMS_LOG_LEVEL);
+
+/* A message of maximum length has all but its last part stored at the same time. */
+BUILD_ASSERT(CONFIG_SMS_CONCAT_PART_BUF_CNT >= CONFIG_SMS_CONCAT_MAX_PARTS - 1,
+	     "Not enough part buffers to reassemble a message of maximum length");
+
+/** @brief Reassembly timeout in milliseconds. */
+#define SMS_CONCAT_TIMEOUT_MS (CONFIG_SMS_CONCAT_TIMEOUT_SEC * MSEC_PER_SEC)
+
+/** @brief Part buffer index of a part that has not been received. */
+#define SMS_CONCAT_PART_NONE UINT8_MAX
+
+/** @brief Buffer holding the payload of a single part of a concatenated message. */
+struct sms_concat_part {
+	/** @brief Indicates whether the buffer is in use. */
+	bool in_use;
+	/** @brief Length of the payload. */
+	uint8_t len;
+	/** @brief Payload of the part. */
+	uint8_t payload[SMS_MAX_PAYLOAD_LEN_CHARS];
+};
+
+/** @brief Reassembly slot of a concatenated message. */
+struct sms_concat_slot {
+	/** @brief Indicates whether the slot is in use. */
+	bool in_use;
+	/** @brief Number of parts received. */
+	uint8_t count;
+	/** @brief Uptime in milliseconds when the first part was received. */
+	uint32_t start;
+	/** @brief Header of the part with the lowest sequence number received so far. */
+	struct sms_deliver_header header;
+	/** @brief Part buffer index for each part in sequence order. */
+	uint8_t parts[CONFIG_SMS_CONCAT_MAX_PARTS];
+};
+
+static struct sms_concat_slot slots[CONFIG_SMS_CONCAT_SLOT_CNT];
+static struct sms_concat_part part_bufs[CONFIG_SMS_CONCAT_PART_BUF_CNT];
+
+static void slot_free(struct sms_concat_slot *slot)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(slot->parts); i++) {
+		if (slot->parts[i] != SMS_CONCAT_PART_NONE) {
+			part_bufs[slot->parts[i]].in_use = false;
+		}
+	}
+
+	slot->in_use = false;
+}
+
+static void slot_evict(struct sms_concat_slot *slot, const char *reason)
+{
+	LOG_WRN("Dropping concatenated message %d from %s (%s), %d of %d parts received",
+		slot->header.concatenated.ref_number,
+		log_strdup(slot->header.originating_address.address_str),
+		reason,
+		slot->count,
+		slot->header.concatenated.total_msgs);
+
+	slot_free(slot);
+}
+
+/**
+ * @brief Evict the slots of messages that have not been completed in time.
+ *
+ * @param[in] now Current uptime in milliseconds.
+ */
+static void slots_expire(uint32_t now)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		if (slots[i].in_use && (now - slots[i].start) >= SMS_CONCAT_TIMEOUT_MS) {
+			slot_evict(&slots[i], "timeout");
+		}
+	}
+}
+
+/**
+ * @brief Find the slot in use with the oldest first part.
+ *
+ * @param[in] exclude Slot that is not considered, can be NULL.
+ *
+ * @return Oldest slot or NULL if there are no slots in use.
+ */
+static struct sms_concat_slot *slot_oldest(const struct sms_concat_slot *exclude)
+{
+	struct sms_concat_slot *oldest = NULL;
+
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		if (!slots[i].in_use || &slots[i] == exclude) {
+			continue;
+		}
+		if (oldest == NULL || (int32_t)(slots[i].start - oldest->start) < 0) {
+			oldest = &slots[i];
+		}
+	}
+
+	return oldest;
+}
+
+/**
+ * @brief Find the slot of the message a part belongs to.
+ *
+ * @details Parts are matched by originating address, reference number and total number
+ * of parts as specified in 3GPP TS 23.040 Section 9.2.3.24.1.
+ */
+static struct sms_concat_slot *slot_find(const struct sms_deliver_header *header)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		struct sms_concat_slot *slot = &slots[i];
+
+		if (slot->in_use &&
+		    slot->header.concatenated.ref_number == header->concatenated.ref_number &&
+		    slot->header.concatenated.total_msgs == header->concatenated.total_msgs &&
+		    strcmp(slot->header.originating_address.address_str,
+			   header->originating_address.address_str) == 0) {
+			return slot;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Take a free slot into use, evicting the oldest message if all slots are in use.
+ *
+ * @param[in] now Current uptime in milliseconds.
+ */
+static struct sms_concat_slot *slot_alloc(uint32_t now)
+{
+	struct sms_concat_slot *slot = NULL;
+
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		if (!slots[i].in_use) {
+			slot = &slots[i];
+			break;
+		}
+	}
+
+	if (slot == NULL) {
+		slot = slot_oldest(NULL);
+		slot_evict(slot, "no free slot");
+	}
+
+	memset(slot->parts, SMS_CONCAT_PART_NONE, sizeof(slot->parts));
+	slot->count = 0;
+	slot->start = now;
+	slot->in_use = true;
+
+	return slot;
+}
+
+/**
+ * @brief Take a free part buffer into use, evicting the oldest other messages if needed.
+ *
+ * @param[in] slot Slot the part buffer is taken for.
+ *
+ * @return Part buffer index or SMS_CONCAT_PART_NONE if no buffer could be freed.
+ */
+static uint8_t part_alloc(const struct sms_concat_slot *slot)
+{
+	struct sms_concat_slot *oldest;
+
+	do {
+		for (size_t i = 0; i < ARRAY_SIZE(part_bufs); i++) {
+			if (!part_bufs[i].in_use) {
+				part_bufs[i].in_use = true;
+				return i;
+			}
+		}
+
+		oldest = slot_oldest(slot);
+		if (oldest != NULL) {
+			slot_evict(oldest, "no free part buffer");
+		}
+	} while (oldest != NULL);
+
+	return SMS_CONCAT_PART_NONE;
+}
+
+/**
+ * @brief Assemble the complete message into the structure holding its last received part.
+ *
+ * @details The payload of the last received part is moved to its final position within the
+ * payload buffer first so that the stored parts can be copied around it.
+ *
+ * @param[in] slot Slot holding all other parts of the message and the header of the first
+ *                 part. Freed when done.
+ * @param[in,out] data Last received part, complete message on return.
+ */
+static void message_assemble(struct sms_concat_slot *slot, struct sms_data *data)
+{
+	uint8_t seq = data->header.deliver.concatenated.seq_number;
+	uint8_t total = data->header.deliver.concatenated.total_msgs;
+	size_t offset = 0;
+
+	for (int i = 0; i < seq - 1; i++) {
+		offset += part_bufs[slot->parts[i]].len;
+	}
+	memmove(data->payload + offset, data->payload, data->payload_len);
+
+	offset = 0;
+	for (int i = 0; i < total; i++) {
+		struct sms_concat_part *part;
+
+		if (i == seq - 1) {
+			offset += data->payload_len;
+			continue;
+		}
+
+		part = &part_bufs[slot->parts[i]];
+		memcpy(data->payload + offset, part->payload, part->len);
+		offset += part->len;
+	}
+
+	data->payload[offset] = '\0';
+	data->payload_len = offset;
+
+	data->header.deliver = slot->header;
+	data->header.deliver.concatenated.seq_number = 0;
+
+	LOG_DBG("Concatenated message %d reassembled, length: %d",
+		data->header.deliver.concatenated.ref_number, data->payload_len);
+
+	slot_free(slot);
+}
+
+int sms_concat_process(struct sms_data *data)
+{
+	struct sms_deliver_header *header = &data->header.deliver;
+	uint8_t seq = header->concatenated.seq_number;
+	uint8_t total = header->concatenated.total_msgs;
+	uint32_t now = k_uptime_get_32();
+	struct sms_concat_slot *slot;
+	struct sms_concat_part *part;
+	uint8_t index;
+
+	if (data->type != SMS_TYPE_DELIVER || !header->concatenated.present || total < 2) {
+		return 0;
+	}
+
+	if (total > CONFIG_SMS_CONCAT_MAX_PARTS) {
+		LOG_WRN("Concatenated message %d has too many parts (%d), delivering part %d",
+			header->concatenated.ref_number, total, seq);
+		return 0;
+	}
+
+	slots_expire(now);
+
+	slot = slot_find(header);
+	if (slot == NULL) {
+		slot = slot_alloc(now);
+	} else if (slot->parts[seq - 1] != SMS_CONCAT_PART_NONE) {
+		LOG_DBG("Ignoring duplicate part %d of concatenated message %d",
+			seq, header->concatenated.ref_number);
+		return -EALREADY;
+	}
+
+	if (slot->count == 0 || seq < slot->header.concatenated.seq_number) {
+		slot->header = *header;
+	}
+
+	if (slot->count + 1 == total) {
+		message_assemble(slot, data);
+		return 0;
+	}
+
+	index = part_alloc(slot);
+	if (index == SMS_CONCAT_PART_NONE) {
+		LOG_ERR("No part buffer for concatenated message %d, delivering part %d",
+			header->concatenated.ref_number, seq);
+		slot_evict(slot, "no free part buffer");
+		return 0;
+	}
+
+	part = &part_bufs[index];
+	part->len = data->payload_len;
+	memcpy(part->payload, data->payload, data->payload_len);
+
+	slot->parts[seq - 1] = index;
+	slot->count++;
+
+	LOG_DBG("Stored part %d of %d of concatenated message %d",
+		seq, total, header->concatenated.ref_number);
+
+	return -EINPROGRESS;
+}
+
+void sms_concat_reset(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		if (slots[i].in_use) {
+			slot_free(&slots[i]);
+		}
+	}
+}
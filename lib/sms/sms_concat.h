@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _SMS_CONCAT_INCLUDE_H_
+#define _SMS_CONCAT_INCLUDE_H_
+
+/* Forward declaration */
+struct sms_data;
+
+/**
+ * @brief Process a received SMS message for reassembly of concatenated messages.
+ *
+ * @details Parts of a concatenated message are stored into a fixed pool of reassembly slots
+ * until all parts of the message have been received. When the last missing part is processed,
+ * the complete message is assembled into the given structure, which then holds the header of
+ * the first part and the payload of all parts in sequence order.
+ *
+ * Messages that are not concatenated, or that consist of more parts than can be
+ * reassembled, are left untouched.
+ *
+ * @param[in,out] data Received SMS message.
+ *
+ * @retval -EINPROGRESS Part was stored and the message is not complete yet.
+ * @retval -EALREADY Part has already been received and was ignored.
+ * @return Zero if the message in @p data should be delivered to listeners.
+ */
+int sms_concat_process(struct sms_data *data);
+
+/**
+ * @brief Drop all partially received concatenated messages.
+ */
+void sms_concat_reset(void);
+
+#endif
@@ -610,7 +610,7 @@ static int decode_pdu_ud_7bit(struct parser *parser, uint8_t *buf)
 	struct pdu_deliver_data * const pdata = parser->data;
 	uint16_t actual_data_length;
 	uint8_t length;
-	uint8_t skip_bits;
+	uint16_t skip_bits;
 	uint8_t skip_septets;
 	int length_udh_skipped;
 
@@ -628,13 +628,16 @@ static int decode_pdu_ud_7bit(struct parser *parser, uint8_t *buf)
 
 	actual_data_length = MIN(actual_data_length, pdata->udl);
 
-	/* Convert GSM 7bit data to ASCII characters */
-	length = string_conversion_gsm7bit_to_ascii(
-		buf, sms_payload_tmp, actual_data_length, true);
+	/* Verify that payload buffer is not too short */
+	__ASSERT(actual_data_length <= parser->payload_buf_size,
+		"GSM 7bit User-Data-Length shorter than output buffer");
+
+	/* Unpack GSM 7bit data directly into the output buffer */
+	length = string_conversion_7bit_sms_unpacking(buf, parser->payload, actual_data_length);
 
 	/* Check whether User Data Header is present.
-	 * If yes, we need to skip those septets in the sms_payload_tmp, which has all of the data
-	 * decoded including User Data Header. This is done because the actual data/text is
+	 * If yes, we need to skip those septets in the unpacked data, which has all of the data
+	 * unpacked including User Data Header. This is done because the actual data/text is
 	 * aligned into septet (7bit) boundary after User Data Header.
 	 */
 	skip_bits = pdata->udhl * 8;
@@ -644,18 +647,19 @@ static int decode_pdu_ud_7bit(struct parser *parser, uint8_t *buf)
 		skip_septets++;
 	}
 
-	/* Number of characters/bytes in the actual data which excludes
-	 * User Data Header but minimum is 0. In some corner cases this would
-	 * result in negative value causing crashes.
+	/* Number of septets in the actual data which excludes User Data Header but minimum is 0.
+	 * In some corner cases this would result in negative value causing crashes.
 	 */
 	length_udh_skipped = (length >= skip_septets) ? (int)(length - skip_septets) : 0;
 
-	/* Verify that payload buffer is not too short */
-	__ASSERT(length_udh_skipped <= parser->payload_buf_size,
-		"GSM 7bit User-Data-Length shorter than output buffer");
+	/* Convert the actual data to ASCII characters in place. Conversion never produces more
+	 * characters than it consumes septets so the output does not overtake the input.
+	 */
+	length_udh_skipped = string_conversion_gsm7bit_to_ascii(
+		parser->payload + skip_septets, parser->payload, length_udh_skipped, false);
 
-	/* Copy decoded data/text into the output buffer */
-	memcpy(parser->payload, sms_payload_tmp + skip_septets, length_udh_skipped);
+	/* Clear the septets left behind the converted data */
+	memset(parser->payload + length_udh_skipped, 0, length - length_udh_skipped);
 
 	return length_udh_skipped;
 }
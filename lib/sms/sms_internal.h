@@ -22,7 +22,7 @@ extern uint8_t sms_buf_tmp[SMS_BUF_TMP_LEN];
 /**
  * @brief Temporary buffer for SMS payload.
  *
- * @details Will be used at least as output for encoding and decoding of SMS payload.
+ * @details Will be used at least as output for encoding of SMS payload.
  * However, this is a temporary internal buffer that can be used for other purposes too.
  * Be careful when using this internal buffer so that the caller hasn't already passed the data
  * using the same buffer.
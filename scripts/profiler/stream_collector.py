@@ -0,0 +1,142 @@
+#
+# Copyright (c) 2021 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+from events import EventsData
+from stream_decoder import StreamDecoder
+from rtt_nordic_config import RttNordicConfig
+import sys
+import argparse
+import logging
+import signal
+import threading
+import time
+
+
+RTT_STREAM_CHANNEL_NAME = 'Nordic profiler stream'
+
+
+class RttSource():
+    def __init__(self, config=RttNordicConfig):
+        from pynrfjprog.LowLevel import API
+        from rtt_nordic_profiler_host import RttNordicProfilerHost
+
+        self.config = config
+        snr = config['device_snr']
+        device_family = RttNordicProfilerHost.rtt_get_device_family(snr)
+        self.jlink = API(device_family)
+        self.jlink.open()
+        if snr is not None:
+            self.jlink.connect_to_emu_with_snr(snr)
+        else:
+            self.jlink.connect_to_emu_without_snr()
+
+        if config['reset_on_start']:
+            self.jlink.sys_reset()
+            self.jlink.go()
+
+        self.jlink.rtt_start()
+        while not self.jlink.rtt_is_control_block_found():
+            time.sleep(0.2)
+
+        self.channel = None
+        while self.channel is None:
+            _, up_channel_cnt = self.jlink.rtt_read_channel_count()
+            for idx in range(0, up_channel_cnt):
+                chan_name, _ = self.jlink.rtt_read_channel_info(
+                    idx, 'UP_DIRECTION')
+                if chan_name == RTT_STREAM_CHANNEL_NAME:
+                    self.channel = idx
+
+    def read(self):
+        data = self.jlink.rtt_read(self.channel,
+                                   self.config['rtt_read_chunk_size'],
+                                   encoding=None)
+        if len(data) == 0:
+            time.sleep(self.config['rtt_read_period'])
+        return bytes(data)
+
+    def close(self):
+        self.jlink.rtt_stop()
+        self.jlink.disconnect_from_emu()
+        self.jlink.close()
+
+
+class UartSource():
+    def __init__(self, port, baudrate):
+        import serial
+
+        self.serial = serial.Serial(port, baudrate, timeout=0.1)
+
+    def read(self):
+        return self.serial.read(max(1, self.serial.in_waiting))
+
+    def close(self):
+        self.serial.close()
+
+
+class FileSource():
+    def __init__(self, filename):
+        self.file = open(filename, 'rb')
+
+    def read(self):
+        data = self.file.read(4096)
+        if len(data) == 0:
+            time.sleep(0.1)
+        return data
+
+    def close(self):
+        self.file.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Collecting data from stream profiler for given time and saving to files.')
+    parser.add_argument('time', type=int, help='Time of collecting data [s]')
+    parser.add_argument('dataset_name', help='Name of dataset')
+    parser.add_argument('--uart', help='Read stream from given serial port')
+    parser.add_argument('--baudrate', type=int, default=115200,
+                        help='Baudrate of serial port')
+    parser.add_argument('--file', help='Read stream from given file')
+    parser.add_argument('--log', help='Log level')
+    args = parser.parse_args()
+
+    if args.log is not None:
+        log_lvl_number = int(getattr(logging, args.log.upper(), None))
+    else:
+        log_lvl_number = logging.INFO
+
+    def sigint_handler(sig, frame):
+        end_ev.set()
+
+    signal.signal(signal.SIGINT, sigint_handler)
+    end_ev = threading.Event()
+
+    if args.file is not None:
+        source = FileSource(args.file)
+    elif args.uart is not None:
+        source = UartSource(args.uart, args.baudrate)
+    else:
+        source = RttSource()
+
+    events_data = EventsData([], {})
+    decoder = StreamDecoder(events_data, log_lvl=log_lvl_number)
+
+    start_time = time.time()
+    while not end_ev.is_set():
+        if args.time >= 0 and time.time() - start_time > args.time:
+            break
+        decoder.feed(source.read())
+
+    source.close()
+    events_data.write_data_to_files(args.dataset_name + ".csv",
+                                    args.dataset_name + ".json")
+    if decoder.dropped_cnt > 0:
+        decoder.logger.warning("Events dropped by device: {}".format(
+            decoder.dropped_cnt))
+    decoder.logger.info("Events data saved to files")
+    sys.exit()
+
+if __name__ == "__main__":
+    main()
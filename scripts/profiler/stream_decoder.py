@@ -0,0 +1,176 @@
+#
+# Copyright (c) 2021 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+from events import Event, EventType
+import logging
+import struct
+
+
+class RecordType():
+    HEADER = 0x01
+    EVENT_DESCR = 0x02
+    EVENT = 0x03
+    DROPPED = 0x04
+
+
+class StreamDecoder():
+    """Incremental decoder of the binary stream sent by stream profiler.
+
+    Data received from the device can be fed in chunks of any size. Every
+    record is prefixed with a sync byte, its type and payload length, so
+    records of unknown type are skipped. If the sync byte is missing, the
+    payload length does not match the record type or the record is not
+    followed by another record, the data is dropped until the next sync
+    byte. Event types are learned from the descriptions that the device
+    resends periodically.
+    """
+    RECORD_SYNC = 0x5A
+    RECORD_HDR_SIZE = 3
+    STREAM_MAGIC = b'NPRF'
+    STREAM_VERSION = 2
+    HEADER_SIZE = len(STREAM_MAGIC) + struct.calcsize('<BI')
+    DROPPED_SIZE = struct.calcsize('<I')
+    EVENT_DESCR_HDR_SIZE = struct.calcsize('<H')
+    EVENT_HDR_SIZE = struct.calcsize('<HQ')
+
+    def __init__(self, events_data, queue=None, log_lvl=logging.WARNING):
+        self.events_data = events_data
+        self.queue = queue
+        self.buf = bytearray()
+        self.ticks_per_sec = None
+        self.dropped_cnt = 0
+        self.skipped_bytes = 0
+
+        self.logger = logging.getLogger('Stream decoder')
+        self.logger_console = logging.StreamHandler()
+        self.logger.setLevel(log_lvl)
+        self.log_format = logging.Formatter(
+                              '[%(levelname)s] %(name)s: %(message)s')
+        self.logger_console.setFormatter(self.log_format)
+        self.logger.addHandler(self.logger_console)
+
+    def feed(self, data):
+        self.buf += data
+        pos = 0
+        while len(self.buf) - pos >= self.RECORD_HDR_SIZE:
+            sync, rec_type, rec_len = struct.unpack_from('<BBB', self.buf,
+                                                         pos)
+            if sync != self.RECORD_SYNC or \
+               not self._record_len_valid(rec_type, rec_len):
+                pos = self._resync(pos)
+                continue
+            rec_end = pos + self.RECORD_HDR_SIZE + rec_len
+            if rec_end > len(self.buf):
+                break
+            if rec_end < len(self.buf) and \
+               self.buf[rec_end] != self.RECORD_SYNC:
+                pos = self._resync(pos)
+                continue
+            payload = bytes(self.buf[pos + self.RECORD_HDR_SIZE:rec_end])
+            self._process_record(rec_type, payload)
+            pos = rec_end
+        del self.buf[:pos]
+
+    def _resync(self, pos):
+        next_sync = self.buf.find(bytes([self.RECORD_SYNC]), pos + 1)
+        if next_sync < 0:
+            next_sync = len(self.buf)
+        skipped = next_sync - pos
+        self.skipped_bytes += skipped
+        self.logger.warning("Invalid data in stream, skipped {} bytes".format(
+            skipped))
+        return next_sync
+
+    def _record_len_valid(self, rec_type, rec_len):
+        if rec_type == RecordType.HEADER:
+            return rec_len == self.HEADER_SIZE
+        elif rec_type == RecordType.EVENT_DESCR:
+            return rec_len > self.EVENT_DESCR_HDR_SIZE
+        elif rec_type == RecordType.EVENT:
+            return rec_len >= self.EVENT_HDR_SIZE
+        elif rec_type == RecordType.DROPPED:
+            return rec_len == self.DROPPED_SIZE
+        return True
+
+    def _process_record(self, rec_type, payload):
+        if rec_type == RecordType.HEADER:
+            self._process_header(payload)
+        elif rec_type == RecordType.EVENT_DESCR:
+            self._process_event_descr(payload)
+        elif rec_type == RecordType.EVENT:
+            self._process_event(payload)
+        elif rec_type == RecordType.DROPPED:
+            cnt, = struct.unpack_from('<I', payload)
+            self.dropped_cnt += cnt
+            self.logger.warning("Device dropped {} events".format(cnt))
+        else:
+            self.logger.warning("Unknown record type: {}".format(rec_type))
+
+    def _process_header(self, payload):
+        magic = payload[0:len(self.STREAM_MAGIC)]
+        version, ticks_per_sec = struct.unpack_from(
+            '<BI', payload, len(self.STREAM_MAGIC))
+        if magic != self.STREAM_MAGIC or version != self.STREAM_VERSION:
+            self.logger.error("Unsupported stream: {} version {}".format(
+                magic, version))
+        # Header is resent periodically with the event descriptions.
+        if ticks_per_sec != self.ticks_per_sec:
+            self.ticks_per_sec = ticks_per_sec
+            self.logger.info("Stream started, {} ticks per second".format(
+                self.ticks_per_sec))
+
+    def _process_event_descr(self, payload):
+        id, = struct.unpack_from('<H', payload)
+        desc_fields = payload[2:].decode('utf-8').split(',')
+
+        name = desc_fields[0]
+        data_type = []
+        for i in range(2, len(desc_fields) // 2 + 1):
+            data_type.append(desc_fields[i])
+        data = []
+        for i in range(len(desc_fields) // 2 + 1, len(desc_fields)):
+            data.append(desc_fields[i])
+
+        et = EventType(name, data_type, data)
+        registered = self.events_data.registered_events_types.get(id)
+        if registered is not None and \
+           registered.serialize() == et.serialize():
+            # Description resent by the device.
+            return
+        self.events_data.registered_events_types[id] = et
+        if self.queue is not None:
+            self.queue.put(self.events_data.registered_events_types)
+
+    def _process_event(self, payload):
+        if self.ticks_per_sec is None:
+            self.logger.warning("Event received before stream header")
+            return
+
+        id, timestamp_raw = struct.unpack_from('<HQ', payload)
+        et = self.events_data.registered_events_types.get(id)
+        if et is None:
+            self.logger.warning("Event of unknown type: {}".format(id))
+            return
+
+        data_len = len(payload) - self.EVENT_HDR_SIZE
+        if data_len != struct.calcsize('<I') * len(et.data_types):
+            self.logger.warning("Wrong length of event {}: {}".format(
+                id, len(payload)))
+            return
+
+        # Timestamps are 64-bit, no overflow handling is needed.
+        timestamp = timestamp_raw / self.ticks_per_sec
+
+        data = []
+        offset = struct.calcsize('<HQ')
+        for i in et.data_types:
+            fmt = '<i' if i[0] == 's' else '<I'
+            data.append(struct.unpack_from(fmt, payload, offset)[0])
+            offset += struct.calcsize(fmt)
+
+        event = Event(id, timestamp, data)
+        self.events_data.events.append(event)
+        if self.queue is not None:
+            self.queue.put(event)
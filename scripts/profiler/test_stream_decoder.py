@@ -0,0 +1,148 @@
+#
+# Copyright (c) 2021 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+from events import EventsData
+from stream_decoder import RecordType, StreamDecoder
+import logging
+import queue
+import struct
+import unittest
+
+
+TICKS_PER_SEC = 32768
+
+
+def record(rec_type, payload):
+    return struct.pack('<BBB', StreamDecoder.RECORD_SYNC, rec_type,
+                       len(payload)) + payload
+
+
+def header_record():
+    return record(RecordType.HEADER,
+                  StreamDecoder.STREAM_MAGIC +
+                  struct.pack('<BI', StreamDecoder.STREAM_VERSION,
+                              TICKS_PER_SEC))
+
+
+def descr_record(id, descr):
+    return record(RecordType.EVENT_DESCR,
+                  struct.pack('<H', id) + descr.encode('utf-8'))
+
+
+def event_record(id, ticks, data):
+    return record(RecordType.EVENT,
+                  struct.pack('<HQ', id, ticks) +
+                  b''.join(struct.pack('<I', d) for d in data))
+
+
+def dropped_record(cnt):
+    return record(RecordType.DROPPED, struct.pack('<I', cnt))
+
+
+class TestStreamDecoder(unittest.TestCase):
+    def setUp(self):
+        self.events_data = EventsData([], {})
+        self.queue = queue.Queue()
+        self.decoder = StreamDecoder(self.events_data, self.queue,
+                                     log_lvl=logging.CRITICAL)
+        self.start = header_record() + \
+            descr_record(0, 'button,0,u32,s32,id,value') + \
+            descr_record(1, 'click,1')
+
+    def test_records(self):
+        self.decoder.feed(self.start +
+                          event_record(0, 2 * TICKS_PER_SEC, [7, 0xFFFFFFFF]) +
+                          event_record(1, TICKS_PER_SEC // 2, []) +
+                          dropped_record(3))
+
+        et = self.events_data.registered_events_types[0]
+        self.assertEqual(et.name, 'button')
+        self.assertEqual(et.data_types, ['u32', 's32'])
+        self.assertEqual(et.data_descriptions, ['id', 'value'])
+        self.assertEqual(self.events_data.registered_events_types[1].name,
+                         'click')
+
+        events = self.events_data.events
+        self.assertEqual(len(events), 2)
+        self.assertEqual(events[0].type_id, 0)
+        self.assertEqual(events[0].timestamp, 2.0)
+        self.assertEqual(events[0].data, [7, -1])
+        self.assertEqual(events[1].timestamp, 0.5)
+        self.assertEqual(events[1].data, [])
+        self.assertEqual(self.decoder.dropped_cnt, 3)
+        self.assertEqual(self.decoder.skipped_bytes, 0)
+
+    def test_split_records(self):
+        stream = self.start + event_record(0, 100, [1, 2])
+        for i in range(len(stream)):
+            self.decoder.feed(stream[i:i + 1])
+
+        self.assertEqual(len(self.events_data.events), 1)
+        self.assertEqual(self.events_data.events[0].data, [1, 2])
+        self.assertEqual(self.decoder.skipped_bytes, 0)
+        self.assertEqual(len(self.decoder.buf), 0)
+
+    def test_resync_on_garbage(self):
+        garbage = bytes([0x00, StreamDecoder.RECORD_SYNC, 0xFF, 0x13])
+        # Looks like a record header, but the length is wrong.
+        bad_header = bytes([StreamDecoder.RECORD_SYNC, RecordType.HEADER,
+                            0x01, 0xFF])
+        self.decoder.feed(garbage + self.start + bad_header +
+                          event_record(1, 10, []) +
+                          event_record(1, 20, []))
+
+        self.assertEqual(self.decoder.skipped_bytes,
+                         len(garbage) + len(bad_header))
+        self.assertEqual([e.timestamp * TICKS_PER_SEC
+                          for e in self.events_data.events], [10, 20])
+
+    def test_resync_on_lost_bytes(self):
+        lost = event_record(0, 30, [1, 2])
+        self.decoder.feed(self.start + lost[:-3] +
+                          event_record(1, 40, []))
+
+        self.assertEqual(self.decoder.skipped_bytes, len(lost) - 3)
+        self.assertEqual(len(self.events_data.events), 1)
+        self.assertEqual(self.events_data.events[0].type_id, 1)
+
+    def test_record_length_check(self):
+        header = header_record()
+        self.decoder.feed(record(RecordType.HEADER, header[3:] + b'\x00') +
+                          record(RecordType.DROPPED, b'\x01\x00\x00'))
+        self.assertIsNone(self.decoder.ticks_per_sec)
+        self.assertEqual(self.decoder.dropped_cnt, 0)
+        self.assertGreater(self.decoder.skipped_bytes, 0)
+
+        # Event length must match its description.
+        self.decoder.feed(self.start + event_record(0, 50, [1]) +
+                          event_record(0, 60, [1, 2]))
+        self.assertEqual(len(self.events_data.events), 1)
+        self.assertEqual(self.events_data.events[0].data, [1, 2])
+
+    def test_late_start(self):
+        # Host connects after the device started sending the stream.
+        self.decoder.feed(event_record(0, 70, [1, 2]))
+        self.assertEqual(len(self.events_data.events), 0)
+
+        self.decoder.feed(self.start + event_record(0, 80, [3, 4]))
+        self.assertEqual(len(self.events_data.events), 1)
+        self.assertEqual(self.events_data.events[0].data, [3, 4])
+
+    def test_descr_resend(self):
+        self.decoder.feed(self.start)
+        queued = self.queue.qsize()
+
+        # Periodic resend does not register the event types again.
+        self.decoder.feed(self.start + event_record(1, 90, []))
+        self.assertEqual(self.queue.qsize(), queued + 1)
+
+        self.decoder.feed(descr_record(1, 'click,1,u32,id') +
+                          event_record(1, 100, [5]))
+        self.assertEqual(self.queue.qsize(), queued + 3)
+        self.assertEqual(self.events_data.events[-1].data, [5])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**
+ * @file
+ * @brief Light LC fixed-point illuminance regulator
+ *
+ * Integer implementation of the Light LC Server's PI regulator and
+ * illuminance fade, for cores without an FPU. Illuminance values are passed
+ * in centilux, and the regulator works on the error in units of 1/10000 lux.
+ * The regulator coefficients and the integral sum are fixed-point numbers
+ * with @ref REG_FIXED_FRAC_BITS fractional bits.
+ */
+
+#ifndef LIGHT_CTRL_REG_FIXED_H__
+#define LIGHT_CTRL_REG_FIXED_H__
+
+#include <zephyr.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of fractional bits in the fixed-point coefficients and sum. */
+#define REG_FIXED_FRAC_BITS 32
+
+/** Number of regulator input units per centilux. */
+#define REG_FIXED_CENTI_LUX_SCALE 100
+
+/** Number of regulator input units per lux. */
+#define REG_FIXED_LUX_SCALE (100 * REG_FIXED_CENTI_LUX_SCALE)
+
+/** Largest coefficient magnitude that fits the fixed-point format. */
+#define REG_FIXED_COEFF_MAX 4000.0f
+
+/** @brief Convert a regulator coefficient to fixed-point.
+ *
+ *  The coefficient is scaled to the regulator input unit and the regulator
+ *  step interval, and clamped to @ref REG_FIXED_COEFF_MAX.
+ *
+ *  @param coeff Floating point coefficient.
+ *  @param interval Regulator step interval (in milliseconds), or
+ *                  @c MSEC_PER_SEC for proportional coefficients.
+ *
+ *  @return Fixed-point coefficient.
+ */
+static inline int32_t reg_fixed_coeff(float coeff, uint32_t interval)
+{
+	coeff = CLAMP(coeff, -REG_FIXED_COEFF_MAX, REG_FIXED_COEFF_MAX);
+
+	return (coeff * interval / MSEC_PER_SEC) *
+	       ((float)(1ULL << REG_FIXED_FRAC_BITS) / REG_FIXED_LUX_SCALE);
+}
+
+/** @brief Get the regulator input for the given illuminance values.
+ *
+ *  Errors within the dead zone of the regulator, given by @p accuracy,
+ *  result in zero input.
+ *
+ *  @param target Target illuminance (in centilux).
+ *  @param ambient Ambient illuminance (in centilux).
+ *  @param accuracy Regulator accuracy (in percent).
+ *
+ *  @return Regulator input (in 1/10000 lux).
+ */
+static inline int32_t reg_fixed_input(uint32_t target, uint32_t ambient,
+				      uint8_t accuracy)
+{
+	int32_t error = ((int32_t)target - (int32_t)ambient) *
+			REG_FIXED_CENTI_LUX_SCALE;
+	/* Accuracy is in percent and both up and down, which makes the dead
+	 * zone accuracy * target / 200 lux, or accuracy * target / 2 in input
+	 * units:
+	 */
+	int32_t dead_zone = (accuracy * target) / 2;
+
+	if (error > dead_zone) {
+		return error - dead_zone;
+	}
+
+	if (error < -dead_zone) {
+		return error + dead_zone;
+	}
+
+	return 0;
+}
+
+/** @brief Run a single step of the regulator.
+ *
+ *  @param[in,out] i Integral sum.
+ *  @param input Regulator input, as returned by @ref reg_fixed_input.
+ *  @param kp Fixed-point proportional coefficient.
+ *  @param ki Fixed-point integral coefficient.
+ *
+ *  @return Regulator output, as a linear lightness level.
+ */
+static inline uint16_t reg_fixed_step(int64_t *i, int32_t input, int32_t kp,
+				      int32_t ki)
+{
+	int64_t output;
+
+	*i += (int64_t)input * ki;
+	*i = CLAMP(*i, 0, (int64_t)UINT16_MAX << REG_FIXED_FRAC_BITS);
+
+	output = (*i + (int64_t)input * kp) >> REG_FIXED_FRAC_BITS;
+
+	return CLAMP(output, 0, UINT16_MAX);
+}
+
+/** @brief Interpolate the illuminance of a fade.
+ *
+ *  @param start Illuminance at the start of the fade (in centilux).
+ *  @param end Illuminance at the end of the fade (in centilux).
+ *  @param curr Time since the start of the fade (in milliseconds).
+ *  @param duration Duration of the fade (in milliseconds).
+ *
+ *  @return Current illuminance (in centilux).
+ */
+static inline uint32_t reg_fixed_fade(uint32_t start, uint32_t end,
+				      uint32_t curr, uint32_t duration)
+{
+	if (curr >= duration) {
+		return end;
+	}
+
+	return start + ((int64_t)end - start) * curr / duration;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIGHT_CTRL_REG_FIXED_H__ */
@@ -10,6 +10,7 @@
 #include <bluetooth/mesh/properties.h>
 #include "lightness_internal.h"
 #include "light_ctrl_internal.h"
+#include "light_ctrl_reg_fixed.h"
 #include "gen_onoff_internal.h"
 #include "sensor.h"
 #include "model_utils.h"
@@ -56,9 +57,25 @@ static void restart_timer(struct bt_mesh_light_ctrl_srv *srv, uint32_t delay)
 	k_work_reschedule(&srv->timer, K_MSEC(delay));
 }
 
+#if CONFIG_BT_MESH_LIGHT_CTRL_SRV_REG
+static void reg_coeffs_update(struct bt_mesh_light_ctrl_srv *srv)
+{
+#if CONFIG_BT_MESH_LIGHT_CTRL_SRV_REG_FIXED_POINT
+	/* Convert the coefficients once, so the regulator steps don't need
+	 * any floating point operations:
+	 */
+	srv->reg.kiu = reg_fixed_coeff(srv->reg.cfg.kiu, REG_INT);
+	srv->reg.kid = reg_fixed_coeff(srv->reg.cfg.kid, REG_INT);
+	srv->reg.kpu = reg_fixed_coeff(srv->reg.cfg.kpu, MSEC_PER_SEC);
+	srv->reg.kpd = reg_fixed_coeff(srv->reg.cfg.kpd, MSEC_PER_SEC);
+#endif
+}
+#endif
+
 static void reg_start(struct bt_mesh_light_ctrl_srv *srv)
 {
 #if CONFIG_BT_MESH_LIGHT_CTRL_SRV_REG
+	reg_coeffs_update(srv);
 	k_work_schedule(&srv->reg.timer, K_MSEC(REG_INT));
 #endif
 }
@@ -71,7 +88,7 @@ static inline uint32_t to_centi_lux(const struct sensor_value *lux)
 static inline void from_centi_lux(uint32_t centi_lux, struct sensor_value *lux)
 {
 	lux->val1 = centi_lux / 100L;
-	lux->val2 = centi_lux % 10000L;
+	lux->val2 = (centi_lux % 100L) * 10000L;
 }
 
 static void store(struct bt_mesh_light_ctrl_srv *srv, enum flags kind)
@@ -314,9 +331,21 @@ static uint16_t light_get(struct bt_mesh_light_ctrl_srv *srv)
 
 #if CONFIG_BT_MESH_LIGHT_CTRL_SRV_REG
 
-static float sensor_to_float(struct sensor_value *val)
+static uint32_t centi_lux_get(struct bt_mesh_light_ctrl_srv *srv)
 {
-	return val->val1 + val->val2 / 1000000.0f;
+	if (!is_enabled(srv)) {
+		return 0;
+	}
+
+	uint32_t cfg = to_centi_lux(&srv->reg.cfg.lux[srv->state]);
+
+	if (!atomic_test_bit(&srv->flags, FLAG_TRANSITION) ||
+	    !srv->fade.duration) {
+		return cfg;
+	}
+
+	return reg_fixed_fade(to_centi_lux(&srv->fade.initial_lux), cfg,
+			      curr_fade_time(srv), srv->fade.duration);
 }
 
 static void lux_get(struct bt_mesh_light_ctrl_srv *srv,
@@ -333,12 +362,13 @@ static void lux_get(struct bt_mesh_light_ctrl_srv *srv,
 		return;
 	}
 
-	uint32_t delta = curr_fade_time(srv);
-	uint32_t init = to_centi_lux(&srv->fade.initial_lux);
-	uint32_t cfg = to_centi_lux(&srv->reg.cfg.lux[srv->state]);
-	uint32_t centi_lux = init + ((cfg - init) * delta) / srv->fade.duration;
+	from_centi_lux(centi_lux_get(srv), lux);
+}
 
-	from_centi_lux(centi_lux, lux);
+#if !CONFIG_BT_MESH_LIGHT_CTRL_SRV_REG_FIXED_POINT
+static float sensor_to_float(struct sensor_value *val)
+{
+	return val->val1 + val->val2 / 1000000.0f;
 }
 
 static float lux_getf(struct bt_mesh_light_ctrl_srv *srv)
@@ -358,6 +388,7 @@ static float lux_getf(struct bt_mesh_light_ctrl_srv *srv)
 
 	return to_centi_lux(&srv->reg.cfg.lux[srv->state]) / 100.0f;
 }
+#endif
 
 #else
 
@@ -526,6 +557,20 @@ static void reg_step(struct k_work *work)
 
 	k_work_reschedule(&srv->reg.timer, K_MSEC(REG_INT));
 
+#if CONFIG_BT_MESH_LIGHT_CTRL_SRV_REG_FIXED_POINT
+	int32_t input = reg_fixed_input(centi_lux_get(srv),
+					to_centi_lux(&srv->ambient_lux),
+					srv->reg.cfg.accuracy);
+	uint16_t output;
+
+	if (input >= 0) {
+		output = reg_fixed_step(&srv->reg.i, input, srv->reg.kpu,
+					srv->reg.kiu);
+	} else {
+		output = reg_fixed_step(&srv->reg.i, input, srv->reg.kpd,
+					srv->reg.kid);
+	}
+#else
 	float target = lux_getf(srv);
 	float ambient = sensor_to_float(&srv->ambient_lux);
 	float error = target - ambient;
@@ -556,6 +601,7 @@ static void reg_step(struct k_work *work)
 
 	float p = input * kp;
 	uint16_t output = CLAMP(srv->reg.i + p, 0, UINT16_MAX);
+#endif
 
 	/* The regulator output is always in linear format. We'll convert to
 	 * the configured representation again before calling the Lightness
@@ -1184,26 +1230,27 @@ static int prop_set(struct net_buf_simple *buf,
 	/* Regulator coefficients are raw IEEE-754 floats, pull them straight
 	 * from the buffer instead of using sensor to decode them:
 	 */
+	float *coeff = NULL;
+
 	switch (id) {
 	case BT_MESH_LIGHT_CTRL_COEFF_KID:
-		memcpy(&srv->reg.cfg.kid,
-		       net_buf_simple_pull_mem(buf, sizeof(float)),
-		       sizeof(float));
-		return 0;
+		coeff = &srv->reg.cfg.kid;
+		break;
 	case BT_MESH_LIGHT_CTRL_COEFF_KIU:
-		memcpy(&srv->reg.cfg.kiu,
-		       net_buf_simple_pull_mem(buf, sizeof(float)),
-		       sizeof(float));
-		return 0;
+		coeff = &srv->reg.cfg.kiu;
+		break;
 	case BT_MESH_LIGHT_CTRL_COEFF_KPD:
-		memcpy(&srv->reg.cfg.kpd,
-		       net_buf_simple_pull_mem(buf, sizeof(float)),
-		       sizeof(float));
-		return 0;
+		coeff = &srv->reg.cfg.kpd;
+		break;
 	case BT_MESH_LIGHT_CTRL_COEFF_KPU:
-		memcpy(&srv->reg.cfg.kpu,
-		       net_buf_simple_pull_mem(buf, sizeof(float)),
+		coeff = &srv->reg.cfg.kpu;
+		break;
+	}
+
+	if (coeff) {
+		memcpy(coeff, net_buf_simple_pull_mem(buf, sizeof(float)),
 		       sizeof(float));
+		reg_coeffs_update(srv);
 		return 0;
 	}
 #endif
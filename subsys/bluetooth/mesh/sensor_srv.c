@@ -24,13 +24,22 @@
 static struct bt_mesh_sensor *sensor_get(struct bt_mesh_sensor_srv *srv,
 					 uint16_t id)
 {
-	struct bt_mesh_sensor *sensor;
+	int low = 0;
+	int high = srv->sensor_count;
+
+	while (low < high) {
+		int mid = low + (high - low) / 2;
+		struct bt_mesh_sensor *sensor = srv->sensors_by_id[mid];
 
-	SENSOR_FOR_EACH(&srv->sensors, sensor)
-	{
 		if (sensor->type->id == id) {
 			return sensor;
 		}
+
+		if (sensor->type->id < id) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
 	}
 
 	return NULL;
@@ -860,6 +869,7 @@ static int sensor_srv_init(struct bt_mesh_model *model)
 		}
 
 		sys_slist_append(&srv->sensors, &best->state.node);
+		srv->sensors_by_id[count] = best;
 		BT_DBG("Sensor 0x%04x", best->type->id);
 		min_id = best->type->id + 1;
 	}
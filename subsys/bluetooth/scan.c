@@ -100,6 +100,9 @@ struct bt_scan_addr_filter {
 struct bt_scan_uuid {
 	/* Pointer to the appropriate type of UUID. **/
 	struct bt_uuid *uuid;
+
+	/* UUID converted to 128-bit form, used as the lookup key. */
+	uint8_t key[BT_SCAN_UUID_128_SIZE];
 	union {
 		/* 16-bit UUID. */
 		struct bt_uuid_16 uuid_16;
@@ -194,8 +197,29 @@ struct bt_scan_filters {
 	 * matched to generate an event.
 	 */
 	bool all_mode;
+
+	/* Number of enabled filters. */
+	uint8_t enabled_cnt;
+};
+
+/* Filter lookup index.
+ * The filters are kept in the order they were added, and every index array
+ * holds the filter positions sorted by the filter value. It is updated when
+ * a filter is added, so that the advertising reports can be matched using
+ * binary search instead of comparing them with every filter.
+ */
+struct bt_scan_filter_index {
+	uint8_t name[CONFIG_BT_SCAN_NAME_CNT];
+	uint8_t short_name[CONFIG_BT_SCAN_SHORT_NAME_CNT];
+	uint8_t addr[CONFIG_BT_SCAN_ADDRESS_CNT];
+	uint8_t uuid[CONFIG_BT_SCAN_UUID_CNT];
+	uint8_t appearance[CONFIG_BT_SCAN_APPEARANCE_CNT];
+	uint8_t manufacturer_data[CONFIG_BT_SCAN_MANUFACTURER_DATA_CNT];
 };
 
+/* Compares the filter at the given position with the key. */
+typedef int (*filter_cmp_t)(uint8_t pos, const void *key);
+
 #if CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER
 /* Connection attempts filter device */
 struct conn_attempts_device {
@@ -230,6 +254,60 @@ struct conn_blocklist {
 };
 #endif /* CONFIG_BT_SCAN_BLOCKLIST */
 
+#if CONFIG_BT_SCAN_DEDUP
+/* Types of reports that are cached separately for a device. With active
+ * scanning, a device sends the advertising data and the scan response
+ * one after the other.
+ */
+enum dedup_report_type {
+	DEDUP_REPORT_ADV,
+	DEDUP_REPORT_SCAN_RSP,
+
+	DEDUP_REPORT_TYPE_COUNT
+};
+
+/* Last advertising reports of a device */
+struct dedup_entry {
+	/* Address of the device. */
+	bt_addr_le_t addr;
+
+	/* Hash of the advertising data and the filter match state of
+	 * the last report of every type.
+	 */
+	uint32_t hash[DEDUP_REPORT_TYPE_COUNT];
+
+	/* Uptime when the report of every type was last passed to
+	 * the application.
+	 */
+	int64_t timestamp[DEDUP_REPORT_TYPE_COUNT];
+
+	/* Bit mask of the report types that were received. */
+	uint8_t reported;
+
+	/* Value of the use counter when a report was last received. */
+	uint32_t last_used;
+};
+
+/* Cache of the devices that were recently reported, one entry
+ * per device address.
+ */
+struct dedup_cache {
+	/* Array of the cached devices. */
+	struct dedup_entry entry[CONFIG_BT_SCAN_DEDUP_CACHE_SIZE];
+
+	/* Count of the cached devices. */
+	size_t count;
+
+	/* Incremented on every lookup, used to find the least recently
+	 * seen device.
+	 */
+	uint32_t use_cnt;
+
+	/* Cache statistics. */
+	struct bt_scan_dedup_stats stats;
+};
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
 /* Scanning module instance. Options for the different scanning modes.
  * This structure stores all module settings. It is used to enable
  * or disable scanning modes and to configure filters.
@@ -238,6 +316,9 @@ static struct bt_scan {
 	/* Filter data. */
 	struct bt_scan_filters scan_filters;
 
+	/* Filter lookup index. */
+	struct bt_scan_filter_index index;
+
 	/* If set to true, the module automatically connects
 	 * after a filter match.
 	 */
@@ -264,6 +345,11 @@ static struct bt_scan {
 	struct conn_blocklist blocklist;
 #endif /* CONFIG_BT_SCAN_BLOCKLIST */
 
+#if CONFIG_BT_SCAN_DEDUP
+	/* Cache of the recently received reports. */
+	struct dedup_cache dedup;
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
 } bt_scan;
 
 static sys_slist_t callback_list;
@@ -451,6 +537,124 @@ static bool conn_attempts_exceeded(const bt_addr_le_t *addr)
 
 #endif /* CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER */
 
+#if CONFIG_BT_SCAN_DEDUP
+static uint32_t adv_data_hash(const struct net_buf_simple *ad, bool match)
+{
+	/* 32-bit FNV-1a hash. */
+	uint32_t hash = 2166136261U;
+
+	hash = (hash ^ match) * 16777619U;
+
+	for (size_t i = 0; i < ad->len; i++) {
+		hash = (hash ^ ad->data[i]) * 16777619U;
+	}
+
+	return hash;
+}
+
+static struct dedup_entry *dedup_entry_alloc(struct dedup_cache *cache)
+{
+	struct dedup_entry *oldest;
+
+	if (cache->count < ARRAY_SIZE(cache->entry)) {
+		return &cache->entry[cache->count++];
+	}
+
+	/* Replace the least recently seen device. The age is computed
+	 * relative to the use counter, so that it is correct when
+	 * the counter overflows.
+	 */
+	oldest = &cache->entry[0];
+
+	for (size_t i = 1; i < cache->count; i++) {
+		if ((cache->use_cnt - cache->entry[i].last_used) >
+		    (cache->use_cnt - oldest->last_used)) {
+			oldest = &cache->entry[i];
+		}
+	}
+
+	return oldest;
+}
+
+static enum dedup_report_type
+dedup_report_type_get(const struct bt_le_scan_recv_info *info)
+{
+	if ((info->adv_type == BT_GAP_ADV_TYPE_SCAN_RSP) ||
+	    (info->adv_props & BT_GAP_ADV_PROP_SCAN_RESPONSE)) {
+		return DEDUP_REPORT_SCAN_RSP;
+	}
+
+	return DEDUP_REPORT_ADV;
+}
+
+static bool report_repeated(const struct bt_scan_device_info *device_info,
+			    bool match)
+{
+	const bt_addr_le_t *addr = device_info->recv_info->addr;
+	struct dedup_cache *cache = &bt_scan.dedup;
+	struct dedup_entry *entry = NULL;
+	enum dedup_report_type type;
+	bool repeated = false;
+	int64_t now;
+	uint32_t hash;
+
+	if ((match && !IS_ENABLED(CONFIG_BT_SCAN_DEDUP_MATCH)) ||
+	    (!match && !IS_ENABLED(CONFIG_BT_SCAN_DEDUP_NO_MATCH))) {
+		return false;
+	}
+
+	type = dedup_report_type_get(device_info->recv_info);
+	hash = adv_data_hash(device_info->adv_data, match);
+	now = (CONFIG_BT_SCAN_DEDUP_TIMEOUT_MS > 0) ? k_uptime_get() : 0;
+
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+
+	for (size_t i = 0; i < cache->count; i++) {
+		if (bt_addr_le_cmp(&cache->entry[i].addr, addr) == 0) {
+			entry = &cache->entry[i];
+			break;
+		}
+	}
+
+	if (!entry) {
+		entry = dedup_entry_alloc(cache);
+		bt_addr_le_copy(&entry->addr, addr);
+		entry->reported = 0;
+	} else if ((entry->reported & BIT(type)) &&
+		   (entry->hash[type] == hash)) {
+		repeated = (CONFIG_BT_SCAN_DEDUP_TIMEOUT_MS == 0) ||
+			   ((now - entry->timestamp[type]) <
+			    CONFIG_BT_SCAN_DEDUP_TIMEOUT_MS);
+	}
+
+	/* A device that changed its advertising data replaces its own
+	 * entry, so it does not evict other devices from the cache.
+	 */
+	entry->hash[type] = hash;
+	entry->reported |= BIT(type);
+
+	if (repeated) {
+		cache->stats.hits++;
+	} else {
+		entry->timestamp[type] = now;
+		cache->stats.misses++;
+	}
+
+	cache->use_cnt++;
+	entry->last_used = cache->use_cnt;
+
+	k_mutex_unlock(&scan_mutex);
+
+	return repeated;
+}
+#else
+static bool report_repeated(const struct bt_scan_device_info *device_info,
+			    bool match)
+{
+	return false;
+}
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
 static bool scan_device_filter_check(const bt_addr_le_t *addr)
 {
 #if CONFIG_BT_SCAN_BLOCKLIST
@@ -501,19 +705,55 @@ static void scan_connect_with_target(struct bt_scan_control *control,
 	}
 }
 
+/* Find the first position in the sorted index
+ * at which the filter is not less than the key.
+ */
+static size_t index_lower_bound(const uint8_t *index, size_t cnt,
+				filter_cmp_t cmp, const void *key)
+{
+	size_t low = 0;
+	size_t high = cnt;
+
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+
+		if (cmp(index[mid], key) < 0) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	return low;
+}
+
+static void index_insert(uint8_t *index, size_t cnt, uint8_t pos,
+			 filter_cmp_t cmp, const void *key)
+{
+	size_t i = index_lower_bound(index, cnt, cmp, key);
+
+	memmove(&index[i + 1], &index[i], cnt - i);
+	index[i] = pos;
+}
+
+static int addr_cmp(uint8_t pos, const void *key)
+{
+	return bt_addr_le_cmp(&bt_scan.scan_filters.addr.target_addr[pos], key);
+}
+
 static bool adv_addr_compare(const bt_addr_le_t *target_addr,
 			     struct bt_scan_control *control)
 {
 	const bt_addr_le_t *addr =
 			bt_scan.scan_filters.addr.target_addr;
+	const uint8_t *index = bt_scan.index.addr;
 	uint8_t counter = bt_scan.scan_filters.addr.cnt;
+	size_t i = index_lower_bound(index, counter, addr_cmp, target_addr);
 
-	for (size_t i = 0; i < counter; i++) {
-		if (bt_addr_le_cmp(target_addr, &addr[i]) == 0) {
-			control->filter_status.addr.addr = &addr[i];
+	if ((i < counter) && (addr_cmp(index[i], target_addr) == 0)) {
+		control->filter_status.addr.addr = &addr[index[i]];
 
-			return true;
-		}
+		return true;
 	}
 
 	return false;
@@ -559,6 +799,8 @@ static int scan_addr_filter_add(const bt_addr_le_t *target_addr)
 
 	/* Add target address to filter. */
 	bt_addr_le_copy(&addr_filter[counter], target_addr);
+	index_insert(bt_scan.index.addr, counter, counter, addr_cmp,
+		     target_addr);
 
 	LOG_DBG("Filter set on address type %i",
 		addr_filter[counter].type);
@@ -573,11 +815,16 @@ static int scan_addr_filter_add(const bt_addr_le_t *target_addr)
 	return 0;
 }
 
-static bool adv_name_cmp(const uint8_t *data,
-			 uint8_t data_len,
-			 const char *target_name)
+/* Compares the name filter with the advertised name. The filter matches
+ * if it starts with the advertised name. All the filters which match follow
+ * each other in the index.
+ */
+static int name_cmp(uint8_t pos, const void *key)
 {
-	return strncmp(target_name, data, data_len) == 0;
+	const struct bt_data *data = key;
+
+	return strncmp(bt_scan.scan_filters.name.target_name[pos],
+		       (const char *)data->data, data->data_len);
 }
 
 static bool adv_name_compare(const struct bt_data *data,
@@ -585,24 +832,24 @@ static bool adv_name_compare(const struct bt_data *data,
 {
 	struct bt_scan_name_filter const *name_filter =
 			&bt_scan.scan_filters.name;
+	const uint8_t *index = bt_scan.index.name;
 	uint8_t counter = bt_scan.scan_filters.name.cnt;
-	uint8_t data_len = data->data_len;
-
-	/* Compare the name found with the name filter. */
-	for (size_t i = 0; i < counter; i++) {
-		if (adv_name_cmp(data->data,
-				 data_len,
-				 name_filter->target_name[i])) {
+	uint8_t match = counter;
 
-			control->filter_status.name.name =
-				name_filter->target_name[i];
-			control->filter_status.name.len = data_len;
+	/* Report the first added of the matching filters. */
+	for (size_t i = index_lower_bound(index, counter, name_cmp, data);
+	     (i < counter) && (name_cmp(index[i], data) == 0); i++) {
+		match = MIN(match, index[i]);
+	}
 
-			return true;
-		}
+	if (match == counter) {
+		return false;
 	}
 
-	return false;
+	control->filter_status.name.name = name_filter->target_name[match];
+	control->filter_status.name.len = data->data_len;
+
+	return true;
 }
 
 static inline bool is_name_filter_enabled(void)
@@ -627,6 +874,7 @@ static void name_check(struct bt_scan_control *control,
 static int scan_name_filter_add(const char *name)
 {
 	uint8_t counter = bt_scan.scan_filters.name.cnt;
+	struct bt_data key;
 	size_t name_len;
 
 	/* If no memory for filter. */
@@ -649,9 +897,15 @@ static int scan_name_filter_add(const char *name)
 	}
 
 	/* Add name to filter. */
+	memset(bt_scan.scan_filters.name.target_name[counter], 0,
+	       CONFIG_BT_SCAN_NAME_MAX_LEN);
 	memcpy(bt_scan.scan_filters.name.target_name[counter],
 	       name, name_len);
 
+	key.data = (const uint8_t *)name;
+	key.data_len = CONFIG_BT_SCAN_NAME_MAX_LEN;
+	index_insert(bt_scan.index.name, counter, counter, name_cmp, &key);
+
 	bt_scan.scan_filters.name.cnt++;
 
 	LOG_DBG("Adding filter on %s name", name);
@@ -659,17 +913,12 @@ static int scan_name_filter_add(const char *name)
 	return 0;
 }
 
-static bool adv_short_name_cmp(const uint8_t *data,
-			       uint8_t data_len,
-			       const char *target_name,
-			       uint8_t short_name_min_len)
+static int short_name_cmp(uint8_t pos, const void *key)
 {
-	if ((data_len >= short_name_min_len) &&
-	    (strncmp(target_name, data, data_len) == 0)) {
-		return true;
-	}
+	const struct bt_data *data = key;
 
-	return false;
+	return strncmp(bt_scan.scan_filters.short_name.name[pos].target_name,
+		       (const char *)data->data, data->data_len);
 }
 
 static bool adv_short_name_compare(const struct bt_data *data,
@@ -677,25 +926,28 @@ static bool adv_short_name_compare(const struct bt_data *data,
 {
 	const struct bt_scan_short_name_filter *name_filter =
 			&bt_scan.scan_filters.short_name;
+	const uint8_t *index = bt_scan.index.short_name;
 	uint8_t counter = bt_scan.scan_filters.short_name.cnt;
 	uint8_t data_len = data->data_len;
+	uint8_t match = counter;
 
-	/* Compare the name found with the name filters. */
-	for (size_t i = 0; i < counter; i++) {
-		if (adv_short_name_cmp(data->data,
-				       data_len,
-				       name_filter->name[i].target_name,
-				       name_filter->name[i].min_len)) {
-
-			control->filter_status.short_name.name =
-				name_filter->name[i].target_name;
-			control->filter_status.short_name.len = data_len;
-
-			return true;
+	/* Report the first added of the matching filters. */
+	for (size_t i = index_lower_bound(index, counter, short_name_cmp, data);
+	     (i < counter) && (short_name_cmp(index[i], data) == 0); i++) {
+		if (data_len >= name_filter->name[index[i]].min_len) {
+			match = MIN(match, index[i]);
 		}
 	}
 
-	return false;
+	if (match == counter) {
+		return false;
+	}
+
+	control->filter_status.short_name.name =
+		name_filter->name[match].target_name;
+	control->filter_status.short_name.len = data_len;
+
+	return true;
 }
 
 static inline bool is_short_name_filter_enabled(void)
@@ -723,6 +975,7 @@ static int scan_short_name_filter_add(const struct bt_scan_short_name *short_nam
 		bt_scan.scan_filters.short_name.cnt;
 	struct bt_scan_short_name_filter *short_name_filter =
 		    &bt_scan.scan_filters.short_name;
+	struct bt_data key;
 	uint8_t name_len;
 
 	/* If no memory for filter. */
@@ -748,10 +1001,17 @@ static int scan_short_name_filter_add(const struct bt_scan_short_name *short_nam
 
 	/* Add name to the filter. */
 	short_name_filter->name[counter].min_len = short_name->min_len;
+	memset(short_name_filter->name[counter].target_name, 0,
+	       CONFIG_BT_SCAN_SHORT_NAME_MAX_LEN);
 	memcpy(short_name_filter->name[counter].target_name,
 	       short_name->name,
 	       name_len);
 
+	key.data = (const uint8_t *)short_name->name;
+	key.data_len = CONFIG_BT_SCAN_SHORT_NAME_MAX_LEN;
+	index_insert(bt_scan.index.short_name, counter, counter,
+		     short_name_cmp, &key);
+
 	bt_scan.scan_filters.short_name.cnt++;
 
 	LOG_DBG("Adding filter on %s name", short_name->name);
@@ -759,12 +1019,42 @@ static int scan_short_name_filter_add(const struct bt_scan_short_name *short_nam
 	return 0;
 }
 
-static bool find_uuid(const uint8_t *data,
-		      uint8_t data_len,
-		      uint8_t uuid_type,
-		      const struct bt_scan_uuid *target_uuid)
+/* Converts little-endian UUID of any size to the 128-bit form. 16 and 32-bit
+ * UUIDs are aliases of the Bluetooth Base UUID, like in bt_uuid_cmp().
+ */
+static void uuid_key_set(uint8_t *key, const uint8_t *data, uint8_t len)
 {
+	static const uint8_t uuid_base[BT_SCAN_UUID_128_SIZE] = {
+		BT_UUID_128_ENCODE(0x00000000, 0x0000, 0x1000, 0x8000,
+				   0x00805F9B34FB)
+	};
+
+	if (len == BT_SCAN_UUID_128_SIZE) {
+		memcpy(key, data, len);
+	} else {
+		memcpy(key, uuid_base, sizeof(uuid_base));
+		memcpy(&key[12], data, len);
+	}
+}
+
+static int uuid_cmp(uint8_t pos, const void *key)
+{
+	return memcmp(bt_scan.scan_filters.uuid.uuid[pos].key, key,
+		      BT_SCAN_UUID_128_SIZE);
+}
+
+static bool adv_uuid_compare(const struct bt_data *data, uint8_t uuid_type,
+			     struct bt_scan_control *control)
+{
+	const struct bt_scan_uuid_filter *uuid_filter =
+			&bt_scan.scan_filters.uuid;
+	const bool all_filters_mode = bt_scan.scan_filters.all_mode;
+	const uint8_t counter = bt_scan.scan_filters.uuid.cnt;
+	const uint8_t *index = bt_scan.index.uuid;
+	uint8_t data_len = data->data_len;
+	uint8_t uuid_match_cnt = 0;
 	uint8_t uuid_len;
+	bool found[CONFIG_BT_SCAN_UUID_CNT];
 
 	switch (uuid_type) {
 	case BT_UUID_TYPE_16:
@@ -783,35 +1073,24 @@ static bool find_uuid(const uint8_t *data,
 		return false;
 	}
 
-	for (size_t i = 0; i < data_len; i += uuid_len) {
-		struct bt_uuid_128 uuid;
+	memset(found, 0, sizeof(found));
 
-		if (!bt_uuid_create(&uuid.uuid, &data[i], uuid_len)) {
-			return false;
-		}
+	/* Look up every advertised UUID in the index once. */
+	for (size_t i = 0; i + uuid_len <= data_len; i += uuid_len) {
+		uint8_t key[BT_SCAN_UUID_128_SIZE];
+		size_t pos;
+
+		uuid_key_set(key, &data->data[i], uuid_len);
 
-		if (bt_uuid_cmp(&uuid.uuid, target_uuid->uuid) == 0) {
-			return true;
+		pos = index_lower_bound(index, counter, uuid_cmp, key);
+		if ((pos < counter) && (uuid_cmp(index[pos], key) == 0)) {
+			found[index[pos]] = true;
 		}
 	}
 
-	return false;
-}
-
-static bool adv_uuid_compare(const struct bt_data *data, uint8_t uuid_type,
-			     struct bt_scan_control *control)
-{
-	const struct bt_scan_uuid_filter *uuid_filter =
-			&bt_scan.scan_filters.uuid;
-	const bool all_filters_mode = bt_scan.scan_filters.all_mode;
-	const uint8_t counter = bt_scan.scan_filters.uuid.cnt;
-	uint8_t data_len = data->data_len;
-	uint8_t uuid_match_cnt = 0;
-
 	for (size_t i = 0; i < counter; i++) {
 
-		if (find_uuid(data->data, data_len, uuid_type,
-			      &uuid_filter->uuid[i])) {
+		if (found[i]) {
 			control->filter_status.uuid.uuid[uuid_match_cnt] =
 				uuid_filter->uuid[i].uuid;
 
@@ -869,6 +1148,7 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 	struct bt_uuid_16 *uuid_16;
 	struct bt_uuid_32 *uuid_32;
 	struct bt_uuid_128 *uuid_128;
+	uint8_t val[sizeof(uint32_t)];
 
 	/* If no memory. */
 	if (counter >= CONFIG_BT_SCAN_UUID_CNT) {
@@ -890,6 +1170,9 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 		uuid_filter[counter].uuid_data.uuid_16 = *uuid_16;
 		uuid_filter[counter].uuid =
 				(struct bt_uuid *)&uuid_filter[counter].uuid_data.uuid_16;
+
+		sys_put_le16(uuid_16->val, val);
+		uuid_key_set(uuid_filter[counter].key, val, sizeof(uint16_t));
 		break;
 
 	case BT_UUID_TYPE_32:
@@ -898,6 +1181,9 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 		uuid_filter[counter].uuid_data.uuid_32 = *uuid_32;
 		uuid_filter[counter].uuid =
 				(struct bt_uuid *)&uuid_filter[counter].uuid_data.uuid_32;
+
+		sys_put_le32(uuid_32->val, val);
+		uuid_key_set(uuid_filter[counter].key, val, sizeof(uint32_t));
 		break;
 
 	case BT_UUID_TYPE_128:
@@ -906,34 +1192,29 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 		uuid_filter[counter].uuid_data.uuid_128 = *uuid_128;
 		uuid_filter[counter].uuid =
 				(struct bt_uuid *)&uuid_filter[counter].uuid_data.uuid_128;
+
+		uuid_key_set(uuid_filter[counter].key, uuid_128->val,
+			     BT_SCAN_UUID_128_SIZE);
 		break;
 
 	default:
 		return -EINVAL;
 	}
 
+	index_insert(bt_scan.index.uuid, counter, counter, uuid_cmp,
+		     uuid_filter[counter].key);
 	bt_scan.scan_filters.uuid.cnt++;
 	LOG_DBG("Added filter on UUID type %x", uuid->type);
 
 	return 0;
 }
 
-static bool find_appearance(const uint8_t *data,
-			    uint8_t data_len,
-			    const uint16_t *appearance)
+static int appearance_cmp(uint8_t pos, const void *key)
 {
-	if (data_len != sizeof(uint16_t)) {
-		return false;
-	}
-
-	uint16_t decoded_appearance = sys_get_be16(data);
-
-	if (decoded_appearance == *appearance) {
-		return true;
-	}
+	uint16_t appearance = bt_scan.scan_filters.appearance.appearance[pos];
+	uint16_t target = *(const uint16_t *)key;
 
-	/* Could not find the appearance among the encoded data. */
-	return false;
+	return (appearance > target) - (appearance < target);
 }
 
 static bool adv_appearance_compare(const struct bt_data *data,
@@ -943,21 +1224,27 @@ static bool adv_appearance_compare(const struct bt_data *data,
 			&bt_scan.scan_filters.appearance;
 	const uint8_t counter =
 			bt_scan.scan_filters.appearance.cnt;
-	uint8_t data_len = data->data_len;
+	const uint8_t *index = bt_scan.index.appearance;
+	uint16_t decoded_appearance;
+	size_t i;
+
+	if (data->data_len != sizeof(uint16_t)) {
+		return false;
+	}
+
+	decoded_appearance = sys_get_be16(data->data);
 
 	/* Verify if the advertised appearance matches
 	 * the provided appearance.
 	 */
-	for (size_t i = 0; i < counter; i++) {
-		if (find_appearance(data->data,
-				    data_len,
-				    &appearance_filter->appearance[i])) {
-
-			control->filter_status.appearance.appearance =
-					&appearance_filter->appearance[i];
+	i = index_lower_bound(index, counter, appearance_cmp,
+			      &decoded_appearance);
+	if ((i < counter) &&
+	    (appearance_cmp(index[i], &decoded_appearance) == 0)) {
+		control->filter_status.appearance.appearance =
+				&appearance_filter->appearance[index[i]];
 
-			return true;
-		}
+		return true;
 	}
 
 	return false;
@@ -1001,6 +1288,8 @@ static int scan_appearance_filter_add(uint16_t appearance)
 
 	/* Add appearance to the filter. */
 	appearance_filter[counter] = appearance;
+	index_insert(bt_scan.index.appearance, counter, counter,
+		     appearance_cmp, &appearance);
 	bt_scan.scan_filters.appearance.cnt++;
 
 	LOG_DBG("Added filter on appearance %x", appearance);
@@ -1024,30 +1313,62 @@ static bool adv_manufacturer_data_cmp(const uint8_t *data,
 	return true;
 }
 
+/* Orders the manufacturer data filters lexicographically. */
+static int manufacturer_data_cmp(uint8_t pos, const void *key)
+{
+	const struct bt_data *data = key;
+	uint8_t data_len =
+		bt_scan.scan_filters.manufacturer_data.manufacturer_data[pos].data_len;
+	int err = memcmp(
+		bt_scan.scan_filters.manufacturer_data.manufacturer_data[pos].data,
+		data->data, MIN(data_len, data->data_len));
+
+	return err ? err : (int)data_len - (int)data->data_len;
+}
+
 static bool adv_manufacturer_data_compare(const struct bt_data *data,
 					  struct bt_scan_control *control)
 {
 	const struct bt_scan_manufacturer_data_filter *md_filter =
 		&bt_scan.scan_filters.manufacturer_data;
+	const uint8_t *index = bt_scan.index.manufacturer_data;
 	uint8_t counter = bt_scan.scan_filters.manufacturer_data.cnt;
+	uint8_t match = counter;
+	struct bt_data first_byte = {
+		.data = data->data,
+		.data_len = 1,
+	};
 
-	/* Compare the name found with the name filter. */
-	for (size_t i = 0; i < counter; i++) {
+	if (data->data_len == 0) {
+		return false;
+	}
+
+	/* Only the filters starting with the same byte as the data can match.
+	 * Report the first added of the matching filters.
+	 */
+	for (size_t i = index_lower_bound(index, counter,
+					  manufacturer_data_cmp, &first_byte);
+	     (i < counter) &&
+	     (md_filter->manufacturer_data[index[i]].data[0] == data->data[0]);
+	     i++) {
 		if (adv_manufacturer_data_cmp(data->data,
 				data->data_len,
-				md_filter->manufacturer_data[i].data,
-				md_filter->manufacturer_data[i].data_len)) {
-
-			control->filter_status.manufacturer_data.data =
-				md_filter->manufacturer_data[i].data;
-			control->filter_status.manufacturer_data.len =
-				md_filter->manufacturer_data[i].data_len;
-
-			return true;
+				md_filter->manufacturer_data[index[i]].data,
+				md_filter->manufacturer_data[index[i]].data_len)) {
+			match = MIN(match, index[i]);
 		}
 	}
 
-	return false;
+	if (match == counter) {
+		return false;
+	}
+
+	control->filter_status.manufacturer_data.data =
+		md_filter->manufacturer_data[match].data;
+	control->filter_status.manufacturer_data.len =
+		md_filter->manufacturer_data[match].data_len;
+
+	return true;
 }
 static inline bool is_manufacturer_data_filter_enabled(void)
 {
@@ -1074,6 +1395,7 @@ static int scan_manufacturer_data_filter_add(const struct bt_scan_manufacturer_d
 	struct bt_scan_manufacturer_data_filter *md_filter =
 		&bt_scan.scan_filters.manufacturer_data;
 	uint8_t counter = bt_scan.scan_filters.manufacturer_data.cnt;
+	struct bt_data key;
 
 	/* If no memory for filter. */
 	if (counter >= CONFIG_BT_SCAN_MANUFACTURER_DATA_CNT) {
@@ -1103,6 +1425,11 @@ static int scan_manufacturer_data_filter_add(const struct bt_scan_manufacturer_d
 	md_filter->manufacturer_data[counter].data_len =
 		manufacturer_data->data_len;
 
+	key.data = manufacturer_data->data;
+	key.data_len = manufacturer_data->data_len;
+	index_insert(bt_scan.index.manufacturer_data, counter, counter,
+		     manufacturer_data_cmp, &key);
+
 	bt_scan.scan_filters.manufacturer_data.cnt++;
 
 	LOG_DBG("Adding filter on manufacturer data");
@@ -1240,6 +1567,37 @@ void bt_scan_filter_remove_all(void)
 	k_mutex_unlock(&scan_mutex);
 }
 
+static uint8_t enabled_filters_count(void)
+{
+	uint8_t filter_cnt = 0;
+
+	if (is_addr_filter_enabled()) {
+		filter_cnt++;
+	}
+
+	if (is_name_filter_enabled()) {
+		filter_cnt++;
+	}
+
+	if (is_short_name_filter_enabled()) {
+		filter_cnt++;
+	}
+
+	if (is_uuid_filter_enabled()) {
+		filter_cnt++;
+	}
+
+	if (is_appearance_filter_enabled()) {
+		filter_cnt++;
+	}
+
+	if (is_manufacturer_data_filter_enabled()) {
+		filter_cnt++;
+	}
+
+	return filter_cnt;
+}
+
 void bt_scan_filter_disable(void)
 {
 	/* Disable all filters. */
@@ -1249,6 +1607,7 @@ void bt_scan_filter_disable(void)
 	bt_scan.scan_filters.uuid.enabled = false;
 	bt_scan.scan_filters.appearance.enabled = false;
 	bt_scan.scan_filters.manufacturer_data.enabled = false;
+	bt_scan.scan_filters.enabled_cnt = 0;
 }
 
 int bt_scan_filter_enable(uint8_t mode, bool match_all)
@@ -1291,6 +1650,9 @@ int bt_scan_filter_enable(uint8_t mode, bool match_all)
 	/* Select the filter mode. */
 	filters->all_mode = match_all;
 
+	/* Count the enabled filters once, not for every advertising report. */
+	filters->enabled_cnt = enabled_filters_count();
+
 	return 0;
 }
 
@@ -1369,33 +1731,22 @@ void bt_scan_update_init_conn_params(struct bt_le_conn_param *new_conn_param)
 	bt_scan.conn_param = *new_conn_param;
 }
 
-static void check_enabled_filters(struct bt_scan_control *control)
+static bool adv_data_check_needed(const struct bt_scan_control *control)
 {
-	control->filter_cnt = 0;
-
-	if (is_addr_filter_enabled()) {
-		control->filter_cnt++;
-	}
+	uint8_t addr_filter_cnt = is_addr_filter_enabled() ? 1 : 0;
 
-	if (is_name_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_short_name_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_uuid_filter_enabled()) {
-		control->filter_cnt++;
+	/* No filter is using the advertising data. */
+	if (control->filter_cnt == addr_filter_cnt) {
+		return false;
 	}
 
-	if (is_appearance_filter_enabled()) {
-		control->filter_cnt++;
+	/* All filters must match, but the address did not. */
+	if (control->all_mode && addr_filter_cnt &&
+	    !control->filter_status.addr.match) {
+		return false;
 	}
 
-	if (is_manufacturer_data_filter_enabled()) {
-		control->filter_cnt++;
-	}
+	return true;
 }
 
 static bool adv_data_found(struct bt_data *data, void *user_data)
@@ -1445,7 +1796,8 @@ static bool adv_data_found(struct bt_data *data, void *user_data)
 		break;
 	}
 
-	return true;
+	/* Stop parsing when all the enabled filters are matched. */
+	return scan_control->filter_match_cnt < scan_control->filter_cnt;
 }
 
 static void filter_state_check(struct bt_scan_control *control,
@@ -1455,23 +1807,21 @@ static void filter_state_check(struct bt_scan_control *control,
 		return;
 	}
 
-	if (control->all_mode &&
-	    (control->filter_match_cnt == control->filter_cnt)) {
-		notify_filter_matched(&control->device_info,
-				      &control->filter_status,
-				      control->connectable);
-		scan_connect_with_target(control, addr);
-	}
-
-	/* In the normal filter mode, only one filter match is
+	/* In the multifilter mode, all enabled filters must match.
+	 * In the normal filter mode, only one filter match is
 	 * needed to generate the notification to the main application.
 	 */
-	else if ((!control->all_mode) && control->filter_match) {
-		notify_filter_matched(&control->device_info,
-				      &control->filter_status,
-				      control->connectable);
+	if ((control->all_mode &&
+	     (control->filter_match_cnt == control->filter_cnt)) ||
+	    ((!control->all_mode) && control->filter_match)) {
+		if (!report_repeated(&control->device_info, true)) {
+			notify_filter_matched(&control->device_info,
+					      &control->filter_status,
+					      control->connectable);
+		}
+
 		scan_connect_with_target(control, addr);
-	} else {
+	} else if (!report_repeated(&control->device_info, false)) {
 		notify_filter_no_match(&control->device_info,
 				       control->connectable);
 	}
@@ -1486,8 +1836,7 @@ static void scan_recv(const struct bt_le_scan_recv_info *info,
 	memset(&scan_control, 0, sizeof(scan_control));
 
 	scan_control.all_mode = bt_scan.scan_filters.all_mode;
-
-	check_enabled_filters(&scan_control);
+	scan_control.filter_cnt = bt_scan.scan_filters.enabled_cnt;
 
 	/* Check id device is connectable. */
 	scan_control.connectable =
@@ -1499,9 +1848,11 @@ static void scan_recv(const struct bt_le_scan_recv_info *info,
 	/* Save advertising buffer state to transfer it
 	 * data to application if futher processing is needed.
 	 */
-	net_buf_simple_save(ad, &state);
-	bt_data_parse(ad, adv_data_found, (void *)&scan_control);
-	net_buf_simple_restore(ad, &state);
+	if (adv_data_check_needed(&scan_control)) {
+		net_buf_simple_save(ad, &state);
+		bt_data_parse(ad, adv_data_found, (void *)&scan_control);
+		net_buf_simple_restore(ad, &state);
+	}
 
 	scan_control.device_info.recv_info = info;
 	scan_control.device_info.conn_param = &bt_scan.conn_param;
@@ -1533,6 +1884,11 @@ int bt_scan_start(enum bt_scan_type scan_type)
 		return -EINVAL;
 	}
 
+#if CONFIG_BT_SCAN_DEDUP
+	/* Report all devices again when the scanning is started. */
+	bt_scan_dedup_clear();
+#endif /* CONFIG_BT_SCAN_DEDUP */
+
 	/* Start the scanning. */
 	int err = bt_le_scan_start(&bt_scan.scan_param, NULL);
 
@@ -1617,3 +1973,19 @@ void bt_scan_conn_attempts_filter_clear(void)
 	k_mutex_unlock(&scan_mutex);
 }
 #endif /* CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER */
+
+#if CONFIG_BT_SCAN_DEDUP
+void bt_scan_dedup_clear(void)
+{
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+	bt_scan.dedup.count = 0;
+	k_mutex_unlock(&scan_mutex);
+}
+
+void bt_scan_dedup_stats_get(struct bt_scan_dedup_stats *stats)
+{
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+	*stats = bt_scan.dedup.stats;
+	k_mutex_unlock(&scan_mutex);
+}
+#endif /* CONFIG_BT_SCAN_DEDUP */
@@ -20,9 +20,6 @@ LOG_MODULE_REGISTER(event_manager, CONFIG_EVENT_MANAGER_LOG_LEVEL);
 const struct {} linker_tag __attribute__((__section__("event_manager"))) __used;
 
 
-static void event_processor_fn(struct k_work *work);
-
-
 #if CONFIG_EVENT_MANAGER_PROFILER_ENABLED
 #define IDS_COUNT CONFIG_EVENT_MANAGER_MAX_EVENT_CNT
 #else
@@ -35,11 +32,45 @@ extern uint32_t event_manager_displayed_events;
 static uint32_t event_manager_displayed_events;
 #endif
 
+/* Every dispatch class keeps its own queue of events and a work item that is
+ * used to drain the queue. Events of the same class are processed in FIFO
+ * order.
+ */
+struct dispatch_class {
+	sys_slist_t eventq;
+	struct k_work work;
+	struct k_work_q *work_q;
+#ifdef CONFIG_EVENT_MANAGER_DISPATCH_STATS
+	struct event_dispatch_stats stats;
+#endif
+};
+
 static uint16_t profiler_event_ids[IDS_COUNT];
-static K_WORK_DEFINE(event_processor, event_processor_fn);
-static sys_slist_t eventq = SYS_SLIST_STATIC_INIT(&eventq);
+static struct dispatch_class dispatch_classes[CONFIG_EVENT_MANAGER_DISPATCH_CLASS_CNT];
 static struct k_spinlock lock;
 
+#ifdef CONFIG_EVENT_MANAGER_EVENT_POOL
+static struct k_spinlock pool_lock;
+#endif
+
+/* Event types are limited by the size of the displayed events mask. */
+#define EVENT_TYPE_CNT_MAX (sizeof(event_manager_displayed_events) * 8)
+
+#ifdef CONFIG_EVENT_MANAGER_EVENT_COALESCING
+/* Not yet processed event of every event type that can be coalesced. */
+static struct event_header *pending_events[EVENT_TYPE_CNT_MAX];
+#endif
+
+#ifdef CONFIG_EVENT_MANAGER_DISPATCH_TABLE
+/* Listeners of all event types, ordered by event type and subscriber
+ * priority. Subscribers of an event type with index i are located between
+ * dispatch_table_idx[i] and dispatch_table_idx[i + 1].
+ */
+static const struct event_listener *dispatch_table[CONFIG_EVENT_MANAGER_DISPATCH_TABLE_SIZE];
+static uint16_t dispatch_table_idx[EVENT_TYPE_CNT_MAX + 1];
+static bool dispatch_table_ready;
+#endif /* CONFIG_EVENT_MANAGER_DISPATCH_TABLE */
+
 
 static bool log_is_event_displayed(const struct event_type *et)
 {
@@ -228,19 +259,376 @@ static int trace_event_init(void)
 	return 0;
 }
 
+#ifdef CONFIG_EVENT_MANAGER_EVENT_POOL
+#if CONFIG_EVENT_MANAGER_EVENT_POOL_SHARED_BLOCK_CNT > 0
+#define SHARED_POOL_MAX_BLOCK_SIZE CONFIG_EVENT_MANAGER_EVENT_POOL_SHARED_MAX_BLOCK_SIZE
+#else
+#define SHARED_POOL_MAX_BLOCK_SIZE 0
+#endif
+
+#define SHARED_POOL_DEFINE(size)						\
+	K_MEM_SLAB_DEFINE(shared_pool_##size, size,				\
+			  CONFIG_EVENT_MANAGER_EVENT_POOL_SHARED_BLOCK_CNT,	\
+			  sizeof(void *))
+
+/* Pools shared by all event types, ordered by block size. */
+#if SHARED_POOL_MAX_BLOCK_SIZE >= 32
+SHARED_POOL_DEFINE(32);
+#endif
+#if SHARED_POOL_MAX_BLOCK_SIZE >= 64
+SHARED_POOL_DEFINE(64);
+#endif
+#if SHARED_POOL_MAX_BLOCK_SIZE >= 128
+SHARED_POOL_DEFINE(128);
+#endif
+#if SHARED_POOL_MAX_BLOCK_SIZE >= 256
+SHARED_POOL_DEFINE(256);
+#endif
+#if SHARED_POOL_MAX_BLOCK_SIZE >= 512
+SHARED_POOL_DEFINE(512);
+#endif
+#if SHARED_POOL_MAX_BLOCK_SIZE >= 1024
+SHARED_POOL_DEFINE(1024);
+#endif
+
+static struct k_mem_slab *const shared_pools[] = {
+#if SHARED_POOL_MAX_BLOCK_SIZE >= 32
+	&shared_pool_32,
+#endif
+#if SHARED_POOL_MAX_BLOCK_SIZE >= 64
+	&shared_pool_64,
+#endif
+#if SHARED_POOL_MAX_BLOCK_SIZE >= 128
+	&shared_pool_128,
+#endif
+#if SHARED_POOL_MAX_BLOCK_SIZE >= 256
+	&shared_pool_256,
+#endif
+#if SHARED_POOL_MAX_BLOCK_SIZE >= 512
+	&shared_pool_512,
+#endif
+#if SHARED_POOL_MAX_BLOCK_SIZE >= 1024
+	&shared_pool_1024,
+#endif
+	NULL
+};
+
+static bool is_pool_block(const struct k_mem_slab *slab, const void *mem)
+{
+	const char *addr = mem;
+
+	return (addr >= slab->buffer) &&
+	       (addr < slab->buffer + slab->num_blocks * slab->block_size);
+}
+
+static void *shared_pool_alloc(size_t size)
+{
+	void *mem;
+
+	for (size_t i = 0; shared_pools[i] != NULL; i++) {
+		if ((size <= shared_pools[i]->block_size) &&
+		    !k_mem_slab_alloc(shared_pools[i], &mem, K_NO_WAIT)) {
+			return mem;
+		}
+	}
+
+	return NULL;
+}
+
+void *_event_pool_alloc(const struct event_type *et, size_t size)
+{
+	ASSERT_EVENT_ID(et);
+
+	struct event_pool *pool = et->pool;
+	void *mem;
+
+	__ASSERT_NO_MSG(pool != NULL);
+
+	if ((size <= pool->slab->block_size) &&
+	    !k_mem_slab_alloc(pool->slab, &mem, K_NO_WAIT)) {
+		uint32_t used = k_mem_slab_num_used_get(pool->slab);
+		k_spinlock_key_t key = k_spin_lock(&pool_lock);
+
+		if (used > pool->max_used) {
+			pool->max_used = used;
+		}
+
+		k_spin_unlock(&pool_lock, key);
+
+		return mem;
+	}
+
+	mem = shared_pool_alloc(size);
+
+	k_spinlock_key_t key = k_spin_lock(&pool_lock);
+
+	if (mem) {
+		pool->shared_cnt++;
+	} else {
+		pool->heap_fallback_cnt++;
+	}
+
+	k_spin_unlock(&pool_lock, key);
+
+	return mem ? mem : k_malloc(size);
+}
+
+/* Return the block to the pool it was allocated from, if any. */
+static bool pool_free(struct event_header *eh)
+{
+	struct k_mem_slab *slab = eh->type_id->pool->slab;
+	void *mem = eh;
+
+	if (is_pool_block(slab, eh)) {
+		k_mem_slab_free(slab, &mem);
+		return true;
+	}
+
+	for (size_t i = 0; shared_pools[i] != NULL; i++) {
+		if (is_pool_block(shared_pools[i], eh)) {
+			k_mem_slab_free(shared_pools[i], &mem);
+			return true;
+		}
+	}
+
+	return false;
+}
+#endif /* CONFIG_EVENT_MANAGER_EVENT_POOL */
+
+void event_manager_free(struct event_header *eh)
+{
+	__ASSERT_NO_MSG(eh);
+	ASSERT_EVENT_ID(eh->type_id);
+
+#ifdef CONFIG_EVENT_MANAGER_EVENT_POOL
+	if (pool_free(eh)) {
+		return;
+	}
+#endif /* CONFIG_EVENT_MANAGER_EVENT_POOL */
+
+	k_free(eh);
+}
+
+/* Check if any per-event logging or tracing may be needed for the event type.
+ * Event processing checks the hooks once per event to avoid evaluating
+ * logging and tracing conditions for every notified listener.
+ */
+static bool event_hooks_enabled(const struct event_type *et)
+{
+	if (IS_ENABLED(CONFIG_EVENT_MANAGER_TRACE_EVENT_EXECUTION)) {
+		size_t event_cnt = __stop_event_types - __start_event_types;
+
+		if (is_profiling_enabled(profiler_event_ids[event_cnt]) ||
+		    is_profiling_enabled(profiler_event_ids[event_cnt + 1])) {
+			return true;
+		}
+	}
+
+	return IS_ENABLED(CONFIG_EVENT_MANAGER_SHOW_EVENTS) &&
+	       log_is_event_displayed(et);
+}
+
+#ifdef CONFIG_EVENT_MANAGER_DISPATCH_TABLE
+static int dispatch_table_init(void)
+{
+	size_t event_cnt = __stop_event_types - __start_event_types;
+	size_t pos = 0;
+
+	if (event_cnt >= ARRAY_SIZE(dispatch_table_idx)) {
+		LOG_ERR("Too many event types");
+		return -ENOMEM;
+	}
+
+	for (size_t i = 0; i < event_cnt; i++) {
+		const struct event_type *et = &__start_event_types[i];
+
+		dispatch_table_idx[i] = pos;
+
+		for (size_t prio = SUBS_PRIO_MIN; prio <= SUBS_PRIO_MAX; prio++) {
+			for (const struct event_subscriber *es =
+					et->subs_start[prio];
+			     es != et->subs_stop[prio];
+			     es++) {
+				if (pos >= ARRAY_SIZE(dispatch_table)) {
+					LOG_ERR("Increase CONFIG_EVENT_MANAGER_DISPATCH_TABLE_SIZE");
+					return -ENOMEM;
+				}
+
+				__ASSERT_NO_MSG(es->listener != NULL);
+				dispatch_table[pos] = es->listener;
+				pos++;
+			}
+		}
+	}
+
+	dispatch_table_idx[event_cnt] = pos;
+	dispatch_table_ready = true;
+
+	return 0;
+}
+#endif /* CONFIG_EVENT_MANAGER_DISPATCH_TABLE */
+
+static bool notify_listener(const struct event_header *eh,
+			    const struct event_listener *el,
+			    bool hooks)
+{
+	__ASSERT_NO_MSG(el != NULL);
+	__ASSERT_NO_MSG(el->notification != NULL);
+
+	if (unlikely(hooks)) {
+		log_event_progress(eh->type_id, el);
+	}
+
+	bool consumed = el->notification(eh);
+
+	if (unlikely(hooks) && consumed) {
+		log_event_consumed(eh->type_id);
+	}
+
+	return consumed;
+}
+
+static void notify_listeners(const struct event_header *eh, bool hooks)
+{
+	const struct event_type *et = eh->type_id;
+
+#ifdef CONFIG_EVENT_MANAGER_DISPATCH_TABLE
+	if (likely(dispatch_table_ready)) {
+		size_t event_idx = et - __start_event_types;
+		const struct event_listener **el =
+			&dispatch_table[dispatch_table_idx[event_idx]];
+		const struct event_listener **el_end =
+			&dispatch_table[dispatch_table_idx[event_idx + 1]];
+
+		for (; el != el_end; el++) {
+			if (notify_listener(eh, *el, hooks)) {
+				break;
+			}
+		}
+
+		return;
+	}
+#endif /* CONFIG_EVENT_MANAGER_DISPATCH_TABLE */
+
+	for (size_t prio = SUBS_PRIO_MIN; prio <= SUBS_PRIO_MAX; prio++) {
+		for (const struct event_subscriber *es = et->subs_start[prio];
+		     es != et->subs_stop[prio];
+		     es++) {
+
+			__ASSERT_NO_MSG(es != NULL);
+
+			if (notify_listener(eh, es->listener, hooks)) {
+				return;
+			}
+		}
+	}
+}
+
+static bool event_coalesce(struct event_header *eh)
+{
+#ifdef CONFIG_EVENT_MANAGER_EVENT_COALESCING
+	/* Called with the lock held. */
+	const struct event_type *et = eh->type_id;
+	size_t event_idx = et - __start_event_types;
+
+	if (!et->coalesce) {
+		return false;
+	}
+
+	__ASSERT_NO_MSG(event_idx < ARRAY_SIZE(pending_events));
+
+	struct event_header *pending = pending_events[event_idx];
+
+	return pending && et->coalesce(pending, eh);
+#else
+	return false;
+#endif /* CONFIG_EVENT_MANAGER_EVENT_COALESCING */
+}
+
+static void event_pending_set(struct event_header *eh)
+{
+#ifdef CONFIG_EVENT_MANAGER_EVENT_COALESCING
+	/* Called with the lock held, when the event is queued. */
+	const struct event_type *et = eh->type_id;
+
+	if (!et->coalesce) {
+		return;
+	}
+
+	/* The newest event is used to coalesce events submitted later. */
+	pending_events[et - __start_event_types] = eh;
+#endif /* CONFIG_EVENT_MANAGER_EVENT_COALESCING */
+}
+
+static void event_pending_clear(const struct event_header *eh)
+{
+#ifdef CONFIG_EVENT_MANAGER_EVENT_COALESCING
+	const struct event_type *et = eh->type_id;
+
+	if (!et->coalesce) {
+		return;
+	}
+
+	size_t event_idx = et - __start_event_types;
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (pending_events[event_idx] == eh) {
+		pending_events[event_idx] = NULL;
+	}
+
+	k_spin_unlock(&lock, key);
+#endif /* CONFIG_EVENT_MANAGER_EVENT_COALESCING */
+}
+
+static void stats_event_submitted(struct dispatch_class *dc,
+				  struct event_header *eh)
+{
+#ifdef CONFIG_EVENT_MANAGER_DISPATCH_STATS
+	/* Called with the lock held. */
+	eh->submit_cycles = k_cycle_get_32();
+
+	dc->stats.submitted_cnt++;
+	dc->stats.queue_depth++;
+	if (dc->stats.queue_depth > dc->stats.max_queue_depth) {
+		dc->stats.max_queue_depth = dc->stats.queue_depth;
+	}
+#endif /* CONFIG_EVENT_MANAGER_DISPATCH_STATS */
+}
+
+static void stats_event_dequeued(struct dispatch_class *dc,
+				 const struct event_header *eh)
+{
+#ifdef CONFIG_EVENT_MANAGER_DISPATCH_STATS
+	uint32_t latency = k_cyc_to_us_floor32(k_cycle_get_32() -
+					       eh->submit_cycles);
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	__ASSERT_NO_MSG(dc->stats.queue_depth > 0);
+	dc->stats.queue_depth--;
+	dc->stats.total_latency_us += latency;
+	if (latency > dc->stats.max_latency_us) {
+		dc->stats.max_latency_us = latency;
+	}
+
+	k_spin_unlock(&lock, key);
+#endif /* CONFIG_EVENT_MANAGER_DISPATCH_STATS */
+}
+
 static void event_processor_fn(struct k_work *work)
 {
+	struct dispatch_class *dc = CONTAINER_OF(work, struct dispatch_class,
+						 work);
 	sys_slist_t events = SYS_SLIST_STATIC_INIT(&events);
 
 	/* Make current event list local. */
 	k_spinlock_key_t key = k_spin_lock(&lock);
 
-	if (sys_slist_is_empty(&eventq)) {
+	if (sys_slist_is_empty(&dc->eventq)) {
 		k_spin_unlock(&lock, key);
 		return;
 	}
 
-	sys_slist_merge_slist(&events, &eventq);
+	sys_slist_merge_slist(&events, &dc->eventq);
 
 	k_spin_unlock(&lock, key);
 
@@ -254,62 +642,139 @@ static void event_processor_fn(struct k_work *work)
 
 		ASSERT_EVENT_ID(eh->type_id);
 
-		const struct event_type *et = eh->type_id;
+		/* Event can no longer be modified by coalescing. */
+		event_pending_clear(eh);
 
-		trace_event_execution(eh, true);
+		stats_event_dequeued(dc, eh);
 
-		log_event(eh);
+		const bool hooks = event_hooks_enabled(eh->type_id);
 
-		bool consumed = false;
+		if (unlikely(hooks)) {
+			trace_event_execution(eh, true);
+			log_event(eh);
+		}
 
-		for (size_t prio = SUBS_PRIO_MIN;
-		     (prio <= SUBS_PRIO_MAX) && !consumed;
-		     prio++) {
-			for (const struct event_subscriber *es =
-					et->subs_start[prio];
-			     (es != et->subs_stop[prio]) && !consumed;
-			     es++) {
+		notify_listeners(eh, hooks);
 
-				__ASSERT_NO_MSG(es != NULL);
+		if (unlikely(hooks)) {
+			trace_event_execution(eh, false);
+		}
 
-				const struct event_listener *el = es->listener;
+		event_manager_free(eh);
+	}
+}
 
-				__ASSERT_NO_MSG(el != NULL);
-				__ASSERT_NO_MSG(el->notification != NULL);
+void _event_submit(struct event_header *eh)
+{
+	__ASSERT_NO_MSG(eh);
+	ASSERT_EVENT_ID(eh->type_id);
 
-				log_event_progress(et, el);
+	__ASSERT_NO_MSG(eh->type_id->dispatch_class <
+			ARRAY_SIZE(dispatch_classes));
 
-				consumed = el->notification(eh);
+	struct dispatch_class *dc =
+		&dispatch_classes[eh->type_id->dispatch_class];
 
-				if (consumed) {
-					log_event_consumed(et);
-				}
-			}
-		}
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (event_coalesce(eh)) {
+		k_spin_unlock(&lock, key);
+		event_manager_free(eh);
+		return;
+	}
 
-		trace_event_execution(eh, false);
+	if (IS_ENABLED(CONFIG_EVENT_MANAGER_PROFILER_ENABLED)) {
+		/* Coalesced events are never processed, so only the events
+		 * that are going to be queued are traced. The event must be
+		 * traced before it is queued, as it can be freed right after.
+		 * Other events are not coalesced into it until it is queued.
+		 */
+		k_spin_unlock(&lock, key);
+		trace_event_submission(eh);
+		key = k_spin_lock(&lock);
+	}
 
-		k_free(eh);
+	event_pending_set(eh);
+	sys_slist_append(&dc->eventq, &eh->node);
+	stats_event_submitted(dc, eh);
+	struct k_work_q *work_q = dc->work_q;
+	k_spin_unlock(&lock, key);
+
+	if (work_q) {
+		k_work_submit_to_queue(work_q, &dc->work);
+	} else {
+		k_work_submit(&dc->work);
 	}
 }
 
-void _event_submit(struct event_header *eh)
+int event_manager_dispatch_class_queue_set(uint8_t dispatch_class,
+					   struct k_work_q *work_q)
 {
-	__ASSERT_NO_MSG(eh);
-	ASSERT_EVENT_ID(eh->type_id);
+	if (dispatch_class >= ARRAY_SIZE(dispatch_classes)) {
+		return -EINVAL;
+	}
+
+	struct dispatch_class *dc = &dispatch_classes[dispatch_class];
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	dc->work_q = work_q;
+
+	k_spin_unlock(&lock, key);
 
-	trace_event_submission(eh);
+	return 0;
+}
+
+#ifdef CONFIG_EVENT_MANAGER_DISPATCH_STATS
+int event_manager_dispatch_stats_get(uint8_t dispatch_class,
+				     struct event_dispatch_stats *stats)
+{
+	if ((dispatch_class >= ARRAY_SIZE(dispatch_classes)) || !stats) {
+		return -EINVAL;
+	}
 
 	k_spinlock_key_t key = k_spin_lock(&lock);
-	sys_slist_append(&eventq, &eh->node);
+
+	*stats = dispatch_classes[dispatch_class].stats;
+
 	k_spin_unlock(&lock, key);
 
-	k_work_submit(&event_processor);
+	return 0;
+}
+#endif /* CONFIG_EVENT_MANAGER_DISPATCH_STATS */
+
+static int dispatch_classes_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	for (size_t i = 0; i < ARRAY_SIZE(dispatch_classes); i++) {
+		sys_slist_init(&dispatch_classes[i].eventq);
+		k_work_init(&dispatch_classes[i].work, event_processor_fn);
+	}
+
+	return 0;
 }
 
+/* Dispatch classes must be ready before any event can be submitted. */
+SYS_INIT(dispatch_classes_init, PRE_KERNEL_1,
+	 CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+
 int event_manager_init(void)
 {
+	if (IS_ENABLED(CONFIG_EVENT_MANAGER_EVENT_COALESCING) &&
+	    ((__stop_event_types - __start_event_types) > EVENT_TYPE_CNT_MAX)) {
+		LOG_ERR("Too many event types");
+		return -ENOMEM;
+	}
+
 	log_event_init();
 
+#ifdef CONFIG_EVENT_MANAGER_DISPATCH_TABLE
+	int err = dispatch_table_init();
+
+	if (err) {
+		return err;
+	}
+#endif /* CONFIG_EVENT_MANAGER_DISPATCH_TABLE */
+
 	return trace_event_init();
 }
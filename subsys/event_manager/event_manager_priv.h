@@ -82,6 +82,24 @@ extern "C" {
 #define _EVENT_ID(ename) (&_CONCAT(__event_type_, ename))
 
 
+/* Event memory allocation.
+ *
+ * If event pools are enabled every event type owns a memory slab and falls
+ * back to the system heap only if the slab cannot serve the request.
+ */
+#ifdef CONFIG_EVENT_MANAGER_EVENT_POOL
+struct event_type;
+
+void *_event_pool_alloc(const struct event_type *et, size_t size);
+
+#define _EVENT_MEM_ALLOC(ename, size) _event_pool_alloc(_EVENT_ID(ename), (size))
+
+#else
+#define _EVENT_MEM_ALLOC(ename, size) k_malloc(size)
+
+#endif /* CONFIG_EVENT_MANAGER_EVENT_POOL */
+
+
 /* Macro generates a function of name new_ename where ename is provided as
  * an argument. Allocator function is used to create an event of the given
  * ename type.
@@ -89,7 +107,8 @@ extern "C" {
 #define _EVENT_ALLOCATOR_FN(ename)					\
 	static inline struct ename *_CONCAT(new_, ename)(void)		\
 	{								\
-		struct ename *event = (struct ename *)k_malloc(sizeof(*event));\
+		struct ename *event =					\
+			(struct ename *)_EVENT_MEM_ALLOC(ename, sizeof(*event));\
 		BUILD_ASSERT(offsetof(struct ename, header) == 0,	\
 				 "");					\
 		if (unlikely(!event)) {					\
@@ -111,7 +130,8 @@ extern "C" {
 #define _EVENT_ALLOCATOR_DYNDATA_FN(ename)				\
 	static inline struct ename *_CONCAT(new_, ename)(size_t size)	\
 	{								\
-		struct ename *event = (struct ename *)k_malloc(sizeof(*event) + size);\
+		struct ename *event =					\
+			(struct ename *)_EVENT_MEM_ALLOC(ename, sizeof(*event) + size);\
 		BUILD_ASSERT((offsetof(struct ename, dyndata) +		\
 				  sizeof(event->dyndata.size)) ==	\
 				 sizeof(*event), "");			\
@@ -221,8 +241,32 @@ extern "C" {
 	_EVENT_ALLOCATOR_DYNDATA_FN(ename)
 
 
-#define _EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct)							\
+/* Macro defining a memory pool for the event type. The pool is a memory slab
+ * with block size matching size of the event structure.
+ */
+#ifdef CONFIG_EVENT_MANAGER_EVENT_POOL
+#define _EVENT_POOL_SLAB_DEFINE(sname, ename, block_cnt)				\
+	K_MEM_SLAB_DEFINE(sname, sizeof(struct ename), block_cnt,			\
+			  __alignof__(struct ename))
+
+#define _EVENT_POOL_DEFINE(ename, block_cnt)						\
+	_EVENT_POOL_SLAB_DEFINE(_CONCAT(__event_slab_, ename), ename, block_cnt);	\
+	static struct event_pool _CONCAT(__event_pool_, ename) = {			\
+		.slab = &_CONCAT(__event_slab_, ename),					\
+	}
+
+#define _EVENT_POOL_INIT(ename) .pool = &_CONCAT(__event_pool_, ename),
+
+#else
+#define _EVENT_POOL_DEFINE(ename, block_cnt)
+#define _EVENT_POOL_INIT(ename)
+
+#endif /* CONFIG_EVENT_MANAGER_EVENT_POOL */
+
+
+#define _EVENT_TYPE_DEFINE(ename, pool_size, init_log_en, log_fn, ...)					\
 	_EVENT_SUBSCRIBERS_DEFINE(ename);										\
+	_EVENT_POOL_DEFINE(ename, pool_size);										\
 	const struct event_type _CONCAT(__event_type_, ename) __used							\
 	__attribute__((__section__("event_types"))) = {									\
 		.name				= STRINGIFY(ename),							\
@@ -238,7 +282,8 @@ extern "C" {
 		},													\
 		.init_log_enable		= init_log_en,								\
 		.log_event			= log_fn,								\
-		.ev_info			= ev_info_struct,							\
+		_EVENT_POOL_INIT(ename)											\
+		.ev_info			= __VA_ARGS__								\
 	}
 
 
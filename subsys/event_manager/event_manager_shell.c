@@ -89,6 +89,61 @@ static int show_subscribers(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+#ifdef CONFIG_EVENT_MANAGER_EVENT_POOL
+static int show_pools(const struct shell *shell, size_t argc,
+		      char **argv)
+{
+	shell_fprintf(shell, SHELL_NORMAL, "Event pools:\n");
+	for (const struct event_type *et = __start_event_types;
+	     (et != NULL) && (et != __stop_event_types);
+	     et++) {
+
+		const struct event_pool *pool = et->pool;
+
+		__ASSERT_NO_MSG(pool != NULL);
+		shell_fprintf(shell, SHELL_NORMAL,
+			      "|\t[E:%s] block:%zu used:%u/%u max:%u shared:%u heap:%u\n",
+			      et->name,
+			      pool->slab->block_size,
+			      k_mem_slab_num_used_get(pool->slab),
+			      pool->slab->num_blocks,
+			      pool->max_used,
+			      pool->shared_cnt,
+			      pool->heap_fallback_cnt);
+	}
+
+	return 0;
+}
+#endif /* CONFIG_EVENT_MANAGER_EVENT_POOL */
+
+#ifdef CONFIG_EVENT_MANAGER_DISPATCH_STATS
+static int show_dispatch_stats(const struct shell *shell, size_t argc,
+			       char **argv)
+{
+	shell_fprintf(shell, SHELL_NORMAL, "Dispatch classes:\n");
+	for (size_t i = 0; i < CONFIG_EVENT_MANAGER_DISPATCH_CLASS_CNT; i++) {
+		struct event_dispatch_stats stats;
+		int err = event_manager_dispatch_stats_get(i, &stats);
+
+		__ASSERT_NO_MSG(!err);
+		ARG_UNUSED(err);
+
+		uint32_t processed = stats.submitted_cnt - stats.queue_depth;
+		uint32_t avg_latency = (processed > 0) ?
+			(uint32_t)(stats.total_latency_us / processed) : 0;
+
+		shell_fprintf(shell, SHELL_NORMAL,
+			      "|\tclass:%zu submitted:%u depth:%u max depth:%u "
+			      "latency avg:%uus max:%uus\n",
+			      i, stats.submitted_cnt, stats.queue_depth,
+			      stats.max_queue_depth, avg_latency,
+			      stats.max_latency_us);
+	}
+
+	return 0;
+}
+#endif /* CONFIG_EVENT_MANAGER_DISPATCH_STATS */
+
 static void set_event_displaying(const struct shell *shell, size_t argc,
 				 char **argv, bool enable)
 {
@@ -168,6 +223,12 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_event_manager,
 	SHELL_CMD_ARG(show_subscribers, NULL, "Show subscribers",
 		      show_subscribers, 0, 0),
 	SHELL_CMD_ARG(show_events, NULL, "Show events", show_events, 0, 0),
+	SHELL_COND_CMD_ARG(CONFIG_EVENT_MANAGER_DISPATCH_STATS,
+			   show_dispatch_stats, NULL,
+			   "Show event dispatch statistics",
+			   show_dispatch_stats, 0, 0),
+	SHELL_COND_CMD_ARG(CONFIG_EVENT_MANAGER_EVENT_POOL, show_pools, NULL,
+			   "Show event pools usage", show_pools, 0, 0),
 	SHELL_CMD_ARG(disable, NULL, "Disable displaying event with given ID",
 		      disable_event_displaying, 0,
 		      sizeof(event_manager_displayed_events) * 8 - 1),
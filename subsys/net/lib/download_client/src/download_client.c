@@ -34,6 +34,9 @@ int url_parse_host(const char *url, char *host, size_t len);
 
 int http_parse(struct download_client *client, size_t len);
 int http_get_request_send(struct download_client *client);
+int http_pipeline_fill(struct download_client *client);
+size_t http_recv_len_max(const struct download_client *client);
+bool using_range_requests(const struct download_client *client);
 
 int coap_block_init(struct download_client *client, size_t from);
 int coap_parse(struct download_client *client, size_t len);
@@ -362,13 +365,14 @@ cleanup:
 	return err;
 }
 
-int socket_send(const struct download_client *client, size_t len)
+int socket_send(const struct download_client *client, const char *buf,
+		size_t len)
 {
 	int sent;
 	size_t off = 0;
 
 	while (len) {
-		sent = send(client->fd, client->buf + off, len, 0);
+		sent = send(client->fd, buf + off, len, 0);
 		if (sent <= 0) {
 			return -errno;
 		}
@@ -380,6 +384,16 @@ int socket_send(const struct download_client *client, size_t len)
 	return 0;
 }
 
+/* Offset at which the download ends, zero if not known yet */
+size_t download_end_get(const struct download_client *client)
+{
+	if (client->range_end != 0) {
+		return client->range_end;
+	}
+
+	return client->file_size;
+}
+
 static int request_send(struct download_client *dl)
 {
 	switch (dl->proto) {
@@ -396,23 +410,101 @@ static int request_send(struct download_client *dl)
 	return 0;
 }
 
-static int fragment_evt_send(const struct download_client *client)
+#if CONFIG_DOWNLOAD_CLIENT_FRAGMENT_BUF_CNT > 1
+static void fragment_thread(void *client, void *a, void *b)
+{
+	struct download_client *const dl = client;
+	struct download_client_evt evt = {
+		.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
+	};
+
+	while (true) {
+		(void)k_msgq_get(&dl->fragment_q, &evt.fragment, K_FOREVER);
+
+		/* Fragments following a refused one are dropped */
+		if (!dl->fragment_refused && dl->callback(&evt)) {
+			LOG_INF("Fragment refused, download stopped.");
+			dl->fragment_refused = true;
+		}
+
+		k_sem_give(&dl->fragment_free);
+	}
+}
+#endif
+
+/* Wait until all queued fragments are handed to the application.
+ * Returns true if the application has refused a fragment.
+ */
+static bool fragments_flush(struct download_client *dl)
 {
+#if CONFIG_DOWNLOAD_CLIENT_FRAGMENT_BUF_CNT > 1
+	const size_t cnt = CONFIG_DOWNLOAD_CLIENT_FRAGMENT_BUF_CNT - 1;
+
+	for (size_t i = 0; i < cnt; i++) {
+		(void)k_sem_take(&dl->fragment_free, K_FOREVER);
+	}
+	for (size_t i = 0; i < cnt; i++) {
+		k_sem_give(&dl->fragment_free);
+	}
+
+	return dl->fragment_refused;
+#else
+	return false;
+#endif
+}
+
+/* Hand the fragment to the application. Any data received past the
+ * fragment is moved to the beginning of the buffer used for reception.
+ */
+static int fragment_evt_send(struct download_client *client)
+{
+	int rc;
+	char *frag_buf = client->buf;
+
 	__ASSERT(client->offset <= CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
 		 "Buffer overflow!");
 
+#if CONFIG_DOWNLOAD_CLIENT_FRAGMENT_BUF_CNT > 1
+	/* The fragment is handed to the application by the fragment thread,
+	 * the next fragment is received in the next free buffer meanwhile.
+	 * Buffers are freed in the order they are queued.
+	 */
+	const struct download_fragment fragment = {
+		.buf = frag_buf,
+		.len = client->offset,
+		.offset = client->progress - client->offset,
+	};
+
+	(void)k_msgq_put(&client->fragment_q, &fragment, K_FOREVER);
+	(void)k_sem_take(&client->fragment_free, K_FOREVER);
+
+	client->fragment_idx = (client->fragment_idx + 1) %
+			       CONFIG_DOWNLOAD_CLIENT_FRAGMENT_BUF_CNT;
+	client->buf = client->fragment_buf[client->fragment_idx];
+
+	rc = client->fragment_refused;
+#else
 	const struct download_client_evt evt = {
 		.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
 		.fragment = {
-			.buf = client->buf,
+			.buf = frag_buf,
 			.len = client->offset,
+			.offset = client->progress - client->offset,
 		}
 	};
 
-	return client->callback(&evt);
+	rc = client->callback(&evt);
+#endif
+
+	if (client->http.carry_len) {
+		memmove(client->buf, frag_buf + client->offset,
+			client->http.carry_len);
+	}
+
+	return rc;
 }
 
-static int error_evt_send(const struct download_client *dl, int error)
+static int error_evt_send(struct download_client *dl, int error)
 {
 	/* Error will be sent as negative. */
 	__ASSERT_NO_MSG(error > 0);
@@ -422,6 +514,11 @@ static int error_evt_send(const struct download_client *dl, int error)
 		.error = -error
 	};
 
+	if (fragments_flush(dl)) {
+		/* Download was stopped by the application */
+		return 1;
+	}
+
 	return dl->callback(&evt);
 }
 
@@ -435,6 +532,10 @@ static int reconnect(struct download_client *dl)
 		return err;
 	}
 
+	/* Pending requests and data are lost with the connection */
+	dl->http.requests_pending = 0;
+	dl->http.carry_len = 0;
+
 	err = download_client_connect(dl, dl->host, &dl->config);
 	if (err) {
 		return err;
@@ -443,6 +544,15 @@ static int reconnect(struct download_client *dl)
 	return 0;
 }
 
+static size_t recv_len_max(const struct download_client *dl)
+{
+	if (dl->proto == IPPROTO_TCP || dl->proto == IPPROTO_TLS_1_2) {
+		return http_recv_len_max(dl);
+	}
+
+	return CONFIG_DOWNLOAD_CLIENT_BUF_SIZE - dl->offset;
+}
+
 void download_thread(void *client, void *a, void *b)
 {
 	int rc = 0;
@@ -451,23 +561,33 @@ void download_thread(void *client, void *a, void *b)
 	struct download_client *const dl = client;
 
 restart_and_suspend:
-	k_thread_suspend(dl->tid);
+	/* Let the application handle all received fragments */
+	(void)fragments_flush(dl);
+	k_sem_give(&dl->idle);
+	(void)k_sem_take(&dl->start, K_FOREVER);
 
 	while (true) {
-		__ASSERT(dl->offset < sizeof(dl->buf), "Buffer overflow");
+		__ASSERT(dl->offset < CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
+			 "Buffer overflow");
+
+		if (dl->http.carry_len) {
+			/* Parse the data received with the previous fragment */
+			len = dl->http.carry_len;
+			dl->http.carry_len = 0;
+			goto parse;
+		}
 
-		if (sizeof(dl->buf) - dl->offset == 0) {
+		if (CONFIG_DOWNLOAD_CLIENT_BUF_SIZE - dl->offset == 0) {
 			LOG_ERR("Could not fit HTTP header from server (> %d)",
-				sizeof(dl->buf));
+				CONFIG_DOWNLOAD_CLIENT_BUF_SIZE);
 			error_evt_send(dl, E2BIG);
 			break;
 		}
 
 		LOG_DBG("Receiving up to %d bytes at %p...",
-			(sizeof(dl->buf) - dl->offset), (dl->buf + dl->offset));
+			recv_len_max(dl), (dl->buf + dl->offset));
 
-		len = recv(dl->fd, dl->buf + dl->offset,
-			   sizeof(dl->buf) - dl->offset, 0);
+		len = recv(dl->fd, dl->buf + dl->offset, recv_len_max(dl), 0);
 
 		if ((len == 0) || (len == -1)) {
 			/* We just had an unexpected socket error or closure */
@@ -525,9 +645,15 @@ restart_and_suspend:
 
 		LOG_DBG("Read %d bytes from socket", len);
 
+parse:
 		if (dl->proto == IPPROTO_TCP || dl->proto == IPPROTO_TLS_1_2) {
 			rc = http_parse(client, len);
 			if (rc > 0) {
+				/* Request the next fragments in advance as soon
+				 * as the file size is known. Errors on the
+				 * socket are detected by recv().
+				 */
+				(void)http_pipeline_fill(dl);
 				/* Wait for more data (fragment/header) */
 				continue;
 			}
@@ -561,12 +687,14 @@ restart_and_suspend:
 			break;
 		}
 
-		if (dl->progress == dl->file_size) {
+		if (dl->progress == download_end_get(dl)) {
 			LOG_INF("Download complete");
 			const struct download_client_evt evt = {
 				.id = DOWNLOAD_CLIENT_EVT_DONE,
 			};
-			dl->callback(&evt);
+			if (!fragments_flush(dl)) {
+				dl->callback(&evt);
+			}
 			/* Restart and suspend */
 			break;
 		}
@@ -581,10 +709,18 @@ send_again:
 		dl->offset = 0;
 		/* Request next fragment, if necessary (HTTPS/CoAP) */
 		if (dl->proto != IPPROTO_TCP || len == 0
-		   || IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS)) {
+		   || using_range_requests(dl)) {
 			dl->http.has_header = false;
 
-			rc = request_send(dl);
+			/* Pipelined requests are answered first */
+			rc = 0;
+			if (dl->http.requests_pending == 0) {
+				rc = request_send(dl);
+			}
+			if (!rc && (dl->proto == IPPROTO_TCP ||
+				    dl->proto == IPPROTO_TLS_1_2)) {
+				rc = http_pipeline_fill(dl);
+			}
 			if (rc) {
 				rc = error_evt_send(dl, ECONNRESET);
 				if (rc) {
@@ -616,10 +752,33 @@ int download_client_init(struct download_client *const client,
 
 	client->fd = -1;
 	client->callback = callback;
+	client->buf = client->fragment_buf[0];
+
+#if CONFIG_DOWNLOAD_CLIENT_FRAGMENT_BUF_CNT > 1
+	k_msgq_init(&client->fragment_q, (char *)client->fragment_q_buf,
+		    sizeof(struct download_fragment),
+		    ARRAY_SIZE(client->fragment_q_buf));
+	/* A fragment can be handed to the application before the download
+	 * thread takes the next buffer, so all buffers can be free at once.
+	 */
+	k_sem_init(&client->fragment_free,
+		   CONFIG_DOWNLOAD_CLIENT_FRAGMENT_BUF_CNT - 1,
+		   CONFIG_DOWNLOAD_CLIENT_FRAGMENT_BUF_CNT);
+
+	k_thread_create(&client->fragment_thread, client->fragment_thread_stack,
+			K_THREAD_STACK_SIZEOF(client->fragment_thread_stack),
+			fragment_thread, client, NULL, NULL,
+			K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
 
-	/* The thread is spawned now, but it will suspend itself;
-	 * it is resumed when the download is started via the API.
+	k_thread_name_set(&client->fragment_thread, "download_client_frag");
+#endif
+
+	/* The thread is spawned now, but it waits until the download
+	 * is started via the API.
 	 */
+	k_sem_init(&client->idle, 0, 1);
+	k_sem_init(&client->start, 0, 1);
+
 	client->tid =
 		k_thread_create(&client->thread, client->thread_stack,
 				K_THREAD_STACK_SIZEOF(client->thread_stack),
@@ -694,25 +853,24 @@ int download_client_disconnect(struct download_client *const client)
 	return 0;
 }
 
-int download_client_start(struct download_client *client, const char *file,
-			  size_t from)
+static int download_start(struct download_client *client, const char *file,
+			  size_t from, size_t to)
 {
 	int err;
 
-	if (client == NULL) {
-		return -EINVAL;
-	}
-
-	if (client->fd < 0) {
-		return -ENOTCONN;
-	}
-
 	client->file = file;
 	client->file_size = 0;
 	client->progress = from;
+	client->range_end = to;
 
 	client->offset = 0;
 	client->http.has_header = false;
+	client->http.carry_len = 0;
+	client->http.requests_pending = 0;
+
+#if CONFIG_DOWNLOAD_CLIENT_FRAGMENT_BUF_CNT > 1
+	client->fragment_refused = false;
+#endif
 
 	if (client->proto == IPPROTO_UDP || client->proto == IPPROTO_DTLS_1_2) {
 		if (IS_ENABLED(CONFIG_COAP)) {
@@ -725,15 +883,72 @@ int download_client_start(struct download_client *client, const char *file,
 		return err;
 	}
 
+	if (client->proto == IPPROTO_TCP || client->proto == IPPROTO_TLS_1_2) {
+		/* The end of a range is known in advance */
+		err = http_pipeline_fill(client);
+		if (err) {
+			return err;
+		}
+	}
+
 	LOG_INF("Downloading: %s [%u]", log_strdup(client->file),
 		client->progress);
 
 	/* Let the thread run */
-	k_thread_resume(client->tid);
+	k_sem_reset(&client->idle);
+	k_sem_give(&client->start);
 
 	return 0;
 }
 
+/* Wait until the download thread has stopped and handed all received
+ * fragments to the application.
+ */
+int download_idle_wait(struct download_client *client, k_timeout_t timeout)
+{
+	int err;
+
+	err = k_sem_take(&client->idle, timeout);
+	if (!err) {
+		/* The thread stays idle until the next download is started */
+		k_sem_give(&client->idle);
+	}
+
+	return err;
+}
+
+int download_client_start(struct download_client *client, const char *file,
+			  size_t from)
+{
+	if (client == NULL) {
+		return -EINVAL;
+	}
+
+	if (client->fd < 0) {
+		return -ENOTCONN;
+	}
+
+	return download_start(client, file, from, 0);
+}
+
+int download_client_range_start(struct download_client *client,
+				const char *file, size_t from, size_t to)
+{
+	if (client == NULL || from >= to) {
+		return -EINVAL;
+	}
+
+	if (client->fd < 0) {
+		return -ENOTCONN;
+	}
+
+	if (client->proto != IPPROTO_TCP && client->proto != IPPROTO_TLS_1_2) {
+		return -EPROTONOSUPPORT;
+	}
+
+	return download_start(client, file, from, to);
+}
+
 void download_client_pause(struct download_client *client)
 {
 	k_thread_suspend(client->tid);
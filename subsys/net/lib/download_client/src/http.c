@@ -33,13 +33,41 @@ LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
 
 int url_parse_host(const char *url, char *host, size_t len);
 int url_parse_file(const char *url, char *file, size_t len);
-int socket_send(const struct download_client *client, size_t len);
+int socket_send(const struct download_client *client, const char *buf,
+		size_t len);
+size_t download_end_get(const struct download_client *client);
 
-int http_get_request_send(struct download_client *client)
+bool using_range_requests(const struct download_client *client)
+{
+	/* We use range requests only for HTTPS, due to memory limitations.
+	 * When using HTTP, we request the whole resource to minimize
+	 * network usage (only one request/response are sent).
+	 */
+	return (client->proto == IPPROTO_TLS_1_2 ||
+		IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS) ||
+		client->range_end != 0);
+}
+
+static size_t fragment_size(const struct download_client *client)
+{
+	if (client->config.frag_size_override) {
+		return client->config.frag_size_override;
+	}
+
+	return CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE;
+}
+
+/* The request is built in the unused part of the response buffer,
+ * after the received data.
+ */
+static int http_request_send(struct download_client *client, size_t from)
 {
 	int err;
 	int len;
 	size_t off;
+	size_t end;
+	size_t used;
+	char *buf;
 	char host[HOSTNAME_SIZE];
 	char file[FILENAME_SIZE];
 
@@ -57,51 +85,111 @@ int http_get_request_send(struct download_client *client)
 	}
 
 	/* Offset of last byte in range (Content-Range) */
-	if (client->config.frag_size_override) {
-		off = client->progress + client->config.frag_size_override - 1;
-	} else {
-		off = client->progress +
-			CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE - 1;
-	}
+	off = from + fragment_size(client) - 1;
 
-	if (client->file_size != 0) {
-		/* Don't request bytes past the end of file */
-		off = MIN(off, client->file_size);
+	end = download_end_get(client);
+	if (end != 0) {
+		/* Don't request bytes past the end of download */
+		off = MIN(off, end - 1);
 	}
 
-	/* We use range requests only for HTTPS, due to memory limitations.
-	 * When using HTTP, we request the whole resource to minimize
-	 * network usage (only one request/response are sent).
-	 */
-	if (client->proto == IPPROTO_TLS_1_2
-	   || IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS)) {
-		len = snprintf(client->buf,
-			CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
-			GET_HTTPS_TEMPLATE, file, host, client->progress, off);
+	used = client->offset + client->http.carry_len;
+	buf = client->buf + used;
+
+	if (using_range_requests(client)) {
+		len = snprintf(buf, CONFIG_DOWNLOAD_CLIENT_BUF_SIZE - used,
+			GET_HTTPS_TEMPLATE, file, host, from, off);
 	} else {
-		len = snprintf(client->buf,
-			CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
-			GET_HTTP_TEMPLATE, file, host, client->progress);
+		len = snprintf(buf, CONFIG_DOWNLOAD_CLIENT_BUF_SIZE - used,
+			GET_HTTP_TEMPLATE, file, host, from);
 	}
 
-	if (len < 0 || len > CONFIG_DOWNLOAD_CLIENT_BUF_SIZE) {
-		LOG_ERR("Cannot create GET request, buffer too small");
+	if (len < 0 || len >= CONFIG_DOWNLOAD_CLIENT_BUF_SIZE - used) {
 		return -ENOMEM;
 	}
 
 	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
-		LOG_HEXDUMP_DBG(client->buf, len, "HTTP request");
+		LOG_HEXDUMP_DBG(buf, len, "HTTP request");
 	}
 
-	err = socket_send(client, len);
+	err = socket_send(client, buf, len);
 	if (err) {
 		LOG_ERR("Failed to send HTTP request, errno %d", errno);
 		return err;
 	}
 
+	if (using_range_requests(client)) {
+		client->http.requests_pending++;
+		client->http.range_offset = from + fragment_size(client);
+	}
+
+	return 0;
+}
+
+int http_get_request_send(struct download_client *client)
+{
+	int err;
+
+	/* Requests are (re)started from the current progress
+	 * only when no response is pending.
+	 */
+	__ASSERT_NO_MSG(client->http.requests_pending == 0);
+
+	err = http_request_send(client, client->progress);
+	if (err == -ENOMEM) {
+		LOG_ERR("Cannot create GET request, buffer too small");
+	}
+
+	return err;
+}
+
+/* Send the requests for the next fragments in advance, up to
+ * CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH pending requests.
+ */
+int http_pipeline_fill(struct download_client *client)
+{
+	int err;
+	const size_t end = download_end_get(client);
+
+	if (!using_range_requests(client) || end == 0) {
+		/* The ranges can only be requested once the file size
+		 * is known from the first response.
+		 */
+		return 0;
+	}
+
+	while (client->http.requests_pending <
+	       CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH &&
+	       client->http.range_offset < end) {
+		err = http_request_send(client, client->http.range_offset);
+		if (err == -ENOMEM) {
+			/* No room for the request until the buffer is
+			 * handed to the application, try again later.
+			 */
+			return 0;
+		}
+		if (err) {
+			return err;
+		}
+	}
+
 	return 0;
 }
 
+/* Maximum number of bytes to receive, so that only the payload of the
+ * current response is received in the buffer when its length is known.
+ */
+size_t http_recv_len_max(const struct download_client *client)
+{
+	size_t len = CONFIG_DOWNLOAD_CLIENT_BUF_SIZE - client->offset;
+
+	if (client->http.has_header && using_range_requests(client)) {
+		len = MIN(len, client->http.body_len - client->offset);
+	}
+
+	return len;
+}
+
 /* Returns:
  *  1 while the header is being received
  *  0 if the header has been fully received
@@ -111,11 +199,15 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 {
 	char *p;
 	char *q;
-	const bool using_range_requests = (client->proto == IPPROTO_TLS_1_2 ||
-		IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS));
-	const unsigned int expected_status = using_range_requests ? 206 : 200;
+	const bool range_requests = using_range_requests(client);
+	const unsigned int expected_status = range_requests ? 206 : 200;
 	unsigned int http_status;
 
+	if (client->offset < CONFIG_DOWNLOAD_CLIENT_BUF_SIZE) {
+		/* Do not look past the received data */
+		client->buf[client->offset] = '\0';
+	}
+
 	p = strstr(client->buf, "\r\n\r\n");
 	if (!p || p > client->buf + client->offset) {
 		/* Waiting full HTTP header */
@@ -168,7 +260,7 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 	 * and via "Content-Range" in case of HTTPS with range requests.
 	 */
 	if (client->file_size == 0) {
-		if (using_range_requests) {
+		if (range_requests) {
 			p = strstr(client->buf, "content-range");
 			if (!p) {
 				LOG_ERR("Server did not send "
@@ -208,6 +300,15 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 		client->http.connection_close = true;
 	}
 
+	if (range_requests) {
+		/* The response contains the requested range,
+		 * up to the end of the download.
+		 */
+		client->http.body_len = MIN(fragment_size(client),
+					    download_end_get(client) -
+					    client->progress);
+	}
+
 	client->http.has_header = true;
 
 	return 0;
@@ -244,8 +345,8 @@ int http_parse(struct download_client *client, size_t len)
 			 */
 			LOG_DBG("Copying %u payload bytes",
 				client->offset - hdr_len);
-			memcpy(client->buf, client->buf + hdr_len,
-			       client->offset - hdr_len);
+			memmove(client->buf, client->buf + hdr_len,
+				client->offset - hdr_len);
 
 			client->offset -= hdr_len;
 		} else {
@@ -254,24 +355,36 @@ int http_parse(struct download_client *client, size_t len)
 			 */
 			client->offset = 0;
 		}
+
+		/* Only the payload bytes count as progress */
+		len = client->offset;
 	}
 
-	/* Accumulate overall file progress.
-	 * If the last recv() call read an HTTP header,
-	 * `offset` has been moved at the end of any trailing
-	 * payload bytes by http_header_parse(). In this case,
-	 * `offset` is less than `len` and it represents
-	 * the actual payload bytes.
-	 */
-	client->progress += MIN(client->offset, len);
+	if (using_range_requests(client) &&
+	    client->offset > client->http.body_len) {
+		/* The buffer contains the beginning of the next (pipelined)
+		 * response. Keep it after the fragment, to be parsed once
+		 * the fragment is handed to the application.
+		 */
+		client->http.carry_len = client->offset - client->http.body_len;
+		client->offset = client->http.body_len;
+		len -= client->http.carry_len;
+	}
+
+	/* Accumulate overall file progress. */
+	client->progress += len;
 
 	/* Have we received a whole fragment or the whole file? */
-	if (client->progress != client->file_size &&
-	    client->offset < (client->config.frag_size_override != 0 ?
-			      client->config.frag_size_override :
-			      CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE)) {
+	if (client->progress != download_end_get(client) &&
+	    client->offset < fragment_size(client)) {
 		return 1;
 	}
 
+	if (using_range_requests(client)) {
+		/* The response is complete */
+		client->http.has_header = false;
+		client->http.requests_pending--;
+	}
+
 	return 0;
 }
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <sys/util.h>
+#include <logging/log.h>
+#include <net/download_client.h>
+
+LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
+
+#define RANGE_CNT CONFIG_DOWNLOAD_CLIENT_MULTI_RANGE_CNT
+
+int download_idle_wait(struct download_client *client, k_timeout_t timeout);
+
+/* The download client callback does not identify the client,
+ * so only one multi-range download can be in progress at a time.
+ */
+static struct download_client_multi *active;
+
+/* Find the range which the fragment belongs to. Fragments of a range are
+ * received in order, starting from the delivered offset.
+ */
+static int fragment_range(const struct download_client_multi *dlm,
+			  const struct download_fragment *fragment)
+{
+	for (size_t i = 0; i < RANGE_CNT; i++) {
+		if (fragment->offset >= dlm->delivered[i] &&
+		    fragment->offset < dlm->client[i].range_end) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static int range_callback(const struct download_client_evt *event)
+{
+	struct download_client_multi *dlm = active;
+	int rc = 0;
+
+	k_mutex_lock(&dlm->lock, K_FOREVER);
+
+	if (dlm->stopped) {
+		/* Stop the download of the remaining ranges */
+		rc = 1;
+	} else if (event->id == DOWNLOAD_CLIENT_EVT_DONE) {
+		__ASSERT_NO_MSG(dlm->ranges_left > 0);
+		dlm->ranges_left--;
+		if (dlm->ranges_left == 0) {
+			LOG_INF("All ranges downloaded");
+			dlm->callback(event);
+		}
+	} else if (event->id == DOWNLOAD_CLIENT_EVT_FRAGMENT) {
+		int range = fragment_range(dlm, &event->fragment);
+
+		__ASSERT_NO_MSG(range >= 0);
+
+		rc = dlm->callback(event);
+		if (rc) {
+			dlm->stopped = true;
+		} else if (range >= 0) {
+			dlm->delivered[range] = event->fragment.offset +
+						event->fragment.len;
+		}
+	} else {
+		rc = dlm->callback(event);
+		if (rc) {
+			dlm->stopped = true;
+		}
+	}
+
+	k_mutex_unlock(&dlm->lock);
+
+	return rc;
+}
+
+int download_client_multi_init(struct download_client_multi *dlm,
+			       download_client_callback_t callback)
+{
+	int err;
+
+	if (dlm == NULL || callback == NULL) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < RANGE_CNT; i++) {
+		err = download_client_init(&dlm->client[i], range_callback);
+		if (err) {
+			return err;
+		}
+	}
+
+	k_mutex_init(&dlm->lock);
+	dlm->callback = callback;
+
+	return 0;
+}
+
+int download_client_multi_start(struct download_client_multi *dlm,
+				const char *host,
+				const struct download_client_cfg *config,
+				const char *file, size_t file_size)
+{
+	size_t frag_size;
+	size_t range_size;
+
+	if (dlm == NULL || host == NULL || config == NULL || file == NULL ||
+	    file_size == 0) {
+		return -EINVAL;
+	}
+
+	frag_size = config->frag_size_override ?
+		    config->frag_size_override :
+		    CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE;
+
+	/* Align the ranges to fragments, to avoid partial fragments */
+	range_size = ROUND_UP(DIV_ROUND_UP(file_size, RANGE_CNT), frag_size);
+
+	dlm->host = host;
+	dlm->file = file;
+	dlm->config = *config;
+
+	/* The progress of every range is kept, so the download
+	 * can be resumed.
+	 */
+	for (size_t i = 0; i < RANGE_CNT; i++) {
+		struct download_client *client = &dlm->client[i];
+
+		dlm->delivered[i] = MIN(i * range_size, file_size);
+		client->range_end = MIN(dlm->delivered[i] + range_size,
+					file_size);
+	}
+
+	return download_client_multi_resume(dlm);
+}
+
+int download_client_multi_resume(struct download_client_multi *dlm)
+{
+	int err;
+
+	if (dlm == NULL || dlm->file == NULL) {
+		return -EINVAL;
+	}
+
+	if (active != NULL && active != dlm && active->ranges_left > 0) {
+		LOG_ERR("Multi-range download already in progress");
+		return -EALREADY;
+	}
+
+	active = dlm;
+
+	/* Stop the ranges which are still being downloaded. Closing the
+	 * socket wakes up a thread waiting for data, and the thread stops
+	 * on the next event. The client of a range which is complete is
+	 * waited for as well, since its thread may not have sent the last
+	 * event yet.
+	 */
+	k_mutex_lock(&dlm->lock, K_FOREVER);
+	dlm->stopped = true;
+	k_mutex_unlock(&dlm->lock);
+
+	for (size_t i = 0; i < RANGE_CNT; i++) {
+		(void)download_client_disconnect(&dlm->client[i]);
+	}
+
+	for (size_t i = 0; i < RANGE_CNT; i++) {
+		(void)download_idle_wait(&dlm->client[i], K_FOREVER);
+	}
+
+	dlm->stopped = false;
+	dlm->ranges_left = 0;
+
+	for (size_t i = 0; i < RANGE_CNT; i++) {
+		if (dlm->delivered[i] < dlm->client[i].range_end) {
+			dlm->ranges_left++;
+		}
+	}
+
+	for (size_t i = 0; i < RANGE_CNT; i++) {
+		struct download_client *client = &dlm->client[i];
+
+		if (dlm->delivered[i] == client->range_end) {
+			continue;
+		}
+
+		/* Start over on a new connection, since responses to
+		 * pipelined requests may still be received on the old one.
+		 * The thread may have reconnected before it stopped.
+		 */
+		(void)download_client_disconnect(client);
+
+		/* The client progress can be ahead of the delivered data,
+		 * if the download was stopped with fragments in flight.
+		 */
+		err = download_client_connect(client, dlm->host, &dlm->config);
+		if (!err) {
+			LOG_INF("Range %d: %u-%u", i, dlm->delivered[i],
+				client->range_end - 1);
+			err = download_client_range_start(client, dlm->file,
+							  dlm->delivered[i],
+							  client->range_end);
+		}
+
+		if (err) {
+			LOG_ERR("Failed to start range %d, err %d", i, err);
+			/* Stop the ranges which are already started */
+			k_mutex_lock(&dlm->lock, K_FOREVER);
+			dlm->stopped = true;
+			k_mutex_unlock(&dlm->lock);
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+void download_client_multi_disconnect(struct download_client_multi *dlm)
+{
+	for (size_t i = 0; i < RANGE_CNT; i++) {
+		(void)download_client_disconnect(&dlm->client[i]);
+	}
+}
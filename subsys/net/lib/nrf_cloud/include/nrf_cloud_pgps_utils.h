@@ -5,6 +5,7 @@
  */
 
 #include <zephyr.h>
+#include "nrf_cloud_pgps_schema_v1.h"
 
 #ifndef NRF_CLOUD_PGPS_UTILS_H_
 #define NRF_CLOUD_PGPS_UTILS_H_
@@ -42,13 +43,27 @@ struct gps_location {
 	int64_t gps_sec;
 };
 
-struct nrf_cloud_pgps_header;
+/* Flash block of every prediction of a complete prediction set, in time order,
+ * and the checksum of each stored prediction, or 0 if not known;
+ * saved with the prediction set so it does not need to be rebuilt at startup.
+ */
+struct npgps_index {
+	struct nrf_cloud_pgps_header header;
+	uint8_t blocks[NUM_PREDICTIONS];
+	uint32_t pred_crc[NUM_PREDICTIONS];
+	uint32_t crc;
+};
 
 typedef int (*npgps_buffer_handler_t)(uint8_t *buf, size_t len);
+/* called when a download stops on an error before it is done */
+typedef void (*npgps_error_handler_t)(int err);
 
 /* settings functions */
 int npgps_save_header(struct nrf_cloud_pgps_header *header);
 const struct nrf_cloud_pgps_header *npgps_get_saved_header(void);
+int npgps_save_index(struct npgps_index *idx);
+int npgps_clear_index(void);
+const struct npgps_index *npgps_get_saved_index(void);
 const struct gps_location *npgps_get_saved_location(void);
 int npgps_settings_init(void);
 
@@ -75,9 +90,12 @@ int npgps_pointer_to_block(uint8_t *p);
 void *npgps_block_to_pointer(int block);
 
 /* download functions */
-int npgps_download_init(npgps_buffer_handler_t handler);
+int npgps_download_init(npgps_buffer_handler_t handler,
+			npgps_error_handler_t error_handler);
 int npgps_download_start(const char *host, const char *file, int sec_tag,
 			 const char *apn, size_t fragment_size);
+int npgps_download_resume(void);
+size_t npgps_download_received(void);
 
 
 #ifdef __cplusplus
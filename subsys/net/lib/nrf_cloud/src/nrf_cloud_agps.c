@@ -506,8 +506,6 @@ static int copy_time_and_tow(nrf_gnss_agps_data_system_time_and_sv_tow_t *dst,
 
 static int agps_send_to_modem(struct nrf_cloud_apgs_element *agps_data)
 {
-	atomic_set(&request_in_progress, 0);
-
 	switch (agps_data->type) {
 	case NRF_CLOUD_AGPS_UTC_PARAMETERS: {
 		nrf_gnss_agps_data_utc_t utc;
@@ -693,6 +691,8 @@ int nrf_cloud_agps_process(const char *buf, size_t buf_len, const int *socket)
 
 	if (version != NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION) {
 		LOG_ERR("Cannot parse schema version: %d", version);
+		LOG_DBG("A-GPS_inject_active UNLOCKED");
+		k_sem_give(&agps_injection_active);
 		return -EBADMSG;
 	}
 
@@ -714,6 +714,8 @@ int nrf_cloud_agps_process(const char *buf, size_t buf_len, const int *socket)
 		}
 	}
 
+	atomic_set(&request_in_progress, 0);
+
 	while (parsed_len < buf_len) {
 		size_t element_size =
 			get_next_agps_element(&element, &buf[parsed_len]);
@@ -19,6 +19,7 @@
 #include <net/nrf_cloud_agps.h>
 #include <net/nrf_cloud_pgps.h>
 #include <settings/settings.h>
+#include <sys/crc.h>
 #include <power/reboot.h>
 #include <logging/log_ctrl.h>
 
@@ -37,6 +38,9 @@ LOG_MODULE_REGISTER(nrf_cloud_pgps, CONFIG_NRF_CLOUD_GPS_LOG_LEVEL);
 #define REPLACEMENT_THRESHOLD		CONFIG_NRF_CLOUD_PGPS_REPLACEMENT_THRESHOLD
 #define SEC_TAG				CONFIG_NRF_CLOUD_SEC_TAG
 #define FRAGMENT_SIZE			CONFIG_NRF_CLOUD_PGPS_DOWNLOAD_FRAGMENT_SIZE
+#define RESUME_RETRIES			CONFIG_NRF_CLOUD_PGPS_DOWNLOAD_RESUME_RETRIES
+#define RESUME_DELAY_SEC		CONFIG_NRF_CLOUD_PGPS_DOWNLOAD_RESUME_DELAY
+#define RESUME_DELAY_MAX_SEC		SEC_PER_HOUR
 #define PREDICTION_MIDPOINT_SHIFT_SEC	(120 * SEC_PER_MIN)
 #define LOCATION_UNC_SEMIMAJOR_K	89U
 #define LOCATION_UNC_SEMIMINOR_K	89U
@@ -93,13 +97,21 @@ struct pgps_index {
 	uint8_t dl_pnum;
 	uint8_t pnum_offset;
 	uint8_t cur_pnum;
+	uint8_t resume_count;
 	bool partial_request;
 	bool stale_server_data;
+	bool dl_interrupted;
 	uint32_t storage_extent;
 	int store_block;
+	/* most recent request, to repeat it if its download is interrupted */
+	struct gps_pgps_request request;
 
 	/* array of pointers to predictions, in sorted time order */
 	struct nrf_cloud_pgps_prediction *predictions[NUM_PREDICTIONS];
+	/* predictions that have been checked against their expected time */
+	bool validated[NUM_PREDICTIONS];
+	/* checksum of each stored prediction, or 0 if not known */
+	uint32_t pred_crc[NUM_PREDICTIONS];
 };
 
 static struct pgps_index index;
@@ -125,12 +137,16 @@ static void cache_pgps_header(const struct nrf_cloud_pgps_header *header);
 static int consume_pgps_data(uint8_t pnum, const char *buf, size_t buf_len);
 static void prediction_work_handler(struct k_work *work);
 static void prediction_timer_handler(struct k_timer *dummy);
+static void resume_work_handler(struct k_work *work);
+static int resume_download(void);
+static int send_request(const struct gps_pgps_request *request);
 void agps_print_enable(bool enable);
 static void print_time_details(const char *info,
 			       int64_t sec, uint16_t day, uint32_t time_of_day);
 
 K_WORK_DEFINE(prediction_work, prediction_work_handler);
 K_TIMER_DEFINE(prediction_timer, prediction_timer_handler, NULL);
+K_WORK_DELAYABLE_DEFINE(resume_work, resume_work_handler);
 
 static int determine_prediction_num(struct nrf_cloud_pgps_header *header,
 				    struct nrf_cloud_pgps_prediction *p)
@@ -268,6 +284,8 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 	/* reset catalog of predictions */
 	for (pnum = 0; pnum < count; pnum++) {
 		index.predictions[pnum] = NULL;
+		index.validated[pnum] = false;
+		index.pred_crc[pnum] = 0;
 	}
 
 	npgps_reset_block_pool();
@@ -322,6 +340,7 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 		LOG_INF("Prediction num:%u, loc:%p, blk:%d", pnum, pred, i);
 		__ASSERT(i != -1, "unexpected pointer value %p", pred);
 		npgps_mark_block_used(i, true);
+		index.validated[pnum] = true;
 	}
 
 	/* find first free block in flash, if any, after chronologicaly
@@ -342,6 +361,124 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 	return pnum;
 }
 
+/* Rebuild the catalog of predictions from the index saved with the prediction
+ * set, without reading the predictions; each prediction is validated when it
+ * is first looked up.
+ */
+static int load_saved_index(void)
+{
+	const struct npgps_index *saved = npgps_get_saved_index();
+	uint16_t count = index.header.prediction_count;
+	int block = NO_BLOCK;
+	int pnum;
+
+	if ((saved == NULL) ||
+	    memcmp(&saved->header, &index.header, sizeof(index.header))) {
+		LOG_INF("No index saved for stored P-GPS data");
+		return 0;
+	}
+
+	for (pnum = 0; pnum < count; pnum++) {
+		if (saved->blocks[pnum] >= NUM_BLOCKS) {
+			LOG_WRN("Saved index has invalid block:%u for prediction num:%u",
+				saved->blocks[pnum], pnum);
+			return 0;
+		}
+	}
+
+	npgps_reset_block_pool();
+
+	for (pnum = 0; pnum < count; pnum++) {
+		block = saved->blocks[pnum];
+		index.predictions[pnum] = npgps_block_to_pointer(block);
+		index.validated[pnum] = false;
+		index.pred_crc[pnum] = saved->pred_crc[pnum];
+		npgps_mark_block_used(block, true);
+	}
+
+	/* new downloads begin after the chronologically last prediction */
+	npgps_find_first_free(block);
+	npgps_print_blocks();
+
+	return count;
+}
+
+/* Save the catalog of a complete prediction set, unless already saved. */
+static void save_index(void)
+{
+	struct npgps_index idx;
+	const struct npgps_index *saved = npgps_get_saved_index();
+	int block;
+	int pnum;
+	int err;
+
+	memset(&idx, 0, sizeof(idx));
+	memcpy(&idx.header, &index.header, sizeof(idx.header));
+
+	for (pnum = 0; pnum < index.header.prediction_count; pnum++) {
+		block = NO_BLOCK;
+		if (index.predictions[pnum]) {
+			block = npgps_pointer_to_block((uint8_t *)index.predictions[pnum]);
+		}
+		if (block == NO_BLOCK) {
+			LOG_WRN("Prediction num:%u missing; index not saved", pnum);
+			return;
+		}
+		idx.blocks[pnum] = block;
+		idx.pred_crc[pnum] = index.pred_crc[pnum];
+	}
+
+	if (saved && !memcmp(saved, &idx, offsetof(struct npgps_index, crc))) {
+		return;
+	}
+
+	err = npgps_save_index(&idx);
+	if (err) {
+		LOG_ERR("Error saving P-GPS index:%d", err);
+	}
+}
+
+/* Check all stored predictions after one of them did not match the saved
+ * index, as at init, and drop the predictions from the bad one on; its
+ * contents may pass the checks even if they do not match their checksum.
+ */
+static int revalidate_stored_predictions(const struct nrf_cloud_pgps_prediction *bad)
+{
+	uint16_t gps_day;
+	uint32_t gps_time_of_day;
+	int block = NO_BLOCK;
+	int num_valid;
+	int pnum;
+
+	npgps_clear_index();
+
+	num_valid = validate_stored_predictions(&gps_day, &gps_time_of_day);
+	for (pnum = 0; pnum < num_valid; pnum++) {
+		if (index.predictions[pnum] == bad) {
+			num_valid = pnum;
+			break;
+		}
+		block = npgps_pointer_to_block((uint8_t *)index.predictions[pnum]);
+	}
+
+	for (pnum = num_valid; pnum < index.header.prediction_count; pnum++) {
+		if (index.validated[pnum]) {
+			npgps_free_block(npgps_pointer_to_block((uint8_t *)
+								index.predictions[pnum]));
+		}
+		index.predictions[pnum] = NULL;
+		index.validated[pnum] = false;
+		index.pred_crc[pnum] = 0;
+	}
+
+	/* new downloads begin after the last prediction kept */
+	if (block != NO_BLOCK) {
+		npgps_find_first_free(block);
+	}
+
+	return num_valid;
+}
+
 static void get_prediction_day_time(int pnum, int64_t *gps_sec, uint16_t *gps_day,
 				    uint32_t *gps_time_of_day)
 {
@@ -355,6 +492,47 @@ static void get_prediction_day_time(int pnum, int64_t *gps_sec, uint16_t *gps_da
 	}
 }
 
+/* Number of predictions stored from the first one on, without gaps. */
+static int count_stored_predictions(void)
+{
+	int pnum;
+
+	for (pnum = 0; pnum < index.header.prediction_count; pnum++) {
+		if (index.predictions[pnum] == NULL) {
+			break;
+		}
+	}
+
+	return pnum;
+}
+
+/* Request the predictions from the first one that is not stored on. */
+static int request_missing_predictions(int num_valid)
+{
+	struct gps_pgps_request request;
+	uint16_t count = index.header.prediction_count;
+
+	if (!num_valid) {
+		/* read a full set of predictions */
+		if (handler) {
+			handler(PGPS_EVT_UNAVAILABLE, NULL);
+		}
+		return nrf_cloud_pgps_request_all();
+	}
+
+	/* read missing predictions at end */
+	if (handler) {
+		handler(PGPS_EVT_LOADING, NULL);
+	}
+	LOG_INF("Incomplete P-GPS data; "
+		"requesting %u predictions...", count - num_valid);
+	get_prediction_day_time(num_valid, NULL, &request.gps_day,
+				&request.gps_time_of_day);
+	request.prediction_count = count - num_valid;
+	request.prediction_period_min = index.header.prediction_period_min;
+	return nrf_cloud_pgps_request(&request);
+}
+
 static void discard_oldest_predictions(int num)
 {
 	int i;
@@ -379,6 +557,8 @@ static void discard_oldest_predictions(int num)
 	for (i = last; i < index.header.prediction_count; i++) {
 		pnum = i - last;
 		index.predictions[pnum] = index.predictions[i];
+		index.validated[pnum] = index.validated[i];
+		index.pred_crc[pnum] = index.pred_crc[i];
 	}
 
 	/* set prediction pointers for 'last' in the newly empty
@@ -387,9 +567,18 @@ static void discard_oldest_predictions(int num)
 	for (pnum = index.header.prediction_count - last; pnum <
 	      index.header.prediction_count; pnum++) {
 		index.predictions[pnum] = NULL;
+		index.validated[pnum] = false;
+		index.pred_crc[pnum] = 0;
 	}
 	npgps_print_blocks();
 
+	/* the current prediction has moved along with the others */
+	if ((index.cur_pnum != 0xff) && (index.cur_pnum >= last)) {
+		index.cur_pnum -= last;
+	} else {
+		index.cur_pnum = 0xff;
+	}
+
 	/* update index and header for new first stored prediction */
 	get_prediction_day_time(last, &index.start_sec,
 				&index.header.gps_day,
@@ -515,9 +704,11 @@ int nrf_cloud_pgps_find_prediction(struct nrf_cloud_pgps_prediction **prediction
 	uint32_t start_time = index.header.gps_time_of_day;
 	uint16_t period_min = index.header.prediction_period_min;
 	uint16_t count = index.header.prediction_count;
+	uint16_t pred_day;
+	uint32_t pred_time;
+	int num_valid;
 	int err;
 	int pnum;
-	bool margin = false;
 
 	if (state == PGPS_NONE) {
 		LOG_ERR("P-GPS subsystem is not initialized.");
@@ -543,6 +734,17 @@ int nrf_cloud_pgps_find_prediction(struct nrf_cloud_pgps_prediction **prediction
 		cur_gps_sec = 0;
 	}
 
+	/* most lookups are for the same prediction as the previous one */
+	pnum = index.cur_pnum;
+	if ((pnum < count) && index.validated[pnum] && (cur_gps_sec >= start_sec)) {
+		offset_sec = cur_gps_sec - start_sec - (int64_t)pnum * index.period_sec;
+		if ((offset_sec >= 0) && (offset_sec < index.period_sec)) {
+			*prediction = index.predictions[pnum];
+			start_expiration_timer(pnum, cur_gps_sec);
+			return pnum;
+		}
+	}
+
 	print_time_details("Looking for prediction for:",
 			   cur_gps_sec, cur_gps_day, cur_gps_time_of_day);
 
@@ -572,7 +774,6 @@ int nrf_cloud_pgps_find_prediction(struct nrf_cloud_pgps_prediction **prediction
 			LOG_WRN("data expired!");
 			return -ETIMEDOUT;
 		}
-		margin = true;
 		/* data is expired; use most recent entry */
 		pnum = count - 1;
 	} else {
@@ -587,14 +788,34 @@ int nrf_cloud_pgps_find_prediction(struct nrf_cloud_pgps_prediction **prediction
 	index.cur_pnum = pnum;
 	*prediction = index.predictions[pnum];
 	if (*prediction) {
-		err = validate_prediction(*prediction,
-					  cur_gps_day, cur_gps_time_of_day,
-					  period_min, false, margin);
-		if (!err) {
-			start_expiration_timer(pnum, cur_gps_sec);
-			return pnum;
+		/* predictions are checked once, when first used */
+		if (!index.validated[pnum]) {
+			get_prediction_day_time(pnum, NULL, &pred_day, &pred_time);
+			err = validate_prediction(*prediction, pred_day, pred_time,
+						  period_min, true, false);
+			if (!err && index.pred_crc[pnum] &&
+			    (crc32_ieee((uint8_t *)*prediction, sizeof(**prediction)) !=
+			     index.pred_crc[pnum])) {
+				LOG_ERR("Prediction num:%u does not match its checksum", pnum);
+				err = -EINVAL;
+			}
+			if (err) {
+				/* stored data does not match the saved index */
+				LOG_WRN("Stored P-GPS data does not match index; checking all");
+				num_valid = revalidate_stored_predictions(*prediction);
+				*prediction = NULL;
+				if (state == PGPS_READY) {
+					(void)request_missing_predictions(num_valid);
+				}
+				if (pnum >= num_valid) {
+					return nrf_cloud_pgps_loading() ? -ELOADING : err;
+				}
+				*prediction = index.predictions[pnum];
+			}
+			index.validated[pnum] = true;
 		}
-		return err;
+		start_expiration_timer(pnum, cur_gps_sec);
+		return pnum;
 	}
 	if (nrf_cloud_pgps_loading()) {
 		LOG_WRN("Prediction num:%u not loaded yet", pnum);
@@ -670,19 +891,25 @@ bool nrf_cloud_pgps_loading(void)
 
 int nrf_cloud_pgps_request(const struct gps_pgps_request *request)
 {
-	int err = 0;
-	cJSON *data_obj;
-	cJSON *pgps_req_obj;
-	cJSON *ret;
-
 	if (state == PGPS_NONE) {
 		LOG_ERR("P-GPS subsystem is not initialized.");
 		return -EINVAL;
 	}
 
 	if (nrf_cloud_pgps_loading()) {
-		return 0;
+		return index.dl_interrupted ? resume_download() : 0;
 	}
+
+	return send_request(request);
+}
+
+static int send_request(const struct gps_pgps_request *request)
+{
+	int err = 0;
+	cJSON *data_obj;
+	cJSON *pgps_req_obj;
+	cJSON *ret;
+
 	ignore_packets = false;
 
 	LOG_INF("Requesting %u predictions...", request->prediction_count);
@@ -714,6 +941,7 @@ int nrf_cloud_pgps_request(const struct gps_pgps_request *request)
 		index.pnum_offset = 0;
 	}
 	index.expected_count = request->prediction_count;
+	memcpy(&index.request, request, sizeof(index.request));
 
 	ret = cJSON_AddNumberToObject(data_obj, PGPS_JSON_PRED_COUNT,
 				      request->prediction_count);
@@ -767,7 +995,7 @@ int nrf_cloud_pgps_request_all(void)
 	}
 
 	if (nrf_cloud_pgps_loading()) {
-		return 0;
+		return index.dl_interrupted ? resume_download() : 0;
 	}
 
 	npgps_reset_block_pool();
@@ -805,6 +1033,10 @@ int nrf_cloud_pgps_preemptive_updates(void)
 		return -EINVAL;
 	}
 
+	if (nrf_cloud_pgps_loading()) {
+		return index.dl_interrupted ? resume_download() : 0;
+	}
+
 	if (current == 0xff) {
 		return nrf_cloud_pgps_request_all();
 	}
@@ -1037,7 +1269,8 @@ static int open_storage(uint32_t offset, bool preserve)
 	return err;
 }
 
-static int store_prediction(uint8_t *p, size_t len, uint32_t sentinel, bool last)
+static int store_prediction(uint8_t *p, size_t len, uint32_t sentinel, bool last,
+			    uint32_t *crc)
 {
 	static bool first = true;
 	static uint8_t pad[PGPS_PREDICTION_PAD];
@@ -1050,6 +1283,8 @@ static int store_prediction(uint8_t *p, size_t len, uint32_t sentinel, bool last
 		first = false;
 	}
 
+	/* checksum of the prediction as stored, for checking it when used */
+	*crc = crc32_ieee_update(0, p, schema_offset);
 	err = stream_flash_buffered_write(&stream, p, schema_offset, false);
 	if (err) {
 		LOG_ERR("Error writing pgps prediction:%d", err);
@@ -1057,16 +1292,19 @@ static int store_prediction(uint8_t *p, size_t len, uint32_t sentinel, bool last
 	}
 	p += schema_offset;
 	len -= schema_offset;
+	*crc = crc32_ieee_update(*crc, &schema, sizeof(schema));
 	err = stream_flash_buffered_write(&stream, &schema, sizeof(schema), false);
 	if (err) {
 		LOG_ERR("Error writing schema:%d", err);
 		return err;
 	}
+	*crc = crc32_ieee_update(*crc, p, len);
 	err = stream_flash_buffered_write(&stream, p, len, false);
 	if (err) {
 		LOG_ERR("Error writing pgps prediction:%d", err);
 		return err;
 	}
+	*crc = crc32_ieee_update(*crc, (uint8_t *)&sentinel, sizeof(sentinel));
 	err = stream_flash_buffered_write(&stream, (uint8_t *)&sentinel,
 					  sizeof(sentinel), false);
 	if (err) {
@@ -1084,6 +1322,93 @@ static int flush_storage(void)
 	return stream_flash_buffered_write(&stream, NULL, 0, true);
 }
 
+static void schedule_resume(void)
+{
+	uint32_t delay = RESUME_DELAY_SEC << MIN(index.resume_count, 7);
+
+	delay = MIN(delay, RESUME_DELAY_MAX_SEC);
+	LOG_INF("Resuming P-GPS download in %u seconds", delay);
+	k_work_reschedule(&resume_work, K_SECONDS(delay));
+}
+
+static void download_error_handler(int err)
+{
+	if (state != PGPS_LOADING) {
+		return;
+	}
+
+	LOG_WRN("P-GPS download interrupted at prediction num:%u, offset:%u; err:%d",
+		index.dl_pnum, index.dl_offset, err);
+
+	/* keep the predictions received so far, also across a reset */
+	err = flush_storage();
+	if (err) {
+		LOG_ERR("Error flushing storage:%d", err);
+	}
+	index.dl_interrupted = true;
+	schedule_resume();
+}
+
+/* Request the predictions of an interrupted download that were not stored. */
+static int request_remaining(void)
+{
+	struct gps_pgps_request request;
+
+	if (index.dl_offset == 0) {
+		/* the header was not received, so nothing was stored */
+		memcpy(&request, &index.request, sizeof(request));
+	} else {
+		get_prediction_day_time(index.dl_pnum, NULL, &request.gps_day,
+					&request.gps_time_of_day);
+		request.prediction_count = index.header.prediction_count - index.dl_pnum;
+		request.prediction_period_min = index.header.prediction_period_min;
+	}
+
+	/* the block for the next prediction is allocated again when loading */
+	if (index.store_block != NO_BLOCK) {
+		npgps_free_block(index.store_block);
+		npgps_find_first_free(index.store_block);
+		index.store_block = NO_BLOCK;
+	}
+
+	LOG_INF("Requesting %u predictions not received", request.prediction_count);
+	return send_request(&request);
+}
+
+/* Continue an interrupted download where it stopped, or request the
+ * predictions that were not received once it cannot be resumed.
+ */
+static int resume_download(void)
+{
+	int err;
+
+	(void)k_work_cancel_delayable(&resume_work);
+
+	if (index.resume_count < RESUME_RETRIES) {
+		index.resume_count++;
+		err = npgps_download_resume();
+	} else {
+		err = request_remaining();
+	}
+
+	if (err) {
+		LOG_ERR("Error resuming P-GPS download:%d", err);
+		schedule_resume();
+	} else {
+		index.dl_interrupted = false;
+	}
+	return err;
+}
+
+static void resume_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	if (index.dl_interrupted && (state == PGPS_LOADING)) {
+		(void)resume_download();
+	}
+}
+
 static int process_buffer(uint8_t *buf, size_t len)
 {
 	int err;
@@ -1132,6 +1457,8 @@ static int process_buffer(uint8_t *buf, size_t len)
 			LOG_WRN("Current time unknown; assume data's timeframe is valid");
 		}
 		log_pgps_header("pgps_header: ", header);
+		/* stored predictions are about to change */
+		npgps_clear_index();
 		npgps_save_header(header);
 
 		len -= sizeof(*header);
@@ -1314,7 +1641,8 @@ static int consume_pgps_data(uint8_t pnum, const char *buf, size_t buf_len)
 			index.loading_count++;
 			finished = (index.loading_count == index.expected_count);
 			store_prediction(prediction_ptr, buf_len, (uint32_t)gps_sec,
-					 finished || (index.storage_extent == 1));
+					 finished || (index.storage_extent == 1),
+					 &index.pred_crc[pnum]);
 			index.predictions[pnum] = npgps_block_to_pointer(index.store_block);
 
 			if (pgps_need_assistance &&
@@ -1329,6 +1657,7 @@ static int consume_pgps_data(uint8_t pnum, const char *buf, size_t buf_len)
 			} else {
 				LOG_INF("All P-GPS data received. Done.");
 				state = PGPS_READY;
+				save_index();
 				if (handler) {
 					handler(PGPS_EVT_READY, NULL);
 				}
@@ -1472,13 +1801,19 @@ int nrf_cloud_pgps_process(const char *buf, size_t buf_len)
 			index.period_sec =
 				index.header.prediction_period_min * SEC_PER_MIN;
 			memset(index.predictions, 0, sizeof(index.predictions));
+			memset(index.validated, 0, sizeof(index.validated));
+			memset(index.pred_crc, 0, sizeof(index.pred_crc));
 		} else {
 			for (pnum = index.pnum_offset;
 			     pnum < index.expected_count + index.pnum_offset; pnum++) {
 				index.predictions[pnum] = NULL;
+				index.validated[pnum] = false;
+				index.pred_crc[pnum] = 0;
 			}
 		}
 		index.loading_count = 0;
+		index.resume_count = 0;
+		index.dl_interrupted = false;
 		index.store_block = npgps_alloc_block();
 		if (index.store_block == NO_BLOCK) {
 			LOG_ERR("No free flash space!");
@@ -1568,7 +1903,7 @@ int nrf_cloud_pgps_init(struct nrf_cloud_pgps_init_param *param)
 	memset(&index, 0, sizeof(index));
 	(void)npgps_settings_init();
 
-	err = npgps_download_init(process_buffer);
+	err = npgps_download_init(process_buffer, download_error_handler);
 	if (err) {
 		LOG_ERR("Error initializing download client:%d", err);
 		return err;
@@ -1582,6 +1917,7 @@ int nrf_cloud_pgps_init(struct nrf_cloud_pgps_init_param *param)
 	uint16_t gps_day = 0;
 	uint32_t gps_time_of_day = 0;
 	const struct nrf_cloud_pgps_header *saved_header;
+	bool index_loaded = false;
 
 	saved_header = npgps_get_saved_header();
 	if (validate_pgps_header(saved_header)) {
@@ -1592,12 +1928,20 @@ int nrf_cloud_pgps_init(struct nrf_cloud_pgps_init_param *param)
 		gps_day = index.header.gps_day;
 		gps_time_of_day = index.header.gps_time_of_day;
 
-		/* check for all predictions up to date;
+		/* use the index saved with a complete prediction set, if any;
+		 * otherwise check for all predictions up to date;
 		 * if missing some, get from server
 		 */
-		LOG_INF("Checking stored P-GPS data; count:%u, period_min:%u",
-			count, period_min);
-		num_valid = validate_stored_predictions(&gps_day, &gps_time_of_day);
+		num_valid = load_saved_index();
+		if (num_valid) {
+			LOG_INF("Loaded index of stored P-GPS data; count:%u, period_min:%u",
+				count, period_min);
+			index_loaded = true;
+		} else {
+			LOG_INF("Checking stored P-GPS data; count:%u, period_min:%u",
+				count, period_min);
+			num_valid = validate_stored_predictions(&gps_day, &gps_time_of_day);
+		}
 	}
 
 	struct nrf_cloud_pgps_prediction *test_prediction;
@@ -1607,6 +1951,10 @@ int nrf_cloud_pgps_init(struct nrf_cloud_pgps_init_param *param)
 	if (num_valid) {
 		LOG_INF("Checking if P-GPS data is expired...");
 		err = nrf_cloud_pgps_find_prediction(&test_prediction);
+		if (index_loaded) {
+			/* predictions not matching the index have been dropped */
+			num_valid = count_stored_predictions();
+		}
 		if (err == -ETIMEDOUT) {
 			LOG_WRN("Predictions expired. Requesting predictions...");
 			num_valid = 0;
@@ -1618,32 +1966,14 @@ int nrf_cloud_pgps_init(struct nrf_cloud_pgps_init_param *param)
 		}
 	}
 
-	if (!num_valid) {
-		/* read a full set of predictions */
-		if (handler) {
-			handler(PGPS_EVT_UNAVAILABLE, NULL);
-		}
-		err = nrf_cloud_pgps_request_all();
-	} else if (num_valid < count) {
-		/* read missing predictions at end */
-		struct gps_pgps_request request;
-
-		if (handler) {
-			handler(PGPS_EVT_LOADING, NULL);
-		}
-		LOG_INF("Incomplete P-GPS data; "
-			"requesting %u predictions...", count - num_valid);
-		get_prediction_day_time(num_valid, NULL, &gps_day, &gps_time_of_day);
-		request.gps_day = gps_day;
-		request.gps_time_of_day = gps_time_of_day;
-		request.prediction_count = count - num_valid;
-		request.prediction_period_min = period_min;
-		err = nrf_cloud_pgps_request(&request);
+	if (!num_valid || (num_valid < count)) {
+		err = request_missing_predictions(num_valid);
 	} else if ((count - (pnum + 1)) < REPLACEMENT_THRESHOLD) {
 		/* replace expired predictions with newer */
 		err = nrf_cloud_pgps_preemptive_updates();
 	} else {
 		state = PGPS_READY;
+		save_index();
 		LOG_INF("P-GPS data is up to date.");
 		if (handler) {
 			handler(PGPS_EVT_READY, NULL);
@@ -7,6 +7,7 @@
 #include <zephyr.h>
 #include <pm_config.h>
 #include <stdlib.h>
+#include <sys/crc.h>
 
 #include <net/nrf_cloud_pgps.h>
 #include <settings/settings.h>
@@ -28,6 +29,8 @@ LOG_MODULE_DECLARE(nrf_cloud_pgps, CONFIG_NRF_CLOUD_GPS_LOG_LEVEL);
 #define SETTINGS_FULL_LOCATION			SETTINGS_NAME "/" SETTINGS_KEY_LOCATION
 #define SETTINGS_KEY_LEAP_SEC			"g2u_leap_sec"
 #define SETTINGS_FULL_LEAP_SEC			SETTINGS_NAME "/" SETTINGS_KEY_LEAP_SEC
+#define SETTINGS_KEY_INDEX			"index"
+#define SETTINGS_FULL_INDEX			SETTINGS_NAME "/" SETTINGS_KEY_INDEX
 
 struct block_pool {
 	int first_free;
@@ -43,11 +46,20 @@ static int num_blocks;
 static int gps_leap_seconds = GPS_TO_UTC_LEAP_SECONDS;
 static struct gps_location saved_location;
 static struct nrf_cloud_pgps_header saved_header;
+static struct npgps_index saved_index;
+static bool saved_index_valid;
 
 static K_SEM_DEFINE(pgps_active, 1, 1);
 static struct download_client dlc;
 static int socket_retries_left;
 static npgps_buffer_handler_t buffer_handler;
+static npgps_error_handler_t error_handler;
+
+/* kept to resume an interrupted download */
+static struct download_client_cfg dl_config;
+static const char *dl_host;
+static const char *dl_file;
+static size_t dl_received;
 
 
 static int download_client_callback(const struct download_client_evt *event);
@@ -86,6 +98,21 @@ static int settings_set(const char *key, size_t len_rd,
 			return 0;
 		}
 	}
+	if (!strncmp(key, SETTINGS_KEY_INDEX,
+		     strlen(SETTINGS_KEY_INDEX)) &&
+	    (len_rd == sizeof(saved_index))) {
+		if (read_cb(cb_arg, (void *)&saved_index, len_rd) == len_rd) {
+			saved_index_valid = (saved_index.crc ==
+					     crc32_ieee((uint8_t *)&saved_index,
+							offsetof(struct npgps_index, crc)));
+			LOG_DBG("Read index: count:%u, day:%u, time:%u, valid:%d",
+				saved_index.header.prediction_count,
+				saved_index.header.gps_day,
+				saved_index.header.gps_time_of_day,
+				saved_index_valid);
+			return 0;
+		}
+	}
 	if (!strncmp(key, SETTINGS_KEY_LEAP_SEC,
 		     strlen(SETTINGS_KEY_LEAP_SEC)) &&
 	    (len_rd == sizeof(gps_leap_seconds))) {
@@ -112,6 +139,37 @@ const struct nrf_cloud_pgps_header *npgps_get_saved_header(void)
 	return &saved_header;
 }
 
+int npgps_save_index(struct npgps_index *idx)
+{
+	int ret;
+
+	idx->crc = crc32_ieee((uint8_t *)idx, offsetof(struct npgps_index, crc));
+
+	LOG_DBG("Saving index");
+	ret = settings_save_one(SETTINGS_FULL_INDEX, idx, sizeof(*idx));
+	if (!ret) {
+		memcpy(&saved_index, idx, sizeof(saved_index));
+		saved_index_valid = true;
+	}
+	return ret;
+}
+
+int npgps_clear_index(void)
+{
+	if (!saved_index_valid) {
+		return 0;
+	}
+
+	LOG_DBG("Clearing index");
+	saved_index_valid = false;
+	return settings_delete(SETTINGS_FULL_INDEX);
+}
+
+const struct npgps_index *npgps_get_saved_index(void)
+{
+	return saved_index_valid ? &saved_index : NULL;
+}
+
 /* @TODO: consider rate-limiting these updates to reduce Flash wear */
 static int save_location(void)
 {
@@ -429,21 +487,18 @@ void *npgps_block_to_pointer(int block)
 	return ret;
 }
 
-int npgps_download_init(npgps_buffer_handler_t handler)
+int npgps_download_init(npgps_buffer_handler_t handler,
+			npgps_error_handler_t err_handler)
 {
 	__ASSERT(handler != NULL, "must specify handler");
 	buffer_handler = handler;
+	error_handler = err_handler;
 
 	return download_client_init(&dlc, download_client_callback);
 }
 
-int npgps_download_start(const char *host, const char *file, int sec_tag,
-			 const char *apn, size_t fragment_size)
+static int download_begin(void)
 {
-	if (host == NULL || file == NULL) {
-		return -EINVAL;
-	}
-
 	int err;
 
 	err = k_sem_take(&pgps_active, K_NO_WAIT);
@@ -455,19 +510,12 @@ int npgps_download_start(const char *host, const char *file, int sec_tag,
 
 	socket_retries_left = CONFIG_FOTA_SOCKET_RETRIES;
 
-	struct download_client_cfg config = {
-		.sec_tag = sec_tag,
-		.apn = apn,
-		.frag_size_override = fragment_size,
-		.set_tls_hostname = (sec_tag != -1),
-	};
-
-	err = download_client_connect(&dlc, host, &config);
+	err = download_client_connect(&dlc, dl_host, &dl_config);
 	if (err != 0) {
 		goto cleanup;
 	}
 
-	err = download_client_start(&dlc, file, 0);
+	err = download_client_start(&dlc, dl_file, dl_received);
 	if (err != 0) {
 		download_client_disconnect(&dlc);
 		goto cleanup;
@@ -481,9 +529,77 @@ cleanup:
 	return err;
 }
 
+/* host and file must remain valid until the download is done */
+int npgps_download_start(const char *host, const char *file, int sec_tag,
+			 const char *apn, size_t fragment_size)
+{
+	if (host == NULL || file == NULL) {
+		return -EINVAL;
+	}
+
+	if (k_sem_count_get(&pgps_active) == 0) {
+		LOG_ERR("PGPS download already active.");
+		return -EBUSY;
+	}
+
+	dl_config.sec_tag = sec_tag;
+	dl_config.apn = apn;
+	dl_config.frag_size_override = fragment_size;
+	dl_config.set_tls_hostname = (sec_tag != -1);
+	dl_host = host;
+	dl_file = file;
+	dl_received = 0;
+
+	return download_begin();
+}
+
+int npgps_download_resume(void)
+{
+	if (dl_file == NULL) {
+		return -ENOENT;
+	}
+
+	LOG_INF("Resuming download at offset:%zu", dl_received);
+	return download_begin();
+}
+
+size_t npgps_download_received(void)
+{
+	return dl_received;
+}
+
+static int handle_fragment(const struct download_fragment *fragment)
+{
+	uint8_t *buf = (uint8_t *)fragment->buf;
+	size_t len = fragment->len;
+	size_t skip;
+	int err;
+
+	if (fragment->offset > dl_received) {
+		LOG_ERR("Fragment at offset:%zu, expected:%zu",
+			fragment->offset, dl_received);
+		return -EIO;
+	}
+
+	/* after a resume, data already handled may be received again */
+	skip = dl_received - fragment->offset;
+	if (skip >= len) {
+		return 0;
+	}
+	buf += skip;
+	len -= skip;
+
+	err = buffer_handler(buf, len);
+	if (!err) {
+		dl_received += len;
+	}
+	return err;
+}
+
 static int download_client_callback(const struct download_client_evt *event)
 {
 	int err = 0;
+	int ret;
 
 	if (event == NULL) {
 		return -EINVAL;
@@ -491,8 +607,7 @@ static int download_client_callback(const struct download_client_evt *event)
 
 	switch (event->id) {
 	case DOWNLOAD_CLIENT_EVT_FRAGMENT:
-		err = buffer_handler((uint8_t *)event->fragment.buf,
-				     event->fragment.len);
+		err = handle_fragment(&event->fragment);
 		if (!err) {
 			return err;
 		}
@@ -511,6 +626,8 @@ static int download_client_callback(const struct download_client_evt *event)
 			socket_retries_left--;
 			return 0;
 		}
+		LOG_ERR("Download stopped at offset:%zu, error:%d", dl_received,
+			event->error);
 		err = -EIO;
 		break;
 	}
@@ -518,12 +635,16 @@ static int download_client_callback(const struct download_client_evt *event)
 		return 0;
 	}
 
-	err = download_client_disconnect(&dlc);
-	if (err) {
+	ret = download_client_disconnect(&dlc);
+	if (ret) {
 		LOG_ERR("Error disconnecting from "
-			"download client:%d", err);
+			"download client:%d", ret);
 	}
 	k_sem_give(&pgps_active);
 	LOG_DBG("pgps_active UNLOCKED");
-	return err;
+
+	if ((event->id == DOWNLOAD_CLIENT_EVT_ERROR) && error_handler) {
+		error_handler(event->error);
+	}
+	return err ? err : ret;
 }
@@ -38,6 +38,24 @@ int nrf_rpc_os_init(nrf_rpc_os_work_t callback);
 
 void nrf_rpc_os_thread_pool_send(const uint8_t *data, size_t len);
 
+/** @brief Statistics of the thread pool queue. */
+struct nrf_rpc_os_pool_stats {
+	/** Number of packets passed to the thread pool. */
+	uint32_t sent;
+	/** Number of times the sender was blocked by a full queue. */
+	uint32_t blocked;
+	/** Maximum number of packets waiting in the queue. */
+	uint32_t max_used;
+};
+
+/** @brief Get the statistics of the thread pool queue.
+ *
+ * Only available with CONFIG_NRF_RPC_THREAD_POOL_STATS.
+ *
+ * @param[out] stats Statistics.
+ */
+void nrf_rpc_os_thread_pool_stats_get(struct nrf_rpc_os_pool_stats *stats);
+
 static inline int nrf_rpc_os_event_init(struct nrf_rpc_os_event *event)
 {
 	return k_sem_init(&event->sem, 0, 1);
@@ -29,6 +29,12 @@ static nrf_rpc_os_work_t thread_pool_callback;
 static struct pool_start_msg pool_start_msg_buf[2];
 static struct k_msgq pool_start_msg;
 
+#if defined(CONFIG_NRF_RPC_THREAD_POOL_STATS)
+static atomic_t pool_stats_sent;
+static atomic_t pool_stats_blocked;
+static atomic_t pool_stats_max_used;
+#endif
+
 static struct k_sem context_reserved;
 static atomic_t context_mask;
 
@@ -103,8 +109,41 @@ void nrf_rpc_os_thread_pool_send(const uint8_t *data, size_t len)
 
 	msg.data = data;
 	msg.len = len;
+
+#if defined(CONFIG_NRF_RPC_THREAD_POOL_STATS)
+	atomic_val_t max_used;
+	uint32_t used;
+
+	if (k_msgq_put(&pool_start_msg, &msg, K_NO_WAIT) != 0) {
+		/* The queue is full, wait until a pool thread takes a packet.
+		 * Count the wait once, however long it takes.
+		 */
+		atomic_inc(&pool_stats_blocked);
+		k_msgq_put(&pool_start_msg, &msg, K_FOREVER);
+	}
+
+	used = k_msgq_num_used_get(&pool_start_msg);
+	atomic_inc(&pool_stats_sent);
+
+	do {
+		max_used = atomic_get(&pool_stats_max_used);
+	} while ((used > (uint32_t)max_used) &&
+		 !atomic_cas(&pool_stats_max_used, max_used, used));
+#else
 	k_msgq_put(&pool_start_msg, &msg, K_FOREVER);
+#endif
+}
+
+#if defined(CONFIG_NRF_RPC_THREAD_POOL_STATS)
+void nrf_rpc_os_thread_pool_stats_get(struct nrf_rpc_os_pool_stats *stats)
+{
+	__ASSERT_NO_MSG(stats != NULL);
+
+	stats->sent = atomic_get(&pool_stats_sent);
+	stats->blocked = atomic_get(&pool_stats_blocked);
+	stats->max_used = atomic_get(&pool_stats_max_used);
 }
+#endif
 
 void nrf_rpc_os_msg_set(struct nrf_rpc_os_msg *msg, const uint8_t *data,
 			size_t len)
@@ -0,0 +1,469 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <zephyr.h>
+#include <kernel_structs.h>
+#include <sys/atomic.h>
+#include <sys/byteorder.h>
+#include <profiler.h>
+
+#include "profiler_stream_sink.h"
+
+/* Stream profiler.
+ *
+ * Events are encoded as binary records and stored in lock-free ring buffers
+ * (one per CPU). Space in a ring buffer is reserved with compare-and-swap,
+ * so events can be logged from any context without locking interrupts.
+ * Every record in the ring buffer is preceded by a commit flag that is set
+ * after the record is written. The profiler thread moves committed records
+ * from the ring buffers to the sink.
+ *
+ * Format of records in the stream (multibyte fields are little-endian):
+ * | sync (1 byte) | type (1 byte) | payload length (1 byte) | payload |
+ *
+ * The sync byte is added when a record is moved to the sink, so records in
+ * the ring buffers start with the type. The sync byte and the payload length
+ * allow the host to find the beginning of the next record if a part of the
+ * stream is lost. The stream header and the event descriptions are resent
+ * periodically, so that the host can start decoding at any point.
+ */
+
+#define RECORD_TYPE_HEADER	0x01
+#define RECORD_TYPE_EVENT_DESCR	0x02
+#define RECORD_TYPE_EVENT	0x03
+#define RECORD_TYPE_DROPPED	0x04
+
+#define RECORD_SYNC		0x5A
+
+#define RECORD_HDR_SIZE		2
+#define RECORD_PAYLOAD_MAX	UINT8_MAX
+
+/* Event payload: ID (2 bytes) and timestamp (8 bytes) followed by data. */
+#define EVENT_HDR_SIZE		(RECORD_HDR_SIZE + sizeof(uint16_t) + \
+				 sizeof(uint64_t))
+
+#define STREAM_MAGIC		"NPRF"
+#define STREAM_VERSION		2
+
+#define RECORD_COMMITTED	0xA5
+
+#define RING_SIZE		CONFIG_PROFILER_STREAM_RING_BUFFER_SIZE
+#define RING_MASK		(RING_SIZE - 1)
+
+BUILD_ASSERT((RING_SIZE & RING_MASK) == 0,
+	     "Ring buffer size must be a power of two");
+BUILD_ASSERT(EVENT_HDR_SIZE <= CONFIG_PROFILER_CUSTOM_EVENT_BUF_LEN,
+	     "Custom event buffer too small");
+BUILD_ASSERT(CONFIG_PROFILER_CUSTOM_EVENT_BUF_LEN <=
+	     RECORD_HDR_SIZE + RECORD_PAYLOAD_MAX,
+	     "Custom event buffer too big");
+BUILD_ASSERT(CONFIG_PROFILER_STREAM_TX_BUFFER_SIZE >=
+	     1 + RECORD_HDR_SIZE + RECORD_PAYLOAD_MAX,
+	     "TX buffer too small");
+BUILD_ASSERT(CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS + sizeof(uint16_t) <=
+	     RECORD_PAYLOAD_MAX,
+	     "Event description too long");
+
+
+/* By default, when there is no shell, all events are profiled. */
+#ifndef CONFIG_SHELL
+uint32_t profiler_enabled_events = 0xffffffff;
+#endif
+
+struct stream_ring {
+	/* Indexes are free running, only the lowest bits are used to
+	 * access the buffer.
+	 */
+	atomic_t wr_idx;
+	atomic_t rd_idx;
+	atomic_t dropped_cnt;
+	uint8_t buf[RING_SIZE];
+};
+
+static char descr[CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS]
+		 [CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS];
+static const char * const arg_types_encodings[] = {
+					"u8",  /* uint8_t */
+					"s8",  /* int8_t */
+					"u16", /* uint16_t */
+					"s16", /* int16_t */
+					"u32", /* uint32_t */
+					"s32", /* int32_t */
+					"s",   /* string */
+					"t"    /* time */
+				     };
+
+uint8_t profiler_num_events;
+
+static struct stream_ring rings[CONFIG_MP_NUM_CPUS];
+static atomic_t descr_lost;
+static bool protocol_running;
+static uint8_t tx_buf[CONFIG_PROFILER_STREAM_TX_BUFFER_SIZE];
+static size_t tx_len;
+
+static K_SEM_DEFINE(profiler_sem, 0, 1);
+static K_THREAD_STACK_DEFINE(profiler_stream_stack,
+			     CONFIG_PROFILER_STREAM_STACK_SIZE);
+static struct k_thread profiler_stream_thread;
+static k_tid_t profiler_thread_id;
+
+
+static void ring_write(struct stream_ring *ring, uint32_t idx,
+		       const uint8_t *data, size_t len)
+{
+	size_t off = idx & RING_MASK;
+	size_t chunk = MIN(len, RING_SIZE - off);
+
+	memcpy(&ring->buf[off], data, chunk);
+	memcpy(&ring->buf[0], data + chunk, len - chunk);
+}
+
+static void ring_read(const struct stream_ring *ring, uint32_t idx,
+		      uint8_t *data, size_t len)
+{
+	size_t off = idx & RING_MASK;
+	size_t chunk = MIN(len, RING_SIZE - off);
+
+	memcpy(data, &ring->buf[off], chunk);
+	memcpy(data + chunk, &ring->buf[0], len - chunk);
+}
+
+static void ring_clear(struct stream_ring *ring, uint32_t idx, size_t len)
+{
+	size_t off = idx & RING_MASK;
+	size_t chunk = MIN(len, RING_SIZE - off);
+
+	memset(&ring->buf[off], 0, chunk);
+	memset(&ring->buf[0], 0, len - chunk);
+}
+
+static struct stream_ring *current_ring(void)
+{
+#if CONFIG_MP_NUM_CPUS > 1
+	return &rings[arch_curr_cpu()->id];
+#else
+	return &rings[0];
+#endif
+}
+
+static bool ring_put(const uint8_t *record, size_t len)
+{
+	struct stream_ring *ring = current_ring();
+	size_t rec_len = len + 1;
+	uint32_t wr;
+
+	/* Reserve space for the commit flag and the record. */
+	do {
+		wr = atomic_get(&ring->wr_idx);
+		uint32_t rd = atomic_get(&ring->rd_idx);
+
+		if ((wr - rd) + rec_len > RING_SIZE) {
+			atomic_inc(&ring->dropped_cnt);
+			return false;
+		}
+	} while (!atomic_cas(&ring->wr_idx, wr, wr + rec_len));
+
+	ring_write(ring, wr + 1, record, len);
+
+	/* Record must be visible before it is marked as committed. */
+	__sync_synchronize();
+	ring->buf[wr & RING_MASK] = RECORD_COMMITTED;
+
+	return true;
+}
+
+static void tx_flush(void)
+{
+	if (tx_len > 0) {
+		int err = profiler_stream_sink_write(tx_buf, tx_len);
+
+		__ASSERT_NO_MSG(!err);
+		ARG_UNUSED(err);
+		tx_len = 0;
+	}
+}
+
+static void tx_record(uint8_t type, const uint8_t *payload, size_t len)
+{
+	__ASSERT_NO_MSG(len <= RECORD_PAYLOAD_MAX);
+
+	if (tx_len + 1 + RECORD_HDR_SIZE + len > sizeof(tx_buf)) {
+		tx_flush();
+	}
+
+	tx_buf[tx_len++] = RECORD_SYNC;
+	tx_buf[tx_len++] = type;
+	tx_buf[tx_len++] = len;
+	memcpy(&tx_buf[tx_len], payload, len);
+	tx_len += len;
+}
+
+static void send_stream_header(void)
+{
+	uint8_t payload[sizeof(STREAM_MAGIC) - 1 + sizeof(uint8_t) +
+			sizeof(uint32_t)];
+
+	memcpy(payload, STREAM_MAGIC, sizeof(STREAM_MAGIC) - 1);
+	payload[sizeof(STREAM_MAGIC) - 1] = STREAM_VERSION;
+	sys_put_le32(CONFIG_SYS_CLOCK_TICKS_PER_SEC,
+		     &payload[sizeof(STREAM_MAGIC)]);
+
+	tx_record(RECORD_TYPE_HEADER, payload, sizeof(payload));
+}
+
+static size_t event_descr_encode(uint16_t id, uint8_t *record)
+{
+	size_t len = strlen(descr[id]);
+
+	record[0] = RECORD_TYPE_EVENT_DESCR;
+	record[1] = sizeof(id) + len;
+	sys_put_le16(id, &record[RECORD_HDR_SIZE]);
+	memcpy(&record[RECORD_HDR_SIZE + sizeof(id)], descr[id], len);
+
+	return RECORD_HDR_SIZE + sizeof(id) + len;
+}
+
+static void send_all_event_descr(void)
+{
+	uint8_t ne = profiler_num_events;
+
+	/* Memory barrier to make sure that data is visible
+	 * before being accessed
+	 */
+	__sync_synchronize();
+
+	for (uint16_t id = 0; id < ne; id++) {
+		uint8_t record[RECORD_HDR_SIZE + RECORD_PAYLOAD_MAX];
+		size_t len = event_descr_encode(id, record);
+
+		tx_record(record[0], &record[RECORD_HDR_SIZE],
+			  len - RECORD_HDR_SIZE);
+	}
+}
+
+static bool ring_drain(struct stream_ring *ring)
+{
+	uint32_t rd = atomic_get(&ring->rd_idx);
+	bool drained = false;
+
+	while (ring->buf[rd & RING_MASK] == RECORD_COMMITTED) {
+		/* Make sure the record is read after the commit flag. */
+		__sync_synchronize();
+
+		uint8_t hdr[RECORD_HDR_SIZE];
+
+		ring_read(ring, rd + 1, hdr, sizeof(hdr));
+
+		size_t rec_len = 1 + RECORD_HDR_SIZE + hdr[1];
+
+		__ASSERT_NO_MSG(rec_len <=
+				(uint32_t)atomic_get(&ring->wr_idx) - rd);
+
+		if (tx_len + rec_len > sizeof(tx_buf)) {
+			tx_flush();
+		}
+
+		/* Sync byte replaces the commit flag in the stream. */
+		tx_buf[tx_len++] = RECORD_SYNC;
+		ring_read(ring, rd + 1, &tx_buf[tx_len], rec_len - 1);
+		tx_len += rec_len - 1;
+
+		/* Stale data must not be taken as a commit flag later. */
+		ring_clear(ring, rd, rec_len);
+		rd += rec_len;
+		atomic_set(&ring->rd_idx, rd);
+		drained = true;
+	}
+
+	atomic_val_t dropped = atomic_set(&ring->dropped_cnt, 0);
+
+	if (dropped > 0) {
+		uint8_t payload[sizeof(uint32_t)];
+
+		sys_put_le32(dropped, payload);
+		tx_record(RECORD_TYPE_DROPPED, payload, sizeof(payload));
+	}
+
+	return drained;
+}
+
+static bool descr_resend_due(int64_t *last_sent)
+{
+	if (CONFIG_PROFILER_STREAM_DESCR_RESEND_PERIOD_MS == 0) {
+		return false;
+	}
+
+	int64_t now = k_uptime_get();
+
+	if (now - *last_sent < CONFIG_PROFILER_STREAM_DESCR_RESEND_PERIOD_MS) {
+		return false;
+	}
+
+	*last_sent = now;
+
+	return true;
+}
+
+static void profiler_stream_thread_fn(void)
+{
+	int64_t descr_sent = k_uptime_get();
+
+	send_stream_header();
+
+	while (protocol_running) {
+		bool drained = false;
+
+		if (descr_resend_due(&descr_sent)) {
+			/* Let a host that missed the beginning of the stream
+			 * or lost a part of it decode the following events.
+			 */
+			atomic_set(&descr_lost, false);
+			send_stream_header();
+			send_all_event_descr();
+		} else if (atomic_set(&descr_lost, false)) {
+			send_all_event_descr();
+		}
+
+		for (size_t i = 0; i < ARRAY_SIZE(rings); i++) {
+			drained |= ring_drain(&rings[i]);
+		}
+
+		tx_flush();
+
+		if (!drained) {
+			k_sleep(K_MSEC(CONFIG_PROFILER_STREAM_FLUSH_PERIOD_MS));
+		}
+	}
+
+	k_sem_give(&profiler_sem);
+}
+
+int profiler_init(void)
+{
+	int err = profiler_stream_sink_init();
+
+	if (err) {
+		return err;
+	}
+
+	protocol_running = true;
+	profiler_thread_id = k_thread_create(&profiler_stream_thread,
+			profiler_stream_stack,
+			K_THREAD_STACK_SIZEOF(profiler_stream_stack),
+			(k_thread_entry_t)profiler_stream_thread_fn,
+			NULL, NULL, NULL,
+			CONFIG_PROFILER_STREAM_THREAD_PRIORITY, 0, K_NO_WAIT);
+
+	return 0;
+}
+
+void profiler_term(void)
+{
+	protocol_running = false;
+	k_wakeup(profiler_thread_id);
+	k_sem_take(&profiler_sem, K_FOREVER);
+}
+
+const char *profiler_get_event_descr(size_t profiler_event_id)
+{
+	return descr[profiler_event_id];
+}
+
+uint16_t profiler_register_event_type(const char *name, const char **args,
+				   const enum profiler_arg *arg_types,
+				   uint8_t arg_cnt)
+{
+	/* Lock to make sure that this function can be called
+	 * from multiple threads
+	 */
+	k_sched_lock();
+	uint8_t ne = profiler_num_events;
+
+	__ASSERT_NO_MSG(ne < CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS);
+
+	size_t temp = snprintf(descr[ne],
+			CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS,
+			"%s,%d", name, ne);
+	size_t pos = temp;
+
+	__ASSERT_NO_MSG((pos < CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS)
+			 && (temp > 0));
+
+	for (size_t t = 0; t < arg_cnt; t++) {
+		temp = snprintf(descr[ne] + pos,
+			 CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS - pos,
+			 ",%s", arg_types_encodings[arg_types[t]]);
+		pos += temp;
+		__ASSERT_NO_MSG(
+		  (pos < CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS)
+		   && (temp > 0));
+	}
+
+	for (size_t t = 0; t < arg_cnt; t++) {
+		temp = snprintf(descr[ne] + pos,
+			CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS - pos,
+			",%s", args[t]);
+		pos += temp;
+		__ASSERT_NO_MSG(
+		  (pos < CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS)
+		   && (temp > 0));
+	}
+
+	/* Description is sent in the stream, before any occurrence of the
+	 * event. If there is no space in the ring buffer, all of the
+	 * descriptions are resent by the profiler thread.
+	 */
+	uint8_t record[RECORD_HDR_SIZE + RECORD_PAYLOAD_MAX];
+	size_t len = event_descr_encode(ne, record);
+
+	if (!ring_put(record, len)) {
+		atomic_set(&descr_lost, true);
+	}
+
+	/* Memory barrier to make sure that data is visible
+	 * before being accessed
+	 */
+	__sync_synchronize();
+	profiler_num_events++;
+	k_sched_unlock();
+
+	return ne;
+}
+
+void profiler_log_start(struct log_event_buf *buf)
+{
+	/* Make space for record header and event type ID. */
+	buf->payload = buf->payload_start + RECORD_HDR_SIZE + sizeof(uint16_t);
+	sys_put_le64(k_uptime_ticks(), buf->payload);
+	buf->payload += sizeof(uint64_t);
+}
+
+void profiler_log_encode_u32(struct log_event_buf *buf, uint32_t data)
+{
+	__ASSERT_NO_MSG(buf->payload - buf->payload_start + sizeof(data)
+			 <= CONFIG_PROFILER_CUSTOM_EVENT_BUF_LEN);
+	sys_put_le32(data, buf->payload);
+	buf->payload += sizeof(data);
+}
+
+void profiler_log_add_mem_address(struct log_event_buf *buf,
+				  const void *mem_address)
+{
+	profiler_log_encode_u32(buf, (uint32_t)(uintptr_t)mem_address);
+}
+
+void profiler_log_send(struct log_event_buf *buf, uint16_t event_type_id)
+{
+	size_t len = buf->payload - buf->payload_start;
+
+	buf->payload_start[0] = RECORD_TYPE_EVENT;
+	buf->payload_start[1] = len - RECORD_HDR_SIZE;
+	sys_put_le16(event_type_id, &buf->payload_start[RECORD_HDR_SIZE]);
+
+	(void)ring_put(buf->payload_start, len);
+}
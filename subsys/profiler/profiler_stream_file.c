@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* File sink is built for native_posix only. It uses host file API. */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "profiler_stream_sink.h"
+
+static int fd = -1;
+
+int profiler_stream_sink_init(void)
+{
+	fd = open(CONFIG_PROFILER_STREAM_SINK_FILE_PATH,
+		  O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+	return (fd < 0) ? -EIO : 0;
+}
+
+int profiler_stream_sink_write(const uint8_t *data, size_t len)
+{
+	while (len > 0) {
+		ssize_t written = write(fd, data, len);
+
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			return -EIO;
+		}
+
+		data += written;
+		len -= written;
+	}
+
+	return 0;
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <SEGGER_RTT.h>
+
+#include "profiler_stream_sink.h"
+
+static uint8_t buffer_data[CONFIG_PROFILER_STREAM_SINK_RTT_BUFFER_SIZE];
+
+int profiler_stream_sink_init(void)
+{
+	int ret = SEGGER_RTT_ConfigUpBuffer(
+		CONFIG_PROFILER_STREAM_SINK_RTT_CHANNEL,
+		"Nordic profiler stream",
+		buffer_data,
+		sizeof(buffer_data),
+		SEGGER_RTT_MODE_NO_BLOCK_TRIM);
+
+	return (ret < 0) ? -EIO : 0;
+}
+
+int profiler_stream_sink_write(const uint8_t *data, size_t len)
+{
+	/* Only the profiler thread writes to the channel. */
+	while (len > 0) {
+		unsigned int written = SEGGER_RTT_WriteNoLock(
+			CONFIG_PROFILER_STREAM_SINK_RTT_CHANNEL, data, len);
+
+		if (written == 0) {
+			/* Give host time to read the data. */
+			k_sleep(K_MSEC(1));
+			continue;
+		}
+
+		data += written;
+		len -= written;
+	}
+
+	return 0;
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Stream profiler sink.
+ *
+ * Sink is used by the stream profiler to pass the encoded stream to the host.
+ * Exactly one sink implementation is selected by Kconfig. The sink functions
+ * are called only from the stream profiler thread.
+ */
+
+#ifndef _PROFILER_STREAM_SINK_H_
+#define _PROFILER_STREAM_SINK_H_
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Initialize the sink.
+ *
+ * Returns 0 if the operation was successful, negative error code otherwise.
+ */
+int profiler_stream_sink_init(void);
+
+/* Write data to the sink.
+ *
+ * The function returns after all of the data has been written or queued for
+ * transmission. It blocks while the sink cannot accept more data.
+ *
+ * Returns 0 if the operation was successful, negative error code otherwise.
+ */
+int profiler_stream_sink_write(const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PROFILER_STREAM_SINK_H_ */
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <device.h>
+#include <spinlock.h>
+#include <drivers/uart.h>
+#include <sys/ring_buffer.h>
+
+#include "profiler_stream_sink.h"
+
+static const struct device *uart_dev;
+
+/* Ring buffer is filled by the profiler thread and drained by the UART
+ * interrupt. The lock protects the ring buffer indexes.
+ */
+RING_BUF_DECLARE(tx_buf, CONFIG_PROFILER_STREAM_SINK_UART_BUFFER_SIZE);
+static struct k_spinlock lock;
+static K_SEM_DEFINE(tx_space_sem, 0, 1);
+
+static void uart_isr(const struct device *dev, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	if (!uart_irq_update(dev) || !uart_irq_tx_ready(dev)) {
+		return;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	uint8_t *data;
+	uint32_t len = ring_buf_get_claim(&tx_buf, &data,
+					  CONFIG_PROFILER_STREAM_SINK_UART_BUFFER_SIZE);
+
+	if (len == 0) {
+		uart_irq_tx_disable(dev);
+		k_spin_unlock(&lock, key);
+		return;
+	}
+
+	int sent = uart_fifo_fill(dev, data, len);
+
+	ring_buf_get_finish(&tx_buf, (sent > 0) ? sent : 0);
+	k_spin_unlock(&lock, key);
+
+	if (sent > 0) {
+		k_sem_give(&tx_space_sem);
+	}
+}
+
+int profiler_stream_sink_init(void)
+{
+	uart_dev = device_get_binding(CONFIG_PROFILER_STREAM_SINK_UART_DEV_NAME);
+	if (!uart_dev) {
+		return -ENODEV;
+	}
+
+	uart_irq_tx_disable(uart_dev);
+	uart_irq_callback_user_data_set(uart_dev, uart_isr, NULL);
+
+	return 0;
+}
+
+int profiler_stream_sink_write(const uint8_t *data, size_t len)
+{
+	while (len > 0) {
+		k_spinlock_key_t key = k_spin_lock(&lock);
+		uint32_t written = ring_buf_put(&tx_buf, data, len);
+
+		k_spin_unlock(&lock, key);
+
+		if (written == 0) {
+			/* Wait until the interrupt frees space in the buffer.
+			 * Events are buffered in the profiler ring buffers in
+			 * the meantime.
+			 */
+			k_sem_take(&tx_space_sem, K_FOREVER);
+			continue;
+		}
+
+		uart_irq_tx_enable(uart_dev);
+
+		data += written;
+		len -= written;
+	}
+
+	return 0;
+}
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <string.h>
 #include <shell/shell.h>
 
 #include <zboss_api.h>
@@ -47,12 +48,87 @@ static int cmd_zb_resume(const struct shell *shell, size_t argc, char **argv)
 
 	return 0;
 }
+#endif /* CONFIG_ZIGBEE_SHELL_DEBUG_CMD */
 
+#ifdef CONFIG_ZIGBEE_APP_CB_QUEUE_STATS
+/**@brief Print statistics of the application callback and alarm queue
+ *
+ * @code
+ * zscheduler stats [reset]
+ * @endcode
+ *
+ * Print the number of requests passed to the Zigbee scheduler, the number
+ * of requests rejected because a queue was full and the histogram of the time
+ * the requests waited in the queue. Only non-empty histogram buckets are
+ * printed. If `reset` is given, the statistics are cleared afterwards.
+ *
+ * @code
+ * > zscheduler stats
+ * Processed: 1523, queue full: 0, scheduler full: 2, max depth: 9
+ * Latency max: 1843 us
+ *     0 - 1 us: 12
+ *     2 - 3 us: 310
+ *     4 - 7 us: 1101
+ *  1024 - 2047 us: 100
+ * Done
+ * @endcode
+ */
+static int cmd_zb_stats(const struct shell *shell, size_t argc, char **argv)
+{
+	struct zigbee_app_cb_queue_stats stats;
+	bool reset = false;
+
+	if (argc == 2) {
+		if (strcmp(argv[1], "reset")) {
+			zb_cli_print_error(shell, "Invalid argument", ZB_FALSE);
+			return -EINVAL;
+		}
+		reset = true;
+	}
+
+	zigbee_app_cb_queue_stats_get(&stats);
+	if (reset) {
+		zigbee_app_cb_queue_stats_reset();
+	}
+
+	shell_print(shell, "Processed: %u, queue full: %u, scheduler full: %u, max depth: %u",
+		    stats.processed, stats.queue_full, stats.scheduler_full,
+		    stats.depth_max);
+	shell_print(shell, "Latency max: %u us", stats.latency_max_us);
+
+	for (int i = 0; i < ARRAY_SIZE(stats.latency_hist); i++) {
+		uint32_t low = (i == 0) ? 0 : (uint32_t)BIT(i);
+
+		if (stats.latency_hist[i] == 0) {
+			continue;
+		}
+		if (i == ARRAY_SIZE(stats.latency_hist) - 1) {
+			shell_print(shell, "%6u+ us: %u", low,
+				    stats.latency_hist[i]);
+		} else {
+			shell_print(shell, "%6u - %u us: %u", low,
+				    (uint32_t)BIT(i + 1) - 1, stats.latency_hist[i]);
+		}
+	}
+
+	zb_cli_print_done(shell, ZB_FALSE);
+
+	return 0;
+}
+#endif /* CONFIG_ZIGBEE_APP_CB_QUEUE_STATS */
+
+#if defined(CONFIG_ZIGBEE_SHELL_DEBUG_CMD) || \
+	defined(CONFIG_ZIGBEE_APP_CB_QUEUE_STATS)
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_zigbee,
-	SHELL_CMD_ARG(resume, NULL, "Suspend Zigbee scheduler processing",
-		      cmd_zb_resume, 1, 0),
-	SHELL_CMD_ARG(suspend, NULL, "Suspend Zigbee scheduler processing",
-		      cmd_zb_suspend, 1, 0),
+	SHELL_COND_CMD_ARG(CONFIG_ZIGBEE_SHELL_DEBUG_CMD, resume, NULL,
+			   "Suspend Zigbee scheduler processing",
+			   cmd_zb_resume, 1, 0),
+	SHELL_COND_CMD_ARG(CONFIG_ZIGBEE_APP_CB_QUEUE_STATS, stats, NULL,
+			   "Print application callback queue statistics",
+			   cmd_zb_stats, 1, 1),
+	SHELL_COND_CMD_ARG(CONFIG_ZIGBEE_SHELL_DEBUG_CMD, suspend, NULL,
+			   "Suspend Zigbee scheduler processing",
+			   cmd_zb_suspend, 1, 0),
 	SHELL_SUBCMD_SET_END);
 
 SHELL_CMD_REGISTER(zscheduler, &sub_zigbee, "Zigbee scheduler manipulation",
@@ -5,10 +5,12 @@
  */
 
 #include <pm_config.h>
+#include <string.h>
 #include <storage/flash_map.h>
 #include <logging/log.h>
 
 #include <zboss_api.h>
+#include "zb_nrf_platform.h"
 
 #ifdef ZB_USE_NVRAM
 
@@ -33,6 +35,52 @@ static const struct flash_area *fa; /* ZBOSS nvram */
 static const struct flash_area *fa_pc; /* production config */
 #endif
 
+#ifdef CONFIG_ZIGBEE_NVRAM_STATS
+static struct zigbee_nvram_stats nvram_stats;
+#define NVRAM_STATS_INC(field, val) (nvram_stats.field += (val))
+#else
+#define NVRAM_STATS_INC(field, val)
+#endif
+
+#ifdef CONFIG_ZIGBEE_NVRAM_WRITE_CACHE
+/* Range of the NVRAM area with data waiting in the write cache. The range
+ * is aligned to the flash write block size, the padding bytes are 0xFF.
+ */
+struct nvram_cache_extent {
+	uint32_t addr;
+	uint16_t len;
+	uint16_t buf_offset;
+};
+
+/* Write cache. Extents are stored in the order they were first written to,
+ * and their data is stored back to back in the buffer, so that only the
+ * last extent can grow.
+ */
+static struct {
+	struct nvram_cache_extent extents[CONFIG_ZIGBEE_NVRAM_WRITE_CACHE_EXTENTS];
+	uint8_t buf[CONFIG_ZIGBEE_NVRAM_WRITE_CACHE_SIZE];
+	size_t extent_cnt;
+	size_t used;
+} cache;
+
+static size_t write_align = sizeof(uint32_t);
+static uint8_t erase_page;
+/* Bitmask of erased pages that ZBOSS was not notified about yet. */
+static atomic_t erase_finished_pages;
+
+static void cache_commit_work_handler(struct k_work *work);
+static void erase_work_handler(struct k_work *work);
+static void erase_notify_work_handler(struct k_work *work);
+
+/* Protects the write cache. */
+static K_MUTEX_DEFINE(cache_lock);
+static K_WORK_DELAYABLE_DEFINE(cache_commit_work, cache_commit_work_handler);
+static K_WORK_DEFINE(erase_work, erase_work_handler);
+static K_WORK_DELAYABLE_DEFINE(erase_notify_work, erase_notify_work_handler);
+/* Available when no erase operation is in progress. */
+static K_SEM_DEFINE(erase_sem, 1, 1);
+#endif /* CONFIG_ZIGBEE_NVRAM_WRITE_CACHE */
+
 void zb_osif_nvram_init(const zb_char_t *name)
 {
 	ARG_UNUSED(name);
@@ -43,6 +91,14 @@ void zb_osif_nvram_init(const zb_char_t *name)
 		LOG_ERR("Can't open ZBOSS NVRAM flash area");
 	}
 
+#ifdef CONFIG_ZIGBEE_NVRAM_WRITE_CACHE
+	if (!ret) {
+		write_align = flash_area_align(fa);
+		__ASSERT((sizeof(cache.buf) % write_align) == 0,
+			 "Cache size must be a multiple of the write block size");
+	}
+#endif
+
 #ifdef ZB_PRODUCTION_CONFIG
 	ret = flash_area_open(PM_ZBOSS_PRODUCT_CONFIG_ID, &fa_pc);
 	if (ret) {
@@ -66,6 +122,213 @@ static zb_uint32_t get_page_base_offset(int page_num)
 	return (page_num * zb_get_nvram_page_length());
 }
 
+static int nvram_flash_write(uint32_t flash_addr, const void *buf, size_t len)
+{
+	int err = flash_area_write(fa, flash_addr, buf, len);
+
+	if (err) {
+		LOG_ERR("Write error: %d", err);
+		return err;
+	}
+
+	NVRAM_STATS_INC(flash_writes, 1);
+	NVRAM_STATS_INC(flash_write_bytes, len);
+
+	return 0;
+}
+
+#ifdef CONFIG_ZIGBEE_NVRAM_WRITE_CACHE
+/* Write all cached data to flash, in the order it was first written to the
+ * cache. A reset in the middle of the commit leaves the NVRAM in a state it
+ * could have reached without the cache. Must be called with cache_lock held.
+ */
+static int cache_commit(void)
+{
+	int ret = 0;
+
+	for (size_t i = 0; i < cache.extent_cnt; i++) {
+		struct nvram_cache_extent *extent = &cache.extents[i];
+		int err = nvram_flash_write(extent->addr,
+					    &cache.buf[extent->buf_offset],
+					    extent->len);
+
+		if (err) {
+			ret = err;
+		}
+	}
+
+	if (cache.extent_cnt > 0) {
+		LOG_DBG("Committed %d bytes in %d writes", cache.used,
+			cache.extent_cnt);
+		NVRAM_STATS_INC(commits, 1);
+	}
+
+	cache.extent_cnt = 0;
+	cache.used = 0;
+	(void)k_work_cancel_delayable(&cache_commit_work);
+
+	return ret;
+}
+
+static void cache_commit_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	(void)cache_commit();
+	k_mutex_unlock(&cache_lock);
+}
+
+static bool cache_overlaps(uint32_t start, uint32_t end)
+{
+	for (size_t i = 0; i < cache.extent_cnt; i++) {
+		struct nvram_cache_extent *extent = &cache.extents[i];
+
+		if (start < extent->addr + extent->len && extent->addr < end) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Apply written data to the cached data the same way as flash programming
+ * does, that is bits can only be cleared.
+ */
+static void cache_apply(struct nvram_cache_extent *extent, uint32_t flash_addr,
+			const uint8_t *buf, size_t len)
+{
+	uint8_t *dst = &cache.buf[extent->buf_offset + flash_addr - extent->addr];
+
+	for (size_t i = 0; i < len; i++) {
+		dst[i] &= buf[i];
+	}
+}
+
+/* Must be called with cache_lock held. */
+static int cache_write(uint32_t flash_addr, const uint8_t *buf, size_t len)
+{
+	uint32_t start = ROUND_DOWN(flash_addr, write_align);
+	uint32_t end = ROUND_UP(flash_addr + len, write_align);
+	struct nvram_cache_extent *extent = NULL;
+	int err;
+
+	if (cache.extent_cnt > 0) {
+		extent = &cache.extents[cache.extent_cnt - 1];
+	}
+
+	/* Extend the last extent if the data starts within or right after it. */
+	if (extent && start >= extent->addr &&
+	    start <= extent->addr + extent->len) {
+		uint32_t extent_end = extent->addr + extent->len;
+		size_t grow = (end > extent_end) ? (end - extent_end) : 0;
+
+		if (cache.used + grow <= sizeof(cache.buf) &&
+		    (grow == 0 || !cache_overlaps(extent_end, end))) {
+			memset(&cache.buf[cache.used], 0xFF, grow);
+			cache.used += grow;
+			extent->len += grow;
+			cache_apply(extent, flash_addr, buf, len);
+			return 0;
+		}
+	}
+
+	/* Commit the cache if the data does not fit in it, or if it overlaps
+	 * an extent that cannot be extended.
+	 */
+	if (cache.extent_cnt == ARRAY_SIZE(cache.extents) ||
+	    cache.used + (end - start) > sizeof(cache.buf) ||
+	    cache_overlaps(start, end)) {
+		err = cache_commit();
+		if (err) {
+			return err;
+		}
+	}
+
+	if (end - start > sizeof(cache.buf)) {
+		return nvram_flash_write(flash_addr, buf, len);
+	}
+
+	extent = &cache.extents[cache.extent_cnt++];
+	extent->addr = start;
+	extent->len = end - start;
+	extent->buf_offset = cache.used;
+	memset(&cache.buf[cache.used], 0xFF, extent->len);
+	cache.used += extent->len;
+	cache_apply(extent, flash_addr, buf, len);
+
+	/* Bound the time the data stays in RAM only. */
+	(void)k_work_schedule(&cache_commit_work,
+			      K_MSEC(CONFIG_ZIGBEE_NVRAM_WRITE_CACHE_TIMEOUT));
+
+	return 0;
+}
+
+/* Apply the cached data to the data read from flash. */
+static void cache_read(uint32_t flash_addr, uint8_t *buf, size_t len)
+{
+	for (size_t i = 0; i < cache.extent_cnt; i++) {
+		struct nvram_cache_extent *extent = &cache.extents[i];
+		uint32_t start = MAX(flash_addr, extent->addr);
+		uint32_t end = MIN(flash_addr + len, extent->addr + extent->len);
+		const uint8_t *src;
+
+		if (start >= end) {
+			continue;
+		}
+
+		src = &cache.buf[extent->buf_offset + start - extent->addr];
+		for (uint32_t pos = start; pos < end; pos++) {
+			buf[pos - flash_addr] &= *src++;
+		}
+	}
+}
+
+static void erase_work_handler(struct k_work *work)
+{
+	uint8_t page = erase_page;
+	int err;
+
+	ARG_UNUSED(work);
+
+	err = flash_area_erase(fa, get_page_base_offset(page),
+			       zb_get_nvram_page_length());
+	if (err) {
+		LOG_ERR("Erase error: %d", err);
+	} else {
+		NVRAM_STATS_INC(erases, 1);
+	}
+
+	k_sem_give(&erase_sem);
+
+	(void)atomic_set_bit(&erase_finished_pages, page);
+	erase_notify_work_handler(NULL);
+}
+
+static void erase_notify_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	/* Notify ZBOSS from its own context. If the callback queue is full,
+	 * retry later instead of blocking the system workqueue.
+	 */
+	for (uint8_t page = 0; page < ATOMIC_BITS; page++) {
+		if (!atomic_test_bit(&erase_finished_pages, page)) {
+			continue;
+		}
+
+		if (zigbee_schedule_callback(zb_nvram_erase_finished, page) !=
+		    RET_OK) {
+			(void)k_work_schedule(&erase_notify_work,
+					      K_MSEC(1));
+			return;
+		}
+
+		atomic_clear_bit(&erase_finished_pages, page);
+	}
+}
+#endif /* CONFIG_ZIGBEE_NVRAM_WRITE_CACHE */
+
 zb_ret_t zb_osif_nvram_read(zb_uint8_t page, zb_uint32_t pos, zb_uint8_t *buf,
 			    zb_uint16_t len)
 {
@@ -89,8 +352,19 @@ zb_ret_t zb_osif_nvram_read(zb_uint8_t page, zb_uint32_t pos, zb_uint8_t *buf,
 
 	uint32_t flash_addr = get_page_base_offset(page) + pos;
 
+#ifdef CONFIG_ZIGBEE_NVRAM_WRITE_CACHE
+	k_mutex_lock(&cache_lock, K_FOREVER);
+#endif
+
 	int err = flash_area_read(fa, flash_addr, buf, len);
 
+#ifdef CONFIG_ZIGBEE_NVRAM_WRITE_CACHE
+	if (!err) {
+		cache_read(flash_addr, buf, len);
+	}
+	k_mutex_unlock(&cache_lock);
+#endif
+
 	if (err) {
 		LOG_ERR("Read error: %d", err);
 		return RET_ERROR;
@@ -126,16 +400,67 @@ zb_ret_t zb_osif_nvram_write(zb_uint8_t page, zb_uint32_t pos, void *buf,
 	LOG_DBG("Function: %s, page: %d, pos: %d, len: %d",
 		__func__, page, pos, len);
 
-	int err = flash_area_write(fa, flash_addr, buf, len);
+	NVRAM_STATS_INC(writes, 1);
+
+#ifdef CONFIG_ZIGBEE_NVRAM_WRITE_CACHE
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	int err = cache_write(flash_addr, buf, len);
+
+	k_mutex_unlock(&cache_lock);
+#else
+	int err = nvram_flash_write(flash_addr, buf, len);
+#endif
 
 	if (err) {
-		LOG_ERR("Write error: %d", err);
 		return RET_ERROR;
 	}
 
 	return RET_OK;
 }
 
+#ifdef CONFIG_ZIGBEE_NVRAM_WRITE_CACHE
+zb_ret_t zb_osif_nvram_erase_async(zb_uint8_t page)
+{
+	int err;
+
+	if (page >= zb_get_nvram_page_count()) {
+		zb_nvram_erase_finished(page);
+		return RET_OK;
+	}
+
+	/* Keep the order of the operations on flash. */
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	err = cache_commit();
+	k_mutex_unlock(&cache_lock);
+	if (err) {
+		return RET_ERROR;
+	}
+
+	__ASSERT_NO_MSG(page < ATOMIC_BITS);
+
+	/* Wait for the previous erase operation to complete. */
+	k_sem_take(&erase_sem, K_FOREVER);
+	erase_page = page;
+	k_work_submit(&erase_work);
+
+	return RET_OK;
+}
+
+void zb_osif_nvram_wait_for_last_op(void)
+{
+	zb_osif_nvram_flush();
+
+	k_sem_take(&erase_sem, K_FOREVER);
+	k_sem_give(&erase_sem);
+}
+
+void zb_osif_nvram_flush(void)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	(void)cache_commit();
+	k_mutex_unlock(&cache_lock);
+}
+#else
 zb_ret_t zb_osif_nvram_erase_async(zb_uint8_t page)
 {
 	zb_ret_t ret = RET_OK;
@@ -146,6 +471,8 @@ zb_ret_t zb_osif_nvram_erase_async(zb_uint8_t page)
 		if (err) {
 			LOG_ERR("Erase error: %d", err);
 			ret = RET_ERROR;
+		} else {
+			NVRAM_STATS_INC(erases, 1);
 		}
 	}
 	zb_nvram_erase_finished(page);
@@ -161,6 +488,19 @@ void zb_osif_nvram_flush(void)
 {
 	/* empty for synchronous erase and write */
 }
+#endif /* CONFIG_ZIGBEE_NVRAM_WRITE_CACHE */
+
+#ifdef CONFIG_ZIGBEE_NVRAM_STATS
+void zigbee_nvram_stats_get(struct zigbee_nvram_stats *stats)
+{
+	*stats = nvram_stats;
+}
+
+void zigbee_nvram_stats_reset(void)
+{
+	memset(&nvram_stats, 0, sizeof(nvram_stats));
+}
+#endif /* CONFIG_ZIGBEE_NVRAM_STATS */
 
 
 #ifdef ZB_PRODUCTION_CONFIG
@@ -5,6 +5,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <kernel.h>
 #include <sys/reboot.h>
 #include <logging/log.h>
@@ -52,8 +53,28 @@ typedef struct {
 	zb_uint16_t param;
 	zb_uint16_t user_param;
 	int64_t alarm_timestamp;
+#ifdef CONFIG_ZIGBEE_APP_CB_QUEUE_STATS
+	uint32_t enqueue_cycles;
+#endif
 } zb_app_cb_t;
 
+/**
+ * Cell of the application callback and alarm queue.
+ *
+ * The sequence number tells whether the cell is free for the producer at the
+ * given position or holds an element for the consumer, as in the bounded
+ * queue by D. Vyukov. It is stored relative to the cell index, so that a
+ * zero-initialized queue is empty.
+ */
+typedef struct {
+	atomic_t seq;
+	zb_app_cb_t app_cb;
+} zb_app_cb_cell_t;
+
+BUILD_ASSERT((CONFIG_ZIGBEE_APP_CB_QUEUE_LENGTH &
+	      (CONFIG_ZIGBEE_APP_CB_QUEUE_LENGTH - 1)) == 0,
+	     "Length of the application callback queue must be a power of two");
+
 
 LOG_MODULE_REGISTER(zboss_osif, CONFIG_ZBOSS_OSIF_LOG_LEVEL);
 
@@ -68,11 +89,19 @@ static struct k_poll_signal zigbee_sig = K_POLL_SIGNAL_INITIALIZER(zigbee_sig);
 static K_MUTEX_DEFINE(zigbee_mutex);
 
 /**
- * Message queue, that is used to pass ZBOSS callbacks and alarms from
- * ISR and other threads to ZBOSS main loop context.
+ * Lock-free queue, that is used to pass ZBOSS callbacks and alarms from
+ * ISR and other threads to ZBOSS main loop context. Any number of producers
+ * may add elements, only the ZBOSS thread removes them.
  */
-K_MSGQ_DEFINE(zb_app_cb_msgq, sizeof(zb_app_cb_t),
-	      CONFIG_ZIGBEE_APP_CB_QUEUE_LENGTH, 4);
+static zb_app_cb_cell_t zb_app_cb_queue[CONFIG_ZIGBEE_APP_CB_QUEUE_LENGTH];
+static atomic_t zb_app_cb_enqueue_pos = ATOMIC_INIT(0);
+static atomic_t zb_app_cb_dequeue_pos = ATOMIC_INIT(0);
+
+#ifdef CONFIG_ZIGBEE_APP_CB_QUEUE_STATS
+static struct zigbee_app_cb_queue_stats zb_app_cb_stats;
+static atomic_t zb_app_cb_queue_full = ATOMIC_INIT(0);
+static struct k_spinlock zb_app_cb_stats_lock;
+#endif
 
 /**
  * Work queue that will schedule processing of callbacks from the message queue.
@@ -85,6 +114,13 @@ static struct k_work zb_app_cb_work;
  */
 volatile atomic_t zb_app_cb_process_scheduled = ATOMIC_INIT(0);
 
+/**
+ * Atomic flag, indicating that processing of the queue stopped because
+ * the ZBOSS scheduler queue was full. The ZBOSS thread resumes it after
+ * the next main loop iteration, once scheduled callbacks freed the slots.
+ */
+static atomic_t zb_app_cb_process_retry = ATOMIC_INIT(0);
+
 K_THREAD_STACK_DEFINE(zboss_stack_area, CONFIG_ZBOSS_DEFAULT_THREAD_STACK_SIZE);
 static struct k_thread zboss_thread_data;
 static k_tid_t zboss_tid;
@@ -129,31 +165,176 @@ bool zigbee_is_stack_started(void)
 	return stack_is_started;
 }
 
+static uint32_t zb_app_cb_seq_get(uint32_t pos)
+{
+	uint32_t index = pos & (CONFIG_ZIGBEE_APP_CB_QUEUE_LENGTH - 1);
+
+	return (uint32_t)atomic_get(&zb_app_cb_queue[index].seq) + index;
+}
+
+static void zb_app_cb_seq_set(uint32_t pos, uint32_t seq)
+{
+	uint32_t index = pos & (CONFIG_ZIGBEE_APP_CB_QUEUE_LENGTH - 1);
+
+	(void)atomic_set(&zb_app_cb_queue[index].seq, (atomic_val_t)(seq - index));
+}
+
+/**
+ * Add an element to the application callback queue and schedule its
+ * processing, unless the processing callback is already scheduled and will
+ * pick up the element together with the ones added before.
+ */
+static zb_ret_t zb_app_cb_put(zb_app_cb_t *app_cb)
+{
+	uint32_t pos = (uint32_t)atomic_get(&zb_app_cb_enqueue_pos);
+	int32_t diff;
+
+	while (true) {
+		diff = (int32_t)(zb_app_cb_seq_get(pos) - pos);
+		if (diff == 0) {
+			/* The cell is free, try to reserve it. */
+			if (atomic_cas(&zb_app_cb_enqueue_pos, (atomic_val_t)pos,
+				       (atomic_val_t)(pos + 1))) {
+				break;
+			}
+		} else if (diff < 0) {
+			/* The cell is still in use, the queue is full. */
+#ifdef CONFIG_ZIGBEE_APP_CB_QUEUE_STATS
+			(void)atomic_inc(&zb_app_cb_queue_full);
+#endif
+			return RET_OVERFLOW;
+		}
+		pos = (uint32_t)atomic_get(&zb_app_cb_enqueue_pos);
+	}
+
+#ifdef CONFIG_ZIGBEE_APP_CB_QUEUE_STATS
+	app_cb->enqueue_cycles = k_cycle_get_32();
+#endif
+	zb_app_cb_queue[pos & (CONFIG_ZIGBEE_APP_CB_QUEUE_LENGTH - 1)].app_cb =
+		*app_cb;
+	zb_app_cb_seq_set(pos, pos + 1);
+
+	if (!atomic_get((atomic_t *)&zb_app_cb_process_scheduled)) {
+		k_work_submit(&zb_app_cb_work);
+	}
+
+	return RET_OK;
+}
+
+/**
+ * Get the oldest element of the application callback queue without removing
+ * it. Returns NULL if the queue is empty.
+ */
+static zb_app_cb_t *zb_app_cb_peek(void)
+{
+	uint32_t pos = (uint32_t)atomic_get(&zb_app_cb_dequeue_pos);
+
+	if (zb_app_cb_seq_get(pos) != pos + 1) {
+		return NULL;
+	}
+
+	return &zb_app_cb_queue[pos & (CONFIG_ZIGBEE_APP_CB_QUEUE_LENGTH - 1)]
+		.app_cb;
+}
+
+/**
+ * Remove the oldest element from the application callback queue. Only
+ * called from the ZBOSS main loop context.
+ */
+static void zb_app_cb_remove(void)
+{
+	uint32_t pos = (uint32_t)atomic_get(&zb_app_cb_dequeue_pos);
+
+	zb_app_cb_seq_set(pos, pos + CONFIG_ZIGBEE_APP_CB_QUEUE_LENGTH);
+	(void)atomic_set(&zb_app_cb_dequeue_pos, (atomic_val_t)(pos + 1));
+}
+
+#ifdef CONFIG_ZIGBEE_APP_CB_QUEUE_STATS
+static void zb_app_cb_stats_depth_update(void)
+{
+	uint32_t depth = (uint32_t)atomic_get(&zb_app_cb_enqueue_pos) -
+			 (uint32_t)atomic_get(&zb_app_cb_dequeue_pos);
+	k_spinlock_key_t key = k_spin_lock(&zb_app_cb_stats_lock);
+
+	zb_app_cb_stats.depth_max = MAX(zb_app_cb_stats.depth_max, depth);
+	k_spin_unlock(&zb_app_cb_stats_lock, key);
+}
+
+static void zb_app_cb_stats_update(const zb_app_cb_t *app_cb, zb_ret_t ret_code)
+{
+	k_spinlock_key_t key = k_spin_lock(&zb_app_cb_stats_lock);
+	uint32_t latency_us;
+	uint32_t bucket = 0;
+
+	if (ret_code == RET_OVERFLOW) {
+		zb_app_cb_stats.scheduler_full++;
+		k_spin_unlock(&zb_app_cb_stats_lock, key);
+		return;
+	}
+
+	latency_us = k_cyc_to_us_floor32(k_cycle_get_32() -
+					 app_cb->enqueue_cycles);
+	if (latency_us > 1) {
+		bucket = MIN(31 - __builtin_clz(latency_us),
+			     ZIGBEE_APP_CB_QUEUE_LATENCY_BUCKETS - 1);
+	}
+
+	zb_app_cb_stats.processed++;
+	zb_app_cb_stats.latency_hist[bucket]++;
+	zb_app_cb_stats.latency_max_us =
+		MAX(zb_app_cb_stats.latency_max_us, latency_us);
+	k_spin_unlock(&zb_app_cb_stats_lock, key);
+}
+
+void zigbee_app_cb_queue_stats_get(struct zigbee_app_cb_queue_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&zb_app_cb_stats_lock);
+
+	*stats = zb_app_cb_stats;
+	stats->queue_full = (uint32_t)atomic_get(&zb_app_cb_queue_full);
+	k_spin_unlock(&zb_app_cb_stats_lock, key);
+}
+
+void zigbee_app_cb_queue_stats_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&zb_app_cb_stats_lock);
+
+	memset(&zb_app_cb_stats, 0, sizeof(zb_app_cb_stats));
+	(void)atomic_set(&zb_app_cb_queue_full, 0);
+	k_spin_unlock(&zb_app_cb_stats_lock, key);
+}
+#endif /* defined(CONFIG_ZIGBEE_APP_CB_QUEUE_STATS) */
+
 static void zb_app_cb_process(zb_bufid_t bufid)
 {
 	zb_ret_t ret_code = RET_OK;
-	zb_app_cb_t new_app_cb;
+	zb_app_cb_t *app_cb;
 
 	/* Mark te processing callback as non-scheduled. */
 	(void)atomic_set((atomic_t *)&zb_app_cb_process_scheduled, 0);
 
+#ifdef CONFIG_ZIGBEE_APP_CB_QUEUE_STATS
+	zb_app_cb_stats_depth_update();
+#endif
+
 	/**
-	 * From ZBOSS main loop context: process all requests.
+	 * From ZBOSS main loop context: process all requests, including the ones
+	 * added while processing, in a single batch.
 	 *
 	 * Note: the ZB_SCHEDULE_APP_ALARM is not thread-safe.
 	 */
-	while (!k_msgq_peek(&zb_app_cb_msgq, &new_app_cb)) {
-		switch (new_app_cb.type) {
+	while ((app_cb = zb_app_cb_peek()) != NULL) {
+		switch (app_cb->type) {
 		case ZB_CALLBACK_TYPE_SINGLE_PARAM:
 			ret_code = zb_schedule_app_callback(
-					new_app_cb.func,
-					(zb_uint8_t)new_app_cb.param);
+					app_cb->func,
+					(zb_uint8_t)app_cb->param);
 			break;
 		case ZB_CALLBACK_TYPE_TWO_PARAMS:
 			ret_code = zb_schedule_app_callback2(
-					new_app_cb.func2,
-					(zb_uint8_t)new_app_cb.param,
-					new_app_cb.user_param);
+					app_cb->func2,
+					(zb_uint8_t)app_cb->param,
+					app_cb->user_param);
 			break;
 		case ZB_CALLBACK_TYPE_ALARM_SET:
 		{
@@ -163,71 +344,77 @@ static void zb_app_cb_process(zb_bufid_t bufid)
 			 * is still able to cancel the alarm.
 			 */
 			zb_time_t delay =
-				(k_uptime_get() > new_app_cb.alarm_timestamp ?
+				(k_uptime_get() > app_cb->alarm_timestamp ?
 					1 :
 					ZB_MILLISECONDS_TO_BEACON_INTERVAL(
-						new_app_cb.alarm_timestamp -
+						app_cb->alarm_timestamp -
 						k_uptime_get())
 				);
 			ret_code = zb_schedule_app_alarm(
-					new_app_cb.func,
-					(zb_uint8_t)new_app_cb.param,
+					app_cb->func,
+					(zb_uint8_t)app_cb->param,
 					delay);
 			break;
 		}
 		case ZB_CALLBACK_TYPE_ALARM_CANCEL:
 			ret_code = zb_schedule_alarm_cancel(
-					new_app_cb.func,
-					(zb_uint8_t)new_app_cb.param,
+					app_cb->func,
+					(zb_uint8_t)app_cb->param,
 					NULL);
 			break;
 		case ZB_GET_OUT_BUF_DELAYED:
 			ret_code = zb_buf_get_out_delayed_func(
-				TRACE_CALL(new_app_cb.func));
+				TRACE_CALL(app_cb->func));
 			break;
 		case ZB_GET_IN_BUF_DELAYED:
 			ret_code = zb_buf_get_in_delayed_func(
-				TRACE_CALL(new_app_cb.func));
+				TRACE_CALL(app_cb->func));
 			break;
 		case ZB_GET_OUT_BUF_DELAYED_EXT:
 			ret_code = zb_buf_get_out_delayed_ext_func(
-					TRACE_CALL(new_app_cb.func2),
-					new_app_cb.user_param,
-					new_app_cb.param);
+					TRACE_CALL(app_cb->func2),
+					app_cb->user_param,
+					app_cb->param);
 			break;
 		case ZB_GET_IN_BUF_DELAYED_EXT:
 			ret_code = zb_buf_get_in_delayed_ext_func(
-					TRACE_CALL(new_app_cb.func2),
-					new_app_cb.user_param,
-					new_app_cb.param);
+					TRACE_CALL(app_cb->func2),
+					app_cb->user_param,
+					app_cb->param);
 			break;
 		default:
 			break;
 		}
 
-		/* Check for ZBOSS scheduler queue overflow. */
+#ifdef CONFIG_ZIGBEE_APP_CB_QUEUE_STATS
+		zb_app_cb_stats_update(app_cb, ret_code);
+#endif
+
+		/**
+		 * Check for ZBOSS scheduler queue overflow. The element stays
+		 * in the queue, so producers are signalled with RET_OVERFLOW
+		 * once it fills up, instead of losing requests.
+		 */
 		if (ret_code == RET_OVERFLOW) {
 			break;
 		}
 
-		/* Flush the element from the message queue. */
-		k_msgq_get(&zb_app_cb_msgq, &new_app_cb, K_NO_WAIT);
+		/* Flush the element from the queue. */
+		zb_app_cb_remove();
 	}
 
 	/**
-	 * In case of overflow error - reschedule the processing callback
-	 * to process remaining requests later.
+	 * In case of overflow error - let the ZBOSS thread process remaining
+	 * requests after the scheduled callbacks are executed.
 	 */
 	if (ret_code == RET_OVERFLOW) {
-		k_work_submit(&zb_app_cb_work);
+		(void)atomic_set(&zb_app_cb_process_retry, 1);
 	}
 }
 
 static void zb_app_cb_process_schedule(struct k_work *item)
 {
-	zb_app_cb_t new_app_cb;
-
-	if (k_msgq_peek(&zb_app_cb_msgq, &new_app_cb)) {
+	if (zb_app_cb_peek() == NULL) {
 		return;
 	}
 
@@ -238,13 +425,16 @@ static void zb_app_cb_process_schedule(struct k_work *item)
 
 	/**
 	 * From working thread, non-ISR context: schedule processing callback.
-	 * Repeat endlessly, because the user was already informed that the
-	 * request will be handled.
+	 * If the ZBOSS scheduler queue is full, the requests stay in the queue
+	 * and the ZBOSS thread processes them once the slots are freed,
+	 * because the user was already informed that the request will be
+	 * handled.
 	 *
 	 * Note: the ZB_SCHEDULE_APP_CALLBACK is thread-safe.
 	 */
-	while (zb_schedule_app_callback(zb_app_cb_process, 0) != RET_OK) {
-		k_sleep(K_MSEC(1000));
+	if (zb_schedule_app_callback(zb_app_cb_process, 0) != RET_OK) {
+		(void)atomic_set((atomic_t *)&zb_app_cb_process_scheduled, 0);
+		(void)atomic_set(&zb_app_cb_process_retry, 1);
 	}
 	zigbee_event_notify(ZIGBEE_EVENT_APP);
 
@@ -327,6 +517,15 @@ static void zboss_thread(void *arg1, void *arg2, void *arg3)
 
 	while (1) {
 		zboss_main_loop_iteration();
+
+		/**
+		 * The main loop iteration executed scheduled callbacks, so
+		 * resume processing of requests stopped by the ZBOSS scheduler
+		 * queue overflow.
+		 */
+		if (atomic_cas(&zb_app_cb_process_retry, 1, 0)) {
+			zb_app_cb_process(0);
+		}
 	}
 }
 
@@ -338,12 +537,7 @@ zb_ret_t zigbee_schedule_callback(zb_callback_t func, zb_uint8_t param)
 		.param = param,
 	};
 
-	if (k_msgq_put(&zb_app_cb_msgq, &new_app_cb, K_NO_WAIT)) {
-		return RET_OVERFLOW;
-	}
-
-	k_work_submit(&zb_app_cb_work);
-	return RET_OK;
+	return zb_app_cb_put(&new_app_cb);
 }
 
 zb_ret_t zigbee_schedule_callback2(zb_callback2_t func,
@@ -357,12 +551,7 @@ zb_ret_t zigbee_schedule_callback2(zb_callback2_t func,
 		.user_param = user_param,
 	};
 
-	if (k_msgq_put(&zb_app_cb_msgq, &new_app_cb, K_NO_WAIT)) {
-		return RET_OVERFLOW;
-	}
-
-	k_work_submit(&zb_app_cb_work);
-	return RET_OK;
+	return zb_app_cb_put(&new_app_cb);
 }
 
 zb_ret_t zigbee_schedule_alarm(zb_callback_t func,
@@ -377,12 +566,7 @@ zb_ret_t zigbee_schedule_alarm(zb_callback_t func,
 				   ZB_TIME_BEACON_INTERVAL_TO_MSEC(run_after),
 	};
 
-	if (k_msgq_put(&zb_app_cb_msgq, &new_app_cb, K_NO_WAIT)) {
-		return RET_OVERFLOW;
-	}
-
-	k_work_submit(&zb_app_cb_work);
-	return RET_OK;
+	return zb_app_cb_put(&new_app_cb);
 }
 
 zb_ret_t zigbee_schedule_alarm_cancel(zb_callback_t func, zb_uint8_t param)
@@ -393,12 +577,7 @@ zb_ret_t zigbee_schedule_alarm_cancel(zb_callback_t func, zb_uint8_t param)
 		.param = param,
 	};
 
-	if (k_msgq_put(&zb_app_cb_msgq, &new_app_cb, K_NO_WAIT)) {
-		return RET_OVERFLOW;
-	}
-
-	k_work_submit(&zb_app_cb_work);
-	return RET_OK;
+	return zb_app_cb_put(&new_app_cb);
 }
 
 zb_ret_t zigbee_get_out_buf_delayed(zb_callback_t func)
@@ -408,12 +587,7 @@ zb_ret_t zigbee_get_out_buf_delayed(zb_callback_t func)
 		.func = func,
 	};
 
-	if (k_msgq_put(&zb_app_cb_msgq, &new_app_cb, K_NO_WAIT)) {
-		return RET_OVERFLOW;
-	}
-
-	k_work_submit(&zb_app_cb_work);
-	return RET_OK;
+	return zb_app_cb_put(&new_app_cb);
 }
 
 zb_ret_t zigbee_get_in_buf_delayed(zb_callback_t func)
@@ -423,12 +597,7 @@ zb_ret_t zigbee_get_in_buf_delayed(zb_callback_t func)
 		.func = func,
 	};
 
-	if (k_msgq_put(&zb_app_cb_msgq, &new_app_cb, K_NO_WAIT)) {
-		return RET_OVERFLOW;
-	}
-
-	k_work_submit(&zb_app_cb_work);
-	return RET_OK;
+	return zb_app_cb_put(&new_app_cb);
 }
 
 zb_ret_t zigbee_get_out_buf_delayed_ext(zb_callback2_t func, zb_uint16_t param,
@@ -441,12 +610,7 @@ zb_ret_t zigbee_get_out_buf_delayed_ext(zb_callback2_t func, zb_uint16_t param,
 		.param = max_size,
 	};
 
-	if (k_msgq_put(&zb_app_cb_msgq, &new_app_cb, K_NO_WAIT)) {
-		return RET_OVERFLOW;
-	}
-
-	k_work_submit(&zb_app_cb_work);
-	return RET_OK;
+	return zb_app_cb_put(&new_app_cb);
 }
 
 zb_ret_t zigbee_get_in_buf_delayed_ext(zb_callback2_t func, zb_uint16_t param,
@@ -459,12 +623,7 @@ zb_ret_t zigbee_get_in_buf_delayed_ext(zb_callback2_t func, zb_uint16_t param,
 		.param = max_size,
 	};
 
-	if (k_msgq_put(&zb_app_cb_msgq, &new_app_cb, K_NO_WAIT)) {
-		return RET_OVERFLOW;
-	}
-
-	k_work_submit(&zb_app_cb_work);
-	return RET_OK;
+	return zb_app_cb_put(&new_app_cb);
 }
 
 /**@brief SoC general initialization. */
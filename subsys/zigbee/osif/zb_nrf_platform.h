@@ -57,6 +57,71 @@ void zigbee_debug_resume_zboss_thread(void);
 bool zigbee_is_zboss_thread_suspended(void);
 #endif /* defined(CONFIG_ZIGBEE_DEBUG_FUNCTIONS) */
 
+#ifdef CONFIG_ZIGBEE_APP_CB_QUEUE_STATS
+/** Number of buckets in the histogram of the application callback queue latency. */
+#define ZIGBEE_APP_CB_QUEUE_LATENCY_BUCKETS 20
+
+/**@brief Statistics of the application callback and alarm queue.
+ */
+struct zigbee_app_cb_queue_stats {
+	/** Number of requests passed to the ZBOSS scheduler. */
+	uint32_t processed;
+	/** Number of requests rejected because the queue was full. */
+	uint32_t queue_full;
+	/** Number of times the ZBOSS scheduler queue was full. */
+	uint32_t scheduler_full;
+	/** Maximum number of requests waiting in the queue. */
+	uint32_t depth_max;
+	/** Maximum time a request waited in the queue, in microseconds. */
+	uint32_t latency_max_us;
+	/** Histogram of the time requests waited in the queue. Bucket n counts
+	 *  latencies from 2^n up to 2^(n+1) microseconds, with the first bucket
+	 *  also counting latencies below 1 microsecond and the last bucket
+	 *  counting all longer latencies.
+	 */
+	uint32_t latency_hist[ZIGBEE_APP_CB_QUEUE_LATENCY_BUCKETS];
+};
+
+/**@brief Function for getting the statistics of the application callback
+ *        and alarm queue.
+ *
+ * @param[out] stats  Statistics collected since startup or the last reset.
+ */
+void zigbee_app_cb_queue_stats_get(struct zigbee_app_cb_queue_stats *stats);
+
+/**@brief Function for resetting the statistics of the application callback
+ *        and alarm queue.
+ */
+void zigbee_app_cb_queue_stats_reset(void);
+#endif /* defined(CONFIG_ZIGBEE_APP_CB_QUEUE_STATS) */
+
+#ifdef CONFIG_ZIGBEE_NVRAM_STATS
+/**@brief Counters of the ZBOSS NVRAM operations.
+ */
+struct zigbee_nvram_stats {
+	/** Number of writes requested by ZBOSS. */
+	uint32_t writes;
+	/** Number of write operations on flash. */
+	uint32_t flash_writes;
+	/** Number of bytes written to flash. */
+	uint32_t flash_write_bytes;
+	/** Number of page erase operations on flash. */
+	uint32_t erases;
+	/** Number of times the write cache was committed to flash. */
+	uint32_t commits;
+};
+
+/**@brief Function for getting the counters of the ZBOSS NVRAM operations.
+ *
+ * @param[out] stats  Counters collected since startup or the last reset.
+ */
+void zigbee_nvram_stats_get(struct zigbee_nvram_stats *stats);
+
+/**@brief Function for resetting the counters of the ZBOSS NVRAM operations.
+ */
+void zigbee_nvram_stats_reset(void);
+#endif /* defined(CONFIG_ZIGBEE_NVRAM_STATS) */
+
 /**
  * @}
  */
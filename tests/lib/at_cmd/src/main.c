@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <modem/at_cmd.h>
+
+#include "modem_sim.h"
+
+#define MODEM_LATENCY K_MSEC(2)
+
+static const char *responses[8];
+static size_t response_count;
+static const char *notifs[4];
+static size_t notif_count;
+
+static void response_handler(const char *response)
+{
+	if (response_count < ARRAY_SIZE(responses)) {
+		responses[response_count] = response;
+	}
+	response_count++;
+}
+
+static void cgmr_handler(const char *response)
+{
+	zassert_equal(strcmp(response, "mfw_nrf9160_1.3.0\r\n"), 0,
+		      "Invalid response: %s", response);
+
+	response_handler(response);
+}
+
+static void notif_handler(const char *notif)
+{
+	if (notif_count < ARRAY_SIZE(notifs)) {
+		notifs[notif_count] = notif;
+	}
+	notif_count++;
+}
+
+static void notify_handler(const char *response)
+{
+	modem_sim_notify("+CEREG: 1\r\n");
+
+	response_handler(response);
+}
+
+static void batch_setup(void)
+{
+	modem_sim_reset();
+	modem_sim_latency_set(MODEM_LATENCY);
+
+	response_count = 0;
+	notif_count = 0;
+}
+
+static void test_batch_ok(void)
+{
+	struct at_cmd_batch_cmd cmds[] = {
+		{ .cmd = "AT+CFUN=4" },
+		{ .cmd = "AT+CGMR", .callback = cgmr_handler },
+		{ .cmd = "AT%XSYSTEMMODE=1,0,1,0" },
+		{ .cmd = "AT+CEREG=5", .callback = response_handler },
+		{ .cmd = "AT+CSCON=1" },
+	};
+	struct at_cmd_batch batch = {
+		.cmds = cmds,
+		.count = ARRAY_SIZE(cmds),
+	};
+	static const struct modem_sim_resp resps[] = {
+		{ "AT+CGMR", "mfw_nrf9160_1.3.0\r\nOK\r\n" },
+	};
+	int err;
+
+	modem_sim_responses_set(resps, ARRAY_SIZE(resps));
+
+	err = at_cmd_batch_write(&batch);
+	zassert_equal(err, 0, "Batch failed: %d", err);
+	zassert_equal(batch.executed, ARRAY_SIZE(cmds),
+		      "Not all commands executed");
+	zassert_equal(response_count, 2, "Callbacks not called");
+
+	zassert_equal(modem_sim_cmd_count_get(), ARRAY_SIZE(cmds),
+		      "Invalid number of commands sent");
+	zassert_equal(modem_sim_max_pending_get(), 1,
+		      "Commands must be sent one at a time");
+
+	for (size_t i = 0; i < ARRAY_SIZE(cmds); i++) {
+		zassert_equal(strcmp(modem_sim_cmd_get(i), cmds[i].cmd), 0,
+			      "Invalid command order");
+		zassert_equal(cmds[i].state, AT_CMD_OK, "Invalid state");
+		zassert_equal(cmds[i].code, 0, "Invalid code");
+		zassert_true(cmds[i].time_us >= 1000,
+			     "Invalid command time %u us", cmds[i].time_us);
+	}
+
+	zassert_true(batch.time_us >= ARRAY_SIZE(cmds) * 1000,
+		     "Invalid batch time %u us", batch.time_us);
+}
+
+static void test_batch_stop_on_error(void)
+{
+	struct at_cmd_batch_cmd cmds[] = {
+		{ .cmd = "AT+CFUN=4" },
+		{ .cmd = "AT%XBANDLOCK=2,\"1\"" },
+		{ .cmd = "AT+CEREG=5" },
+	};
+	struct at_cmd_batch batch = {
+		.cmds = cmds,
+		.count = ARRAY_SIZE(cmds),
+		.stop_on_error = true,
+	};
+	static const struct modem_sim_resp resps[] = {
+		{ "AT%XBANDLOCK=2,\"1\"", "ERROR\r\n" },
+	};
+	int err;
+
+	modem_sim_responses_set(resps, ARRAY_SIZE(resps));
+
+	err = at_cmd_batch_write(&batch);
+	zassert_equal(err, -ENOEXEC, "Invalid batch result: %d", err);
+	zassert_equal(batch.executed, 2, "Batch not stopped on error");
+	zassert_equal(modem_sim_cmd_count_get(), 2,
+		      "Command sent after error");
+
+	zassert_equal(cmds[0].state, AT_CMD_OK, "Invalid state");
+	zassert_equal(cmds[1].state, AT_CMD_ERROR, "Invalid state");
+	zassert_equal(cmds[2].state, AT_CMD_ERROR_QUEUE, "Invalid state");
+	zassert_equal(cmds[2].code, -ECANCELED, "Invalid code");
+}
+
+static void test_batch_continue_on_error(void)
+{
+	struct at_cmd_batch_cmd cmds[] = {
+		{ .cmd = "AT+CFUN=4" },
+		{ .cmd = "AT+CSCON=1" },
+		{ .cmd = "AT+CEREG=5" },
+	};
+	struct at_cmd_batch batch = {
+		.cmds = cmds,
+		.count = ARRAY_SIZE(cmds),
+	};
+	static const struct modem_sim_resp resps[] = {
+		{ "AT+CSCON=1", "+CME ERROR: 513\r\n" },
+	};
+	int err;
+
+	modem_sim_responses_set(resps, ARRAY_SIZE(resps));
+
+	err = at_cmd_batch_write(&batch);
+	zassert_equal(err, 513, "Invalid batch result: %d", err);
+	zassert_equal(batch.executed, ARRAY_SIZE(cmds),
+		      "Not all commands executed");
+
+	zassert_equal(cmds[1].state, AT_CMD_ERROR_CME, "Invalid state");
+	zassert_equal(cmds[1].code, 513, "Invalid code");
+	zassert_equal(cmds[2].state, AT_CMD_OK, "Invalid state");
+}
+
+static void test_batch_notification(void)
+{
+	struct at_cmd_batch_cmd cmds[] = {
+		{ .cmd = "AT+CFUN=1", .callback = notify_handler },
+		{ .cmd = "AT+CEREG?", .callback = response_handler },
+	};
+	struct at_cmd_batch batch = {
+		.cmds = cmds,
+		.count = ARRAY_SIZE(cmds),
+	};
+	int err;
+
+	at_cmd_set_notification_handler(notif_handler);
+
+	/* The notification arrives between the responses. */
+	err = at_cmd_batch_write(&batch);
+	zassert_equal(err, 0, "Batch failed: %d", err);
+	zassert_equal(response_count, 2, "Callbacks not called");
+	zassert_equal(notif_count, 1, "Notification not dispatched");
+
+	at_cmd_set_notification_handler(NULL);
+}
+
+static void test_batch_invalid(void)
+{
+	struct at_cmd_batch_cmd cmds[] = {
+		{ .cmd = "AT+CFUN=4" },
+		{ .cmd = " " },
+	};
+	struct at_cmd_batch batch = {
+		.cmds = cmds,
+		.count = ARRAY_SIZE(cmds),
+	};
+
+	zassert_equal(at_cmd_batch_write(NULL), -EINVAL, "NULL batch");
+	zassert_equal(at_cmd_batch_write(&batch), -EINVAL, "Invalid command");
+
+	batch.count = 0;
+	zassert_equal(at_cmd_batch_write(&batch), -EINVAL, "Empty batch");
+
+	zassert_equal(modem_sim_cmd_count_get(), 0, "Command sent");
+}
+
+static void test_batch_timing(void)
+{
+	struct at_cmd_batch_cmd cmds[16];
+	struct at_cmd_batch batch = {
+		.cmds = cmds,
+		.count = ARRAY_SIZE(cmds),
+	};
+	uint32_t start;
+	uint32_t sequential_us;
+	int err;
+
+	for (size_t i = 0; i < ARRAY_SIZE(cmds); i++) {
+		cmds[i].cmd = "AT+CFUN?";
+		cmds[i].callback = NULL;
+	}
+
+	start = k_cycle_get_32();
+	for (size_t i = 0; i < ARRAY_SIZE(cmds); i++) {
+		err = at_cmd_write(cmds[i].cmd, NULL, 0, NULL);
+		zassert_equal(err, 0, "Command failed: %d", err);
+	}
+	sequential_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	err = at_cmd_batch_write(&batch);
+	zassert_equal(err, 0, "Batch failed: %d", err);
+
+	TC_PRINT("%d commands: %u us one by one, %u us as a batch\n",
+		 ARRAY_SIZE(cmds), sequential_us, batch.time_us);
+
+	for (size_t i = 0; i < ARRAY_SIZE(cmds); i++) {
+		TC_PRINT("  %s: %u us\n", cmds[i].cmd, cmds[i].time_us);
+	}
+}
+
+static void test_write_after_batch(void)
+{
+	char buf[32];
+	int err;
+	static const struct modem_sim_resp resps[] = {
+		{ "AT+CGMR", "mfw_nrf9160_1.3.0\r\nOK\r\n" },
+	};
+
+	modem_sim_responses_set(resps, ARRAY_SIZE(resps));
+
+	err = at_cmd_write("AT+CGMR", buf, sizeof(buf), NULL);
+	zassert_equal(err, 0, "Command failed: %d", err);
+	zassert_equal(strcmp(buf, "mfw_nrf9160_1.3.0\r\n"), 0,
+		      "Invalid response: %s", buf);
+}
+
+void test_main(void)
+{
+	zassert_equal(at_cmd_init(), 0, "at_cmd_init failed");
+
+	ztest_test_suite(at_cmd,
+		ztest_unit_test_setup_teardown(test_batch_ok,
+			batch_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_batch_stop_on_error,
+			batch_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_batch_continue_on_error,
+			batch_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_batch_notification,
+			batch_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_batch_invalid,
+			batch_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_batch_timing,
+			batch_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_write_after_batch,
+			batch_setup, unit_test_noop)
+	);
+
+	ztest_run_test_suite(at_cmd);
+}
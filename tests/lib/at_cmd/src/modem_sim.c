@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Simulated modem AT socket. Commands are answered from a table, after a
+ * configurable latency, like the modem does: one command at a time.
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <string.h>
+#include <errno.h>
+#include <net/socket.h>
+
+#include "modem_sim.h"
+
+#define MSG_MAX_LEN 128
+#define CMD_LOG_LEN 32
+
+struct modem_sim_msg {
+	char buf[MSG_MAX_LEN];
+};
+
+K_MSGQ_DEFINE(rx_queue, sizeof(struct modem_sim_msg), 8, 4);
+
+static const struct modem_sim_resp *responses;
+static size_t response_count;
+static k_timeout_t latency;
+static atomic_t pending;
+static size_t max_pending;
+static char cmd_log[CMD_LOG_LEN][MSG_MAX_LEN];
+static size_t cmd_count;
+
+static void respond(const char *resp)
+{
+	struct modem_sim_msg msg;
+
+	strncpy(msg.buf, resp, sizeof(msg.buf) - 1);
+	msg.buf[sizeof(msg.buf) - 1] = '\0';
+
+	k_msgq_put(&rx_queue, &msg, K_FOREVER);
+}
+
+static void respond_work_fn(struct k_work *work)
+{
+	const char *cmd = cmd_log[(cmd_count - 1) % CMD_LOG_LEN];
+	const char *resp = "OK\r\n";
+
+	for (size_t i = 0; i < response_count; i++) {
+		if (strcmp(responses[i].cmd, cmd) == 0) {
+			resp = responses[i].resp;
+			break;
+		}
+	}
+
+	atomic_dec(&pending);
+	respond(resp);
+}
+
+static K_WORK_DELAYABLE_DEFINE(respond_work, respond_work_fn);
+
+int modem_sim_socket(int family, int type, int proto)
+{
+	zassert_equal(family, AF_LTE, "Invalid socket family");
+	zassert_equal(proto, NPROTO_AT, "Invalid socket protocol");
+
+	return 1;
+}
+
+ssize_t modem_sim_send(int sock, const void *buf, size_t len, int flags)
+{
+	char *entry = cmd_log[cmd_count % CMD_LOG_LEN];
+	size_t count;
+
+	len = MIN(len, MSG_MAX_LEN - 1);
+	memcpy(entry, buf, len);
+	entry[len] = '\0';
+	cmd_count++;
+
+	/* The modem handles one command at a time. */
+	count = atomic_inc(&pending) + 1;
+	max_pending = MAX(max_pending, count);
+
+	k_work_schedule(&respond_work, latency);
+
+	return len;
+}
+
+ssize_t modem_sim_recv(int sock, void *buf, size_t max_len, int flags)
+{
+	struct modem_sim_msg msg;
+	size_t len;
+
+	k_msgq_get(&rx_queue, &msg, K_FOREVER);
+
+	len = MIN(strlen(msg.buf) + 1, max_len);
+	memcpy(buf, msg.buf, len);
+
+	return len;
+}
+
+int modem_sim_close(int sock)
+{
+	return 0;
+}
+
+void modem_sim_responses_set(const struct modem_sim_resp *resps, size_t count)
+{
+	responses = resps;
+	response_count = count;
+}
+
+void modem_sim_latency_set(k_timeout_t new_latency)
+{
+	latency = new_latency;
+}
+
+void modem_sim_notify(const char *notif)
+{
+	respond(notif);
+}
+
+size_t modem_sim_cmd_count_get(void)
+{
+	return cmd_count;
+}
+
+size_t modem_sim_max_pending_get(void)
+{
+	return max_pending;
+}
+
+const char *modem_sim_cmd_get(size_t index)
+{
+	return cmd_log[index % CMD_LOG_LEN];
+}
+
+void modem_sim_reset(void)
+{
+	responses = NULL;
+	response_count = 0;
+	latency = K_NO_WAIT;
+	max_pending = 0;
+	cmd_count = 0;
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MODEM_SIM_H_
+#define MODEM_SIM_H_
+
+#include <zephyr.h>
+
+/* Response of the simulated modem to a command. */
+struct modem_sim_resp {
+	const char *cmd;
+	const char *resp;
+};
+
+/* Set the responses of the simulated modem. Other commands get "OK". */
+void modem_sim_responses_set(const struct modem_sim_resp *resps, size_t count);
+
+/* Set the time the simulated modem takes to respond. */
+void modem_sim_latency_set(k_timeout_t latency);
+
+/* Send a notification from the simulated modem. */
+void modem_sim_notify(const char *notif);
+
+/* Get the number of commands received by the simulated modem, and the
+ * maximum number of commands that were waiting for a response at the same
+ * time.
+ */
+size_t modem_sim_cmd_count_get(void);
+size_t modem_sim_max_pending_get(void);
+
+/* Get a command received by the simulated modem. */
+const char *modem_sim_cmd_get(size_t index);
+
+void modem_sim_reset(void);
+
+#endif /* MODEM_SIM_H_ */
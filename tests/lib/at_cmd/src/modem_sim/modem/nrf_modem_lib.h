@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MODEM_SIM_NRF_MODEM_LIB_H_
+#define MODEM_SIM_NRF_MODEM_LIB_H_
+
+static inline void nrf_modem_lib_shutdown_wait(void)
+{
+}
+
+#endif /* MODEM_SIM_NRF_MODEM_LIB_H_ */
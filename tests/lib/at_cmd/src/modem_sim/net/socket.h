@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Socket API of the simulated modem, used instead of the network stack. */
+
+#ifndef MODEM_SIM_SOCKET_H_
+#define MODEM_SIM_SOCKET_H_
+
+#include <zephyr/types.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#define AF_LTE     102
+#define SOCK_DGRAM 2
+#define NPROTO_AT  513
+
+#define socket modem_sim_socket
+#define send   modem_sim_send
+#define recv   modem_sim_recv
+#define close  modem_sim_close
+
+int modem_sim_socket(int family, int type, int proto);
+ssize_t modem_sim_send(int sock, const void *buf, size_t len, int flags);
+ssize_t modem_sim_recv(int sock, void *buf, size_t max_len, int flags);
+int modem_sim_close(int sock);
+
+#endif /* MODEM_SIM_SOCKET_H_ */
@@ -778,6 +778,57 @@ static void test_at_cmd_test_teardown(void)
 	at_params_list_free(&test_list2);
 }
 
+static void test_forced_string_setup(void)
+{
+	at_params_list_init(&test_list2, TEST_PARAMS2);
+}
+
+static void test_forced_string(void)
+{
+	static const char * const forced[] = {
+		"+CGEV: ME PDN ACT 0\r\n",
+		"+CPIN: READY\r\n",
+		"+CPINR: \"SIM PIN\",3\r\n",
+		"%HWVERSION: nRF9160 SICA B0A\r\n",
+		"%SHORTSWVER: nrf9160_1.2.3\r\n",
+		"%XICCID: 8901234567012345678F\r\n",
+		"%XMODEMUUID: 25c95751-efa4-40d4-8b4a-1dcaab81fac9\r\n",
+	};
+	int ret;
+
+	for (size_t i = 0; i < ARRAY_SIZE(forced); i++) {
+		ret = at_parser_params_from_str(forced[i], NULL, &test_list2);
+		zassert_equal(ret, 0,
+			      "at_parser_params_from_str should return 0");
+
+		zassert_equal(at_params_valid_count_get(&test_list2), 2,
+			      "Response %s should have two parameters",
+			      forced[i]);
+		zassert_equal(at_params_type_get(&test_list2, 1),
+			      AT_PARAM_TYPE_STRING,
+			      "Response %s should be parsed as a string",
+			      forced[i]);
+	}
+
+	/* Responses with similar prefixes are parsed as usual. */
+	ret = at_parser_params_from_str("+CGEREP: 1\r\n", NULL, &test_list2);
+	zassert_equal(ret, 0, "at_parser_params_from_str should return 0");
+	zassert_equal(at_params_type_get(&test_list2, 1),
+		      AT_PARAM_TYPE_NUM_INT,
+		      "Param type at index 1 should be an integer");
+
+	ret = at_parser_params_from_str("%XSIM: 1\r\n", NULL, &test_list2);
+	zassert_equal(ret, 0, "at_parser_params_from_str should return 0");
+	zassert_equal(at_params_type_get(&test_list2, 1),
+		      AT_PARAM_TYPE_NUM_INT,
+		      "Param type at index 1 should be an integer");
+}
+
+static void test_forced_string_teardown(void)
+{
+	at_params_list_free(&test_list2);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(at_cmd_parser,
@@ -808,7 +859,11 @@ void test_main(void)
 			 ztest_unit_test_setup_teardown(
 				test_at_cmd_test,
 				test_at_cmd_test_setup,
-				test_at_cmd_test_teardown)
+				test_at_cmd_test_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_forced_string,
+				test_forced_string_setup,
+				test_forced_string_teardown)
 			);
 
 	ztest_run_test_suite(at_cmd_parser);
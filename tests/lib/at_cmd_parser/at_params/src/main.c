@@ -505,6 +505,77 @@ static void test_params_list_management_teardown(void)
 	at_params_list_free(&test_list);
 }
 
+static void test_params_views(void)
+{
+	static const char str[] = "-1234,\"Hello\",1,2,33,4096";
+	struct at_param params[TEST_PARAMS];
+	struct at_param_list list;
+	uint32_t tmp_array[4];
+	const char *tmp_ptr;
+	size_t len;
+	int32_t tmp_int;
+	int64_t tmp_int64;
+
+	zassert_equal(-EINVAL, at_params_list_init_views(&list, NULL,
+							 TEST_PARAMS),
+		      "Init function initializes with NULL parameter");
+	zassert_equal(0, at_params_list_init_views(&list, params, TEST_PARAMS),
+		      "Not able to initialize params list");
+	zassert_equal(TEST_PARAMS, list.param_count,
+		      "Params count should be the same as TEST_PARAMS");
+
+	zassert_equal(0, at_params_view_put(&list, 0, AT_PARAM_TYPE_NUM_INT,
+					    &str[0], 5),
+		      "Put number view should return 0");
+	zassert_equal(0, at_params_string_put(&list, 1, &str[7], 5),
+		      "Put string should return 0");
+	zassert_equal(0, at_params_view_put(&list, 2, AT_PARAM_TYPE_ARRAY,
+					    &str[14], 11),
+		      "Put array view should return 0");
+	zassert_equal(0, at_params_int_put(&list, 3, 42),
+		      "Put int should return 0");
+	zassert_equal(-ENOTSUP, at_params_array_put(&list, 4, tmp_array,
+						     sizeof(tmp_array)),
+		      "Put array should return -ENOTSUP");
+	zassert_equal(-EINVAL, at_params_view_put(&list, 4,
+						  AT_PARAM_TYPE_NUM_INT,
+						  &str[0], 0),
+		      "Put empty number view should return -EINVAL");
+
+	/* Numbers are decoded when read. */
+	zassert_equal(0, at_params_int_get(&list, 0, &tmp_int),
+		      "Get int should return 0");
+	zassert_equal(-1234, tmp_int, "Get int should return -1234");
+	zassert_equal(0, at_params_int64_get(&list, 3, &tmp_int64),
+		      "Get int64 should return 0");
+	zassert_equal(42, tmp_int64, "Get int64 should return 42");
+
+	/* Strings are not copied. */
+	zassert_equal(0, at_params_string_ptr_get(&list, 1, &tmp_ptr, &len),
+		      "Get string pointer should return 0");
+	zassert_equal_ptr(&str[7], tmp_ptr, "String should not be copied");
+	zassert_equal(5, len, "String length should be 5");
+
+	zassert_equal(0, at_params_size_get(&list, 2, &len),
+		      "Get size should return 0");
+	zassert_equal(4 * sizeof(uint32_t), len, "Array size should be 16");
+
+	len = sizeof(tmp_array) - 1;
+	zassert_equal(-ENOMEM, at_params_array_get(&list, 2, tmp_array, &len),
+		      "Get array should return -ENOMEM");
+
+	len = sizeof(tmp_array);
+	zassert_equal(0, at_params_array_get(&list, 2, tmp_array, &len),
+		      "Get array should return 0");
+	zassert_equal(1, tmp_array[0], "Array element 0 should be 1");
+	zassert_equal(2, tmp_array[1], "Array element 1 should be 2");
+	zassert_equal(33, tmp_array[2], "Array element 2 should be 33");
+	zassert_equal(4096, tmp_array[3], "Array element 3 should be 4096");
+
+	at_params_list_free(&list);
+	zassert_equal_ptr(NULL, list.params, "Params is not NULL after free");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(at_params,
@@ -540,7 +611,8 @@ void test_main(void)
 			 ztest_unit_test_setup_teardown(
 					test_params_list_management,
 					test_params_list_management_setup,
-					test_params_list_management_teardown)
+					test_params_list_management_teardown),
+			 ztest_unit_test(test_params_views)
 			);
 
 	ztest_run_test_suite(at_params);
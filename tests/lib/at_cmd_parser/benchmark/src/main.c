@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <kernel.h>
+
+#include <modem/at_cmd_parser.h>
+#include <modem/at_params.h>
+
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+#include "native_rtc.h"
+#endif
+
+#define PARSE_ROUNDS	5000
+#define MAX_PARAMS	32
+#define MAX_STR_LEN	128
+
+/* Notifications received by lte_lc, modem_info and sms. */
+static const char * const notifications[] = {
+	"+CEREG: 5,\"4E21\",\"0001F3A1\",7,,,\"11100000\",\"11100000\"\r\n",
+	"+CSCON: 1\r\n",
+	"%CESQ: 54,2,19,2\r\n",
+	"%XMODEMSLEEP: 1,3600000\r\n",
+	"%NCELLMEAS: 0,\"021D140C\",\"24201\",\"0821\",65535,5300,6400,60,29,"
+	"11495,6400,465,49,26,24,6400,466,47,24,24,6400,467,44,20,24,"
+	"2400,321,39,21,24,11521\r\n",
+	"%XMONITOR: 1,\"Telia N\",\"Telia N\",\"24202\",\"0901\",7,20,"
+	"\"012BE006\",401,6400,53,24,\"\",\"11100000\",\"00011110\","
+	"\"01001001\"\r\n",
+	"+CMT: \"+4799999999\",22\r\n"
+	"0791448720003023240DD0E474D81C0EBB010000111011315214000BE474D81C"
+	"0EBB5DE3771B\r\n",
+	"+CGEV: ME PDN ACT 0\r\n",
+	"%XSYSTEMMODE: 1,0,1,0\r\n",
+	"+CPSMS: 1,,,\"00100001\",\"00000110\"\r\n",
+};
+
+static uint32_t alloc_cnt;
+static uint32_t alloc_size;
+
+void *__real_k_malloc(size_t size);
+void __real_k_free(void *ptr);
+
+void *__wrap_k_malloc(size_t size)
+{
+	alloc_cnt++;
+	alloc_size += size;
+
+	return __real_k_malloc(size);
+}
+
+void __wrap_k_free(void *ptr)
+{
+	__real_k_free(ptr);
+}
+
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+/* Simulated time does not advance while code is executed, use host time. */
+static uint64_t timestamp_get(void)
+{
+	return native_rtc_gettime_us(RTC_CLOCK_REAL);
+}
+
+static uint64_t elapsed_ns(uint64_t start)
+{
+	return (timestamp_get() - start) * NSEC_PER_USEC;
+}
+#else
+static uint64_t timestamp_get(void)
+{
+	return k_cycle_get_32();
+}
+
+static uint64_t elapsed_ns(uint64_t start)
+{
+	uint32_t cycles = k_cycle_get_32() - (uint32_t)start;
+
+	return k_cyc_to_ns_floor64(cycles);
+}
+#endif /* CONFIG_BOARD_NATIVE_POSIX */
+
+/* Parse a notification and read all its parameters, like a notification
+ * handler does. Returns a checksum of the parameter values.
+ */
+static uint32_t notification_handle(const char *notif,
+				    struct at_param_list *list)
+{
+	char str[MAX_STR_LEN];
+	uint32_t array[MAX_PARAMS];
+	uint32_t checksum = 0;
+	int64_t int_val;
+	size_t len;
+	int err;
+
+	err = at_parser_params_from_str(notif, NULL, list);
+	zassert_true((err == 0) || (err == -E2BIG), "Parsing failed: %d",
+		     err);
+
+	for (size_t i = 0; i < at_params_valid_count_get(list); i++) {
+		checksum = checksum * 31 + at_params_type_get(list, i);
+
+		switch (at_params_type_get(list, i)) {
+		case AT_PARAM_TYPE_NUM_INT:
+			err = at_params_int64_get(list, i, &int_val);
+			zassert_equal(err, 0, "Failed to get integer");
+			checksum = checksum * 31 + (uint32_t)int_val;
+			break;
+
+		case AT_PARAM_TYPE_STRING:
+			len = sizeof(str);
+			err = at_params_string_get(list, i, str, &len);
+			zassert_equal(err, 0, "Failed to get string");
+			for (size_t j = 0; j < len; j++) {
+				checksum = checksum * 31 + str[j];
+			}
+			break;
+
+		case AT_PARAM_TYPE_ARRAY:
+			len = sizeof(array);
+			err = at_params_array_get(list, i, array, &len);
+			zassert_equal(err, 0, "Failed to get array");
+			for (size_t j = 0; j < len / sizeof(uint32_t); j++) {
+				checksum = checksum * 31 + array[j];
+			}
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	return checksum;
+}
+
+static void bench_run(const char *name, struct at_param_list *list,
+		      uint32_t *checksums)
+{
+	uint32_t notif_cnt = PARSE_ROUNDS * ARRAY_SIZE(notifications);
+	uint64_t start;
+	uint64_t total_ns;
+
+	alloc_cnt = 0;
+	alloc_size = 0;
+
+	start = timestamp_get();
+
+	for (size_t round = 0; round < PARSE_ROUNDS; round++) {
+		for (size_t i = 0; i < ARRAY_SIZE(notifications); i++) {
+			checksums[i] = notification_handle(notifications[i],
+							   list);
+		}
+	}
+
+	total_ns = elapsed_ns(start);
+
+	TC_PRINT("%s: %u ns per notification, %u heap allocations "
+		 "(%u bytes) per notification\n", name,
+		 (uint32_t)(total_ns / notif_cnt), alloc_cnt / notif_cnt,
+		 alloc_size / notif_cnt);
+}
+
+static void test_parse_benchmark(void)
+{
+	static struct at_param params[MAX_PARAMS];
+	static uint32_t copy_checksums[ARRAY_SIZE(notifications)];
+	static uint32_t view_checksums[ARRAY_SIZE(notifications)];
+	struct at_param_list copy_list;
+	struct at_param_list view_list;
+	int err;
+
+	err = at_params_list_init(&copy_list, MAX_PARAMS);
+	zassert_equal(err, 0, "Failed to initialize list");
+	err = at_params_list_init_views(&view_list, params, MAX_PARAMS);
+	zassert_equal(err, 0, "Failed to initialize list");
+
+	bench_run("Copied parameters", &copy_list, copy_checksums);
+	bench_run("Parameter views", &view_list, view_checksums);
+
+	zassert_equal(alloc_cnt, 0, "Heap used by parameter views");
+
+	/* Both lists must give the same parameters. */
+	for (size_t i = 0; i < ARRAY_SIZE(notifications); i++) {
+		zassert_equal(copy_checksums[i], view_checksums[i],
+			      "Different parameters of %s", notifications[i]);
+	}
+
+	at_params_list_free(&copy_list);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(at_cmd_parser_benchmark,
+			 ztest_unit_test(test_parse_benchmark)
+			 );
+
+	ztest_run_test_suite(at_cmd_parser_benchmark);
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <kernel.h>
+#include <modem/at_notif.h>
+#include <mock_at_cmd.h>
+
+#define HANDLER_CNT 4
+
+static at_cmd_handler_t dispatch;
+static int calls[HANDLER_CNT];
+
+static const char *const lte_notifs[] = { "+CEREG", "+CSCON", "%XT3412" };
+static const char *const sms_notifs[] = { "+CMT", "+CDS" };
+static const char *const cesq_notifs[] = { "%CESQ" };
+
+static void notif_handler_set(at_cmd_handler_t handler, int cmock_num_calls)
+{
+	dispatch = handler;
+}
+
+static void handler(void *context, const char *response)
+{
+	calls[(intptr_t)context]++;
+}
+
+static void self_deregistering_handler(void *context, const char *response)
+{
+	calls[(intptr_t)context]++;
+
+	TEST_ASSERT_EQUAL(0, at_notif_deregister_handler(context,
+		self_deregistering_handler));
+}
+
+static void calls_check(int c0, int c1, int c2, int c3)
+{
+	TEST_ASSERT_EQUAL(c0, calls[0]);
+	TEST_ASSERT_EQUAL(c1, calls[1]);
+	TEST_ASSERT_EQUAL(c2, calls[2]);
+	TEST_ASSERT_EQUAL(c3, calls[3]);
+
+	memset(calls, 0, sizeof(calls));
+}
+
+void setUp(void)
+{
+	memset(calls, 0, sizeof(calls));
+}
+
+void tearDown(void)
+{
+	for (intptr_t i = 0; i < HANDLER_CNT; i++) {
+		(void)at_notif_deregister_handler((void *)i, handler);
+	}
+}
+
+void test_at_notif_init(void)
+{
+	__wrap_at_cmd_set_notification_handler_Stub(notif_handler_set);
+
+	TEST_ASSERT_EQUAL(0, at_notif_init());
+	TEST_ASSERT_NOT_NULL(dispatch);
+}
+
+void test_at_notif_register_invalid(void)
+{
+	static const char *const invalid[] = { "+CEREG: 1" };
+	static const char *const empty[] = { "" };
+
+	TEST_ASSERT_EQUAL(-EINVAL, at_notif_register_handler(NULL, NULL));
+	TEST_ASSERT_EQUAL(-EINVAL, at_notif_register_prefix_handler(NULL,
+		NULL, lte_notifs, ARRAY_SIZE(lte_notifs)));
+	TEST_ASSERT_EQUAL(-EINVAL, at_notif_register_prefix_handler(NULL,
+		handler, NULL, 1));
+	TEST_ASSERT_EQUAL(-EINVAL, at_notif_register_prefix_handler(NULL,
+		handler, lte_notifs, 0));
+	TEST_ASSERT_EQUAL(-EINVAL, at_notif_register_prefix_handler(NULL,
+		handler, invalid, ARRAY_SIZE(invalid)));
+	TEST_ASSERT_EQUAL(-EINVAL, at_notif_register_prefix_handler(NULL,
+		handler, empty, ARRAY_SIZE(empty)));
+}
+
+void test_at_notif_dispatch_prefix(void)
+{
+	TEST_ASSERT_EQUAL(0, at_notif_register_handler((void *)0, handler));
+	TEST_ASSERT_EQUAL(0, at_notif_register_prefix_handler((void *)1,
+		handler, lte_notifs, ARRAY_SIZE(lte_notifs)));
+	TEST_ASSERT_EQUAL(0, at_notif_register_prefix_handler((void *)2,
+		handler, sms_notifs, ARRAY_SIZE(sms_notifs)));
+	TEST_ASSERT_EQUAL(0, at_notif_register_prefix_handler((void *)3,
+		handler, cesq_notifs, ARRAY_SIZE(cesq_notifs)));
+
+	dispatch("+CEREG: 1,\"4E21\",\"0001F3A1\",7\r\n");
+	calls_check(1, 1, 0, 0);
+
+	dispatch("%XT3412: 3600000\r\n");
+	calls_check(1, 1, 0, 0);
+
+	dispatch("+CMT: \"+4799999999\",22\r\n0791448720003023\r\n");
+	calls_check(1, 0, 1, 0);
+
+	dispatch("%CESQ: 54,2,19,2\r\n");
+	calls_check(1, 0, 0, 1);
+
+	/* Prefixes must match the whole notification ID. */
+	dispatch("+CEREGX: 1\r\n");
+	calls_check(1, 0, 0, 0);
+
+	dispatch("+CME ERROR: 513\r\n");
+	calls_check(1, 0, 0, 0);
+
+	dispatch("");
+	calls_check(1, 0, 0, 0);
+}
+
+void test_at_notif_register_twice(void)
+{
+	TEST_ASSERT_EQUAL(0, at_notif_register_prefix_handler((void *)1,
+		handler, lte_notifs, ARRAY_SIZE(lte_notifs)));
+	TEST_ASSERT_EQUAL(0, at_notif_register_prefix_handler((void *)1,
+		handler, lte_notifs, ARRAY_SIZE(lte_notifs)));
+	TEST_ASSERT_EQUAL(0, at_notif_register_handler((void *)1, handler));
+
+	dispatch("+CSCON: 1\r\n");
+	calls_check(0, 1, 0, 0);
+}
+
+void test_at_notif_deregister(void)
+{
+	TEST_ASSERT_EQUAL(0, at_notif_register_prefix_handler((void *)1,
+		handler, lte_notifs, ARRAY_SIZE(lte_notifs)));
+	TEST_ASSERT_EQUAL(0, at_notif_register_prefix_handler((void *)2,
+		handler, lte_notifs, ARRAY_SIZE(lte_notifs)));
+
+	dispatch("+CEREG: 5\r\n");
+	calls_check(0, 1, 1, 0);
+
+	TEST_ASSERT_EQUAL(0, at_notif_deregister_handler((void *)1, handler));
+
+	dispatch("+CEREG: 5\r\n");
+	calls_check(0, 0, 1, 0);
+
+	/* Handlers can deregister themselves while called. */
+	TEST_ASSERT_EQUAL(0, at_notif_register_prefix_handler((void *)3,
+		self_deregistering_handler, lte_notifs,
+		ARRAY_SIZE(lte_notifs)));
+
+	dispatch("+CEREG: 5\r\n");
+	calls_check(0, 0, 1, 1);
+
+	dispatch("+CEREG: 5\r\n");
+	calls_check(0, 0, 1, 0);
+}
+
+void test_at_notif_dispatch_max(void)
+{
+	for (intptr_t i = 0; i < HANDLER_CNT; i++) {
+		TEST_ASSERT_EQUAL(0, at_notif_register_prefix_handler(
+			(void *)i, handler, lte_notifs,
+			ARRAY_SIZE(lte_notifs)));
+	}
+
+	TEST_ASSERT_EQUAL(0, at_notif_register_handler((void *)0,
+		self_deregistering_handler));
+
+	/* Only CONFIG_AT_NOTIF_DISPATCH_MAX handlers are called. */
+	dispatch("+CEREG: 5\r\n");
+	calls_check(2, 1, 1, 0);
+
+	dispatch("+CEREG: 5\r\n");
+	calls_check(1, 1, 1, 1);
+}
+
+extern int unity_main(void);
+
+void main(void)
+{
+	(void)unity_main();
+}
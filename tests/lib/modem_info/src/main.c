@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include <modem/at_cmd.h>
+#include <modem/at_notif.h>
+#include <modem/modem_info.h>
+
+#define NETWORK_TTL_MS CONFIG_MODEM_INFO_CACHE_NETWORK_TTL
+#define AT_CMD_LATENCY_US 100
+
+struct at_response {
+	const char *cmd;
+	const char *rsp;
+	int count;
+	int err;
+};
+
+static struct at_response responses[] = {
+	{ "AT%XCBAND", "%XCBAND: 20\r\n" },
+	{ "AT%XCBAND=?", "%XCBAND: (1,2,3,4,8,12,13,20)\r\n" },
+	{ "AT+CGDCONT?", "+CGDCONT: 0,\"IP\",\"telenor.smart\",\"10.0.0.1\",0,0\r\n" },
+	{ "AT+CEMODE?", "+CEMODE: 2\r\n" },
+	{ "AT+COPS?", "+COPS: 0,2,\"24201\",7\r\n" },
+	{ "AT+CEREG?", "+CEREG: 2,1,\"0BBB\",\"012BEEF\",7\r\n" },
+	{ "AT%XSYSTEMMODE?", "%XSYSTEMMODE: 1,0,1,0\r\n" },
+	{ "AT+CCLK?", "+CCLK: \"21/08/02,10:12:34+08\"\r\n" },
+	{ "AT%XSIM?", "%XSIM: 1\r\n" },
+	{ "AT+CRSM=176,12258,0,0,10", "+CRSM: 144,0,\"89310410106543789301\"\r\n" },
+	{ "AT+CIMI", "244060000000000\r\n" },
+	{ "AT+CGMR", "mfw_nrf9160_1.3.0\r\n" },
+	{ "AT+CGSN", "352656100000000\r\n" },
+	{ "AT%XVBAT", "%XVBAT: 3600\r\n" },
+};
+
+/* Number of distinct commands sent by modem_info_params_get() */
+#define PARAMS_CMDS ARRAY_SIZE(responses)
+/* Number of values read by modem_info_params_get() */
+#define PARAMS_VALUES 18
+/* Commands for values that are never cached */
+#define PARAMS_VOLATILE_CMDS 2
+/* Commands for values that do not change */
+#define PARAMS_STATIC_CMDS 4
+
+static int cmds_sent;
+
+/* Stubs and mocks */
+static struct at_response *response_find(const char *cmd)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(responses); i++) {
+		if (strcmp(responses[i].cmd, cmd) == 0) {
+			return &responses[i];
+		}
+	}
+	return NULL;
+}
+
+int at_cmd_write(const char *const cmd, char *buf, size_t buf_len,
+		 enum at_cmd_state *state)
+{
+	struct at_response *response = response_find(cmd);
+
+	zassert_not_null(response, "Unexpected command %s", cmd);
+
+	k_busy_wait(AT_CMD_LATENCY_US);
+	response->count++;
+	cmds_sent++;
+
+	if (response->err) {
+		return response->err;
+	}
+
+	zassert_true(strlen(response->rsp) < buf_len, NULL);
+	strcpy(buf, response->rsp);
+	return 0;
+}
+
+int at_notif_register_prefix_handler(void *context, at_notif_handler_t handler,
+				     const char *const *prefixes,
+				     size_t count)
+{
+	return 0;
+}
+
+static void reset(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(responses); i++) {
+		responses[i].count = 0;
+		responses[i].err = 0;
+	}
+	cmds_sent = 0;
+	modem_info_cache_clear();
+	modem_info_stats_reset();
+}
+
+static void test_init(void)
+{
+	zassert_equal(modem_info_init(), 0, NULL);
+}
+
+static void test_params_get(void)
+{
+	struct modem_param_info modem;
+	struct modem_info_stats stats;
+
+	reset();
+
+	zassert_equal(modem_info_params_init(&modem), 0, NULL);
+	zassert_equal(modem_info_params_get(&modem), 0, NULL);
+
+	/* every command is sent once, also when several values are read
+	 * from the response
+	 */
+	for (size_t i = 0; i < ARRAY_SIZE(responses); i++) {
+		zassert_equal(responses[i].count, 1, "%s sent %d times",
+			      responses[i].cmd, responses[i].count);
+	}
+
+	zassert_equal(modem.network.current_band.value, 20, NULL);
+	zassert_equal(modem.network.ue_mode.value, 2, NULL);
+	zassert_equal(modem.network.lte_mode.value, 1, NULL);
+	zassert_equal(modem.network.nbiot_mode.value, 0, NULL);
+	zassert_equal(modem.network.gps_mode.value, 1, NULL);
+	zassert_equal(modem.network.area_code.value, 0x0BBB, NULL);
+	zassert_equal(modem.network.cellid_dec, 0x012BEEF, NULL);
+	zassert_equal(modem.network.mcc.value, 242, NULL);
+	zassert_equal(modem.network.mnc.value, 1, NULL);
+	zassert_true(strncmp(modem.network.sup_band.value_string,
+			     "(1,2,3,4,8,12,13,20)",
+			     strlen("(1,2,3,4,8,12,13,20)")) == 0, NULL);
+	zassert_true(strcmp(modem.network.ip_address.value_string,
+			    "10.0.0.1") == 0, NULL);
+	zassert_true(strcmp(modem.network.apn.value_string,
+			    "telenor.smart") == 0, NULL);
+	zassert_true(strcmp(modem.network.date_time.value_string,
+			    "21/08/02,10:12:34+08") == 0, NULL);
+	zassert_equal(modem.sim.uicc.value, 1, NULL);
+	zassert_true(strcmp(modem.sim.iccid.value_string,
+			    "98134001015634873910") == 0, NULL);
+	zassert_true(strcmp(modem.sim.imsi.value_string,
+			    "244060000000000") == 0, NULL);
+	zassert_true(strcmp(modem.device.modem_fw.value_string,
+			    "mfw_nrf9160_1.3.0") == 0, NULL);
+	zassert_true(strcmp(modem.device.imei.value_string,
+			    "352656100000000") == 0, NULL);
+	zassert_equal(modem.device.battery.value, 3600, NULL);
+
+	modem_info_stats_get(&stats);
+	zassert_equal(stats.values, PARAMS_VALUES, NULL);
+	zassert_equal(stats.at_cmds, PARAMS_CMDS, NULL);
+	zassert_equal(stats.cache_hits, 0, NULL);
+	zassert_true(stats.latency_max_us >= AT_CMD_LATENCY_US, NULL);
+	zassert_true(stats.latency_total_us >=
+		     PARAMS_CMDS * AT_CMD_LATENCY_US, NULL);
+
+	TC_PRINT("%u values read with %u AT commands, %u us\n",
+		 stats.values, stats.at_cmds, (uint32_t)stats.latency_total_us);
+}
+
+static void test_params_get_cached(void)
+{
+	struct modem_param_info modem;
+	struct modem_info_stats stats;
+
+	reset();
+
+	zassert_equal(modem_info_params_init(&modem), 0, NULL);
+	zassert_equal(modem_info_params_get(&modem), 0, NULL);
+	zassert_equal(cmds_sent, PARAMS_CMDS, NULL);
+
+	/* only values that change all the time are read again */
+	cmds_sent = 0;
+	zassert_equal(modem_info_params_get(&modem), 0, NULL);
+	zassert_equal(cmds_sent, PARAMS_VOLATILE_CMDS, NULL);
+	zassert_equal(response_find("AT+CCLK?")->count, 2, NULL);
+	zassert_equal(response_find("AT%XVBAT")->count, 2, NULL);
+	zassert_equal(modem.device.battery.value, 3600, NULL);
+	zassert_equal(modem.network.mcc.value, 242, NULL);
+
+	/* network information expires */
+	k_sleep(K_MSEC(NETWORK_TTL_MS + 1));
+	cmds_sent = 0;
+	zassert_equal(modem_info_params_get(&modem), 0, NULL);
+	zassert_equal(cmds_sent, PARAMS_CMDS - PARAMS_STATIC_CMDS, NULL);
+	zassert_equal(response_find("AT+CEREG?")->count, 2, NULL);
+	zassert_equal(response_find("AT+CGMR")->count, 1, NULL);
+
+	modem_info_stats_get(&stats);
+	zassert_equal(stats.values, 3 * PARAMS_VALUES, NULL);
+	zassert_equal(stats.cache_hits,
+		      2 * PARAMS_CMDS - PARAMS_VOLATILE_CMDS -
+		      (PARAMS_CMDS - PARAMS_STATIC_CMDS), NULL);
+
+	/* values that do not change are read after clearing the cache */
+	modem_info_cache_clear();
+	cmds_sent = 0;
+	zassert_equal(modem_info_params_get(&modem), 0, NULL);
+	zassert_equal(cmds_sent, PARAMS_CMDS, NULL);
+}
+
+static void test_single_get(void)
+{
+	char buf[MODEM_INFO_MAX_RESPONSE_SIZE];
+	uint16_t value;
+
+	reset();
+
+	zassert_equal(modem_info_string_get(MODEM_INFO_IMEI, buf, sizeof(buf)),
+		      strlen("352656100000000"), NULL);
+	zassert_equal(modem_info_string_get(MODEM_INFO_IMEI, buf, sizeof(buf)),
+		      strlen("352656100000000"), NULL);
+	zassert_equal(response_find("AT+CGSN")->count, 1, NULL);
+
+	zassert_equal(modem_info_short_get(MODEM_INFO_CUR_BAND, &value),
+		      sizeof(value), NULL);
+	zassert_equal(modem_info_string_get(MODEM_INFO_CUR_BAND, buf,
+					    sizeof(buf)), 2, NULL);
+	zassert_equal(response_find("AT%XCBAND")->count, 1, NULL);
+
+	zassert_equal(modem_info_short_get(MODEM_INFO_BATTERY, &value),
+		      sizeof(value), NULL);
+	zassert_equal(modem_info_short_get(MODEM_INFO_BATTERY, &value),
+		      sizeof(value), NULL);
+	zassert_equal(response_find("AT%XVBAT")->count, 2, NULL);
+	zassert_equal(value, 3600, NULL);
+}
+
+static void test_batch_error(void)
+{
+	struct modem_param_info modem;
+	struct lte_param *params[] = {
+		&modem.network.cellid_hex,
+		&modem.network.current_operator,
+		&modem.network.area_code,
+	};
+
+	reset();
+	zassert_equal(modem_info_params_init(&modem), 0, NULL);
+
+	response_find("AT+CEREG?")->err = -EIO;
+	memset(modem.network.current_operator.value_string, 0,
+	       sizeof(modem.network.current_operator.value_string));
+
+	/* the other values are read, and the failed response is not cached */
+	zassert_equal(modem_info_batch_get(params, ARRAY_SIZE(params)), -EIO,
+		      NULL);
+	zassert_true(strcmp(modem.network.current_operator.value_string,
+			    "24201") == 0, NULL);
+	zassert_equal(response_find("AT+CEREG?")->count, 1, NULL);
+
+	response_find("AT+CEREG?")->err = 0;
+	zassert_equal(modem_info_batch_get(params, ARRAY_SIZE(params)), 0,
+		      NULL);
+	zassert_equal(response_find("AT+CEREG?")->count, 2, NULL);
+	zassert_equal(response_find("AT+COPS?")->count, 1, NULL);
+	zassert_true(strcmp(modem.network.cellid_hex.value_string,
+			    "012BEEF") == 0, NULL);
+
+	params[1] = NULL;
+	zassert_equal(modem_info_batch_get(params, ARRAY_SIZE(params)),
+		      -EINVAL, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(modem_info_test,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_params_get),
+			 ztest_unit_test(test_params_get_cached),
+			 ztest_unit_test(test_single_get),
+			 ztest_unit_test(test_batch_error)
+			 );
+
+	ztest_run_test_suite(modem_info_test);
+}
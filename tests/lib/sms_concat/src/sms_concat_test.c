@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <unity.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <kernel.h>
+#include <modem/sms.h>
+#include <mock_at_cmd.h>
+
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+#include "native_rtc.h"
+#endif
+
+/* Number of times the PDUs are replayed in the benchmark. */
+#define REPLAY_ROUNDS 1000
+
+static int test_handle;
+static bool at_cmd_ignored;
+static int sms_callback_cnt;
+static struct sms_data sms_received;
+
+/* sms_at_handler() is implemented in the library and we'll call it directly
+ * to fake received SMS message
+ */
+extern void sms_at_handler(void *context, const char *at_notif);
+
+/* Message of 291 characters in 2 parts, reference number 126, part 1 */
+static const char cmt_291_1[] = "+CMT: \"+1234567890\",22\r\n"
+	"0791534874894310440A912143658709000012201232054480A00500037E020162B219AD66BBE172B0986C46ABD96EB81C2C269BD16AB61B2E078BC966B49AED86CBC162B219AD66BBE172B0986C46ABD96EB81C2C269BD16AB61B2E078BC966B49AED86CBC162B219AD66BBE172B0986C46ABD96EB81C2C269BD16AB61B2E078BC966B49AED86CBC162B219AD66BBE172B0986C46ABD96EB81C2C269BD16AB61B2E078BC966\r\n";
+
+/* Part 2 */
+static const char cmt_291_2[] = "+CMT: \"+1234567890\",22\r\n"
+	"0791534874894320440A912143658709000012201232054480910500037E02026835DB0D9783C564335ACD76C3E56031D98C56B3DD7039584C36A3D56C375C0E1693CD6835DB0D9783C564335ACD76C3E56031D98C56B3DD7039584C36A3D56C375C0E1693CD6835DB0D9783C564335ACD76C3E56031D98C56B3DD7039584C36A3D56C375C0E1693CD6835DB0D9783C564335ACD76C3E56031\r\n";
+
+/* Message of 755 characters in 5 parts, reference number 128, part 1 */
+static const char cmt_755_1[] = "+CMT: \"+1234567890\",22\r\n"
+	"0791534874894310440A912143658709000012202280655080A0050003800501C2E231B96C3EA3D3EA35BBED7EC3E3F239BD6EBFE3F37A50583C2697CD67745ABD66B7DD6F785C3EA7D7ED777C5E0F0A8BC7E4B2F98C4EABD7ECB6FB0D8FCBE7F4BAFD8ECFEB4161F1985C369FD169F59ADD76BFE171F99C5EB7DFF1793D282C1E93CBE6333AAD5EB3DBEE373C2E9FD3EBF63B3EAF0785C56372D97C46A7D56B76DBFD86C7E5\r\n";
+
+/* Part 2 */
+static const char cmt_755_2[] = "+CMT: \"+1234567890\",22\r\n"
+	"0791534874894370440A912143658709000012202280656080A0050003800502E6F4BAFD8ECFEB4161F1985C369FD169F59ADD76BFE171F99C5EB7DFF1793D282C1E93CBE6333AAD5EB3DBEE373C2E9FD3EBF63B3EAF0785C56372D97C46A7D56B76DBFD86C7E5737ADD7EC7E7F5A0B0784C2E9BCFE8B47ACD6EBBDFF0B87C4EAFDBEFF8BC1E14168FC965F3199D56AFD96DF71B1E97CFE975FB1D9FD783C2E231B96C3EA3D3\r\n";
+
+/* Part 3 */
+static const char cmt_755_3[] = "+CMT: \"+1234567890\",22\r\n"
+	"0791534874894310440A912143658709000012202280656080A0050003800503D46B76DBFD86C7E5737ADD7EC7E7F5A0B0784C2E9BCFE8B47ACD6EBBDFF0B87C4EAFDBEFF8BC1E14168FC965F3199D56AFD96DF71B1E97CFE975FB1D9FD783C2E231B96C3EA3D3EA35BBED7EC3E3F239BD6EBFE3F37A50583C2697CD67745ABD66B7DD6F785C3EA7D7ED777C5E0F0A8BC7E4B2F98C4EABD7ECB6FB0D8FCBE7F4BAFD8ECFEB41\r\n";
+
+/* Part 4 */
+static const char cmt_755_4[] = "+CMT: \"+1234567890\",22\r\n"
+	"0791534874894370440A912143658709000012202280656080A0050003800504C2E231B96C3EA3D3EA35BBED7EC3E3F239BD6EBFE3F37A50583C2697CD67745ABD66B7DD6F785C3EA7D7ED777C5E0F0A8BC7E4B2F98C4EABD7ECB6FB0D8FCBE7F4BAFD8ECFEB4161F1985C369FD169F59ADD76BFE171F99C5EB7DFF1793D282C1E93CBE6333AAD5EB3DBEE373C2E9FD3EBF63B3EAF0785C56372D97C46A7D56B76DBFD86C7E5\r\n";
+
+/* Part 5 */
+static const char cmt_755_5[] = "+CMT: \"+1234567890\",22\r\n"
+	"0791534874894310440A91214365870900001220228065608096050003800505E6F4BAFD8ECFEB4161F1985C369FD169F59ADD76BFE171F99C5EB7DFF1793D282C1E93CBE6333AAD5EB3DBEE373C2E9FD3EBF63B3EAF0785C56372D97C46A7D56B76DBFD86C7E5737ADD7EC7E7F5A0B0784C2E9BCFE8B47ACD6EBBDFF0B87C4EAFDBEFF8BC1E14168FC965F3199D56AFD96DF71B1E97CFE975FB1D9FD703\r\n";
+
+/* Message of 163 characters in 2 parts, reference number 81, part 1 */
+static const char cmt_163_1[] = "+CMT: \"+1234567890\",22\r\n"
+	"0791534874894370440A912143658709000012202280655080A005000351020162B219AD66BBE172B0986C46ABD96EB81C2C269BD16AB61B2E078BC966B49AED86CBC162B219AD66BBE172B0986C46ABD96EB81C2C269BD16AB61B2E078BC966B49AED86CBC162B219AD66BBE172B0986C46ABD96EB81C2C269BD16AB61B2E078BC966B49AED86CBC162B219AD66BBE172B0986C46ABD96EB81C2C269BD16AB61B2E078BC936\r\n";
+
+/* Part 2 */
+static const char cmt_163_2[] = "+CMT: \"+1234567890\",22\r\n"
+	"0791534874894370440A9121436587090000122022806550801305000351020236E5986C46ABD96EB81C0C\r\n";
+
+/* Part 1 of the 755 character message with the total number of parts changed to 6 */
+static const char cmt_755_1_of_6[] = "+CMT: \"+1234567890\",22\r\n"
+	"0791534874894310440A912143658709000012202280655080A0050003800601C2E231B96C3EA3D3EA35BBED7EC3E3F239BD6EBFE3F37A50583C2697CD67745ABD66B7DD6F785C3EA7D7ED777C5E0F0A8BC7E4B2F98C4EABD7ECB6FB0D8FCBE7F4BAFD8ECFEB4161F1985C369FD169F59ADD76BFE171F99C5EB7DFF1793D282C1E93CBE6333AAD5EB3DBEE373C2E9FD3EBF63B3EAF0785C56372D97C46A7D56B76DBFD86C7E5\r\n";
+
+/* Message that is not concatenated */
+static const char cmt_single[] = "+CMT: \"+1234567890\",22\r\n"
+	"0791534874894320040A91214365870900001220900285438003CD771A\r\n";
+
+/* Parts of all messages in the order they are replayed in the benchmark. */
+static const char *const replay_pdus[] = {
+	cmt_291_1, cmt_755_1, cmt_755_4, cmt_291_2, cmt_163_2,
+	cmt_755_2, cmt_163_1, cmt_755_3, cmt_755_5, cmt_single,
+};
+
+/* Number of messages delivered for each round of replay_pdus. */
+#define REPLAY_MSGS 4
+
+/** Callback that SMS library will call when a message is received. */
+static void sms_callback(struct sms_data *const data, void *context)
+{
+	sms_callback_cnt++;
+	memcpy(&sms_received, data, sizeof(sms_received));
+}
+
+void setUp(void)
+{
+	char resp[] = "+CNMI: 0,0,0,0,1\r\n";
+
+	sms_callback_cnt = 0;
+	at_cmd_ignored = false;
+	memset(&sms_received, 0, sizeof(sms_received));
+
+	__wrap_at_cmd_write_ExpectAndReturn("AT+CNMI?", NULL, 0, NULL, 0);
+	__wrap_at_cmd_write_IgnoreArg_buf();
+	__wrap_at_cmd_write_IgnoreArg_buf_len();
+	__wrap_at_cmd_write_ReturnArrayThruPtr_buf(resp, sizeof(resp));
+
+	__wrap_at_cmd_write_ExpectAndReturn("AT+CNMI=3,2,0,1", NULL, 0, NULL, 0);
+
+	test_handle = sms_register_listener(sms_callback, NULL);
+	TEST_ASSERT_EQUAL(0, test_handle);
+}
+
+void tearDown(void)
+{
+	/* Unregistering also drops the partially received messages. */
+	if (!at_cmd_ignored) {
+		__wrap_at_cmd_write_ExpectAndReturn("AT+CNMI=0,0,0,0", NULL, 0, NULL, 0);
+		__wrap_at_cmd_write_IgnoreArg_buf();
+		__wrap_at_cmd_write_IgnoreArg_buf_len();
+	}
+
+	sms_unregister_listener(test_handle);
+}
+
+/**
+ * Helper function to receive a PDU, which is always acknowledged, and
+ * check whether a message was delivered.
+ */
+static void recv_helper(const char *pdu, bool delivered)
+{
+	int callback_cnt = sms_callback_cnt;
+
+	__wrap_at_cmd_write_ExpectAndReturn("AT+CNMA=1", NULL, 0, NULL, 0);
+	sms_at_handler(NULL, pdu);
+
+	TEST_ASSERT_EQUAL(callback_cnt + (delivered ? 1 : 0), sms_callback_cnt);
+}
+
+/** Fill a buffer by repeating a pattern up to the given length. */
+static void text_fill(char *buf, const char *pattern, size_t len)
+{
+	size_t pattern_len = strlen(pattern);
+
+	for (size_t i = 0; i < len; i++) {
+		buf[i] = pattern[i % pattern_len];
+	}
+	buf[len] = '\0';
+}
+
+static void check_msg_291(void)
+{
+	char text[292];
+
+	text_fill(text, "1234567890", 291);
+
+	TEST_ASSERT_EQUAL(SMS_TYPE_DELIVER, sms_received.type);
+	TEST_ASSERT_EQUAL(291, sms_received.payload_len);
+	TEST_ASSERT_EQUAL_STRING(text, sms_received.payload);
+
+	TEST_ASSERT_EQUAL_STRING("1234567890",
+		sms_received.header.deliver.originating_address.address_str);
+	TEST_ASSERT_TRUE(sms_received.header.deliver.concatenated.present);
+	TEST_ASSERT_EQUAL(126, sms_received.header.deliver.concatenated.ref_number);
+	TEST_ASSERT_EQUAL(2, sms_received.header.deliver.concatenated.total_msgs);
+	TEST_ASSERT_EQUAL(0, sms_received.header.deliver.concatenated.seq_number);
+
+	/* Header is the one of the first part */
+	TEST_ASSERT_EQUAL(21, sms_received.header.deliver.time.day);
+	TEST_ASSERT_EQUAL(23, sms_received.header.deliver.time.hour);
+	TEST_ASSERT_EQUAL(50, sms_received.header.deliver.time.minute);
+	TEST_ASSERT_EQUAL(44, sms_received.header.deliver.time.second);
+}
+
+static void check_msg_755(void)
+{
+	char text[756];
+
+	text_fill(text, "abcdefghijklmnopqrstuvwxyz ", 755);
+
+	TEST_ASSERT_EQUAL(755, sms_received.payload_len);
+	TEST_ASSERT_EQUAL_STRING(text, sms_received.payload);
+
+	TEST_ASSERT_EQUAL(128, sms_received.header.deliver.concatenated.ref_number);
+	TEST_ASSERT_EQUAL(5, sms_received.header.deliver.concatenated.total_msgs);
+	TEST_ASSERT_EQUAL(0, sms_received.header.deliver.concatenated.seq_number);
+
+	/* Header is the one of the first part, other parts have a different timestamp */
+	TEST_ASSERT_EQUAL(5, sms_received.header.deliver.time.second);
+}
+
+static void check_msg_163(void)
+{
+	char text[164];
+
+	text_fill(text, "1234567890", 152);
+	strcat(text, "\xA4" "1234567890");
+
+	TEST_ASSERT_EQUAL(163, sms_received.payload_len);
+	TEST_ASSERT_EQUAL_STRING(text, sms_received.payload);
+	TEST_ASSERT_EQUAL(81, sms_received.header.deliver.concatenated.ref_number);
+}
+
+/** Message that is not concatenated is delivered as it is. */
+void test_concat_not_concatenated(void)
+{
+	recv_helper(cmt_single, true);
+
+	TEST_ASSERT_EQUAL_STRING("Moi", sms_received.payload);
+	TEST_ASSERT_FALSE(sms_received.header.deliver.concatenated.present);
+}
+
+/** Parts received in order are delivered once as a complete message. */
+void test_concat_in_order(void)
+{
+	recv_helper(cmt_291_1, false);
+	recv_helper(cmt_291_2, true);
+
+	check_msg_291();
+}
+
+/** Parts received in reverse order are delivered with the header of the first part. */
+void test_concat_reverse_order(void)
+{
+	recv_helper(cmt_291_2, false);
+	recv_helper(cmt_291_1, true);
+
+	check_msg_291();
+}
+
+/** Message with the maximum number of parts received in random order. */
+void test_concat_max_parts_random_order(void)
+{
+	recv_helper(cmt_755_4, false);
+	recv_helper(cmt_755_1, false);
+	recv_helper(cmt_755_5, false);
+	recv_helper(cmt_755_2, false);
+	recv_helper(cmt_755_3, true);
+
+	check_msg_755();
+}
+
+/** Part received twice is ignored. */
+void test_concat_duplicate_part(void)
+{
+	recv_helper(cmt_291_1, false);
+	recv_helper(cmt_291_1, false);
+	recv_helper(cmt_291_2, true);
+
+	check_msg_291();
+
+	/* Duplicate part after the message was delivered starts a new message */
+	recv_helper(cmt_291_2, false);
+}
+
+/** Parts of two messages received interleaved. */
+void test_concat_interleaved(void)
+{
+	recv_helper(cmt_755_1, false);
+	recv_helper(cmt_291_2, false);
+	recv_helper(cmt_755_4, false);
+	recv_helper(cmt_755_2, false);
+	recv_helper(cmt_291_1, true);
+
+	check_msg_291();
+
+	recv_helper(cmt_755_5, false);
+	recv_helper(cmt_755_3, true);
+
+	check_msg_755();
+}
+
+/** Message with the oldest first part is dropped when all slots are in use. */
+void test_concat_slot_eviction(void)
+{
+	recv_helper(cmt_291_1, false);
+	k_sleep(K_MSEC(10));
+	recv_helper(cmt_755_1, false);
+	k_sleep(K_MSEC(10));
+
+	/* Message of 291 characters is dropped */
+	recv_helper(cmt_163_1, false);
+
+	/* Message of 755 characters is dropped, this part starts a new message */
+	recv_helper(cmt_291_2, false);
+
+	recv_helper(cmt_163_2, true);
+	check_msg_163();
+
+	recv_helper(cmt_755_2, false);
+	recv_helper(cmt_755_3, false);
+	recv_helper(cmt_755_4, false);
+	recv_helper(cmt_755_5, false);
+}
+
+/** Message that is not completed in time is dropped. */
+void test_concat_timeout(void)
+{
+	recv_helper(cmt_291_1, false);
+	k_sleep(K_SECONDS(CONFIG_SMS_CONCAT_TIMEOUT_SEC));
+
+	/* First part is dropped, this part starts a new message */
+	recv_helper(cmt_291_2, false);
+	k_sleep(K_SECONDS(CONFIG_SMS_CONCAT_TIMEOUT_SEC - 1));
+
+	recv_helper(cmt_291_1, true);
+	check_msg_291();
+}
+
+/** Parts of a message with more parts than can be reassembled are delivered separately. */
+void test_concat_too_many_parts(void)
+{
+	recv_helper(cmt_755_1_of_6, true);
+
+	TEST_ASSERT_EQUAL(153, sms_received.payload_len);
+	TEST_ASSERT_TRUE(sms_received.header.deliver.concatenated.present);
+	TEST_ASSERT_EQUAL(6, sms_received.header.deliver.concatenated.total_msgs);
+	TEST_ASSERT_EQUAL(1, sms_received.header.deliver.concatenated.seq_number);
+}
+
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+/* Simulated time does not advance while code is executed, use host time. */
+static uint64_t timestamp_get(void)
+{
+	return native_rtc_gettime_us(RTC_CLOCK_REAL);
+}
+
+static uint64_t elapsed_ns(uint64_t start)
+{
+	return (timestamp_get() - start) * NSEC_PER_USEC;
+}
+#else
+static uint64_t timestamp_get(void)
+{
+	return k_cycle_get_32();
+}
+
+static uint64_t elapsed_ns(uint64_t start)
+{
+	uint32_t cycles = k_cycle_get_32() - (uint32_t)start;
+
+	return k_cyc_to_ns_floor64(cycles);
+}
+#endif /* CONFIG_BOARD_NATIVE_POSIX */
+
+/**
+ * Replays the parts of three interleaved concatenated messages and a single message,
+ * never having more than two messages partially received,
+ * and reports the time spent per PDU including decoding and reassembly.
+ */
+void test_concat_replay_benchmark(void)
+{
+	uint64_t start;
+	uint64_t time_ns;
+
+	/* AT commands are not checked in the benchmark */
+	__wrap_at_cmd_write_IgnoreAndReturn(0);
+	at_cmd_ignored = true;
+
+	start = timestamp_get();
+
+	for (int round = 0; round < REPLAY_ROUNDS; round++) {
+		for (size_t i = 0; i < ARRAY_SIZE(replay_pdus); i++) {
+			sms_at_handler(NULL, replay_pdus[i]);
+		}
+	}
+
+	time_ns = elapsed_ns(start);
+
+	TEST_ASSERT_EQUAL(REPLAY_ROUNDS * REPLAY_MSGS, sms_callback_cnt);
+
+	/* Last message delivered in every round is the one that is not concatenated */
+	TEST_ASSERT_EQUAL_STRING("Moi", sms_received.payload);
+
+	printk("Replayed %d PDUs, %u ns per PDU\n",
+	       (int)(REPLAY_ROUNDS * ARRAY_SIZE(replay_pdus)),
+	       (uint32_t)(time_ns / (REPLAY_ROUNDS * ARRAY_SIZE(replay_pdus))));
+}
+
+/* It is required to be added to each test. That is because unity is using
+ * different main signature (returns int) and zephyr expects main which does
+ * not return value.
+ */
+extern int unity_main(void);
+
+void main(void)
+{
+	(void)unity_main();
+}
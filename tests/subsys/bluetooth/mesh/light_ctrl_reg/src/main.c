@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdlib.h>
+#include <ztest.h>
+#include <light_ctrl_reg_fixed.h> // private header from the source folder
+
+/* Regulator step interval (in milliseconds). */
+#define REG_INT 100
+
+/* Number of regulator steps in every precision test run. */
+#define REG_STEPS 200
+
+/* Number of precision test runs for every set of coefficients. */
+#define REG_RUNS 500
+
+/* Largest illuminance (in centilux). */
+#define CENTI_LUX_MAX 16777214
+
+/* Largest accepted difference from the reference regulator output. */
+#define REG_TOLERANCE 4
+
+struct reg_cfg {
+	float kiu;
+	float kid;
+	float kpu;
+	float kpd;
+	uint8_t accuracy;
+};
+
+static const struct reg_cfg reg_cfgs[] = {
+	{ .kiu = 250, .kid = 25, .kpu = 80, .kpd = 80, .accuracy = 2 },
+	{ .kiu = 1000, .kid = 1000, .kpu = 1000, .kpd = 1000, .accuracy = 0 },
+	{ .kiu = 0.5, .kid = 0.25, .kpu = 0.1, .kpd = 0.1, .accuracy = 10 },
+	{ .kiu = 1, .kid = 1, .kpu = 0, .kpd = 0, .accuracy = 100 },
+	{ .kiu = 0, .kid = 0, .kpu = 1000, .kpd = 1000, .accuracy = 2 },
+};
+
+static uint32_t rand_state;
+
+/* Deterministic pseudo random numbers, so that failures can be reproduced. */
+static uint32_t rand_get(uint32_t max)
+{
+	rand_state = rand_state * 1103515245 + 12345;
+
+	return (rand_state >> 1) % (max + 1);
+}
+
+/* Reference regulator step, in double precision. */
+static uint16_t reg_ref_step(double *i, const struct reg_cfg *cfg,
+			     double target, double ambient)
+{
+	double error = target - ambient;
+	double accuracy = (cfg->accuracy * target) / (2 * 100.0);
+	double input;
+	double kp, ki;
+
+	if (error > accuracy) {
+		input = error - accuracy;
+	} else if (error < -accuracy) {
+		input = error + accuracy;
+	} else {
+		input = 0.0;
+	}
+
+	if (input >= 0) {
+		kp = cfg->kpu;
+		ki = cfg->kiu;
+	} else {
+		kp = cfg->kpd;
+		ki = cfg->kid;
+	}
+
+	*i += (input * ki) * ((double)REG_INT / (double)MSEC_PER_SEC);
+	*i = CLAMP(*i, 0, UINT16_MAX);
+
+	return CLAMP(*i + input * kp, 0, UINT16_MAX);
+}
+
+static void test_coeff(void)
+{
+	int32_t one = reg_fixed_coeff(1.0f, MSEC_PER_SEC);
+
+	zassert_equal(reg_fixed_coeff(0.0f, MSEC_PER_SEC), 0, "Zero coeff");
+	zassert_within(one, (1ULL << REG_FIXED_FRAC_BITS) / REG_FIXED_LUX_SCALE,
+		       1, "Wrong unit coeff %d", one);
+	zassert_within(reg_fixed_coeff(1.0f, REG_INT), one / 10, 1,
+		       "Coeff not scaled by interval");
+	zassert_within(reg_fixed_coeff(-250.0f, MSEC_PER_SEC), -250 * one, 250,
+		       "Wrong negative coeff");
+	zassert_equal(reg_fixed_coeff(1e9f, MSEC_PER_SEC),
+		      reg_fixed_coeff(REG_FIXED_COEFF_MAX, MSEC_PER_SEC),
+		      "Coeff not clamped");
+	zassert_equal(reg_fixed_coeff(-1e9f, MSEC_PER_SEC),
+		      reg_fixed_coeff(-REG_FIXED_COEFF_MAX, MSEC_PER_SEC),
+		      "Negative coeff not clamped");
+}
+
+static void test_input(void)
+{
+	/* 1 lux error is 10000 input units: */
+	zassert_equal(reg_fixed_input(200, 100, 0), 10000, NULL);
+	zassert_equal(reg_fixed_input(100, 200, 0), -10000, NULL);
+	zassert_equal(reg_fixed_input(100, 100, 0), 0, NULL);
+
+	/* The dead zone of 10 % of 1000 lux is 50 lux up and down: */
+	zassert_equal(reg_fixed_input(100000, 95000, 10), 0, NULL);
+	zassert_equal(reg_fixed_input(100000, 105000, 10), 0, NULL);
+	zassert_equal(reg_fixed_input(100000, 94999, 10), 100, NULL);
+	zassert_equal(reg_fixed_input(100000, 105001, 10), -100, NULL);
+
+	/* Extreme values don't overflow: */
+	zassert_equal(reg_fixed_input(CENTI_LUX_MAX, 0, 0),
+		      CENTI_LUX_MAX * REG_FIXED_CENTI_LUX_SCALE, NULL);
+	zassert_equal(reg_fixed_input(0, CENTI_LUX_MAX, 100),
+		      -CENTI_LUX_MAX * REG_FIXED_CENTI_LUX_SCALE, NULL);
+	zassert_equal(reg_fixed_input(CENTI_LUX_MAX, 0, 100),
+		      CENTI_LUX_MAX * REG_FIXED_CENTI_LUX_SCALE / 2, NULL);
+}
+
+static void test_step_limits(void)
+{
+	int32_t k = reg_fixed_coeff(REG_FIXED_COEFF_MAX, MSEC_PER_SEC);
+	int32_t input = CENTI_LUX_MAX * REG_FIXED_CENTI_LUX_SCALE;
+	int64_t i = 0;
+
+	zassert_equal(reg_fixed_step(&i, input, k, k), UINT16_MAX, NULL);
+	zassert_equal(i, (int64_t)UINT16_MAX << REG_FIXED_FRAC_BITS,
+		      "Integral sum not clamped");
+
+	zassert_equal(reg_fixed_step(&i, -input, k, k), 0, NULL);
+	zassert_equal(i, 0, "Integral sum not clamped");
+
+	zassert_equal(reg_fixed_step(&i, 0, k, k), 0, NULL);
+}
+
+static void test_step_precision(void)
+{
+	int max_diff = 0;
+
+	rand_state = 1;
+
+	for (int c = 0; c < ARRAY_SIZE(reg_cfgs); c++) {
+		const struct reg_cfg *cfg = &reg_cfgs[c];
+		int32_t kiu = reg_fixed_coeff(cfg->kiu, REG_INT);
+		int32_t kid = reg_fixed_coeff(cfg->kid, REG_INT);
+		int32_t kpu = reg_fixed_coeff(cfg->kpu, MSEC_PER_SEC);
+		int32_t kpd = reg_fixed_coeff(cfg->kpd, MSEC_PER_SEC);
+
+		for (int run = 0; run < REG_RUNS; run++) {
+			/* Every other run in the range of indoor lighting: */
+			uint32_t max = (run & 1) ? CENTI_LUX_MAX : 100000;
+			uint32_t target = rand_get(max);
+			uint32_t ambient = rand_get(max);
+			int64_t i = 0;
+			double ref_i = 0;
+
+			for (int step = 0; step < REG_STEPS; step++) {
+				int32_t input = reg_fixed_input(target, ambient,
+								cfg->accuracy);
+				uint16_t ref = reg_ref_step(&ref_i, cfg,
+							    target / 100.0,
+							    ambient / 100.0);
+				uint16_t out = (input >= 0) ?
+					reg_fixed_step(&i, input, kpu, kiu) :
+					reg_fixed_step(&i, input, kpd, kid);
+				int diff = abs((int)out - (int)ref);
+
+				zassert_true(diff <= REG_TOLERANCE,
+					     "cfg %d: target %u ambient %u step %d: %u, expected %u",
+					     c, target, ambient, step, out, ref);
+				max_diff = MAX(max_diff, diff);
+
+				/* Simulate the light output feeding back into
+				 * the ambient illuminance:
+				 */
+				ambient = MIN((ambient + ref * 3) / 2,
+					      CENTI_LUX_MAX);
+			}
+		}
+	}
+
+	TC_PRINT("Largest difference from reference: %d\n", max_diff);
+}
+
+static void test_fade_precision(void)
+{
+	rand_state = 2;
+
+	zassert_equal(reg_fixed_fade(100, 200, 0, 1000), 100, NULL);
+	zassert_equal(reg_fixed_fade(100, 200, 500, 1000), 150, NULL);
+	zassert_equal(reg_fixed_fade(200, 100, 500, 1000), 150, NULL);
+	zassert_equal(reg_fixed_fade(100, 200, 1000, 1000), 200, NULL);
+	zassert_equal(reg_fixed_fade(100, 200, 2000, 1000), 200, NULL);
+
+	for (int i = 0; i < 100000; i++) {
+		uint32_t start = rand_get(CENTI_LUX_MAX);
+		uint32_t end = rand_get(CENTI_LUX_MAX);
+		uint32_t duration = 1 + rand_get(1000000);
+		uint32_t curr = rand_get(duration);
+		double ref = start + ((double)end - start) * curr / duration;
+		uint32_t lux = reg_fixed_fade(start, end, curr, duration);
+
+		zassert_within(lux, ref, 1.0, "%u -> %u at %u/%u: %u", start,
+			       end, curr, duration, lux);
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(light_ctrl_reg_test,
+			 ztest_unit_test(test_coeff),
+			 ztest_unit_test(test_input),
+			 ztest_unit_test(test_step_limits),
+			 ztest_unit_test(test_step_precision),
+			 ztest_unit_test(test_fade_precision)
+			 );
+
+	ztest_run_test_suite(light_ctrl_reg_test);
+}
@@ -13,6 +13,7 @@
 #include <bluetooth/mesh/sensor_types.h>
 #include <model_utils.h>
 #include <sensor.h> // private header from the source folder
+#include "native_rtc.h"
 
 BUILD_ASSERT(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
 	     "This test is only supported on little endian platforms");
@@ -21,6 +22,12 @@ BUILD_ASSERT(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
 
 struct __packed uint24_t  { uint32_t v:24; };
 
+/* Number of times every encoded sensor value is decoded in the benchmark. */
+#define BENCH_ROUNDS 1000
+
+/* Fits one encoded value of every sensor type. */
+#define BENCH_BUF_SIZE 2048
+
 /****************** types section **********************************/
 
 /****************** mock section **********************************/
@@ -2427,6 +2434,116 @@ static void test_present_rel_output_ripple_voltage(void)
 	percentage8_check(sensor_type);
 }
 
+static const struct bt_mesh_sensor_type *linear_type_get(uint16_t id)
+{
+	Z_STRUCT_SECTION_FOREACH(bt_mesh_sensor_type, type) {
+		if (type->id == id) {
+			return type;
+		}
+	}
+
+	return NULL;
+}
+
+static void test_sensor_type_lookup(void)
+{
+	const struct bt_mesh_sensor_type *prev = NULL;
+	uint16_t id = 0;
+
+	Z_STRUCT_SECTION_FOREACH(bt_mesh_sensor_type, type) {
+		if (prev) {
+			zassert_true(type->id > prev->id,
+				     "Sensor type 0x%04x not sorted", type->id);
+		}
+
+		zassert_equal_ptr(bt_mesh_sensor_type_get(type->id), type,
+				  "Lookup of 0x%04x failed", type->id);
+		prev = type;
+	}
+
+	/* Find an ID that is not a sensor type. */
+	while (linear_type_get(id)) {
+		id++;
+	}
+
+	zassert_is_null(bt_mesh_sensor_type_get(id), "Unknown ID found");
+	zassert_is_null(bt_mesh_sensor_type_get(UINT16_MAX), "Unknown ID found");
+}
+
+static uint32_t status_decode_bench(struct net_buf_simple *buf,
+				    const struct bt_mesh_sensor_type *
+				    (*type_get)(uint16_t id))
+{
+	struct net_buf_simple_state state;
+	struct sensor_value values[CONFIG_BT_MESH_SENSOR_CHANNELS_MAX];
+	uint32_t decoded = 0;
+
+	net_buf_simple_save(buf, &state);
+
+	for (int round = 0; round < BENCH_ROUNDS; round++) {
+		net_buf_simple_restore(buf, &state);
+
+		while (buf->len) {
+			const struct bt_mesh_sensor_type *type;
+			uint8_t len;
+			uint16_t id;
+
+			sensor_status_id_decode(buf, &len, &id);
+			type = type_get(id);
+			zassert_not_null(type, "Unknown type 0x%04x", id);
+			zassert_equal(len, sensor_value_len(type),
+				      "Invalid length for 0x%04x", id);
+			zassert_equal(sensor_value_decode(buf, type, values), 0,
+				      "Decoding 0x%04x failed", id);
+			decoded++;
+		}
+	}
+
+	return decoded;
+}
+
+static void test_status_decode_benchmark(void)
+{
+	static uint8_t data[BENCH_BUF_SIZE];
+	struct net_buf_simple buf;
+	const struct sensor_value values[CONFIG_BT_MESH_SENSOR_CHANNELS_MAX] = {};
+	struct {
+		const char *name;
+		const struct bt_mesh_sensor_type *(*type_get)(uint16_t id);
+	} lookups[] = {
+		{ "Linear lookup", linear_type_get },
+		{ "Sorted lookup", bt_mesh_sensor_type_get },
+	};
+
+	net_buf_simple_init_with_data(&buf, data, sizeof(data));
+	net_buf_simple_reset(&buf);
+
+	Z_STRUCT_SECTION_FOREACH(bt_mesh_sensor_type, type) {
+		struct net_buf_simple_state state;
+
+		net_buf_simple_save(&buf, &state);
+		zassert_equal(sensor_status_id_encode(&buf,
+						      sensor_value_len(type),
+						      type->id), 0,
+			      "Encoding ID of 0x%04x failed", type->id);
+
+		/* Skip types that can't represent zero. */
+		if (sensor_value_encode(&buf, type, values)) {
+			net_buf_simple_restore(&buf, &state);
+		}
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(lookups); i++) {
+		uint64_t start = native_rtc_gettime_us(RTC_CLOCK_REAL);
+		uint32_t decoded = status_decode_bench(&buf, lookups[i].type_get);
+		uint64_t total_ns = (native_rtc_gettime_us(RTC_CLOCK_REAL) -
+				     start) * NSEC_PER_USEC;
+
+		TC_PRINT("%s: %u values, %u ns per value\n", lookups[i].name,
+			 decoded, (uint32_t)(total_ns / decoded));
+	}
+}
+
 void test_main(void)
 {
 	ztest_test_suite(sensor_types_test,
@@ -2535,7 +2652,11 @@ void test_main(void)
 			ztest_unit_test(test_output_voltage_stat),
 			ztest_unit_test(test_present_output_current),
 			ztest_unit_test(test_present_output_voltage),
-			ztest_unit_test(test_present_rel_output_ripple_voltage)
+			ztest_unit_test(test_present_rel_output_ripple_voltage),
+
+			/* Lookup */
+			ztest_unit_test(test_sensor_type_lookup),
+			ztest_unit_test(test_status_decode_benchmark)
 			 );
 
 	ztest_run_test_suite(sensor_types_test);
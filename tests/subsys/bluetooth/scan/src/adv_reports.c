@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <sys/util.h>
+#include "adv_reports.h"
+
+#define ADV_REPORT(_desc, ...)						\
+	{								\
+		.desc = _desc,						\
+		.len = sizeof((uint8_t[]){ __VA_ARGS__ }),		\
+		.data = { __VA_ARGS__ },				\
+	}
+
+const struct adv_report adv_reports[] = {
+	ADV_REPORT("iBeacon",
+		   0x02, 0x01, 0x06,
+		   0x1a, 0xff, 0x4c, 0x00, 0x02, 0x15,
+		   0xe2, 0xc5, 0x6d, 0xb5, 0xdf, 0xfb, 0x48, 0xd2,
+		   0xb0, 0x60, 0xd0, 0xf5, 0xa7, 0x10, 0x96, 0xe0,
+		   0x00, 0x01, 0x00, 0x02, 0xc5),
+	ADV_REPORT("Apple Nearby",
+		   0x02, 0x01, 0x1a,
+		   0x0b, 0xff, 0x4c, 0x00, 0x10, 0x06, 0x1b, 0x1e,
+		   0x8a, 0x4d, 0x2c, 0x70),
+	ADV_REPORT("Microsoft CDP",
+		   0x1e, 0xff, 0x06, 0x00, 0x01, 0x09, 0x20, 0x02,
+		   0x5e, 0x1c, 0x61, 0x3a, 0x8f, 0x92, 0xd4, 0xb0,
+		   0x03, 0x73, 0x9a, 0x2b, 0x46, 0x0c, 0x55, 0x1e,
+		   0x7b, 0x3c, 0x18, 0xa7, 0x3f, 0x1d, 0x4e),
+	ADV_REPORT("Eddystone UID",
+		   0x02, 0x01, 0x06,
+		   0x03, 0x03, 0xaa, 0xfe,
+		   0x17, 0x16, 0xaa, 0xfe, 0x00, 0xe7, 0x36, 0xc8,
+		   0x80, 0x7b, 0xf4, 0x60, 0xfb, 0x41, 0xd6, 0xa1,
+		   0x13, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00),
+	ADV_REPORT("Heart rate sensor",
+		   0x02, 0x01, 0x06,
+		   0x03, 0x03, 0x0d, 0x18,
+		   0x03, 0x19, 0x41, 0x03,
+		   0x0b, 0x09, 'P', 'o', 'l', 'a', 'r', ' ', 'H', '1',
+		   '0', ' '),
+	ADV_REPORT("Nordic UART Service",
+		   0x02, 0x01, 0x06,
+		   0x11, 0x07, 0x9e, 0xca, 0xdc, 0x24, 0x0e, 0xe5,
+		   0xa9, 0xe0, 0x93, 0xf3, 0xa3, 0xb5, 0x01, 0x00,
+		   0x40, 0x6e,
+		   0x09, 0x09, 'N', 'o', 'r', 'd', 'i', 'c', '_', 'U'),
+	ADV_REPORT("Fitness band",
+		   0x02, 0x01, 0x06,
+		   0x05, 0x08, 'M', 'i', ' ', 'B',
+		   0x03, 0x02, 0xe0, 0xfe,
+		   0x0d, 0xff, 0x57, 0x01, 0x00, 0x2b, 0x8e, 0x1a,
+		   0x6c, 0xd1, 0x02, 0xe4, 0x58, 0x9f),
+	ADV_REPORT("Tile",
+		   0x02, 0x01, 0x06,
+		   0x03, 0x03, 0xed, 0xfe,
+		   0x0b, 0x16, 0xed, 0xfe, 0x02, 0x00, 0x7f, 0x36,
+		   0x21, 0xc6, 0x8b, 0x0e),
+	ADV_REPORT("Fast Pair",
+		   0x03, 0x03, 0x2c, 0xfe,
+		   0x06, 0x16, 0x2c, 0xfe, 0x00, 0xb7, 0x27,
+		   0x02, 0x0a, 0xf4),
+	ADV_REPORT("Samsung",
+		   0x02, 0x01, 0x1a,
+		   0x13, 0xff, 0x75, 0x00, 0x42, 0x04, 0x01, 0x80,
+		   0x66, 0x8c, 0x79, 0xf3, 0xd7, 0x48, 0x8e, 0x79,
+		   0xf3, 0xd7, 0x01, 0x00),
+	ADV_REPORT("HID keyboard",
+		   0x02, 0x01, 0x05,
+		   0x03, 0x19, 0xc1, 0x03,
+		   0x03, 0x03, 0x12, 0x18,
+		   0x09, 0x09, 'K', 'e', 'y', 'b', 'o', 'a', 'r', 'd'),
+	ADV_REPORT("Thingy:52",
+		   0x02, 0x01, 0x06,
+		   0x11, 0x07, 0x42, 0x00, 0x74, 0xa9, 0xff, 0x52,
+		   0x10, 0x9b, 0x33, 0x49, 0x35, 0x9b, 0x00, 0x01,
+		   0x68, 0xef,
+		   0x07, 0x09, 'T', 'h', 'i', 'n', 'g', 'y'),
+	ADV_REPORT("Nordic manufacturer data",
+		   0x02, 0x01, 0x06,
+		   0x07, 0xff, 0x59, 0x00, 0x01, 0x02, 0x03, 0x04,
+		   0x0b, 0x09, 'N', 'o', 'r', 'd', 'i', 'c', '_', 'H',
+		   'R', 'M'),
+	ADV_REPORT("Non-connectable beacon",
+		   0x0d, 0xff, 0xe0, 0x00, 0x00, 0x9a, 0x27, 0x3c,
+		   0x11, 0x05, 0x00, 0x00, 0x00, 0x00),
+};
+
+const size_t adv_report_cnt = ARRAY_SIZE(adv_reports);
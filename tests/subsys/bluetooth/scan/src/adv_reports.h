@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef ADV_REPORTS_H_
+#define ADV_REPORTS_H_
+
+#include <zephyr/types.h>
+#include <stddef.h>
+
+/* Advertising data captured in an environment with many devices. */
+struct adv_report {
+	const char *desc;
+	uint8_t len;
+	uint8_t data[31];
+};
+
+extern const struct adv_report adv_reports[];
+extern const size_t adv_report_cnt;
+
+#endif /* ADV_REPORTS_H_ */
@@ -0,0 +1,647 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/uuid.h>
+#include <bluetooth/scan.h>
+
+#include "adv_reports.h"
+
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+#include "native_rtc.h"
+#endif
+
+/* Number of times every captured report is received in the benchmark. */
+#define BENCH_ROUNDS		10000
+
+static struct bt_le_scan_cb *scan_cb;
+
+static uint32_t match_cnt;
+static uint32_t no_match_cnt;
+static struct bt_scan_filter_match last_match;
+
+
+/* The scan callback of the library is called directly by the test. */
+void __wrap_bt_le_scan_cb_register(struct bt_le_scan_cb *cb)
+{
+	scan_cb = cb;
+}
+
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+/* Simulated time does not advance while code is executed, use host time. */
+static uint64_t timestamp_get(void)
+{
+	return native_rtc_gettime_us(RTC_CLOCK_REAL);
+}
+
+static uint64_t elapsed_ns(uint64_t start)
+{
+	return (timestamp_get() - start) * NSEC_PER_USEC;
+}
+#else
+static uint64_t timestamp_get(void)
+{
+	return k_cycle_get_32();
+}
+
+static uint64_t elapsed_ns(uint64_t start)
+{
+	uint32_t cycles = k_cycle_get_32() - (uint32_t)start;
+
+	return k_cyc_to_ns_floor64(cycles);
+}
+#endif /* CONFIG_BOARD_NATIVE_POSIX */
+
+static void scan_filter_match(struct bt_scan_device_info *device_info,
+			      struct bt_scan_filter_match *filter_match,
+			      bool connectable)
+{
+	match_cnt++;
+	last_match = *filter_match;
+}
+
+static void scan_filter_no_match(struct bt_scan_device_info *device_info,
+				 bool connectable)
+{
+	no_match_cnt++;
+}
+
+BT_SCAN_CB_INIT(scan_cb_data, scan_filter_match, scan_filter_no_match,
+		NULL, NULL);
+
+static void addr_get(bt_addr_le_t *addr, uint16_t id)
+{
+	addr->type = BT_ADDR_LE_RANDOM;
+	addr->a.val[0] = id & 0xFF;
+	addr->a.val[1] = id >> 8;
+	addr->a.val[2] = 0x5A;
+	addr->a.val[3] = 0x3C;
+	addr->a.val[4] = 0x96;
+	addr->a.val[5] = 0xC0;
+}
+
+static const struct adv_report *adv_report_find(const char *desc)
+{
+	for (size_t i = 0; i < adv_report_cnt; i++) {
+		if (strcmp(adv_reports[i].desc, desc) == 0) {
+			return &adv_reports[i];
+		}
+	}
+
+	zassert_unreachable("No advertising report %s", desc);
+
+	return NULL;
+}
+
+static void adv_report_recv(const struct adv_report *report, uint16_t id,
+			    uint8_t adv_type)
+{
+	struct bt_le_scan_recv_info info = {
+		.adv_type = adv_type,
+		.adv_props = BT_GAP_ADV_PROP_CONNECTABLE |
+			     BT_GAP_ADV_PROP_SCANNABLE,
+	};
+	struct net_buf_simple ad;
+	bt_addr_le_t addr;
+
+	addr_get(&addr, id);
+	info.addr = &addr;
+	net_buf_simple_init_with_data(&ad, (void *)report->data, report->len);
+
+	scan_cb->recv(&info, &ad);
+}
+
+/* Returns true if the report matched the filters. */
+static bool adv_report_type_check(const char *desc, uint16_t id,
+				  uint8_t adv_type)
+{
+	uint32_t prev_match_cnt = match_cnt;
+
+	memset(&last_match, 0, sizeof(last_match));
+	adv_report_recv(adv_report_find(desc), id, adv_type);
+
+	return match_cnt != prev_match_cnt;
+}
+
+static bool adv_report_check(const char *desc, uint16_t id)
+{
+	return adv_report_type_check(desc, id, BT_GAP_ADV_TYPE_ADV_IND);
+}
+
+static void filters_reset(void)
+{
+	bt_scan_filter_disable();
+	bt_scan_filter_remove_all();
+#if CONFIG_BT_SCAN_DEDUP
+	bt_scan_dedup_clear();
+#endif
+	match_cnt = 0;
+	no_match_cnt = 0;
+}
+
+static void test_init(void)
+{
+	bt_scan_init(NULL);
+	bt_scan_cb_register(&scan_cb_data);
+
+	zassert_not_null(scan_cb, "Scan callback not registered");
+}
+
+static void test_name_filter(void)
+{
+	int err;
+
+	filters_reset();
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Nordic_HRM");
+	zassert_equal(err, 0, "Failed to add filter");
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Keyboard");
+	zassert_equal(err, 0, "Failed to add filter");
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Nordic_UART");
+	zassert_equal(err, 0, "Failed to add filter");
+	err = bt_scan_filter_enable(BT_SCAN_NAME_FILTER, false);
+	zassert_equal(err, 0, "Failed to enable filter");
+
+	zassert_true(adv_report_check("HID keyboard", 0), "No match");
+	zassert_true(last_match.name.match, "Name not matched");
+	zassert_equal(strcmp(last_match.name.name, "Keyboard"), 0,
+		      "Invalid name");
+
+	zassert_true(adv_report_check("Nordic manufacturer data", 0),
+		     "No match");
+	zassert_equal(strcmp(last_match.name.name, "Nordic_HRM"), 0,
+		      "Invalid name");
+
+	/* The advertised name is a prefix of the filter name. */
+	zassert_true(adv_report_check("Nordic UART Service", 0), "No match");
+	zassert_equal(strcmp(last_match.name.name, "Nordic_UART"), 0,
+		      "Invalid name");
+
+	zassert_false(adv_report_check("Thingy:52", 0), "Unexpected match");
+	zassert_false(adv_report_check("Heart rate sensor", 0),
+		      "Unexpected match");
+}
+
+static void test_short_name_filter(void)
+{
+	struct bt_scan_short_name short_name = {
+		.name = "Mi Band",
+		.min_len = 4,
+	};
+	int err;
+
+	filters_reset();
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_SHORT_NAME, &short_name);
+	zassert_equal(err, 0, "Failed to add filter");
+	err = bt_scan_filter_enable(BT_SCAN_SHORT_NAME_FILTER, false);
+	zassert_equal(err, 0, "Failed to enable filter");
+
+	zassert_true(adv_report_check("Fitness band", 0), "No match");
+	zassert_true(last_match.short_name.match, "Short name not matched");
+
+	filters_reset();
+
+	/* The advertised short name is shorter than required. */
+	short_name.min_len = 5;
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_SHORT_NAME, &short_name);
+	zassert_equal(err, 0, "Failed to add filter");
+	err = bt_scan_filter_enable(BT_SCAN_SHORT_NAME_FILTER, false);
+	zassert_equal(err, 0, "Failed to enable filter");
+
+	zassert_false(adv_report_check("Fitness band", 0), "Unexpected match");
+}
+
+static void test_addr_filter(void)
+{
+	bt_addr_le_t addr;
+	int err;
+
+	filters_reset();
+
+	/* Add the addresses in descending order. */
+	for (int i = CONFIG_BT_SCAN_ADDRESS_CNT - 1; i >= 0; i--) {
+		addr_get(&addr, 2 * i);
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addr);
+		zassert_equal(err, 0, "Failed to add filter");
+	}
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addr);
+	zassert_equal(err, -ENOMEM, "Filter added over limit");
+
+	err = bt_scan_filter_enable(BT_SCAN_ADDR_FILTER, false);
+	zassert_equal(err, 0, "Failed to enable filter");
+
+	for (uint16_t id = 0; id < 2 * CONFIG_BT_SCAN_ADDRESS_CNT; id++) {
+		bool match = adv_report_check("Tile", id);
+
+		zassert_equal(match, (id % 2) == 0, "Invalid match of %u", id);
+
+		if (match) {
+			addr_get(&addr, id);
+			zassert_equal(bt_addr_le_cmp(last_match.addr.addr,
+						     &addr), 0,
+				      "Invalid address");
+		}
+	}
+}
+
+static void test_uuid_filter(void)
+{
+	struct bt_uuid_128 uuid_128 = BT_UUID_INIT_128(
+		BT_UUID_128_ENCODE(0x6e400001, 0xb5a3, 0xf393, 0xe0a9,
+				   0xe50e24dcca9e));
+	/* Heart Rate Service as 128-bit alias of the 16-bit UUID. */
+	struct bt_uuid_128 uuid_hrs_128 = BT_UUID_INIT_128(
+		BT_UUID_128_ENCODE(0x0000180d, 0x0000, 0x1000, 0x8000,
+				   0x00805f9b34fb));
+	int err;
+
+	filters_reset();
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_HIDS);
+	zassert_equal(err, 0, "Failed to add filter");
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, &uuid_128);
+	zassert_equal(err, 0, "Failed to add filter");
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, &uuid_hrs_128);
+	zassert_equal(err, 0, "Failed to add filter");
+	err = bt_scan_filter_enable(BT_SCAN_UUID_FILTER, false);
+	zassert_equal(err, 0, "Failed to enable filter");
+
+	zassert_true(adv_report_check("HID keyboard", 0), "No match");
+	zassert_equal(last_match.uuid.count, 1, "Invalid UUID count");
+	zassert_equal(bt_uuid_cmp(last_match.uuid.uuid[0], BT_UUID_HIDS), 0,
+		      "Invalid UUID");
+
+	zassert_true(adv_report_check("Nordic UART Service", 0), "No match");
+	zassert_equal(bt_uuid_cmp(last_match.uuid.uuid[0], &uuid_128.uuid), 0,
+		      "Invalid UUID");
+
+	zassert_true(adv_report_check("Heart rate sensor", 0), "No match");
+	zassert_equal(bt_uuid_cmp(last_match.uuid.uuid[0], BT_UUID_HRS), 0,
+		      "Invalid UUID");
+
+	zassert_false(adv_report_check("Thingy:52", 0), "Unexpected match");
+	zassert_false(adv_report_check("Eddystone UID", 0),
+		      "Unexpected match");
+}
+
+static void test_appearance_filter(void)
+{
+	/* The appearance is decoded as a big-endian value. */
+	uint16_t appearance = 0xC103;
+	int err;
+
+	filters_reset();
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_APPEARANCE, &appearance);
+	zassert_equal(err, 0, "Failed to add filter");
+	err = bt_scan_filter_enable(BT_SCAN_APPEARANCE_FILTER, false);
+	zassert_equal(err, 0, "Failed to enable filter");
+
+	zassert_true(adv_report_check("HID keyboard", 0), "No match");
+	zassert_equal(*last_match.appearance.appearance, appearance,
+		      "Invalid appearance");
+	zassert_false(adv_report_check("Heart rate sensor", 0),
+		      "Unexpected match");
+}
+
+static void test_manufacturer_data_filter(void)
+{
+	uint8_t nordic_long[] = { 0x59, 0x00, 0x01, 0x02 };
+	uint8_t nordic[] = { 0x59, 0x00 };
+	uint8_t ibeacon[] = { 0x4c, 0x00, 0x02, 0x15 };
+	uint8_t apple_nearby[] = { 0x4c, 0x00, 0x10 };
+	struct bt_scan_manufacturer_data md[] = {
+		{ .data = nordic_long, .data_len = sizeof(nordic_long) },
+		{ .data = nordic, .data_len = sizeof(nordic) },
+		{ .data = ibeacon, .data_len = sizeof(ibeacon) },
+		{ .data = apple_nearby, .data_len = sizeof(apple_nearby) },
+	};
+	int err;
+
+	filters_reset();
+
+	for (size_t i = 0; i < ARRAY_SIZE(md); i++) {
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_MANUFACTURER_DATA,
+					 &md[i]);
+		zassert_equal(err, 0, "Failed to add filter");
+	}
+
+	err = bt_scan_filter_enable(BT_SCAN_MANUFACTURER_DATA_FILTER, false);
+	zassert_equal(err, 0, "Failed to enable filter");
+
+	/* Both Nordic filters match, the first added one is reported. */
+	zassert_true(adv_report_check("Nordic manufacturer data", 0),
+		     "No match");
+	zassert_equal(last_match.manufacturer_data.len, sizeof(nordic_long),
+		      "Invalid manufacturer data");
+
+	zassert_true(adv_report_check("iBeacon", 0), "No match");
+	zassert_equal(last_match.manufacturer_data.len, sizeof(ibeacon),
+		      "Invalid manufacturer data");
+
+	zassert_true(adv_report_check("Apple Nearby", 0), "No match");
+	zassert_equal(last_match.manufacturer_data.len, sizeof(apple_nearby),
+		      "Invalid manufacturer data");
+
+	zassert_false(adv_report_check("Microsoft CDP", 0),
+		      "Unexpected match");
+	zassert_false(adv_report_check("Samsung", 0), "Unexpected match");
+}
+
+static void test_all_filters_mode(void)
+{
+	bt_addr_le_t addr;
+	int err;
+
+	filters_reset();
+
+	addr_get(&addr, 1);
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addr);
+	zassert_equal(err, 0, "Failed to add filter");
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Keyboard");
+	zassert_equal(err, 0, "Failed to add filter");
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_HIDS);
+	zassert_equal(err, 0, "Failed to add filter");
+	err = bt_scan_filter_enable(BT_SCAN_ADDR_FILTER | BT_SCAN_NAME_FILTER |
+				    BT_SCAN_UUID_FILTER, true);
+	zassert_equal(err, 0, "Failed to enable filter");
+
+	zassert_true(adv_report_check("HID keyboard", 1), "No match");
+	zassert_true(last_match.addr.match, "Address not matched");
+	zassert_true(last_match.name.match, "Name not matched");
+	zassert_true(last_match.uuid.match, "UUID not matched");
+
+	zassert_false(adv_report_check("HID keyboard", 2), "Unexpected match");
+	zassert_false(adv_report_check("Nordic UART Service", 1),
+		      "Unexpected match");
+}
+
+static void test_dedup(void)
+{
+#if CONFIG_BT_SCAN_DEDUP
+	struct bt_scan_dedup_stats stats_start;
+	struct bt_scan_dedup_stats stats;
+	uint32_t prev_no_match_cnt;
+	int err;
+
+	filters_reset();
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Keyboard");
+	zassert_equal(err, 0, "Failed to add filter");
+	err = bt_scan_filter_enable(BT_SCAN_NAME_FILTER, false);
+	zassert_equal(err, 0, "Failed to enable filter");
+
+	bt_scan_dedup_stats_get(&stats_start);
+
+	zassert_true(adv_report_check("HID keyboard", 0), "No match");
+	zassert_false(adv_report_check("HID keyboard", 0),
+		      "Repeated report passed");
+	zassert_true(adv_report_check("HID keyboard", 1),
+		     "Report of other device suppressed");
+
+	/* A report with other data from the same device replaces
+	 * the cached report of the device.
+	 */
+	prev_no_match_cnt = no_match_cnt;
+	zassert_false(adv_report_check("Tile", 0), "Unexpected match");
+	zassert_false(adv_report_check("Tile", 0), "Unexpected match");
+	zassert_equal(no_match_cnt, prev_no_match_cnt + 1,
+		      "Repeated report passed");
+	zassert_true(adv_report_check("HID keyboard", 0),
+		     "Changed report suppressed");
+	zassert_false(adv_report_check("HID keyboard", 0),
+		      "Repeated report passed");
+
+	/* With active scanning, the advertising data and the scan response
+	 * of a device alternate, and both are suppressed when repeated.
+	 */
+	prev_no_match_cnt = no_match_cnt;
+	zassert_true(adv_report_check("HID keyboard", 2), "No match");
+	zassert_false(adv_report_type_check("Tile", 2,
+					    BT_GAP_ADV_TYPE_SCAN_RSP),
+		      "Unexpected match");
+	for (int i = 0; i < 2; i++) {
+		zassert_false(adv_report_check("HID keyboard", 2),
+			      "Repeated report passed");
+		zassert_false(adv_report_type_check("Tile", 2,
+						    BT_GAP_ADV_TYPE_SCAN_RSP),
+			      "Unexpected match");
+	}
+	zassert_equal(no_match_cnt, prev_no_match_cnt + 1,
+		      "Repeated scan response passed");
+
+	/* Every device takes a single entry, so the cache can hold other
+	 * devices next to the three reported ones.
+	 */
+	for (uint16_t id = 0; id < CONFIG_BT_SCAN_DEDUP_CACHE_SIZE - 3; id++) {
+		adv_report_check("Tile", 0x100 + id);
+	}
+
+	zassert_false(adv_report_check("HID keyboard", 0),
+		      "Device removed from cache before it was full");
+
+	/* Replace the least recently seen device. */
+	adv_report_check("Tile", 0x200);
+
+	zassert_true(adv_report_check("HID keyboard", 1),
+		     "Report not passed after it was removed from cache");
+
+	bt_scan_dedup_stats_get(&stats);
+	zassert_equal(stats.hits - stats_start.hits, 8, "Invalid hit count");
+	zassert_equal(stats.misses - stats_start.misses,
+		      5 + CONFIG_BT_SCAN_DEDUP_CACHE_SIZE,
+		      "Invalid miss count");
+
+	bt_scan_dedup_clear();
+	zassert_true(adv_report_check("HID keyboard", 0),
+		     "Report not passed after cache was cleared");
+
+	if (CONFIG_BT_SCAN_DEDUP_TIMEOUT_MS > 0) {
+		k_sleep(K_MSEC(CONFIG_BT_SCAN_DEDUP_TIMEOUT_MS / 2));
+		zassert_false(adv_report_check("HID keyboard", 0),
+			      "Repeated report passed");
+		k_sleep(K_MSEC(CONFIG_BT_SCAN_DEDUP_TIMEOUT_MS / 2));
+		zassert_true(adv_report_check("HID keyboard", 0),
+			     "Report not passed after timeout");
+	}
+#else
+	ztest_test_skip();
+#endif
+}
+
+static void bench_run(const char *name)
+{
+	uint32_t report_cnt = 0;
+	uint32_t suppressed_cnt = 0;
+	uint64_t start;
+	uint64_t total_ns;
+
+	match_cnt = 0;
+	no_match_cnt = 0;
+
+#if CONFIG_BT_SCAN_DEDUP
+	struct bt_scan_dedup_stats stats_start;
+	struct bt_scan_dedup_stats stats;
+
+	bt_scan_dedup_clear();
+	bt_scan_dedup_stats_get(&stats_start);
+#endif
+
+	start = timestamp_get();
+
+	for (size_t round = 0; round < BENCH_ROUNDS; round++) {
+		for (size_t i = 0; i < adv_report_cnt; i++) {
+			/* Every report is sent by another advertiser. */
+			adv_report_recv(&adv_reports[i], i,
+					BT_GAP_ADV_TYPE_ADV_IND);
+			report_cnt++;
+		}
+	}
+
+	total_ns = elapsed_ns(start);
+
+#if CONFIG_BT_SCAN_DEDUP
+	bt_scan_dedup_stats_get(&stats);
+	suppressed_cnt = stats.hits - stats_start.hits;
+#endif
+
+	zassert_equal(match_cnt + no_match_cnt + suppressed_cnt, report_cnt,
+		      "Reports not handled");
+
+	TC_PRINT("%s: %u reports, %u matched, %u suppressed, "
+		 "%u ns per report\n", name, report_cnt, match_cnt,
+		 suppressed_cnt, (uint32_t)(total_ns / report_cnt));
+}
+
+/* Filters of an application looking for a few devices in an environment with
+ * many advertisers, with the maximum number of filters configured.
+ */
+static void bench_filters_add(void)
+{
+	static const char * const names[] = {
+		"Nordic_HRM", "Nordic_Blinky", "Nordic_UART", "Nordic_LBS",
+		"Keyboard", "Mouse", "Thingy", "Nordic_Throughput",
+	};
+	static const char * const short_names[] = {
+		"Sensor", "Tag", "Mi Scale", "Beacon",
+	};
+	static const uint16_t uuids_16[] = {
+		BT_UUID_HRS_VAL, BT_UUID_HIDS_VAL, BT_UUID_BAS_VAL,
+		BT_UUID_DIS_VAL, BT_UUID_CTS_VAL, BT_UUID_CSC_VAL,
+		BT_UUID_RSC_VAL,
+	};
+	static struct bt_uuid_128 uuid_128 = BT_UUID_INIT_128(
+		BT_UUID_128_ENCODE(0xef680100, 0x9b35, 0x4933, 0x9b10,
+				   0x52ffa9740042));
+	static struct bt_uuid_16 uuid_16[ARRAY_SIZE(uuids_16)];
+	static uint8_t md_data[CONFIG_BT_SCAN_MANUFACTURER_DATA_CNT][4];
+	static const uint16_t appearances[] = {
+		0x4103, 0x8003, 0xC103, 0xC203,
+	};
+	int err;
+
+	for (size_t i = 0; i < ARRAY_SIZE(names); i++) {
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, names[i]);
+		zassert_equal(err, 0, "Failed to add filter");
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(short_names); i++) {
+		struct bt_scan_short_name short_name = {
+			.name = short_names[i],
+			.min_len = 3,
+		};
+
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_SHORT_NAME,
+					 &short_name);
+		zassert_equal(err, 0, "Failed to add filter");
+	}
+
+	for (size_t i = 0; i < CONFIG_BT_SCAN_ADDRESS_CNT; i++) {
+		bt_addr_le_t addr;
+
+		/* Only one of the advertisers is looked for. */
+		addr_get(&addr, i == 0 ? 0 : 0x100 + i);
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addr);
+		zassert_equal(err, 0, "Failed to add filter");
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(uuids_16); i++) {
+		uuid_16[i].uuid.type = BT_UUID_TYPE_16;
+		uuid_16[i].val = uuids_16[i];
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, &uuid_16[i]);
+		zassert_equal(err, 0, "Failed to add filter");
+	}
+
+	err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, &uuid_128);
+	zassert_equal(err, 0, "Failed to add filter");
+
+	for (size_t i = 0; i < ARRAY_SIZE(appearances); i++) {
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_APPEARANCE,
+					 &appearances[i]);
+		zassert_equal(err, 0, "Failed to add filter");
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(md_data); i++) {
+		struct bt_scan_manufacturer_data md = {
+			.data = md_data[i],
+			.data_len = sizeof(md_data[i]),
+		};
+
+		/* Company identifier followed by product data. */
+		md_data[i][0] = 0x59;
+		md_data[i][1] = 0x00;
+		md_data[i][2] = 0x10 + i;
+		md_data[i][3] = 0x01;
+		err = bt_scan_filter_add(BT_SCAN_FILTER_TYPE_MANUFACTURER_DATA,
+					 &md);
+		zassert_equal(err, 0, "Failed to add filter");
+	}
+}
+
+static void test_benchmark(void)
+{
+	int err;
+
+	filters_reset();
+	bench_run("No filters");
+
+	bench_filters_add();
+
+	err = bt_scan_filter_enable(BT_SCAN_ALL_FILTER, false);
+	zassert_equal(err, 0, "Failed to enable filter");
+	bench_run("All filters, any match");
+
+	err = bt_scan_filter_enable(BT_SCAN_ALL_FILTER, true);
+	zassert_equal(err, 0, "Failed to enable filter");
+	bench_run("All filters, all match");
+
+	bt_scan_filter_disable();
+	err = bt_scan_filter_enable(BT_SCAN_NAME_FILTER | BT_SCAN_UUID_FILTER,
+				    false);
+	zassert_equal(err, 0, "Failed to enable filter");
+	bench_run("Name and UUID filters");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(bt_scan,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_name_filter),
+			 ztest_unit_test(test_short_name_filter),
+			 ztest_unit_test(test_addr_filter),
+			 ztest_unit_test(test_uuid_filter),
+			 ztest_unit_test(test_appearance_filter),
+			 ztest_unit_test(test_manufacturer_data_filter),
+			 ztest_unit_test(test_all_filters_mode),
+			 ztest_unit_test(test_dedup),
+			 ztest_unit_test(test_benchmark)
+			 );
+
+	ztest_run_test_suite(bt_scan);
+}
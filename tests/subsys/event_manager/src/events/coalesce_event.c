@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "coalesce_event.h"
+
+
+static bool coalesce_coalesce_event(struct event_header *pending,
+				    const struct event_header *eh)
+{
+	/* Accumulate values of the coalesced events. */
+	cast_coalesce_event(pending)->val += cast_coalesce_event(eh)->val;
+
+	return true;
+}
+
+EVENT_TYPE_DEFINE(coalesce_event,
+		  false,
+		  NULL,
+		  NULL,
+		  EVENT_COALESCE(coalesce_coalesce_event));
@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "dyndata_event.h"
+
+
+/* Event with dynamic data does not fit in a block of its own pool. */
+EVENT_TYPE_POOL_DEFINE(dyndata_event,
+		       0,
+		       false,
+		       NULL,
+		       NULL);
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _DYNDATA_EVENT_H_
+#define _DYNDATA_EVENT_H_
+
+/**
+ * @brief Dynamic Data Event
+ * @defgroup dyndata_event Dynamic Data Event
+ * @{
+ */
+
+#include "event_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct dyndata_event {
+	struct event_header header;
+
+	struct event_dyndata dyndata;
+};
+
+EVENT_TYPE_DYNDATA_DECLARE(dyndata_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _DYNDATA_EVENT_H_ */
@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "high_prio_event.h"
+
+
+/* The test processes the last dispatch class in a high priority work queue. */
+EVENT_TYPE_DEFINE(high_prio_event,
+		  false,
+		  NULL,
+		  NULL,
+		  EVENT_DISPATCH_CLASS(CONFIG_EVENT_MANAGER_DISPATCH_CLASS_CNT - 1));
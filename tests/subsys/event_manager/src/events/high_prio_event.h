@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _HIGH_PRIO_EVENT_H_
+#define _HIGH_PRIO_EVENT_H_
+
+/**
+ * @brief High Priority Event
+ * @defgroup high_prio_event High Priority Event
+ * @{
+ */
+
+#include "event_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct high_prio_event {
+	struct event_header header;
+};
+
+EVENT_TYPE_DECLARE(high_prio_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _HIGH_PRIO_EVENT_H_ */
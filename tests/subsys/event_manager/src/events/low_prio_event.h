@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _LOW_PRIO_EVENT_H_
+#define _LOW_PRIO_EVENT_H_
+
+/**
+ * @brief Low Priority Event
+ * @defgroup low_prio_event Low Priority Event
+ * @{
+ */
+
+#include "event_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct low_prio_event {
+	struct event_header header;
+};
+
+EVENT_TYPE_DECLARE(low_prio_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _LOW_PRIO_EVENT_H_ */
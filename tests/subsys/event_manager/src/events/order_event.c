@@ -7,7 +7,9 @@
 #include "order_event.h"
 
 
+/* Use the last dispatch class to verify event order within a class. */
 EVENT_TYPE_DEFINE(order_event,
 		  false,
 		  NULL,
-		  NULL);
+		  NULL,
+		  EVENT_DISPATCH_CLASS(CONFIG_EVENT_MANAGER_DISPATCH_CLASS_CNT - 1));
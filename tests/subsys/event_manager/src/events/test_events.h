@@ -27,6 +27,9 @@ enum test_id {
 	TEST_SUBSCRIBER_ORDER,
 	TEST_OOM_RESET,
 	TEST_MULTICONTEXT,
+	TEST_COALESCE,
+	TEST_EVENT_POOL,
+	TEST_DISPATCH_CLASS,
 
 	TEST_CNT
 };
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <test_events.h>
+#include <coalesce_event.h>
+
+#include "test_config.h"
+
+#define MODULE test_coalesce
+
+static int received_cnt;
+static int received_sum;
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_test_start_event(eh)) {
+		struct test_start_event *st = cast_test_start_event(eh);
+
+		if (st->test_id != TEST_COALESCE) {
+			return false;
+		}
+
+		received_cnt = 0;
+		received_sum = 0;
+
+		/* Events are submitted from the Event Manager context. None of
+		 * them can be processed before this handler returns.
+		 */
+		for (size_t i = 0; i < TEST_COALESCE_CNT; i++) {
+			struct coalesce_event *event = new_coalesce_event();
+
+			zassert_not_null(event, "Failed to allocate event");
+			event->val = 1;
+			EVENT_SUBMIT(event);
+		}
+
+		return false;
+	}
+
+	if (is_coalesce_event(eh)) {
+		struct coalesce_event *event = cast_coalesce_event(eh);
+
+		received_cnt++;
+		received_sum += event->val;
+
+		if (received_sum < TEST_COALESCE_CNT) {
+			return false;
+		}
+
+		zassert_equal(received_sum, TEST_COALESCE_CNT,
+			      "Invalid value of coalesced events");
+		zassert_equal(received_cnt,
+			      IS_ENABLED(CONFIG_EVENT_MANAGER_EVENT_COALESCING) ?
+			      1 : TEST_COALESCE_CNT,
+			      "Invalid number of received events");
+
+		struct test_end_event *te = new_test_end_event();
+
+		zassert_not_null(te, "Failed to allocate event");
+		te->test_id = TEST_COALESCE;
+		EVENT_SUBMIT(te);
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+EVENT_LISTENER(MODULE, event_handler);
+EVENT_SUBSCRIBE(MODULE, test_start_event);
+EVENT_SUBSCRIBE(MODULE, coalesce_event);
@@ -19,3 +19,7 @@
 
 /* TEST_EVENT_ORDER */
 #define TEST_EVENT_ORDER_CNT 20
+
+
+/* TEST_COALESCE */
+#define TEST_COALESCE_CNT 10
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <test_events.h>
+#include <low_prio_event.h>
+#include <high_prio_event.h>
+
+#define MODULE test_dispatch
+
+#define HIGH_PRIO_CLASS		(CONFIG_EVENT_MANAGER_DISPATCH_CLASS_CNT - 1)
+#define WORK_Q_STACK_SIZE	1024
+#define WORK_Q_PRIORITY		(CONFIG_SYSTEM_WORKQUEUE_PRIORITY - 1)
+
+static K_THREAD_STACK_DEFINE(work_q_stack, WORK_Q_STACK_SIZE);
+static struct k_work_q work_q;
+static bool high_prio_received;
+
+#ifdef CONFIG_EVENT_MANAGER_DISPATCH_STATS
+static struct event_dispatch_stats stats_before[CONFIG_EVENT_MANAGER_DISPATCH_CLASS_CNT];
+#endif
+
+static void end_test(void)
+{
+	int err = event_manager_dispatch_class_queue_set(HIGH_PRIO_CLASS, NULL);
+
+	zassert_equal(err, 0, "Cannot restore the system work queue");
+
+	struct test_end_event *te = new_test_end_event();
+
+	zassert_not_null(te, "Failed to allocate event");
+	te->test_id = TEST_DISPATCH_CLASS;
+	EVENT_SUBMIT(te);
+}
+
+static void check_stats(void)
+{
+#ifdef CONFIG_EVENT_MANAGER_DISPATCH_STATS
+	struct event_dispatch_stats stats;
+	int err;
+
+	err = event_manager_dispatch_stats_get(CONFIG_EVENT_MANAGER_DISPATCH_CLASS_CNT,
+					       &stats);
+	zassert_equal(err, -EINVAL, "Invalid dispatch class accepted");
+
+	err = event_manager_dispatch_stats_get(HIGH_PRIO_CLASS, &stats);
+	zassert_equal(err, 0, "Cannot get dispatch statistics");
+	zassert_equal(stats.submitted_cnt,
+		      stats_before[HIGH_PRIO_CLASS].submitted_cnt + 1,
+		      "Wrong number of submitted events");
+	zassert_equal(stats.queue_depth, 0, "Processed event still queued");
+	zassert_true(stats.max_queue_depth >= 1, "Wrong maximum queue depth");
+
+	err = event_manager_dispatch_stats_get(0, &stats);
+	zassert_equal(err, 0, "Cannot get dispatch statistics");
+	zassert_equal(stats.submitted_cnt, stats_before[0].submitted_cnt + 1,
+		      "Wrong number of submitted events");
+#endif /* CONFIG_EVENT_MANAGER_DISPATCH_STATS */
+}
+
+static void start_test(void)
+{
+	int err;
+
+	err = event_manager_dispatch_class_queue_set(CONFIG_EVENT_MANAGER_DISPATCH_CLASS_CNT,
+						     NULL);
+	zassert_equal(err, -EINVAL, "Invalid dispatch class accepted");
+
+	if (HIGH_PRIO_CLASS == 0) {
+		/* Ordering between dispatch classes cannot be verified. */
+		end_test();
+		return;
+	}
+
+	static bool work_q_started;
+
+	if (!work_q_started) {
+		k_work_queue_start(&work_q, work_q_stack,
+				   K_THREAD_STACK_SIZEOF(work_q_stack),
+				   WORK_Q_PRIORITY, NULL);
+		work_q_started = true;
+	}
+
+	err = event_manager_dispatch_class_queue_set(HIGH_PRIO_CLASS, &work_q);
+	zassert_equal(err, 0, "Cannot set the work queue");
+
+#ifdef CONFIG_EVENT_MANAGER_DISPATCH_STATS
+	for (size_t i = 0; i < ARRAY_SIZE(stats_before); i++) {
+		err = event_manager_dispatch_stats_get(i, &stats_before[i]);
+		zassert_equal(err, 0, "Cannot get dispatch statistics");
+	}
+#endif /* CONFIG_EVENT_MANAGER_DISPATCH_STATS */
+
+	high_prio_received = false;
+
+	/* Events are submitted from the system work queue. The high priority
+	 * event is submitted last, but its work queue takes over as soon as
+	 * the system work queue yields.
+	 */
+	struct low_prio_event *low = new_low_prio_event();
+
+	zassert_not_null(low, "Failed to allocate event");
+	EVENT_SUBMIT(low);
+
+	struct high_prio_event *high = new_high_prio_event();
+
+	zassert_not_null(high, "Failed to allocate event");
+	EVENT_SUBMIT(high);
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_test_start_event(eh)) {
+		struct test_start_event *st = cast_test_start_event(eh);
+
+		if (st->test_id == TEST_DISPATCH_CLASS) {
+			start_test();
+		}
+
+		return false;
+	}
+
+	if (is_high_prio_event(eh)) {
+		zassert_equal_ptr(k_current_get(), &work_q.thread,
+				  "Event processed in wrong work queue");
+		high_prio_received = true;
+
+		return false;
+	}
+
+	if (is_low_prio_event(eh)) {
+		zassert_equal_ptr(k_current_get(), &k_sys_work_q.thread,
+				  "Event processed in wrong work queue");
+		zassert_true(high_prio_received,
+			     "High priority event not processed first");
+
+		check_stats();
+		end_test();
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+EVENT_LISTENER(MODULE, event_handler);
+EVENT_SUBSCRIBE(MODULE, test_start_event);
+EVENT_SUBSCRIBE(MODULE, low_prio_event);
+EVENT_SUBSCRIBE(MODULE, high_prio_event);
@@ -44,9 +44,21 @@ static bool event_handler(const struct event_header *eh)
 				     "No OOM detected, increase TEST_EVENTS_CNT");
 			zassert_true(oom_error, "OOM error not detected");
 
+#ifdef CONFIG_EVENT_MANAGER_EVENT_POOL
+			const struct event_pool *pool =
+				_EVENT_ID(data_event)->pool;
+
+			zassert_equal(pool->max_used, pool->slab->num_blocks,
+				      "Event pool not exhausted before OOM");
+			zassert_true(pool->heap_fallback_cnt > 0,
+				     "No fallback to heap detected");
+#endif /* CONFIG_EVENT_MANAGER_EVENT_POOL */
+
 			/* Freeing memory to enable further testing. */
 			while (i >= 0) {
-				k_free(event_tab[i]);
+				if (event_tab[i] != NULL) {
+					event_manager_free(&event_tab[i]->header);
+				}
 				i--;
 			}
 
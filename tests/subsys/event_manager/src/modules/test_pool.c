@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <string.h>
+
+#include <test_events.h>
+#include <dyndata_event.h>
+
+#define MODULE test_pool
+
+#define TEST_DYNDATA_SIZE	8
+#define TEST_DYNDATA_PATTERN	0xA5
+
+#if CONFIG_EVENT_MANAGER_EVENT_POOL_SHARED_BLOCK_CNT > 0
+/* Event with dynamic data that does not fit in any shared pool block. */
+#define TEST_DYNDATA_LARGE_SIZE CONFIG_EVENT_MANAGER_EVENT_POOL_SHARED_MAX_BLOCK_SIZE
+#else
+#define TEST_DYNDATA_LARGE_SIZE 64
+#endif
+
+static void check_allocations(void)
+{
+	struct dyndata_event *event = new_dyndata_event(TEST_DYNDATA_SIZE);
+
+	zassert_not_null(event, "Failed to allocate event");
+	zassert_equal(event->dyndata.size, TEST_DYNDATA_SIZE,
+		      "Wrong dynamic data size");
+
+#ifdef CONFIG_EVENT_MANAGER_EVENT_POOL
+	const struct event_pool *pool = _EVENT_ID(dyndata_event)->pool;
+	uint32_t shared_cnt = pool->shared_cnt;
+	uint32_t heap_cnt = pool->heap_fallback_cnt;
+
+	zassert_equal(pool->slab->num_blocks, 0,
+		      "Pool size of the event type not applied");
+	zassert_equal(_EVENT_ID(test_start_event)->pool->slab->num_blocks,
+		      CONFIG_EVENT_MANAGER_EVENT_POOL_BLOCK_CNT,
+		      "Wrong default pool size");
+
+	/* Event with dynamic data does not fit in the block of its own pool. */
+	struct dyndata_event *small = new_dyndata_event(TEST_DYNDATA_SIZE);
+
+	zassert_not_null(small, "Failed to allocate event");
+
+	if (CONFIG_EVENT_MANAGER_EVENT_POOL_SHARED_BLOCK_CNT > 0) {
+		zassert_equal(pool->shared_cnt, shared_cnt + 1,
+			      "Event not allocated from the shared pool");
+		zassert_equal(pool->heap_fallback_cnt, heap_cnt,
+			      "Unexpected fallback to heap");
+	} else {
+		zassert_equal(pool->heap_fallback_cnt, heap_cnt + 1,
+			      "No fallback to heap detected");
+	}
+
+	struct dyndata_event *large = new_dyndata_event(TEST_DYNDATA_LARGE_SIZE);
+
+	zassert_not_null(large, "Failed to allocate event");
+	zassert_equal(pool->heap_fallback_cnt, heap_cnt + 1 +
+		      ((CONFIG_EVENT_MANAGER_EVENT_POOL_SHARED_BLOCK_CNT > 0) ? 0 : 1),
+		      "Oversized event not allocated from heap");
+
+	event_manager_free(&small->header);
+	event_manager_free(&large->header);
+#endif /* CONFIG_EVENT_MANAGER_EVENT_POOL */
+
+	event_manager_free(&event->header);
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_test_start_event(eh)) {
+		struct test_start_event *st = cast_test_start_event(eh);
+
+		if (st->test_id != TEST_EVENT_POOL) {
+			return false;
+		}
+
+		check_allocations();
+
+		struct dyndata_event *event = new_dyndata_event(TEST_DYNDATA_SIZE);
+
+		zassert_not_null(event, "Failed to allocate event");
+		memset(event->dyndata.data, TEST_DYNDATA_PATTERN,
+		       event->dyndata.size);
+		EVENT_SUBMIT(event);
+
+		return false;
+	}
+
+	if (is_dyndata_event(eh)) {
+		const struct dyndata_event *event = cast_dyndata_event(eh);
+
+		zassert_equal(event->dyndata.size, TEST_DYNDATA_SIZE,
+			      "Wrong dynamic data size");
+		for (size_t i = 0; i < event->dyndata.size; i++) {
+			zassert_equal(event->dyndata.data[i],
+				      TEST_DYNDATA_PATTERN,
+				      "Wrong dynamic data");
+		}
+
+		struct test_end_event *te = new_test_end_event();
+
+		zassert_not_null(te, "Failed to allocate event");
+		te->test_id = TEST_EVENT_POOL;
+		EVENT_SUBMIT(te);
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+EVENT_LISTENER(MODULE, event_handler);
+EVENT_SUBSCRIBE(MODULE, test_start_event);
+EVENT_SUBSCRIBE(MODULE, dyndata_event);
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <event_manager.h>
+
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+#include "native_rtc.h"
+#endif
+
+/* Number of listeners notified about every bench_event in addition to the
+ * listener counting the processed events.
+ */
+#define BENCH_LISTENER_CNT	8
+#define BENCH_BATCH_SIZE	50
+#define BENCH_ROUNDS		200
+#define BENCH_EVENT_CNT		(BENCH_BATCH_SIZE * BENCH_ROUNDS)
+
+
+struct bench_event {
+	struct event_header header;
+
+	uint32_t val;
+};
+
+EVENT_TYPE_DECLARE(bench_event);
+EVENT_TYPE_DEFINE(bench_event, false, NULL, NULL);
+
+struct bench_base_event {
+	struct event_header header;
+
+	uint32_t val;
+};
+
+EVENT_TYPE_DECLARE(bench_base_event);
+EVENT_TYPE_DEFINE(bench_base_event, false, NULL, NULL);
+
+
+static K_SEM_DEFINE(batch_done_sem, 0, 1);
+static uint32_t batch_cnt;
+static uint32_t listener_calls;
+
+
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+/* Simulated time does not advance while code is executed, use host time. */
+static uint64_t timestamp_get(void)
+{
+	return native_rtc_gettime_us(RTC_CLOCK_REAL);
+}
+
+static uint64_t elapsed_ns(uint64_t start)
+{
+	return (timestamp_get() - start) * NSEC_PER_USEC;
+}
+#else
+static uint64_t timestamp_get(void)
+{
+	return k_cycle_get_32();
+}
+
+static uint64_t elapsed_ns(uint64_t start)
+{
+	uint32_t cycles = k_cycle_get_32() - (uint32_t)start;
+
+	return k_cyc_to_ns_floor64(cycles);
+}
+#endif /* CONFIG_BOARD_NATIVE_POSIX */
+
+static uint64_t bench_run(bool with_listeners)
+{
+	uint64_t start = timestamp_get();
+
+	for (size_t round = 0; round < BENCH_ROUNDS; round++) {
+		for (size_t i = 0; i < BENCH_BATCH_SIZE; i++) {
+			if (with_listeners) {
+				struct bench_event *event = new_bench_event();
+
+				event->val = i;
+				EVENT_SUBMIT(event);
+			} else {
+				struct bench_base_event *event =
+					new_bench_base_event();
+
+				event->val = i;
+				EVENT_SUBMIT(event);
+			}
+		}
+
+		int err = k_sem_take(&batch_done_sem, K_SECONDS(10));
+
+		zassert_equal(err, 0, "Events were not processed");
+	}
+
+	return elapsed_ns(start);
+}
+
+static void test_init(void)
+{
+	zassert_false(event_manager_init(), "Error when initializing");
+}
+
+static void test_dispatch_cost(void)
+{
+	/* Warm up caches and the heap. */
+	(void)bench_run(true);
+	listener_calls = 0;
+
+	uint64_t base_ns = bench_run(false);
+	uint64_t full_ns = bench_run(true);
+
+	zassert_equal(listener_calls, BENCH_EVENT_CNT * BENCH_LISTENER_CNT,
+		      "Invalid number of listener notifications");
+
+	uint64_t listeners_ns = (full_ns > base_ns) ? (full_ns - base_ns) : 0;
+
+	TC_PRINT("Events processed: %u, listeners per event: %u\n",
+		 BENCH_EVENT_CNT, BENCH_LISTENER_CNT + 1);
+	TC_PRINT("Submit and dispatch cost per event: %u ns\n",
+		 (uint32_t)(base_ns / BENCH_EVENT_CNT));
+	TC_PRINT("Notification cost per listener: %u ns\n",
+		 (uint32_t)(listeners_ns /
+			    (BENCH_EVENT_CNT * BENCH_LISTENER_CNT)));
+}
+
+void test_main(void)
+{
+	ztest_test_suite(event_manager_benchmark,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_dispatch_cost)
+			 );
+
+	ztest_run_test_suite(event_manager_benchmark);
+}
+
+
+static bool counter_handler(const struct event_header *eh)
+{
+	batch_cnt++;
+	if (batch_cnt == BENCH_BATCH_SIZE) {
+		batch_cnt = 0;
+		k_sem_give(&batch_done_sem);
+	}
+
+	return false;
+}
+
+EVENT_LISTENER(bench_counter, counter_handler);
+EVENT_SUBSCRIBE_FINAL(bench_counter, bench_event);
+EVENT_SUBSCRIBE_FINAL(bench_counter, bench_base_event);
+
+
+static bool listener_handler(const struct event_header *eh)
+{
+	listener_calls++;
+
+	return false;
+}
+
+#define BENCH_LISTENER_DEFINE(id, subscribe)					\
+	EVENT_LISTENER(_CONCAT(bench_listener_, id), listener_handler);		\
+	subscribe(_CONCAT(bench_listener_, id), bench_event)
+
+/* Subscribers are spread across priority levels. */
+BENCH_LISTENER_DEFINE(0, EVENT_SUBSCRIBE_EARLY);
+BENCH_LISTENER_DEFINE(1, EVENT_SUBSCRIBE_EARLY);
+BENCH_LISTENER_DEFINE(2, EVENT_SUBSCRIBE);
+BENCH_LISTENER_DEFINE(3, EVENT_SUBSCRIBE);
+BENCH_LISTENER_DEFINE(4, EVENT_SUBSCRIBE);
+BENCH_LISTENER_DEFINE(5, EVENT_SUBSCRIBE);
+BENCH_LISTENER_DEFINE(6, EVENT_SUBSCRIBE);
+BENCH_LISTENER_DEFINE(7, EVENT_SUBSCRIBE);
+BUILD_ASSERT(BENCH_LISTENER_CNT == 8);
@@ -0,0 +1,546 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <net/socket.h>
+#include <net/download_client.h>
+
+#define SERVER_ADDR		"192.0.2.1"
+#define SERVER_PORT		8080
+#define SERVER_HOST		"http://" SERVER_ADDR ":8080"
+#define SERVER_FILE		"file.bin"
+#define SERVER_STACK_SIZE	2048
+#define SERVER_PRIORITY		5
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_MULTI_RANGE)
+/* Every range is downloaded over its own connection */
+#define SERVER_WORKER_CNT	CONFIG_DOWNLOAD_CLIENT_MULTI_RANGE_CNT
+#else
+#define SERVER_WORKER_CNT	1
+#endif
+
+#define FILE_SIZE		(64 * 1024)
+#define RESUME_OFFSET		(FILE_SIZE / 3 + 1)
+/* Fragment rejected by the application to stop the multi-range download */
+#define STOP_FRAGMENT		5
+
+/* The server answers requests after the round trip time elapses since the
+ * request is received, to emulate a high latency link. The application
+ * spends a constant time on every fragment, to emulate a flash write.
+ * Transmission over the loopback interface takes no time, so the measured
+ * throughput depends only on how well the client hides both delays.
+ */
+#define LINK_RTT_MS		20
+#define FRAGMENT_PROC_MS	10
+
+static struct download_client client;
+#if defined(CONFIG_DOWNLOAD_CLIENT_MULTI_RANGE)
+static struct download_client_multi dlm;
+static uint8_t received[FILE_SIZE / 8];
+#endif
+
+static K_SEM_DEFINE(server_ready_sem, 0, 1);
+static K_SEM_DEFINE(download_done_sem, 0, 1);
+static K_SEM_DEFINE(download_stopped_sem, 0, 1);
+
+static size_t downloaded;
+static size_t fragment_cnt;
+static size_t data_errors;
+static int download_error;
+static bool stop_download;
+
+
+static uint8_t file_data_get(size_t off)
+{
+	return off % 251;
+}
+
+static int server_send(int fd, const void *buf, size_t len)
+{
+	const uint8_t *data = buf;
+
+	while (len > 0) {
+		ssize_t sent = send(fd, data, len, 0);
+
+		if (sent <= 0) {
+			return -errno;
+		}
+
+		data += sent;
+		len -= sent;
+	}
+
+	return 0;
+}
+
+static int server_respond(int fd, const char *req)
+{
+	char hdr[160];
+	uint8_t body[256];
+	size_t from = 0;
+	size_t to = FILE_SIZE - 1;
+	bool partial = false;
+	int len;
+	int err;
+	char *end;
+	const char *range = strstr(req, "Range: bytes=");
+
+	if (range) {
+		from = strtoul(range + strlen("Range: bytes="), &end, 10);
+		if ((end[0] == '-') && isdigit((unsigned char)end[1])) {
+			to = MIN(strtoul(end + 1, NULL, 10), FILE_SIZE - 1);
+			partial = true;
+		}
+	}
+
+	if (partial) {
+		len = snprintf(hdr, sizeof(hdr),
+			       "HTTP/1.1 206 Partial Content\r\n"
+			       "Content-Range: bytes %u-%u/%u\r\n"
+			       "Content-Length: %u\r\n"
+			       "Connection: keep-alive\r\n"
+			       "\r\n",
+			       from, to, FILE_SIZE, to - from + 1);
+	} else {
+		len = snprintf(hdr, sizeof(hdr),
+			       "HTTP/1.1 200 OK\r\n"
+			       "Content-Length: %u\r\n"
+			       "Connection: keep-alive\r\n"
+			       "\r\n",
+			       to - from + 1);
+	}
+
+	err = server_send(fd, hdr, len);
+	if (err) {
+		return err;
+	}
+
+	for (size_t off = from; off <= to; off += sizeof(body)) {
+		size_t chunk = MIN(sizeof(body), to - off + 1);
+
+		for (size_t i = 0; i < chunk; i++) {
+			body[i] = file_data_get(off + i);
+		}
+
+		err = server_send(fd, body, chunk);
+		if (err) {
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+static void server_connection_handle(int fd)
+{
+	char req[512];
+	size_t len = 0;
+
+	while (true) {
+		ssize_t ret = recv(fd, req + len, sizeof(req) - len - 1, 0);
+
+		if (ret <= 0) {
+			return;
+		}
+
+		/* All requests received now are answered at the same time. */
+		int64_t answer_time = k_uptime_get() + LINK_RTT_MS;
+		char *end;
+
+		len += ret;
+		req[len] = '\0';
+
+		/* Requests may be pipelined, handle all complete ones. */
+		while ((end = strstr(req, "\r\n\r\n")) != NULL) {
+			int64_t wait_time = answer_time - k_uptime_get();
+
+			if (wait_time > 0) {
+				k_sleep(K_MSEC(wait_time));
+			}
+
+			if (server_respond(fd, req)) {
+				return;
+			}
+
+			end += strlen("\r\n\r\n");
+			len -= end - req;
+			memmove(req, end, len + 1);
+		}
+
+		zassert_true(len < sizeof(req) - 1, "Request too long");
+	}
+}
+
+static void server_worker_fn(void *p1, void *p2, void *p3)
+{
+	int fd = (int)(intptr_t)p1;
+
+	while (true) {
+		int conn = accept(fd, NULL, NULL);
+
+		if (conn < 0) {
+			continue;
+		}
+
+		server_connection_handle(conn);
+		close(conn);
+	}
+}
+
+#if SERVER_WORKER_CNT > 1
+static K_THREAD_STACK_ARRAY_DEFINE(server_worker_stack, SERVER_WORKER_CNT - 1,
+				   SERVER_STACK_SIZE);
+static struct k_thread server_worker[SERVER_WORKER_CNT - 1];
+#endif
+
+static void server_thread_fn(void)
+{
+	int fd;
+	int err;
+	int reuse = 1;
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+
+	inet_pton(AF_INET, SERVER_ADDR, &addr.sin_addr);
+
+	fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(fd >= 0, "Failed to create server socket");
+
+	(void)setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	err = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(err, 0, "Failed to bind server socket");
+
+	err = listen(fd, SERVER_WORKER_CNT);
+	zassert_equal(err, 0, "Failed to listen");
+
+#if SERVER_WORKER_CNT > 1
+	/* Additional workers to accept parallel connections */
+	for (size_t i = 0; i < SERVER_WORKER_CNT - 1; i++) {
+		k_thread_create(&server_worker[i], server_worker_stack[i],
+				K_THREAD_STACK_SIZEOF(server_worker_stack[i]),
+				server_worker_fn, (void *)(intptr_t)fd,
+				NULL, NULL, SERVER_PRIORITY, 0, K_NO_WAIT);
+	}
+#endif
+
+	k_sem_give(&server_ready_sem);
+
+	server_worker_fn((void *)(intptr_t)fd, NULL, NULL);
+}
+
+K_THREAD_DEFINE(server_thread, SERVER_STACK_SIZE, server_thread_fn,
+		NULL, NULL, NULL, SERVER_PRIORITY, 0, 0);
+
+
+static int download_client_callback(const struct download_client_evt *event)
+{
+	switch (event->id) {
+	case DOWNLOAD_CLIENT_EVT_FRAGMENT: {
+		const uint8_t *data = event->fragment.buf;
+
+		if (event->fragment.offset != downloaded) {
+			data_errors++;
+		}
+
+		for (size_t i = 0; i < event->fragment.len; i++) {
+			if (data[i] != file_data_get(downloaded + i)) {
+				data_errors++;
+			}
+		}
+
+		downloaded += event->fragment.len;
+		fragment_cnt++;
+
+		k_sleep(K_MSEC(FRAGMENT_PROC_MS));
+		break;
+	}
+	case DOWNLOAD_CLIENT_EVT_DONE:
+		k_sem_give(&download_done_sem);
+		break;
+	case DOWNLOAD_CLIENT_EVT_ERROR:
+		download_error = event->error;
+		k_sem_give(&download_done_sem);
+		/* Do not retry */
+		return 1;
+	}
+
+	return 0;
+}
+
+static void download(size_t from)
+{
+	int err;
+	size_t file_size;
+	int64_t start_time;
+	uint32_t elapsed_ms;
+	const struct download_client_cfg config = {
+		.sec_tag = -1,
+	};
+
+	downloaded = from;
+	fragment_cnt = 0;
+	data_errors = 0;
+	download_error = 0;
+
+	err = download_client_connect(&client, SERVER_HOST, &config);
+	zassert_equal(err, 0, "Failed to connect: %d", err);
+
+	start_time = k_uptime_get();
+
+	err = download_client_start(&client, SERVER_FILE, from);
+	zassert_equal(err, 0, "Failed to start download: %d", err);
+
+	err = k_sem_take(&download_done_sem, K_SECONDS(60));
+	zassert_equal(err, 0, "Download timed out");
+
+	elapsed_ms = MAX(k_uptime_get() - start_time, 1);
+
+	zassert_equal(download_error, 0, "Download error: %d",
+		      download_error);
+	zassert_equal(downloaded, FILE_SIZE, "Invalid amount of data");
+	zassert_equal(data_errors, 0, "Invalid data received");
+
+	err = download_client_file_size_get(&client, &file_size);
+	zassert_equal(err, 0, NULL);
+	zassert_equal(file_size, FILE_SIZE, "Invalid file size");
+
+	err = download_client_disconnect(&client);
+	zassert_equal(err, 0, NULL);
+
+	TC_PRINT("Downloaded %u bytes in %u fragments, %u ms (%u kB/s)\n",
+		 FILE_SIZE - from, fragment_cnt, elapsed_ms,
+		 (FILE_SIZE - from) / elapsed_ms);
+}
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_MULTI_RANGE)
+static int multi_callback(const struct download_client_evt *event)
+{
+	switch (event->id) {
+	case DOWNLOAD_CLIENT_EVT_FRAGMENT: {
+		const uint8_t *data = event->fragment.buf;
+		size_t offset = event->fragment.offset;
+
+		if (stop_download && fragment_cnt == STOP_FRAGMENT) {
+			/* Reject the fragment. It must be delivered again
+			 * when the download is resumed.
+			 */
+			stop_download = false;
+			k_sem_give(&download_stopped_sem);
+			return 1;
+		}
+
+		for (size_t i = 0; i < event->fragment.len; i++) {
+			size_t off = offset + i;
+
+			if (off >= FILE_SIZE ||
+			    (received[off / 8] & BIT(off % 8)) ||
+			    data[i] != file_data_get(off)) {
+				data_errors++;
+				continue;
+			}
+
+			received[off / 8] |= BIT(off % 8);
+		}
+
+		downloaded += event->fragment.len;
+		fragment_cnt++;
+
+		k_sleep(K_MSEC(FRAGMENT_PROC_MS));
+		break;
+	}
+	case DOWNLOAD_CLIENT_EVT_DONE:
+		k_sem_give(&download_done_sem);
+		break;
+	case DOWNLOAD_CLIENT_EVT_ERROR:
+		download_error = event->error;
+		k_sem_give(&download_done_sem);
+		return 1;
+	}
+
+	return 0;
+}
+#endif
+
+static void test_init(void)
+{
+	int err;
+
+	err = k_sem_take(&server_ready_sem, K_SECONDS(10));
+	zassert_equal(err, 0, "Server not started");
+
+	err = download_client_init(&client, download_client_callback);
+	zassert_equal(err, 0, NULL);
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_MULTI_RANGE)
+	err = download_client_multi_init(&dlm, multi_callback);
+	zassert_equal(err, 0, NULL);
+#endif
+}
+
+static void test_download(void)
+{
+	download(0);
+}
+
+static void test_download_resume(void)
+{
+	download(RESUME_OFFSET);
+}
+
+#if defined(CONFIG_DOWNLOAD_CLIENT_MULTI_RANGE)
+static void multi_range_reset(void)
+{
+	memset(received, 0, sizeof(received));
+	downloaded = 0;
+	fragment_cnt = 0;
+	data_errors = 0;
+	download_error = 0;
+}
+
+static void multi_range_check(void)
+{
+	zassert_equal(download_error, 0, "Download error: %d",
+		      download_error);
+	zassert_equal(downloaded, FILE_SIZE, "Invalid amount of data");
+	zassert_equal(data_errors, 0, "Invalid data received");
+
+	for (size_t i = 0; i < sizeof(received); i++) {
+		zassert_equal(received[i], 0xff, "Data missing at %u", i * 8);
+	}
+}
+#endif
+
+static void test_download_multi_range(void)
+{
+#if defined(CONFIG_DOWNLOAD_CLIENT_MULTI_RANGE)
+	int err;
+	int64_t start_time;
+	uint32_t elapsed_ms;
+	const struct download_client_cfg config = {
+		.sec_tag = -1,
+	};
+
+	multi_range_reset();
+
+	start_time = k_uptime_get();
+
+	err = download_client_multi_start(&dlm, SERVER_HOST, &config,
+					  SERVER_FILE, FILE_SIZE);
+	zassert_equal(err, 0, "Failed to start download: %d", err);
+
+	err = k_sem_take(&download_done_sem, K_SECONDS(60));
+	zassert_equal(err, 0, "Download timed out");
+
+	elapsed_ms = MAX(k_uptime_get() - start_time, 1);
+
+	multi_range_check();
+
+	download_client_multi_disconnect(&dlm);
+
+	TC_PRINT("Downloaded %u bytes over %u connections in %u fragments, "
+		 "%u ms (%u kB/s)\n",
+		 FILE_SIZE, CONFIG_DOWNLOAD_CLIENT_MULTI_RANGE_CNT,
+		 fragment_cnt, elapsed_ms, FILE_SIZE / elapsed_ms);
+#else
+	ztest_test_skip();
+#endif
+}
+
+static void test_download_multi_range_resume(void)
+{
+#if defined(CONFIG_DOWNLOAD_CLIENT_MULTI_RANGE)
+	int err;
+	const struct download_client_cfg config = {
+		.sec_tag = -1,
+	};
+
+	multi_range_reset();
+	stop_download = true;
+
+	err = download_client_multi_start(&dlm, SERVER_HOST, &config,
+					  SERVER_FILE, FILE_SIZE);
+	zassert_equal(err, 0, "Failed to start download: %d", err);
+
+	err = k_sem_take(&download_stopped_sem, K_SECONDS(60));
+	zassert_equal(err, 0, "Download not stopped");
+
+	/* Let the other ranges receive the fragments in flight. They are
+	 * dropped, because the download is stopped.
+	 */
+	k_sleep(K_MSEC(10 * LINK_RTT_MS));
+
+	zassert_equal(fragment_cnt, STOP_FRAGMENT,
+		      "Fragments delivered after stop");
+
+	err = download_client_multi_resume(&dlm);
+	zassert_equal(err, 0, "Failed to resume download: %d", err);
+
+	err = k_sem_take(&download_done_sem, K_SECONDS(60));
+	zassert_equal(err, 0, "Download timed out");
+
+	multi_range_check();
+
+	download_client_multi_disconnect(&dlm);
+#else
+	ztest_test_skip();
+#endif
+}
+
+static void test_download_multi_range_resume_busy(void)
+{
+#if defined(CONFIG_DOWNLOAD_CLIENT_MULTI_RANGE)
+	int err;
+	const struct download_client_cfg config = {
+		.sec_tag = -1,
+	};
+
+	multi_range_reset();
+	stop_download = true;
+
+	err = download_client_multi_start(&dlm, SERVER_HOST, &config,
+					  SERVER_FILE, FILE_SIZE);
+	zassert_equal(err, 0, "Failed to start download: %d", err);
+
+	err = k_sem_take(&download_stopped_sem, K_SECONDS(60));
+	zassert_equal(err, 0, "Download not stopped");
+
+	/* Resume while the other ranges are still receiving. No event of
+	 * the stopped download may be delivered after it is resumed.
+	 */
+	err = download_client_multi_resume(&dlm);
+	zassert_equal(err, 0, "Failed to resume download: %d", err);
+
+	err = k_sem_take(&download_done_sem, K_SECONDS(60));
+	zassert_equal(err, 0, "Download timed out");
+
+	multi_range_check();
+
+	download_client_multi_disconnect(&dlm);
+#else
+	ztest_test_skip();
+#endif
+}
+
+void test_main(void)
+{
+	ztest_test_suite(download_client,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_download),
+			 ztest_unit_test(test_download_resume),
+			 ztest_unit_test(test_download_multi_range),
+			 ztest_unit_test(test_download_multi_range_resume),
+			 ztest_unit_test(test_download_multi_range_resume_busy)
+			 );
+
+	ztest_run_test_suite(download_client);
+}
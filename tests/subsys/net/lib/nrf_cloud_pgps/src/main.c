@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include <net/download_client.h>
+#include <date_time.h>
+#include <net/nrf_cloud_pgps.h>
+#include <nrf_cloud_pgps_utils.h>
+
+/* Simulated server file: a P-GPS header followed by a set of predictions. */
+#define FILE_SIZE (sizeof(struct nrf_cloud_pgps_header) + \
+		   NUM_PREDICTIONS * PGPS_PREDICTION_DL_SIZE)
+#define FRAGMENT_SIZE 1024
+#define SOCKET_RETRIES CONFIG_FOTA_SOCKET_RETRIES
+
+static uint8_t server_file[FILE_SIZE];
+
+/* Stubs and mocks */
+static download_client_callback_t dl_callback;
+static size_t server_pos;
+static size_t server_overlap;
+static size_t bytes_sent;
+static size_t start_from;
+static int start_count;
+
+static uint8_t received[FILE_SIZE];
+static size_t received_len;
+static int handler_err;
+static int error_count;
+static int last_error;
+
+int date_time_now(int64_t *unix_time_ms)
+{
+	return -ENODATA;
+}
+
+int download_client_init(struct download_client *client,
+			 download_client_callback_t callback)
+{
+	dl_callback = callback;
+	return 0;
+}
+
+int download_client_connect(struct download_client *client, const char *host,
+			    const struct download_client_cfg *config)
+{
+	return 0;
+}
+
+int download_client_start(struct download_client *client, const char *file,
+			  size_t from)
+{
+	start_from = from;
+	start_count++;
+	/* a server may send data from before the requested offset */
+	server_pos = from - MIN(from, server_overlap);
+	return 0;
+}
+
+int download_client_disconnect(struct download_client *client)
+{
+	return 0;
+}
+
+static int buffer_handler(uint8_t *buf, size_t len)
+{
+	if (handler_err) {
+		return handler_err;
+	}
+	if ((received_len + len > FILE_SIZE) ||
+	    memcmp(buf, &server_file[received_len], len)) {
+		return -EINVAL;
+	}
+	memcpy(&received[received_len], buf, len);
+	received_len += len;
+	return 0;
+}
+
+static void error_handler(int err)
+{
+	error_count++;
+	last_error = err;
+}
+
+/* Send the file from the current position up to the given offset, as the
+ * download client does.
+ */
+static int server_send(size_t until)
+{
+	int err;
+
+	while (server_pos < until) {
+		const struct download_client_evt evt = {
+			.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
+			.fragment = {
+				.buf = &server_file[server_pos],
+				.len = MIN(FRAGMENT_SIZE, until - server_pos),
+				.offset = server_pos,
+			},
+		};
+
+		bytes_sent += evt.fragment.len;
+		server_pos += evt.fragment.len;
+		err = dl_callback(&evt);
+		if (err) {
+			return err;
+		}
+	}
+	return 0;
+}
+
+static int server_event(enum download_client_evt_id id, int error)
+{
+	const struct download_client_evt evt = {
+		.id = id,
+		.error = error,
+	};
+
+	return dl_callback(&evt);
+}
+
+/* Lose the connection until the download client gives up. */
+static void server_drop(void)
+{
+	for (int i = 0; i < SOCKET_RETRIES; i++) {
+		zassert_equal(server_event(DOWNLOAD_CLIENT_EVT_ERROR, -ECONNRESET),
+			      0, "Download not retried");
+	}
+	zassert_not_equal(server_event(DOWNLOAD_CLIENT_EVT_ERROR, -ECONNRESET),
+			  0, "Download not stopped");
+}
+
+static void reset(void)
+{
+	server_pos = 0;
+	server_overlap = 0;
+	bytes_sent = 0;
+	start_count = 0;
+	received_len = 0;
+	handler_err = 0;
+	error_count = 0;
+	last_error = 0;
+}
+
+static void test_init(void)
+{
+	for (size_t i = 0; i < sizeof(server_file); i++) {
+		server_file[i] = (i * 31 + i / 256) & 0xff;
+	}
+
+	zassert_equal(npgps_download_init(buffer_handler, error_handler), 0,
+		      NULL);
+	zassert_equal(npgps_download_resume(), -ENOENT,
+		      "Resumed without a download");
+}
+
+static void test_download(void)
+{
+	reset();
+
+	zassert_equal(npgps_download_start("host", "file", -1, NULL,
+					   FRAGMENT_SIZE), 0, NULL);
+	zassert_equal(start_from, 0, NULL);
+	zassert_equal(npgps_download_start("host", "file", -1, NULL,
+					   FRAGMENT_SIZE), -EBUSY,
+		      "Second download started");
+
+	zassert_equal(server_send(FILE_SIZE), 0, NULL);
+	zassert_equal(server_event(DOWNLOAD_CLIENT_EVT_DONE, 0), 0, NULL);
+
+	zassert_equal(received_len, FILE_SIZE, NULL);
+	zassert_equal(npgps_download_received(), FILE_SIZE, NULL);
+	zassert_equal(bytes_sent, FILE_SIZE, NULL);
+	zassert_equal(error_count, 0, NULL);
+}
+
+static void test_socket_retries(void)
+{
+	reset();
+
+	zassert_equal(npgps_download_start("host", "file", -1, NULL,
+					   FRAGMENT_SIZE), 0, NULL);
+	zassert_equal(server_send(FILE_SIZE / 2), 0, NULL);
+
+	/* the download client reconnects and continues by itself */
+	zassert_equal(server_event(DOWNLOAD_CLIENT_EVT_ERROR, -ECONNRESET), 0,
+		      NULL);
+	zassert_equal(server_send(FILE_SIZE), 0, NULL);
+	zassert_equal(server_event(DOWNLOAD_CLIENT_EVT_DONE, 0), 0, NULL);
+
+	zassert_equal(received_len, FILE_SIZE, NULL);
+	zassert_equal(error_count, 0, NULL);
+	zassert_equal(start_count, 1, NULL);
+}
+
+static void run_interrupted(const size_t *drops, int num_drops, size_t overlap)
+{
+	size_t restart_bytes = FILE_SIZE;
+
+	reset();
+	server_overlap = overlap;
+
+	zassert_equal(npgps_download_start("host", "file", -1, NULL,
+					   FRAGMENT_SIZE), 0, NULL);
+
+	for (int i = 0; i < num_drops; i++) {
+		zassert_equal(server_send(drops[i]), 0, NULL);
+		server_drop();
+
+		zassert_equal(error_count, i + 1, "Interruption not reported");
+		zassert_equal(last_error, -ECONNRESET, NULL);
+		zassert_equal(npgps_download_received(), drops[i], NULL);
+
+		zassert_equal(npgps_download_resume(), 0, NULL);
+		zassert_equal(start_from, drops[i], "Not resumed at last byte");
+
+		/* starting over would send everything received again */
+		restart_bytes += drops[i];
+	}
+
+	zassert_equal(server_send(FILE_SIZE), 0, NULL);
+	zassert_equal(server_event(DOWNLOAD_CLIENT_EVT_DONE, 0), 0, NULL);
+
+	zassert_equal(received_len, FILE_SIZE, NULL);
+	zassert_mem_equal(received, server_file, FILE_SIZE, NULL);
+	zassert_equal(start_count, num_drops + 1, NULL);
+	zassert_true(bytes_sent <= FILE_SIZE + num_drops * overlap, NULL);
+
+	TC_PRINT("%d interruptions: %zu bytes transferred for %zu byte file, "
+		 "%zu when starting over\n",
+		 num_drops, bytes_sent, (size_t)FILE_SIZE, restart_bytes);
+}
+
+static void test_resume(void)
+{
+	/* in the middle of predictions, and in the header */
+	const size_t drops[] = {
+		FILE_SIZE / 4 + 123,
+		FILE_SIZE / 2 + 7,
+		3 * FILE_SIZE / 4 + PGPS_PREDICTION_DL_SIZE / 2,
+	};
+	const size_t header_drop[] = { sizeof(struct nrf_cloud_pgps_header) / 2 };
+
+	run_interrupted(drops, ARRAY_SIZE(drops), 0);
+	run_interrupted(header_drop, ARRAY_SIZE(header_drop), 0);
+}
+
+static void test_resume_overlap(void)
+{
+	const size_t drops[] = {
+		FILE_SIZE / 3 + 1,
+		2 * FILE_SIZE / 3 + 1,
+	};
+
+	/* data received again is not handled twice */
+	run_interrupted(drops, ARRAY_SIZE(drops), FRAGMENT_SIZE / 2 + 3);
+}
+
+static void test_gap(void)
+{
+	const struct download_client_evt evt = {
+		.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
+		.fragment = {
+			.buf = &server_file[FRAGMENT_SIZE + 1],
+			.len = FRAGMENT_SIZE,
+			.offset = FRAGMENT_SIZE + 1,
+		},
+	};
+
+	reset();
+
+	zassert_equal(npgps_download_start("host", "file", -1, NULL,
+					   FRAGMENT_SIZE), 0, NULL);
+	zassert_equal(server_send(FRAGMENT_SIZE), 0, NULL);
+	zassert_not_equal(dl_callback(&evt), 0, "Missing data not detected");
+	zassert_equal(received_len, FRAGMENT_SIZE, NULL);
+}
+
+static void test_handler_error(void)
+{
+	reset();
+
+	zassert_equal(npgps_download_start("host", "file", -1, NULL,
+					   FRAGMENT_SIZE), 0, NULL);
+	handler_err = -ENOMEM;
+	zassert_equal(server_send(FILE_SIZE), -ENOMEM, NULL);
+
+	/* only interruptions are reported, and the download can restart */
+	zassert_equal(error_count, 0, NULL);
+	zassert_equal(npgps_download_received(), 0, NULL);
+	zassert_equal(npgps_download_start("host", "file", -1, NULL,
+					   FRAGMENT_SIZE), 0, NULL);
+	handler_err = 0;
+	zassert_equal(server_send(FILE_SIZE), 0, NULL);
+	zassert_equal(server_event(DOWNLOAD_CLIENT_EVT_DONE, 0), 0, NULL);
+	zassert_equal(received_len, FILE_SIZE, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(nrf_cloud_pgps_test,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_download),
+			 ztest_unit_test(test_socket_retries),
+			 ztest_unit_test(test_resume),
+			 ztest_unit_test(test_resume_overlap),
+			 ztest_unit_test(test_gap),
+			 ztest_unit_test(test_handler_error)
+			 );
+
+	ztest_run_test_suite(nrf_cloud_pgps_test);
+}
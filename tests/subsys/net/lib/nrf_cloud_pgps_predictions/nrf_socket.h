@@ -0,0 +1,10 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* modem library header replaced to build the test for native_posix */
+#ifndef NRF_SOCKET_H__
+#define NRF_SOCKET_H__
+#endif /* NRF_SOCKET_H__ */
@@ -0,0 +1,677 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include <net/download_client.h>
+#include <settings/settings.h>
+#include <storage/stream_flash.h>
+
+/* include the module to reach its state */
+#include "nrf_cloud_pgps.c"
+
+#define START_DAY 15000
+#define START_SEC ((int64_t)START_DAY * SEC_PER_DAY)
+#define PERIOD_SEC (PREDICTION_PERIOD * SEC_PER_MIN)
+#define SERVER_FRAGMENT_SIZE 1024
+#define SOCKET_RETRIES CONFIG_FOTA_SOCKET_RETRIES
+#define DL_INFO "[\"host\",\"file\"]"
+
+/* Simulated server file: a P-GPS header followed by a set of predictions. */
+static uint8_t server_file[sizeof(struct nrf_cloud_pgps_header) +
+			   NUM_PREDICTIONS * PGPS_PREDICTION_DL_SIZE];
+static size_t server_size;
+
+/* flash storage of the predictions */
+static uint8_t flash[NUM_BLOCKS * BLOCK_SIZE] __aligned(4);
+
+/* Stubs and mocks */
+static download_client_callback_t dl_callback;
+static size_t server_pos;
+static size_t bytes_sent;
+static size_t start_from;
+
+static int64_t now_ms;
+static uint8_t *flash_pos;
+static uint8_t *flash_end;
+
+static int request_count;
+static cJSON *last_request;
+static enum nrf_cloud_pgps_event last_event;
+
+/* Settings kept in RAM, as a settings backend keeps them in flash. */
+struct setting {
+	char name[32];
+	uint8_t value[128];
+	size_t len;
+};
+
+static struct setting settings[8];
+
+static struct setting *setting_find(const char *name)
+{
+	for (int i = 0; i < ARRAY_SIZE(settings); i++) {
+		if (settings[i].len && !strcmp(settings[i].name, name)) {
+			return &settings[i];
+		}
+	}
+	return NULL;
+}
+
+static ssize_t setting_read(void *cb_arg, void *data, size_t len)
+{
+	struct setting *s = cb_arg;
+
+	len = MIN(len, s->len);
+	memcpy(data, s->value, len);
+	return len;
+}
+
+static int settings_ram_load(struct settings_store *cs,
+			     const struct settings_load_arg *arg)
+{
+	for (int i = 0; i < ARRAY_SIZE(settings); i++) {
+		if (settings[i].len) {
+			settings_call_set_handler(settings[i].name, settings[i].len,
+						  setting_read, &settings[i], arg);
+		}
+	}
+	return 0;
+}
+
+static int settings_ram_save(struct settings_store *cs, const char *name,
+			     const char *value, size_t val_len)
+{
+	struct setting *s = setting_find(name);
+
+	if (!val_len) {
+		if (s) {
+			s->len = 0;
+		}
+		return 0;
+	}
+	for (int i = 0; (s == NULL) && (i < ARRAY_SIZE(settings)); i++) {
+		if (!settings[i].len) {
+			s = &settings[i];
+		}
+	}
+	if ((s == NULL) || (val_len > sizeof(s->value)) ||
+	    (strlen(name) >= sizeof(s->name))) {
+		return -ENOMEM;
+	}
+	strcpy(s->name, name);
+	memcpy(s->value, value, val_len);
+	s->len = val_len;
+	return 0;
+}
+
+static const struct settings_store_itf settings_ram_itf = {
+	.csi_load = settings_ram_load,
+	.csi_save = settings_ram_save,
+};
+
+static struct settings_store settings_ram_store = {
+	.cs_itf = &settings_ram_itf,
+};
+
+int settings_backend_init(void)
+{
+	settings_dst_register(&settings_ram_store);
+	settings_src_register(&settings_ram_store);
+	return 0;
+}
+
+int date_time_now(int64_t *unix_time_ms)
+{
+	*unix_time_ms = now_ms;
+	return 0;
+}
+
+int nct_dc_send(const struct nct_dc_data *dc)
+{
+	request_count++;
+	cJSON_Delete(last_request);
+	last_request = cJSON_Parse(dc->data.ptr);
+	return 0;
+}
+
+int nrf_cloud_agps_process(const char *buf, size_t buf_len, const int *socket)
+{
+	return 0;
+}
+
+void nrf_cloud_agps_processed(struct gps_agps_request *received_elements)
+{
+	memset(received_elements, 0, sizeof(*received_elements));
+}
+
+int stream_flash_init(struct stream_flash_ctx *ctx, const struct device *fdev,
+		      uint8_t *buf, size_t buf_len, size_t offset, size_t size,
+		      stream_flash_callback_t cb)
+{
+	if ((offset < (uint32_t)flash) ||
+	    (offset + size > (uint32_t)flash + sizeof(flash))) {
+		return -EINVAL;
+	}
+	flash_pos = (uint8_t *)offset;
+	flash_end = flash_pos + size;
+	return 0;
+}
+
+int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *data,
+				size_t len, bool flush)
+{
+	if (len > (flash_end - flash_pos)) {
+		return -EFBIG;
+	}
+	if (len) {
+		memcpy(flash_pos, data, len);
+	}
+	flash_pos += len;
+	return 0;
+}
+
+int download_client_init(struct download_client *client,
+			 download_client_callback_t callback)
+{
+	dl_callback = callback;
+	return 0;
+}
+
+int download_client_connect(struct download_client *client, const char *host,
+			    const struct download_client_cfg *config)
+{
+	return 0;
+}
+
+int download_client_start(struct download_client *client, const char *file,
+			  size_t from)
+{
+	start_from = from;
+	server_pos = from;
+	return 0;
+}
+
+int download_client_disconnect(struct download_client *client)
+{
+	return 0;
+}
+
+static void pgps_handler(enum nrf_cloud_pgps_event event,
+			 struct nrf_cloud_pgps_prediction *p)
+{
+	last_event = event;
+}
+
+/* Send the file from the current position up to the given offset, as the
+ * download client does.
+ */
+static int server_send(size_t until)
+{
+	int err;
+
+	while (server_pos < until) {
+		const struct download_client_evt evt = {
+			.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
+			.fragment = {
+				.buf = &server_file[server_pos],
+				.len = MIN(SERVER_FRAGMENT_SIZE, until - server_pos),
+				.offset = server_pos,
+			},
+		};
+
+		bytes_sent += evt.fragment.len;
+		server_pos += evt.fragment.len;
+		err = dl_callback(&evt);
+		if (err) {
+			return err;
+		}
+	}
+	return 0;
+}
+
+static int server_event(enum download_client_evt_id id, int error)
+{
+	const struct download_client_evt evt = {
+		.id = id,
+		.error = error,
+	};
+
+	return dl_callback(&evt);
+}
+
+/* Lose the connection until the download client gives up. */
+static void server_drop(void)
+{
+	for (int i = 0; i < SOCKET_RETRIES; i++) {
+		zassert_equal(server_event(DOWNLOAD_CLIENT_EVT_ERROR, -ECONNRESET),
+			      0, "Download not retried");
+	}
+	zassert_not_equal(server_event(DOWNLOAD_CLIENT_EVT_ERROR, -ECONNRESET),
+			  0, "Download not stopped");
+}
+
+/* Prediction num pnum as the cloud creates it, and as it is stored. */
+static void make_prediction(int pnum, struct nrf_cloud_pgps_prediction *p)
+{
+	int64_t gps_sec = START_SEC + pnum * PERIOD_SEC;
+	uint16_t gps_day;
+	uint32_t gps_time_of_day;
+
+	npgps_gps_sec_to_day_time(gps_sec, &gps_day, &gps_time_of_day);
+
+	memset(p, 0, sizeof(*p));
+	p->time_type = NRF_CLOUD_AGPS_GPS_SYSTEM_CLOCK;
+	p->time_count = 1;
+	p->time.date_day = gps_day;
+	p->time.time_full_s = gps_time_of_day;
+	p->schema_version = NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION;
+	p->ephemeris_type = NRF_CLOUD_AGPS_EPHEMERIDES;
+	p->ephemeris_count = NRF_CLOUD_PGPS_NUM_SV;
+	for (int i = 0; i < NRF_CLOUD_PGPS_NUM_SV; i++) {
+		p->ephemerii[i].sv_id = i + 1;
+		p->ephemerii[i].toe = pnum + 1;
+		p->ephemerii[i].af0 = pnum * 1000 + i;
+	}
+	p->sentinel = (uint32_t)gps_sec;
+}
+
+/* Server file with the predictions from prediction num first on. */
+static void make_server_file(int first)
+{
+	const size_t schema_offset = offsetof(struct nrf_cloud_pgps_prediction,
+					      schema_version);
+	struct nrf_cloud_pgps_prediction p;
+	struct nrf_cloud_pgps_header header = {
+		.schema_version = NRF_CLOUD_PGPS_BIN_SCHEMA_VERSION,
+		.array_type = NRF_CLOUD_PGPS_PREDICTION_HEADER,
+		.num_items = 1,
+		.prediction_count = NUM_PREDICTIONS - first,
+		.prediction_size = PGPS_PREDICTION_DL_SIZE,
+		.prediction_period_min = PREDICTION_PERIOD,
+	};
+	uint16_t gps_day;
+	uint32_t gps_time_of_day;
+	uint8_t *pos = server_file;
+
+	npgps_gps_sec_to_day_time(START_SEC + first * PERIOD_SEC, &gps_day,
+				  &gps_time_of_day);
+	header.gps_day = gps_day;
+	header.gps_time_of_day = gps_time_of_day;
+	memcpy(pos, &header, sizeof(header));
+	pos += sizeof(header);
+
+	/* the schema version and the sentinel are not downloaded */
+	for (int pnum = first; pnum < NUM_PREDICTIONS; pnum++) {
+		make_prediction(pnum, &p);
+		memcpy(pos, &p, schema_offset);
+		memcpy(pos + schema_offset, &p.ephemeris_type,
+		       PGPS_PREDICTION_DL_SIZE - schema_offset);
+		pos += PGPS_PREDICTION_DL_SIZE;
+	}
+	server_size = pos - server_file;
+	server_pos = 0;
+	bytes_sent = 0;
+}
+
+/* Set the current time within prediction num pnum; predictions are looked up
+ * for the middle of their validity period.
+ */
+static void set_time(int pnum)
+{
+	int64_t gps_sec = START_SEC + pnum * PERIOD_SEC + SEC_PER_MIN -
+			  PREDICTION_MIDPOINT_SHIFT_SEC;
+
+	now_ms = (gps_sec + GPS_TO_UNIX_UTC_OFFSET_SECONDS - GPS_TO_UTC_LEAP_SECONDS) *
+		 MSEC_PER_SEC;
+}
+
+static int requested(const char *key)
+{
+	cJSON *data = cJSON_GetObjectItem(last_request, PGPS_JSON_DATA_KEY);
+	cJSON *item = cJSON_GetObjectItem(data, key);
+
+	return cJSON_IsNumber(item) ? item->valueint : -1;
+}
+
+/* Check that the predictions from prediction num first on are requested. */
+static void check_request(int first)
+{
+	uint16_t gps_day;
+	uint32_t gps_time_of_day;
+
+	zassert_equal(request_count, 1, "Predictions not requested");
+	zassert_equal(requested(PGPS_JSON_PRED_COUNT), NUM_PREDICTIONS - first,
+		      NULL);
+	if (first) {
+		npgps_gps_sec_to_day_time(START_SEC + first * PERIOD_SEC, &gps_day,
+					  &gps_time_of_day);
+		zassert_equal(requested(PGPS_JSON_GPS_DAY), gps_day, NULL);
+		zassert_equal(requested(PGPS_JSON_GPS_TIME), gps_time_of_day, NULL);
+	}
+}
+
+static void check_predictions(int first)
+{
+	struct nrf_cloud_pgps_prediction expected;
+
+	for (int pnum = first; pnum < NUM_PREDICTIONS; pnum++) {
+		make_prediction(pnum, &expected);
+		zassert_not_null(index.predictions[pnum],
+				 "Prediction num:%d missing", pnum);
+		zassert_mem_equal(index.predictions[pnum], &expected,
+				  sizeof(expected), "Prediction num:%d wrong", pnum);
+	}
+}
+
+/* Start the module, with the storage and the settings left by the previous
+ * run, as after a reset.
+ */
+static void boot(void)
+{
+	struct nrf_cloud_pgps_init_param param = {
+		.event_handler = pgps_handler,
+		.storage_base = (uint32_t)flash,
+		.storage_size = sizeof(flash),
+	};
+
+	state = PGPS_NONE;
+	k_timer_stop(&prediction_timer);
+	(void)k_work_cancel_delayable(&resume_work);
+	request_count = 0;
+	zassert_equal(nrf_cloud_pgps_init(&param), 0, NULL);
+}
+
+static void erase(void)
+{
+	struct nrf_cloud_pgps_header header;
+
+	memset(&header, 0, sizeof(header));
+	memset(flash, 0xff, sizeof(flash));
+	memset(settings, 0, sizeof(settings));
+	zassert_equal(settings_subsys_init(), 0, NULL);
+	(void)npgps_clear_index();
+	zassert_equal(npgps_save_header(&header), 0, NULL);
+}
+
+static void start_download(int first)
+{
+	make_server_file(first);
+	zassert_equal(nrf_cloud_pgps_process(DL_INFO, strlen(DL_INFO)), 0, NULL);
+}
+
+static void finish_download(void)
+{
+	zassert_equal(server_send(server_size), 0, NULL);
+	zassert_equal(server_event(DOWNLOAD_CLIENT_EVT_DONE, 0), 0, NULL);
+	zassert_equal(state, PGPS_READY, "Predictions not loaded");
+	zassert_equal(last_event, PGPS_EVT_READY, NULL);
+	zassert_not_null(npgps_get_saved_index(), "Index not saved");
+}
+
+/* Start without stored predictions and download a full set. */
+static void load_all(int pnum)
+{
+	erase();
+	set_time(pnum);
+	boot();
+	zassert_equal(last_event, PGPS_EVT_UNAVAILABLE, NULL);
+	check_request(0);
+	start_download(0);
+	finish_download();
+	check_predictions(0);
+}
+
+static void test_index_round_trip(void)
+{
+	struct nrf_cloud_pgps_prediction *loaded[NUM_PREDICTIONS];
+	struct npgps_index saved;
+	struct setting *s;
+
+	load_all(1);
+	memcpy(loaded, index.predictions, sizeof(loaded));
+
+	s = setting_find("nrf_cloud_pgps/index");
+	zassert_not_null(s, "Index not saved in settings");
+	zassert_equal(s->len, sizeof(saved), NULL);
+	memcpy(&saved, s->value, sizeof(saved));
+	for (int pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+		zassert_equal(saved.blocks[pnum],
+			      npgps_pointer_to_block((uint8_t *)loaded[pnum]), NULL);
+		zassert_not_equal(saved.pred_crc[pnum], 0, NULL);
+		zassert_equal(saved.pred_crc[pnum],
+			      crc32_ieee((uint8_t *)loaded[pnum], sizeof(*loaded[pnum])),
+			      NULL);
+	}
+
+	/* only the prediction in use is checked at startup */
+	boot();
+	zassert_equal(state, PGPS_READY, NULL);
+	zassert_equal(request_count, 0, "Predictions requested again");
+	zassert_mem_equal(index.predictions, loaded, sizeof(loaded), NULL);
+	for (int pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+		zassert_equal(index.validated[pnum], pnum == 1,
+			      "Prediction num:%d checked", pnum);
+		zassert_equal(index.pred_crc[pnum], saved.pred_crc[pnum], NULL);
+	}
+
+	/* without a valid saved index, all predictions are checked */
+	s->value[offsetof(struct npgps_index, crc)] ^= 1;
+	boot();
+	zassert_equal(state, PGPS_READY, NULL);
+	zassert_equal(request_count, 0, "Predictions requested again");
+	zassert_mem_equal(index.predictions, loaded, sizeof(loaded), NULL);
+	for (int pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+		zassert_true(index.validated[pnum], "Prediction num:%d not checked",
+			     pnum);
+	}
+	zassert_not_null(npgps_get_saved_index(), "Index not saved again");
+}
+
+static void test_crc_mismatch(void)
+{
+	struct nrf_cloud_pgps_prediction *p;
+	struct nrf_cloud_pgps_prediction *bad;
+
+	load_all(1);
+	boot();
+
+	/* change stored data not covered by the checks of the prediction header */
+	bad = index.predictions[4];
+	bad->ephemerii[3].af0 ^= 1;
+
+	set_time(4);
+	zassert_equal(nrf_cloud_pgps_find_prediction(&p), -ELOADING, NULL);
+	zassert_is_null(p, NULL);
+	zassert_is_null(npgps_get_saved_index(), "Index kept for changed data");
+	for (int pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+		zassert_equal(index.predictions[pnum] == NULL, pnum >= 4,
+			      "Prediction num:%d not dropped", pnum);
+	}
+
+	/* the bad prediction and the ones after it are downloaded again */
+	check_request(4);
+	start_download(4);
+	zassert_equal_ptr(npgps_block_to_pointer(index.store_block), bad,
+			  "Not stored in the freed block");
+	finish_download();
+	check_predictions(0);
+
+	zassert_equal(nrf_cloud_pgps_find_prediction(&p), 4, NULL);
+	zassert_equal_ptr(p, index.predictions[4], NULL);
+}
+
+static void test_header_mismatch(void)
+{
+	struct nrf_cloud_pgps_prediction *p;
+
+	load_all(1);
+
+	/* the prediction in use at startup is not the one in the index */
+	index.predictions[2]->time_type = 0;
+	set_time(2);
+	boot();
+	zassert_equal(last_event, PGPS_EVT_LOADING, NULL);
+	zassert_true(nrf_cloud_pgps_loading(), NULL);
+	check_request(2);
+	zassert_is_null(index.predictions[2], "Bad prediction kept");
+
+	start_download(2);
+	finish_download();
+	check_predictions(0);
+
+	zassert_equal(nrf_cloud_pgps_find_prediction(&p), 2, NULL);
+	zassert_equal_ptr(p, index.predictions[2], NULL);
+}
+
+static void test_discard_cur_pnum(void)
+{
+	struct nrf_cloud_pgps_prediction *p;
+	struct nrf_cloud_pgps_prediction *cur;
+
+	load_all(1);
+
+	set_time(5);
+	zassert_equal(nrf_cloud_pgps_find_prediction(&cur), 5, NULL);
+
+	discard_oldest_predictions(3);
+	zassert_equal(index.cur_pnum, 2, "Current prediction num not moved");
+	zassert_equal_ptr(index.predictions[2], cur, NULL);
+	zassert_true(index.validated[2], NULL);
+	for (int pnum = NUM_PREDICTIONS - 3; pnum < NUM_PREDICTIONS; pnum++) {
+		zassert_is_null(index.predictions[pnum], NULL);
+	}
+	zassert_equal(npgps_num_free(), 3, NULL);
+
+	/* the same time finds the same prediction */
+	zassert_equal(nrf_cloud_pgps_find_prediction(&p), 2, NULL);
+	zassert_equal_ptr(p, cur, NULL);
+
+	/* no current prediction once it is discarded */
+	discard_oldest_predictions(3);
+	zassert_equal(index.cur_pnum, 0xff, NULL);
+}
+
+static void test_resume_mid_prediction(void)
+{
+	const size_t partial = PGPS_PREDICTION_DL_SIZE / 3;
+	const size_t drop = sizeof(struct nrf_cloud_pgps_header) +
+			    2 * PGPS_PREDICTION_DL_SIZE + partial;
+
+	erase();
+	set_time(1);
+	boot();
+	start_download(0);
+	zassert_equal(server_send(drop), 0, NULL);
+	server_drop();
+
+	/* the start of the next prediction is kept until the rest arrives */
+	zassert_true(index.dl_interrupted, NULL);
+	zassert_equal(index.dl_pnum, 2, NULL);
+	zassert_equal(index.pred_offset, partial, NULL);
+	zassert_mem_equal(prediction_buf, &server_file[drop - partial], partial, NULL);
+	zassert_not_null(index.predictions[1], NULL);
+	zassert_is_null(index.predictions[2], NULL);
+
+	zassert_equal(resume_download(), 0, NULL);
+	zassert_equal(start_from, drop, "Not resumed at last byte");
+	finish_download();
+	check_predictions(0);
+
+	zassert_equal(bytes_sent, server_size, "Data sent again");
+	zassert_equal(request_count, 1, "Predictions requested again");
+}
+
+static void test_request_remaining(void)
+{
+	const size_t drop = sizeof(struct nrf_cloud_pgps_header) +
+			    3 * PGPS_PREDICTION_DL_SIZE + 100;
+	int block;
+
+	erase();
+	set_time(1);
+	boot();
+	start_download(0);
+	zassert_equal(server_send(drop), 0, NULL);
+	server_drop();
+	block = index.store_block;
+	zassert_not_equal(block, NO_BLOCK, NULL);
+
+	/* resumed until the retries run out */
+	for (int i = 0; i < RESUME_RETRIES; i++) {
+		zassert_equal(resume_download(), 0, NULL);
+		server_drop();
+	}
+	request_count = 0;
+	zassert_equal(resume_download(), 0, NULL);
+
+	/* the block of the next prediction is free until it is loaded */
+	zassert_equal(index.store_block, NO_BLOCK, NULL);
+	zassert_equal(npgps_num_free(), NUM_PREDICTIONS - 3, NULL);
+	check_request(3);
+
+	start_download(3);
+	zassert_equal(index.store_block, block, "Not stored in the same block");
+	finish_download();
+	check_predictions(0);
+	zassert_equal(npgps_num_free(), 0, NULL);
+}
+
+static void test_prediction_crc(void)
+{
+	struct nrf_cloud_pgps_prediction *p;
+	struct nrf_cloud_pgps_prediction *unknown;
+	struct nrf_cloud_pgps_prediction *changed;
+
+	load_all(1);
+	boot();
+
+	/* a prediction matching its checksum is used */
+	set_time(3);
+	zassert_false(index.validated[3], NULL);
+	zassert_equal(nrf_cloud_pgps_find_prediction(&p), 3, NULL);
+	zassert_equal_ptr(p, index.predictions[3], NULL);
+	zassert_true(index.validated[3], NULL);
+
+	/* without a known checksum, only the prediction header is checked */
+	unknown = index.predictions[5];
+	index.pred_crc[5] = 0;
+	unknown->ephemerii[0].af0 ^= 1;
+	set_time(5);
+	zassert_equal(nrf_cloud_pgps_find_prediction(&p), 5, NULL);
+	zassert_equal_ptr(p, unknown, NULL);
+
+	/* a prediction not matching its checksum is not used */
+	changed = index.predictions[6];
+	changed->ephemerii[NRF_CLOUD_PGPS_NUM_SV - 1].sqrt_a ^= 1;
+	set_time(6);
+	zassert_equal(nrf_cloud_pgps_find_prediction(&p), -ELOADING, NULL);
+	zassert_is_null(p, NULL);
+	zassert_is_null(index.predictions[6], NULL);
+	zassert_equal_ptr(index.predictions[5], unknown, NULL);
+	check_request(6);
+
+	start_download(6);
+	finish_download();
+	check_predictions(6);
+	zassert_equal(nrf_cloud_pgps_find_prediction(&p), 6, NULL);
+	zassert_equal_ptr(p, changed, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(nrf_cloud_pgps_predictions_test,
+			 ztest_unit_test(test_index_round_trip),
+			 ztest_unit_test(test_crc_mismatch),
+			 ztest_unit_test(test_header_mismatch),
+			 ztest_unit_test(test_discard_cur_pnum),
+			 ztest_unit_test(test_resume_mid_prediction),
+			 ztest_unit_test(test_request_remaining),
+			 ztest_unit_test(test_prediction_crc)
+			 );
+
+	ztest_run_test_suite(nrf_cloud_pgps_predictions_test);
+}
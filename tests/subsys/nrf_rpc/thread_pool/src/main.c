@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <nrf_rpc_os.h>
+
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+#include "native_rtc.h"
+#endif
+
+#define ROUND_TRIP_CNT		1000
+
+/* Number of packets waiting for a free thread from the thread pool. */
+#define POOL_QUEUE_SIZE		2
+
+/* Packets are received in bursts, as from the rpmsg receive thread when
+ * several commands are sent by the other core. Every command takes some time
+ * to execute, for example, waiting for a response from the Bluetooth stack.
+ */
+#define BURST_SIZE		8
+#define BURST_CNT		20
+#define PACKET_CNT		(BURST_SIZE * BURST_CNT)
+#define HANDLER_TIME_MS		2
+#define BURST_INTERVAL_MS	10
+
+/* Same priority as the rpmsg receive thread. */
+#define RX_THREAD_PRIORITY	-1
+#define RX_THREAD_STACK_SIZE	1024
+
+enum bench_mode {
+	BENCH_ROUND_TRIP,
+	BENCH_BURST,
+};
+
+static uint8_t packets[PACKET_CNT];
+static uint8_t processed[PACKET_CNT];
+static atomic_t processed_cnt;
+static enum bench_mode mode;
+
+static K_SEM_DEFINE(response_sem, 0, 1);
+static K_SEM_DEFINE(burst_done_sem, 0, 1);
+
+static K_THREAD_STACK_DEFINE(rx_thread_stack, RX_THREAD_STACK_SIZE);
+static struct k_thread rx_thread;
+static uint32_t rx_blocked_ms;
+
+
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+/* Simulated time does not advance while code is executed, use host time. */
+static uint64_t timestamp_get(void)
+{
+	return native_rtc_gettime_us(RTC_CLOCK_REAL);
+}
+
+static uint64_t elapsed_ns(uint64_t start)
+{
+	return (timestamp_get() - start) * NSEC_PER_USEC;
+}
+#else
+static uint64_t timestamp_get(void)
+{
+	return k_cycle_get_32();
+}
+
+static uint64_t elapsed_ns(uint64_t start)
+{
+	uint32_t cycles = k_cycle_get_32() - (uint32_t)start;
+
+	return k_cyc_to_ns_floor64(cycles);
+}
+#endif /* CONFIG_BOARD_NATIVE_POSIX */
+
+static void pool_handler(const uint8_t *data, size_t len)
+{
+	size_t idx = data - packets;
+
+	zassert_equal(len, 1, "Invalid packet length");
+	zassert_true(idx < PACKET_CNT, "Invalid packet");
+
+	if (mode == BENCH_ROUND_TRIP) {
+		/* Loopback response */
+		k_sem_give(&response_sem);
+		return;
+	}
+
+	k_sleep(K_MSEC(HANDLER_TIME_MS));
+
+	processed[idx]++;
+	if (atomic_inc(&processed_cnt) + 1 == PACKET_CNT) {
+		k_sem_give(&burst_done_sem);
+	}
+}
+
+static void rx_thread_fn(void *p1, void *p2, void *p3)
+{
+	size_t idx = 0;
+
+	for (size_t burst = 0; burst < BURST_CNT; burst++) {
+		int64_t burst_start = k_uptime_get();
+
+		for (size_t i = 0; i < BURST_SIZE; i++) {
+			nrf_rpc_os_thread_pool_send(&packets[idx], 1);
+			idx++;
+		}
+
+		/* Time spent in the receive thread not receiving data. */
+		rx_blocked_ms += k_uptime_get() - burst_start;
+
+		k_sleep(K_MSEC(BURST_INTERVAL_MS));
+	}
+}
+
+static void test_init(void)
+{
+	int err;
+
+	err = nrf_rpc_os_init(pool_handler);
+	zassert_equal(err, 0, "Initialization failed");
+}
+
+static void test_round_trip(void)
+{
+	uint64_t start;
+	uint64_t total_ns;
+
+	mode = BENCH_ROUND_TRIP;
+
+	start = timestamp_get();
+
+	for (size_t i = 0; i < ROUND_TRIP_CNT; i++) {
+		nrf_rpc_os_thread_pool_send(&packets[i % PACKET_CNT], 1);
+		zassert_equal(k_sem_take(&response_sem, K_SECONDS(1)), 0,
+			      "No response");
+	}
+
+	total_ns = elapsed_ns(start);
+
+	TC_PRINT("Round trip through thread pool: %u ns\n",
+		 (uint32_t)(total_ns / ROUND_TRIP_CNT));
+}
+
+static void test_burst(void)
+{
+	struct nrf_rpc_os_pool_stats stats_start;
+	struct nrf_rpc_os_pool_stats stats;
+	int64_t start;
+	uint32_t total_ms;
+	int err;
+
+	mode = BENCH_BURST;
+	memset(processed, 0, sizeof(processed));
+	atomic_set(&processed_cnt, 0);
+	rx_blocked_ms = 0;
+
+	nrf_rpc_os_thread_pool_stats_get(&stats_start);
+
+	start = k_uptime_get();
+
+	k_thread_create(&rx_thread, rx_thread_stack,
+			K_THREAD_STACK_SIZEOF(rx_thread_stack), rx_thread_fn,
+			NULL, NULL, NULL, RX_THREAD_PRIORITY, 0, K_NO_WAIT);
+
+	err = k_sem_take(&burst_done_sem, K_SECONDS(10));
+	zassert_equal(err, 0, "Packets not processed");
+
+	total_ms = k_uptime_get() - start;
+
+	err = k_thread_join(&rx_thread, K_SECONDS(1));
+	zassert_equal(err, 0, "Receive thread not finished");
+
+	for (size_t i = 0; i < PACKET_CNT; i++) {
+		zassert_equal(processed[i], 1, "Packet %u processed %u times",
+			      i, processed[i]);
+	}
+
+	nrf_rpc_os_thread_pool_stats_get(&stats);
+	zassert_equal(stats.sent - stats_start.sent, PACKET_CNT,
+		      "Invalid number of sent packets");
+	zassert_true(stats.max_used <= POOL_QUEUE_SIZE, "Invalid queue usage");
+
+	/* Every burst is bigger than the queue. The receive thread is blocked
+	 * at least once per burst and at most once per packet.
+	 */
+	zassert_true(stats.blocked - stats_start.blocked >= BURST_CNT,
+		     "Blocking not counted");
+	zassert_true(stats.blocked - stats_start.blocked <=
+		     PACKET_CNT - POOL_QUEUE_SIZE,
+		     "Blocking counted more than once per packet");
+
+	TC_PRINT("%u packets in %u ms, receive thread blocked for %u ms "
+		 "(%u times), max queue usage %u\n",
+		 PACKET_CNT, total_ms, rx_blocked_ms,
+		 stats.blocked - stats_start.blocked, stats.max_used);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(nrf_rpc_thread_pool,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_round_trip),
+			 ztest_unit_test(test_burst)
+			 );
+
+	ztest_run_test_suite(nrf_rpc_thread_pool);
+}
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <sys/byteorder.h>
+#include <ztest.h>
+#include <profiler.h>
+
+#include "profiler_stream_sink.h"
+
+/* Record format, as described in profiler_stream.c. */
+#define RECORD_SYNC		0x5A
+#define RECORD_TYPE_HEADER	0x01
+#define RECORD_TYPE_EVENT_DESCR	0x02
+#define RECORD_TYPE_EVENT	0x03
+#define RECORD_TYPE_DROPPED	0x04
+#define RECORD_HDR_SIZE		3
+
+#define STREAM_VERSION		2
+#define HEADER_PAYLOAD_SIZE	9
+#define EVENT_PAYLOAD_SIZE	(sizeof(uint16_t) + sizeof(uint64_t) + \
+				 sizeof(uint32_t))
+
+#define TEST_EVENT_DESCR	"test_event,0,u32,value"
+#define TEST_VALUE		0x12345678
+#define TEST_BURST_CNT		100
+
+/* Wait long enough for the profiler thread to send the data. */
+#define FLUSH_WAIT		K_MSEC(5 * CONFIG_PROFILER_STREAM_FLUSH_PERIOD_MS)
+
+/* Fake sink collecting the stream. */
+static uint8_t output[4096];
+static size_t output_len;
+static bool output_overflow;
+static uint16_t test_event_id;
+
+int profiler_stream_sink_init(void)
+{
+	return 0;
+}
+
+int profiler_stream_sink_write(const uint8_t *data, size_t len)
+{
+	if (output_len + len > sizeof(output)) {
+		output_overflow = true;
+		len = sizeof(output) - output_len;
+	}
+
+	memcpy(&output[output_len], data, len);
+	output_len += len;
+
+	return 0;
+}
+
+struct record_cnt {
+	size_t header;
+	size_t descr;
+	size_t event;
+	uint32_t dropped;
+};
+
+/* Check framing of all of the records received so far and count them. */
+static void parse_records(struct record_cnt *cnt)
+{
+	size_t pos = 0;
+
+	memset(cnt, 0, sizeof(*cnt));
+	zassert_false(output_overflow, "Output overflow");
+
+	while (pos < output_len) {
+		zassert_true(pos + RECORD_HDR_SIZE <= output_len,
+			     "Truncated record header");
+		zassert_equal(output[pos], RECORD_SYNC, "No sync byte");
+
+		uint8_t type = output[pos + 1];
+		uint8_t len = output[pos + 2];
+		const uint8_t *payload = &output[pos + RECORD_HDR_SIZE];
+
+		zassert_true(pos + RECORD_HDR_SIZE + len <= output_len,
+			     "Truncated record");
+
+		switch (type) {
+		case RECORD_TYPE_HEADER:
+			zassert_equal(len, HEADER_PAYLOAD_SIZE,
+				      "Wrong header length");
+			zassert_mem_equal(payload, "NPRF", 4, "Wrong magic");
+			zassert_equal(payload[4], STREAM_VERSION,
+				      "Wrong version");
+			zassert_equal(sys_get_le32(&payload[5]),
+				      CONFIG_SYS_CLOCK_TICKS_PER_SEC,
+				      "Wrong tick frequency");
+			cnt->header++;
+			break;
+
+		case RECORD_TYPE_EVENT_DESCR:
+			zassert_equal(sys_get_le16(payload), test_event_id,
+				      "Wrong event type ID");
+			zassert_equal(len, sizeof(uint16_t) +
+				      strlen(TEST_EVENT_DESCR),
+				      "Wrong description length");
+			zassert_mem_equal(&payload[sizeof(uint16_t)],
+					  TEST_EVENT_DESCR,
+					  strlen(TEST_EVENT_DESCR),
+					  "Wrong description");
+			cnt->descr++;
+			break;
+
+		case RECORD_TYPE_EVENT:
+			zassert_equal(len, EVENT_PAYLOAD_SIZE,
+				      "Wrong event length");
+			zassert_equal(sys_get_le16(payload), test_event_id,
+				      "Wrong event type ID");
+			zassert_true(sys_get_le64(&payload[2]) <=
+				     k_uptime_ticks(), "Wrong timestamp");
+			zassert_equal(sys_get_le32(&payload[10]),
+				      TEST_VALUE + cnt->event,
+				      "Wrong event data");
+			cnt->event++;
+			break;
+
+		case RECORD_TYPE_DROPPED:
+			zassert_equal(len, sizeof(uint32_t),
+				      "Wrong dropped record length");
+			cnt->dropped += sys_get_le32(payload);
+			break;
+
+		default:
+			zassert_unreachable("Unknown record type");
+		}
+
+		pos += RECORD_HDR_SIZE + len;
+	}
+}
+
+static void log_test_event(uint32_t value)
+{
+	struct log_event_buf buf;
+
+	profiler_log_start(&buf);
+	profiler_log_encode_u32(&buf, value);
+	profiler_log_send(&buf, test_event_id);
+}
+
+static void setup(void)
+{
+	output_len = 0;
+	output_overflow = false;
+}
+
+static void test_stream_start(void)
+{
+	static const char *args[] = {"value"};
+	static const enum profiler_arg arg_types[] = {PROFILER_ARG_U32};
+	struct record_cnt cnt;
+
+	zassert_equal(profiler_init(), 0, "Init failed");
+	test_event_id = profiler_register_event_type("test_event", args,
+						     arg_types, 1);
+	k_sleep(FLUSH_WAIT);
+
+	parse_records(&cnt);
+	zassert_true(output_len > 0, "Nothing sent");
+	zassert_equal(output[1], RECORD_TYPE_HEADER,
+		      "Stream does not start with header");
+	zassert_equal(cnt.header, 1, "Wrong number of headers");
+	zassert_equal(cnt.descr, 1, "Event description not sent");
+	zassert_equal(cnt.event, 0, "Unexpected event");
+}
+
+static void test_event(void)
+{
+	struct record_cnt cnt;
+
+	log_test_event(TEST_VALUE);
+	k_sleep(FLUSH_WAIT);
+
+	parse_records(&cnt);
+	zassert_equal(cnt.event, 1, "Event not sent");
+	zassert_equal(cnt.dropped, 0, "Event dropped");
+}
+
+static void test_dropped(void)
+{
+	struct record_cnt cnt;
+
+	/* Profiler thread cannot drain the ring buffer in the meantime. */
+	k_sched_lock();
+	for (size_t i = 0; i < TEST_BURST_CNT; i++) {
+		log_test_event(TEST_VALUE + i);
+	}
+	k_sched_unlock();
+	k_sleep(FLUSH_WAIT);
+
+	parse_records(&cnt);
+	zassert_true(cnt.dropped > 0, "Ring buffer overflow not reported");
+	zassert_true(cnt.event > 0, "Events not sent");
+	zassert_equal(cnt.event + cnt.dropped, TEST_BURST_CNT,
+		      "Events lost without being reported");
+}
+
+static void test_descr_resend(void)
+{
+	struct record_cnt cnt;
+
+	k_sleep(K_MSEC(2 * CONFIG_PROFILER_STREAM_DESCR_RESEND_PERIOD_MS));
+
+	parse_records(&cnt);
+	zassert_true(cnt.header > 0, "Stream header not resent");
+	zassert_equal(cnt.header, cnt.descr,
+		      "Event description not resent with header");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(profiler_stream,
+		ztest_unit_test_setup_teardown(test_stream_start, setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_event, setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_dropped, setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_descr_resend, setup,
+					       unit_test_noop)
+	);
+
+	ztest_run_test_suite(profiler_stream);
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <device.h>
+#include <drivers/uart.h>
+#include <ztest.h>
+
+#include "profiler_stream_sink.h"
+
+#define TX_BUFFER_SIZE CONFIG_PROFILER_STREAM_SINK_UART_BUFFER_SIZE
+#define OUTPUT_SIZE (4 * TX_BUFFER_SIZE)
+#define WRITER_STACK_SIZE 1024
+#define WRITER_PRIORITY K_PRIO_PREEMPT(1)
+
+/* Fake UART driver. The test runs the interrupt handler on demand. */
+static uart_irq_callback_user_data_t fake_isr;
+static void *fake_isr_data;
+static bool tx_enabled;
+static size_t fifo_size;
+static uint8_t output[OUTPUT_SIZE];
+static size_t output_len;
+
+static int fake_fifo_fill(const struct device *dev, const uint8_t *data,
+			  int len)
+{
+	size_t cnt = MIN((size_t)len, fifo_size);
+
+	zassert_true(output_len + cnt <= sizeof(output), "Output overflow");
+	memcpy(&output[output_len], data, cnt);
+	output_len += cnt;
+
+	return cnt;
+}
+
+static void fake_irq_tx_enable(const struct device *dev)
+{
+	tx_enabled = true;
+}
+
+static void fake_irq_tx_disable(const struct device *dev)
+{
+	tx_enabled = false;
+}
+
+static int fake_irq_tx_ready(const struct device *dev)
+{
+	return tx_enabled;
+}
+
+static int fake_irq_update(const struct device *dev)
+{
+	return 1;
+}
+
+static void fake_irq_callback_set(const struct device *dev,
+				  uart_irq_callback_user_data_t cb,
+				  void *user_data)
+{
+	fake_isr = cb;
+	fake_isr_data = user_data;
+}
+
+static const struct uart_driver_api fake_uart_api = {
+	.fifo_fill = fake_fifo_fill,
+	.irq_tx_enable = fake_irq_tx_enable,
+	.irq_tx_disable = fake_irq_tx_disable,
+	.irq_tx_ready = fake_irq_tx_ready,
+	.irq_update = fake_irq_update,
+	.irq_callback_set = fake_irq_callback_set,
+};
+
+static int fake_uart_init(const struct device *dev)
+{
+	return 0;
+}
+
+DEVICE_DEFINE(fake_uart, "FAKE_UART", fake_uart_init, NULL, NULL, NULL,
+	      POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE, &fake_uart_api);
+
+static void run_isr(void)
+{
+	zassert_not_null(fake_isr, "Interrupt handler not set");
+	fake_isr(device_get_binding("FAKE_UART"), fake_isr_data);
+}
+
+/* Run the interrupt handler until the sink disables the TX interrupt. */
+static size_t drain(void)
+{
+	size_t isr_cnt = 0;
+
+	while (tx_enabled) {
+		run_isr();
+		isr_cnt++;
+		zassert_true(isr_cnt <= OUTPUT_SIZE + 1, "TX never completes");
+	}
+
+	return isr_cnt;
+}
+
+static void fill_pattern(uint8_t *buf, size_t len, uint8_t seed)
+{
+	for (size_t i = 0; i < len; i++) {
+		buf[i] = (uint8_t)(seed + i);
+	}
+}
+
+static void setup(void)
+{
+	output_len = 0;
+	fifo_size = TX_BUFFER_SIZE;
+	memset(output, 0, sizeof(output));
+}
+
+static void test_init(void)
+{
+	zassert_equal(profiler_stream_sink_init(), 0, "Init failed");
+	zassert_not_null(fake_isr, "Interrupt handler not set");
+	zassert_false(tx_enabled, "TX interrupt enabled without data");
+}
+
+static void test_write(void)
+{
+	uint8_t data[10];
+
+	fill_pattern(data, sizeof(data), 0x10);
+
+	zassert_equal(profiler_stream_sink_write(data, sizeof(data)), 0,
+		      "Write failed");
+	zassert_true(tx_enabled, "TX interrupt not enabled");
+	zassert_equal(output_len, 0, "Data sent outside of the interrupt");
+
+	drain();
+
+	zassert_equal(output_len, sizeof(data), "Wrong number of bytes sent");
+	zassert_mem_equal(output, data, sizeof(data), "Wrong data sent");
+}
+
+static void test_partial_fifo_fill(void)
+{
+	uint8_t data[TX_BUFFER_SIZE - 1];
+
+	fill_pattern(data, sizeof(data), 0x20);
+	fifo_size = 3;
+
+	zassert_equal(profiler_stream_sink_write(data, sizeof(data)), 0,
+		      "Write failed");
+
+	size_t isr_cnt = drain();
+
+	zassert_true(isr_cnt > sizeof(data) / fifo_size,
+		     "Data not sent in parts");
+	zassert_equal(output_len, sizeof(data), "Wrong number of bytes sent");
+	zassert_mem_equal(output, data, sizeof(data), "Wrong data sent");
+}
+
+static K_THREAD_STACK_DEFINE(writer_stack, WRITER_STACK_SIZE);
+static struct k_thread writer_thread;
+static uint8_t writer_data[3 * TX_BUFFER_SIZE];
+static volatile bool writer_done;
+
+static void writer_fn(void *p1, void *p2, void *p3)
+{
+	zassert_equal(profiler_stream_sink_write(writer_data,
+						 sizeof(writer_data)),
+		      0, "Write failed");
+	writer_done = true;
+}
+
+static void test_backpressure(void)
+{
+	fill_pattern(writer_data, sizeof(writer_data), 0x30);
+	fifo_size = 16;
+	writer_done = false;
+
+	k_thread_create(&writer_thread, writer_stack,
+			K_THREAD_STACK_SIZEOF(writer_stack), writer_fn,
+			NULL, NULL, NULL, WRITER_PRIORITY, 0, K_NO_WAIT);
+
+	/* Writer must wait for space instead of dropping the data. */
+	k_sleep(K_MSEC(50));
+	zassert_false(writer_done, "Writer not blocked on full buffer");
+	zassert_equal(output_len, 0, "Data sent outside of the interrupt");
+
+	while (!writer_done || tx_enabled) {
+		run_isr();
+		k_sleep(K_MSEC(1));
+	}
+
+	zassert_equal(k_thread_join(&writer_thread, K_SECONDS(1)), 0,
+		      "Writer did not finish");
+	zassert_equal(output_len, sizeof(writer_data),
+		      "Wrong number of bytes sent");
+	zassert_mem_equal(output, writer_data, sizeof(writer_data),
+			  "Wrong data sent");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(profiler_stream_uart,
+		ztest_unit_test(test_init),
+		ztest_unit_test_setup_teardown(test_write, setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_partial_fifo_fill, setup,
+					       unit_test_noop),
+		ztest_unit_test_setup_teardown(test_backpressure, setup,
+					       unit_test_noop)
+	);
+
+	ztest_run_test_suite(profiler_stream_uart);
+}
@@ -9,6 +9,7 @@
 #include <zboss_api.h>
 #include <zb_errors.h>
 #include <zb_osif.h>
+#include <zb_nrf_platform.h>
 
 #define PAGE_SIZE 0x400         /* Size for testing purpose */
 #define VIRTUAL_PAGE_COUNT 2    /* ZBOSS uses two virtual pages */
@@ -48,6 +49,7 @@ static void test_zb_nvram_erase(void)
 
 		zassert_true(ret == RET_OK, "Erasing failed");
 	}
+	zb_osif_nvram_wait_for_last_op();
 
 	/* Validate if flash memory is cleared */
 	for (uint8_t page = 0; page < VIRTUAL_PAGE_COUNT; page++) {
@@ -97,13 +99,61 @@ static void test_zb_nvram_write(void)
 	}
 }
 
+static void test_zb_nvram_small_writes(void)
+{
+	const uint32_t word_cnt = 64;
+	struct zigbee_nvram_stats stats;
+	uint32_t word;
+	int ret;
+
+	ret = zb_osif_nvram_erase_async(0);
+	zassert_true(ret == RET_OK, "Erasing failed");
+	zb_osif_nvram_wait_for_last_op();
+
+	zigbee_nvram_stats_reset();
+
+	for (uint32_t i = 0; i < word_cnt; i++) {
+		word = i;
+		ret = zb_osif_nvram_write(0, i * sizeof(word), &word,
+					  sizeof(word));
+		zassert_true(ret == RET_OK, "writing failed");
+	}
+
+	/* Written data must be readable before it is flushed */
+	for (uint32_t i = 0; i < word_cnt; i++) {
+		zb_osif_nvram_read(0, i * sizeof(word), (zb_uint8_t *)&word,
+				   sizeof(word));
+		zassert_equal(word, i, "reading before flush failed");
+	}
+
+	zb_osif_nvram_flush();
+
+	for (uint32_t i = 0; i < word_cnt; i++) {
+		zb_osif_nvram_read(0, i * sizeof(word), (zb_uint8_t *)&word,
+				   sizeof(word));
+		zassert_equal(word, i, "reading after flush failed");
+	}
+
+	zigbee_nvram_stats_get(&stats);
+	zassert_equal(stats.writes, word_cnt, "Incorrect write count");
+	zassert_equal(stats.flash_write_bytes, word_cnt * sizeof(word),
+		      "Incorrect flash write byte count");
+	if (IS_ENABLED(CONFIG_ZIGBEE_NVRAM_WRITE_CACHE)) {
+		zassert_equal(stats.flash_writes, 1,
+			      "Writes not combined");
+	} else {
+		zassert_equal(stats.flash_writes, word_cnt,
+			      "Incorrect flash write count");
+	}
+}
 
 void test_main(void)
 {
 	ztest_test_suite(osif_test,
 			 ztest_unit_test(test_zb_nvram_memory_size),
 			 ztest_unit_test(test_zb_nvram_erase),
-			 ztest_unit_test(test_zb_nvram_write)
+			 ztest_unit_test(test_zb_nvram_write),
+			 ztest_unit_test(test_zb_nvram_small_writes)
 			 );
 
 	ztest_run_test_suite(osif_test);
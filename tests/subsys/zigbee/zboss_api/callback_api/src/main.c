@@ -166,6 +166,58 @@ void test_zboss_app_callbacks(void)
 	}
 }
 
+static atomic_t burst_cb_cnt;
+static uint8_t burst_cb_order[CONFIG_ZIGBEE_APP_CB_QUEUE_LENGTH];
+
+static void burst_callback(uint8_t param)
+{
+	atomic_val_t idx = atomic_inc(&burst_cb_cnt);
+
+	if (idx < ARRAY_SIZE(burst_cb_order)) {
+		burst_cb_order[idx] = param;
+	}
+}
+
+void test_zboss_app_callback_burst(void)
+{
+	struct zigbee_app_cb_queue_stats stats;
+	zb_ret_t ret;
+
+	zigbee_app_cb_queue_stats_reset();
+
+	/* Fill the queue before the ZBOSS thread gets a chance to run. */
+	k_sched_lock();
+	for (uint8_t i = 0; i < CONFIG_ZIGBEE_APP_CB_QUEUE_LENGTH; i++) {
+		ret = zigbee_schedule_callback(burst_callback, i);
+		zassert_equal(ret, RET_OK, "Unable to schedule callback.");
+	}
+	ret = zigbee_schedule_callback(burst_callback,
+				       CONFIG_ZIGBEE_APP_CB_QUEUE_LENGTH);
+	k_sched_unlock();
+
+	zassert_equal(ret, RET_OVERFLOW,
+		      "Full queue not signalled to the producer.");
+
+	/* Let the ZBOSS thread process the callbacks. */
+	k_sleep(K_MSEC(100));
+
+	zassert_equal(atomic_get(&burst_cb_cnt),
+		      CONFIG_ZIGBEE_APP_CB_QUEUE_LENGTH,
+		      "Not all scheduled callbacks were called.");
+	for (uint8_t i = 0; i < ARRAY_SIZE(burst_cb_order); i++) {
+		zassert_equal(burst_cb_order[i], i,
+			      "Callbacks called in incorrect order.");
+	}
+
+	zigbee_app_cb_queue_stats_get(&stats);
+	zassert_equal(stats.queue_full, 1,
+		      "Incorrect number of rejected requests.");
+	zassert_true(stats.processed >= CONFIG_ZIGBEE_APP_CB_QUEUE_LENGTH,
+		     "Incorrect number of processed requests.");
+	zassert_equal(stats.depth_max, CONFIG_ZIGBEE_APP_CB_QUEUE_LENGTH,
+		      "Incorrect maximum queue depth.");
+}
+
 void test_main(void)
 {
 	/* Erase NVRAM to have repeatability of test runs. */
@@ -176,7 +228,8 @@ void test_main(void)
 
 	ztest_test_suite(zboss_api_callback,
 			 ztest_unit_test(test_zboss_startup_signals),
-			 ztest_unit_test(test_zboss_app_callbacks));
+			 ztest_unit_test(test_zboss_app_callbacks),
+			 ztest_unit_test(test_zboss_app_callback_burst));
 
 	ztest_run_test_suite(zboss_api_callback);
 }